@@ -0,0 +1,144 @@
+/*
+ * adc_dma_sim.c
+ *
+ *  Board profiles and the trigger / conversion / DMA loop behind
+ *  adc_dma_sim.h.
+ */
+
+#include "adc_dma_sim.h"
+
+#include <string.h>
+
+/* ADC clock PCLK/2 = 32 MHz; 1.5 sampling + 12.5 conversion cycles */
+#define CONV_NS_12B_1C5 (14.0f * 1000.0f / 32.0f)
+
+/* ADC_SCAN_SEQ_FIXED converts the enabled channels in ascending order */
+static const AdcSim_Rank apc250Ranks[] = {
+    {  0, "LED_VOLTAGE_4" },       /* PA0 */
+    {  1, "LED_VOLTAGE_3" },       /* PA1 */
+    {  2, "LED_VOLTAGE_2" },       /* PA2 */
+    {  3, "LED_VOLTAGE_1" },       /* PA3 */
+    {  4, "BATTERY_NTC_2" },       /* PA4 */
+    {  5, "SYS_CURRENT" },         /* PA5 */
+    {  8, "USB_C_60W_IN" },        /* PB0 */
+    {  9, "USB_C_100W_V_BUS" },    /* PB1 */
+    { 10, "USB_C_100W_V_SOURCE" }, /* PB2 */
+    { 11, "USB_C_100W_I_SENSE" },  /* PB10 */
+    { 15, "USB_C_100W_V_SINK" },   /* PB11 */
+    { 16, "USB_C_60W_V_BUS" },     /* PB12 */
+    { 17, "USB_C_60W_I_SENSE" },   /* PC4 */
+    { 18, "USB_C_60W_V_SINK" },    /* PC5 */
+};
+
+/* Same front end without PB10 (USB_C_100W_I_SENSE) */
+static const AdcSim_Rank spc250msRanks[] = {
+    {  0, "LED_VOLTAGE_4" },
+    {  1, "LED_VOLTAGE_3" },
+    {  2, "LED_VOLTAGE_2" },
+    {  3, "LED_VOLTAGE_1" },
+    {  4, "BATTERY_NTC_2" },
+    {  5, "SYS_CURRENT" },
+    {  8, "USB_C_60W_IN" },
+    {  9, "USB_C_100W_V_BUS" },
+    { 10, "USB_C_100W_V_SOURCE" },
+    { 15, "USB_C_100W_V_SINK" },
+    { 16, "USB_C_60W_V_BUS" },
+    { 17, "USB_C_60W_I_SENSE" },   /* labelled DC_USB_C_60W_I_SENSE in main.h */
+    { 18, "USB_C_60W_V_SINK" },
+};
+
+const AdcSim_Profile AdcSim_apc250 = {
+    .board      = "apc250",
+    .trigger_Hz = 10.0f,    /* TIM4 TRGO: 64 MHz / 6400 / 1000 */
+    .conv_ns    = CONV_NS_12B_1C5,
+    .vref_mV    = 3300.0f,
+    .bits       = 12,
+    .rankCount  = sizeof apc250Ranks / sizeof apc250Ranks[0],
+    .ranks      = apc250Ranks,
+    .bufferLen  = 17,       /* ADC_NUM_CONVERSIONS, adc_buffer in main.c */
+    .notes      = "TIM4 TRGO at 10 Hz into the 17-halfword circular adc_buffer; "
+                  "MX_ADC1_Init configures no channel, so the sequence is the 14 "
+                  "pins HAL_ADC_MspInit puts in analog mode",
+};
+
+const AdcSim_Profile AdcSim_spc250ms = {
+    .board      = "spc250ms",
+    .trigger_Hz = 1000.0f,
+    .conv_ns    = CONV_NS_12B_1C5,
+    .vref_mV    = 3300.0f,
+    .bits       = 12,
+    .rankCount  = sizeof spc250msRanks / sizeof spc250msRanks[0],
+    .ranks      = spc250msRanks,
+    .bufferLen  = 2 * (sizeof spc250msRanks / sizeof spc250msRanks[0]),
+    .notes      = "13 fixed-sequence ranks from adc.c; the firmware starts the ADC "
+                  "from software without DMA, so rate (1 kHz) and the double "
+                  "buffer (2 x 13 halfwords) are assumed",
+};
+
+static const AdcSim_Profile *const profiles[] = { &AdcSim_apc250, &AdcSim_spc250ms };
+
+const AdcSim_Profile *AdcSim_findProfile(const char *board){
+    for (size_t i = 0; i < sizeof profiles / sizeof profiles[0]; i++)
+        if (strcmp(profiles[i]->board, board) == 0)
+            return profiles[i];
+    return NULL;
+}
+
+__attribute__((weak)) void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc){
+    (void)hadc;
+}
+
+__attribute__((weak)) void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc){
+    (void)hadc;
+}
+
+void AdcSim_init(AdcSim *sim, const AdcSim_Profile *profile, ADC_HandleTypeDef *hadc,
+                 uint16_t *buffer, float trigger_Hz, uint32_t seed){
+    memset(sim, 0, sizeof *sim);
+    sim->profile = profile;
+    sim->hadc = hadc;
+    sim->buffer = buffer;
+    sim->trigger_Hz = trigger_Hz > 0.0f ? trigger_Hz : profile->trigger_Hz;
+    for (uint8_t r = 0; r < profile->rankCount; r++)
+        SigGen_init(&sim->signal[r], 0.0f, seed * 2654435761u + r + 1u);
+    memset(buffer, 0, profile->bufferLen * sizeof buffer[0]);
+}
+
+SigChannel *AdcSim_signal(AdcSim *sim, const char *net){
+    for (uint8_t r = 0; r < sim->profile->rankCount; r++)
+        if (strcmp(sim->profile->ranks[r].net, net) == 0)
+            return &sim->signal[r];
+    return NULL;
+}
+
+void AdcSim_run(AdcSim *sim, uint64_t dur_ns){
+    const AdcSim_Profile *p = sim->profile;
+    const double period_ns = 1e9 / (double)sim->trigger_Hz;
+    const uint16_t half = p->bufferLen / 2;
+    const uint64_t end = sim->end_ns + dur_ns;
+
+    for (;;){
+        /* From the trigger count, so the period error does not accumulate */
+        uint64_t t = (uint64_t)((double)sim->triggers * period_ns);
+        if (t >= end)
+            break;
+        sim->triggers++;
+
+        for (uint8_t r = 0; r < p->rankCount; r++){
+            sim->now_ns = t + (uint64_t)((float)(r + 1) * p->conv_ns);
+            float mV = SigGen_sample_mV(&sim->signal[r], sim->now_ns);
+            sim->buffer[sim->pos++] = SigGen_toCounts(mV, p->vref_mV, p->bits);
+            sim->conversions++;
+
+            if (sim->pos == half){
+                sim->halfCallbacks++;
+                HAL_ADC_ConvHalfCpltCallback(sim->hadc);
+            } else if (sim->pos == p->bufferLen){
+                sim->pos = 0;
+                sim->fullCallbacks++;
+                HAL_ADC_ConvCpltCallback(sim->hadc);
+            }
+        }
+    }
+    sim->end_ns = end;
+}
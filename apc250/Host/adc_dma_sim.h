@@ -0,0 +1,100 @@
+/*
+ * adc_dma_sim.h
+ *
+ *  Host model of the ADC1 -> DMA1 channel 1 path: each trigger converts the
+ *  board's rank sequence, every conversion is sampled from a SigChannel at
+ *  its own instant and written to a circular halfword buffer, and the HAL
+ *  transfer callbacks fire where the DMA half- and full-transfer interrupts
+ *  would. Processing code written against the HAL callbacks runs unchanged
+ *  on the virtual clock, at whatever speed the host manages.
+ *
+ *  HAL_ADC_ConvHalfCpltCallback / HAL_ADC_ConvCpltCallback are weak here,
+ *  as in the Cube HAL; the code under test provides the real ones. Build
+ *  with -DADC_SIM_HAVE_HAL when a host HAL header already defines
+ *  ADC_HandleTypeDef.
+ */
+
+#ifndef ADC_DMA_SIM_H_
+#define ADC_DMA_SIM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "siggen.h"
+#include <stdint.h>
+
+#ifndef ADC_SIM_MAX_RANKS
+#define ADC_SIM_MAX_RANKS 16
+#endif
+
+#ifndef ADC_SIM_HAVE_HAL
+typedef struct {
+    void *Instance;
+} ADC_HandleTypeDef;
+#endif
+
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc);
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc);
+
+/* One conversion of the regular sequence */
+typedef struct {
+    uint8_t     channel;   /* ADC_CHANNEL_n */
+    const char *net;       /* signal name, main.h pin label without ADC_ / _Pin */
+} AdcSim_Rank;
+
+typedef struct {
+    const char        *board;
+    float              trigger_Hz;   /* sequence starts per second */
+    float              conv_ns;      /* sampling + conversion, per rank */
+    float              vref_mV;
+    uint8_t            bits;
+    uint8_t            rankCount;
+    const AdcSim_Rank *ranks;
+    uint16_t           bufferLen;    /* halfwords in the circular buffer */
+    const char        *notes;        /* where the numbers come from */
+} AdcSim_Profile;
+
+extern const AdcSim_Profile AdcSim_apc250;
+extern const AdcSim_Profile AdcSim_spc250ms;
+
+/* Profile by board name, NULL if unknown */
+const AdcSim_Profile *AdcSim_findProfile(const char *board);
+
+typedef struct {
+    const AdcSim_Profile *profile;
+    ADC_HandleTypeDef    *hadc;
+    uint16_t             *buffer;        /* profile->bufferLen halfwords */
+    float                 trigger_Hz;    /* profile value unless overridden */
+    SigChannel            signal[ADC_SIM_MAX_RANKS];
+
+    uint64_t now_ns;         /* virtual clock: time of the last conversion */
+    uint64_t end_ns;         /* simulated up to here */
+    uint64_t triggers;       /* sequences started */
+    uint64_t conversions;
+    uint64_t halfCallbacks;
+    uint64_t fullCallbacks;
+    uint16_t pos;            /* next DMA write index */
+} AdcSim;
+
+/* Bind a profile, handle and buffer; every signal starts as a noiseless
+ * 0 mV level seeded from seed. trigger_Hz <= 0 keeps the profile rate. */
+void AdcSim_init(AdcSim *sim, const AdcSim_Profile *profile, ADC_HandleTypeDef *hadc,
+                 uint16_t *buffer, float trigger_Hz, uint32_t seed);
+
+/* Signal feeding the rank with this net name, NULL if none */
+SigChannel *AdcSim_signal(AdcSim *sim, const char *net);
+
+/* Run every trigger due in [end_ns, end_ns + dur_ns) */
+void AdcSim_run(AdcSim *sim, uint64_t dur_ns);
+
+/* Rank written by the n-th conversion since start (n = 0, 1, ...) */
+static inline uint8_t AdcSim_rankOf(const AdcSim *sim, uint64_t n){
+    return (uint8_t)(n % sim->profile->rankCount);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ADC_DMA_SIM_H_ */
@@ -0,0 +1,290 @@
+/*
+ * adc_sim.c
+ *
+ *  ADC pipeline regression and throughput run on the simulated DMA path
+ *  (adc_dma_sim.h), for each board profile:
+ *
+ *    adc_sim [-b apc250|spc250ms] [-r trigger_Hz] [-s seed] [-v] [seconds]
+ *
+ *  seconds defaults to 60, at least 55 (the bench signals below). Without
+ *  -b both boards run.
+ *
+ *  The pipeline under test is what the firmware's DMA callbacks would do:
+ *  take the completed half of adc_buffer, demultiplex it by conversion
+ *  count (the buffer need not hold whole sequences), low-pass every rank
+ *  and watch two nets for fault thresholds. The bench drives every rank
+ *  with noise, LED_VOLTAGE_1 with a ramp, the NTC with a step, both VBUS
+ *  sense lines with switching ripple, SYS_CURRENT with a slow and a 1 ms
+ *  overcurrent transient and USB_C_60W_IN with a brownout.
+ *
+ *  Checks: callback counts match the conversions, every conversion was
+ *  consumed exactly once, every filtered rank settles within FILTER_TOL_MV
+ *  of the ideal level, and the slow transient and the brownout trip their
+ *  watch within a sequence-and-a-buffer of their start. The 1 ms transient
+ *  is only reported: whether a trigger catches it is the point of running
+ *  it. The last line gives the speed against real time. Exits non-zero if
+ *  any check fails (`make run`).
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "adc_dma_sim.h"
+
+#define S(x)           ((uint64_t)((x) * 1e9))
+#define MIN_SECONDS    55
+#define FILTER_SHIFT   4        /* EMA weight 1/16 per sample of a rank */
+#define FILTER_TOL_MV  15.0f
+#define MAX_BUFFER     64
+#define MAX_TRIPS      8
+
+typedef struct {
+    const char *net;
+    int         above;          /* trip above the threshold, else below */
+    float       threshold_mV;
+    int         rank;           /* -1 when the board lacks the net */
+    uint16_t    threshold;      /* counts */
+    int         active;
+    int         trips;
+    uint64_t    trip_ns[MAX_TRIPS];   /* callback time of each trip */
+} Watch;
+
+/* Expected fault on a watch: must trip within the latency bound, or (0)
+ * is reported only */
+typedef struct {
+    int         watch;
+    uint64_t    t0_ns;
+    int         must;
+    const char *what;
+} Fault;
+
+static Watch watches[] = {
+    { "SYS_CURRENT",  1, 1200.0f, -1, 0, 0, 0, {0} },   /* overcurrent */
+    { "USB_C_60W_IN", 0, 1000.0f, -1, 0, 0, 0, {0} },   /* brownout */
+};
+#define WATCH_COUNT (int)(sizeof watches / sizeof watches[0])
+
+static const Fault faults[] = {
+    { 0, S(30.0),    1, "overcurrent, tau 300 ms" },
+    { 0, S(45.0005), 0, "overcurrent, tau 1 ms" },
+    { 1, S(50.0),    1, "brownout, tau 200 ms" },
+};
+
+static AdcSim sim;
+static ADC_HandleTypeDef hadc1;
+static uint16_t adc_buffer[MAX_BUFFER];
+static int verbose;
+
+/* Pipeline state: what firmware would keep */
+static uint64_t consumed;                        /* conversions taken out */
+static int32_t  filtered[ADC_SIM_MAX_RANKS];     /* counts << FILTER_SHIFT */
+static uint8_t  primed[ADC_SIM_MAX_RANKS];
+
+static void process(uint16_t from, uint16_t to){
+    for (uint16_t i = from; i < to; i++){
+        uint8_t rank = AdcSim_rankOf(&sim, consumed++);
+        uint16_t x = adc_buffer[i];
+
+        if (!primed[rank]){
+            filtered[rank] = (int32_t)x << FILTER_SHIFT;
+            primed[rank] = 1;
+        } else {
+            filtered[rank] += (int32_t)x - (filtered[rank] >> FILTER_SHIFT);
+        }
+
+        for (int w = 0; w < WATCH_COUNT; w++){
+            Watch *wt = &watches[w];
+            if (wt->rank != rank) continue;
+            int over = wt->above ? x > wt->threshold : x < wt->threshold;
+            if (over && !wt->active && wt->trips < MAX_TRIPS)
+                wt->trip_ns[wt->trips++] = sim.now_ns;
+            wt->active = over;
+        }
+    }
+}
+
+static void dump(const char *which, uint16_t from, uint16_t to){
+    printf("[ADCSIM] %8.3f s %-4s", (double)sim.now_ns * 1e-9, which);
+    for (uint16_t i = from; i < to; i++) printf(" %4u", adc_buffer[i]);
+    printf("\n");
+}
+
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc){
+    (void)hadc;
+    uint16_t half = sim.profile->bufferLen / 2;
+    if (verbose && sim.halfCallbacks <= 2) dump("half", 0, half);
+    process(0, half);
+}
+
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc){
+    (void)hadc;
+    uint16_t half = sim.profile->bufferLen / 2;
+    if (verbose && sim.fullCallbacks <= 2) dump("full", half, sim.profile->bufferLen);
+    process(half, sim.profile->bufferLen);
+}
+
+/* Bench signals, pin millivolts (3.3 V full scale) */
+static void setupSignals(void){
+    static const struct { const char *net; float mV; } levels[] = {
+        { "LED_VOLTAGE_1", 1200.0f }, { "LED_VOLTAGE_2", 1200.0f },
+        { "LED_VOLTAGE_3", 1200.0f }, { "LED_VOLTAGE_4", 1200.0f },
+        { "BATTERY_NTC_2", 1650.0f }, { "SYS_CURRENT",    400.0f },
+        { "USB_C_60W_IN",  1650.0f }, { "USB_C_100W_V_BUS", 1650.0f },
+        { "USB_C_100W_V_SOURCE", 1500.0f }, { "USB_C_100W_I_SENSE", 300.0f },
+        { "USB_C_100W_V_SINK", 1600.0f }, { "USB_C_60W_V_BUS", 1650.0f },
+        { "USB_C_60W_I_SENSE", 250.0f }, { "USB_C_60W_V_SINK", 1600.0f },
+    };
+    for (size_t i = 0; i < sizeof levels / sizeof levels[0]; i++){
+        SigChannel *ch = AdcSim_signal(&sim, levels[i].net);
+        if (!ch) continue;
+        ch->base_mV = levels[i].mV;
+        SigGen_noise(ch, 4.0f);
+    }
+
+    SigGen_ramp(AdcSim_signal(&sim, "LED_VOLTAGE_1"), S(5), S(20), 1500.0f);
+    SigGen_step(AdcSim_signal(&sim, "BATTERY_NTC_2"), S(20), -300.0f);
+    /* Buck ripple well above the trigger rate and not a multiple of it:
+     * a ripple locked to the trigger aliases to a DC offset */
+    SigGen_pwmRipple(AdcSim_signal(&sim, "USB_C_100W_V_BUS"), 287341.7f, 0.40f, 40.0f);
+    SigGen_pwmRipple(AdcSim_signal(&sim, "USB_C_60W_V_BUS"), 411713.3f, 0.25f, 40.0f);
+    SigGen_transient(AdcSim_signal(&sim, "SYS_CURRENT"), faults[0].t0_ns, S(0.3), 2000.0f);
+    SigGen_transient(AdcSim_signal(&sim, "SYS_CURRENT"), faults[1].t0_ns, S(0.001), 2000.0f);
+    SigGen_transient(AdcSim_signal(&sim, "USB_C_60W_IN"), faults[2].t0_ns, S(0.2), -1000.0f);
+}
+
+static double wallSeconds(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int runBoard(const AdcSim_Profile *p, float trigger_Hz, uint32_t seed, uint32_t seconds){
+    int failures = 0;
+    const char *b = p->board;
+
+    if (p->bufferLen > MAX_BUFFER || p->rankCount > ADC_SIM_MAX_RANKS){
+        printf("[ADCSIM] %s: profile exceeds MAX_BUFFER / ADC_SIM_MAX_RANKS: FAIL\n", b);
+        return 1;
+    }
+    AdcSim_init(&sim, p, &hadc1, adc_buffer, trigger_Hz, seed);
+    consumed = 0;
+    memset(filtered, 0, sizeof filtered);
+    memset(primed, 0, sizeof primed);
+    for (int w = 0; w < WATCH_COUNT; w++){
+        Watch *wt = &watches[w];
+        wt->rank = -1;
+        for (uint8_t r = 0; r < p->rankCount; r++)
+            if (strcmp(p->ranks[r].net, wt->net) == 0) wt->rank = r;
+        wt->threshold = SigGen_toCounts(wt->threshold_mV, p->vref_mV, p->bits);
+        wt->active = 0;
+        wt->trips = 0;
+    }
+    setupSignals();
+
+    printf("[ADCSIM] %s: %u ranks at %.0f Hz into %u halfwords (%s)\n",
+           b, p->rankCount, (double)sim.trigger_Hz, p->bufferLen, p->notes);
+    if (p->bufferLen % p->rankCount)
+        printf("[ADCSIM] %s: note: the buffer holds %.2f sequences, so a rank's slot moves "
+               "from one transfer to the next\n", b, (double)p->bufferLen / p->rankCount);
+
+    double t0 = wallSeconds();
+    AdcSim_run(&sim, S(seconds));
+    double wall = wallSeconds() - t0;
+
+    /* Callbacks against the conversions the DMA made */
+    uint16_t half = p->bufferLen / 2;
+    uint64_t expFull = sim.conversions / p->bufferLen;
+    uint64_t expHalf = expFull + (sim.conversions % p->bufferLen >= half);
+    uint64_t pending = sim.pos >= half ? sim.pos - half : sim.pos;
+    int ok = sim.halfCallbacks == expHalf && sim.fullCallbacks == expFull &&
+             consumed + pending == sim.conversions;
+    printf("[ADCSIM] %s: %llu triggers, %llu conversions, %llu half / %llu full callbacks, "
+           "%llu consumed: %s\n", b, (unsigned long long)sim.triggers,
+           (unsigned long long)sim.conversions, (unsigned long long)sim.halfCallbacks,
+           (unsigned long long)sim.fullCallbacks, (unsigned long long)consumed, ok ? "OK" : "FAIL");
+    failures += !ok;
+
+    /* Filtered ranks against the ideal level */
+    float worst = 0.0f;
+    const char *worstNet = "";
+    int bad = 0;
+    for (uint8_t r = 0; r < p->rankCount; r++){
+        float got = (float)filtered[r] / (float)(1 << FILTER_SHIFT) * p->vref_mV / (float)(1 << p->bits);
+        float want = SigGen_level_mV(&sim.signal[r], sim.now_ns);
+        float err = got > want ? got - want : want - got;
+        if (err > worst){ worst = err; worstNet = p->ranks[r].net; }
+        if (err > FILTER_TOL_MV){
+            printf("[ADCSIM] %s: %s filtered %.1f mV, level %.1f mV\n", b, p->ranks[r].net, got, want);
+            bad++;
+        }
+    }
+    printf("[ADCSIM] %s: filtered ranks within %.1f mV of the level (worst %s): %s\n",
+           b, (double)worst, worstNet, bad ? "FAIL" : "OK");
+    failures += bad != 0;
+
+    /* Fault watches: first trip at or after the fault start */
+    double period_s = 1.0 / sim.trigger_Hz;
+    uint64_t bound = S(period_s * (1.0 + (double)((p->bufferLen + p->rankCount - 1) / p->rankCount)));
+    for (size_t f = 0; f < sizeof faults / sizeof faults[0]; f++){
+        const Watch *wt = &watches[faults[f].watch];
+        if (wt->rank < 0 || faults[f].t0_ns >= S(seconds)) continue;
+        int64_t latency = -1;
+        for (int i = 0; i < wt->trips; i++)
+            if (wt->trip_ns[i] >= faults[f].t0_ns){ latency = (int64_t)(wt->trip_ns[i] - faults[f].t0_ns); break; }
+        int fail = faults[f].must && (latency < 0 || (uint64_t)latency > bound);
+        if (latency < 0)
+            printf("[ADCSIM] %s: %s on %s at %.4f s: missed%s\n", b, faults[f].what, wt->net,
+                   (double)faults[f].t0_ns * 1e-9, fail ? ": FAIL" : "");
+        else
+            printf("[ADCSIM] %s: %s on %s at %.4f s: tripped in the callback +%.3f ms%s\n", b,
+                   faults[f].what, wt->net, (double)faults[f].t0_ns * 1e-9, (double)latency * 1e-6,
+                   faults[f].must ? (fail ? ": FAIL" : ": OK") : "");
+        failures += fail;
+    }
+
+    printf("[ADCSIM] %s: %u s simulated in %.2f ms wall, %.0fx real time, %.1f ns/conversion\n",
+           b, seconds, wall * 1e3, wall > 0.0 ? (double)seconds / wall : 0.0,
+           sim.conversions ? wall * 1e9 / (double)sim.conversions : 0.0);
+    return failures;
+}
+
+static void usage(const char *prog){
+    fprintf(stderr, "usage: %s [-b apc250|spc250ms] [-r trigger_Hz] [-s seed] [-v] [seconds >= %d]\n",
+            prog, MIN_SECONDS);
+}
+
+int main(int argc, char **argv){
+    const AdcSim_Profile *only = NULL;
+    float trigger_Hz = 0.0f;
+    uint32_t seed = 1;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "b:r:s:v")) != -1){
+        switch (opt){
+        case 'b':
+            only = AdcSim_findProfile(optarg);
+            if (!only){ fprintf(stderr, "unknown board %s\n", optarg); return 2; }
+            break;
+        case 'r': trigger_Hz = (float)atof(optarg); break;
+        case 's': seed = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'v': verbose = 1; break;
+        default: usage(argv[0]); return 2;
+        }
+    }
+    uint32_t seconds = optind < argc ? (uint32_t)atoi(argv[optind]) : 60u;
+    if (seconds < MIN_SECONDS){
+        usage(argv[0]);
+        return 2;
+    }
+
+    int failures = 0;
+    if (only){
+        failures = runBoard(only, trigger_Hz, seed, seconds);
+    } else {
+        failures += runBoard(&AdcSim_apc250, trigger_Hz, seed, seconds);
+        failures += runBoard(&AdcSim_spc250ms, trigger_Hz, seed, seconds);
+    }
+    printf("[ADCSIM] %d failure(s)\n", failures);
+    return failures ? 1 : 0;
+}
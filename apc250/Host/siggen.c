@@ -0,0 +1,136 @@
+/*
+ * siggen.c
+ *
+ *  Signal components for siggen.h. Sampling is on the hot path of the ADC
+ *  simulation (one call per conversion), so the noise is a sum of uniforms
+ *  rather than Box-Muller and transients stop being evaluated once they
+ *  have decayed to a few parts per million of their peak.
+ */
+
+#include "siggen.h"
+
+#include <math.h>
+#include <string.h>
+
+/* A transient is treated as over after this many time constants */
+#define TRANSIENT_TAUS 12
+
+static int add(SigChannel *ch, const SigComponent *c){
+    if (ch->count >= SIGGEN_MAX_COMPONENTS)
+        return -1;
+    ch->comp[ch->count++] = *c;
+    return 0;
+}
+
+static uint32_t xorshift32(uint32_t *s){
+    uint32_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *s = x;
+}
+
+/* Irwin-Hall with four terms: mean 0, variance 1, tails cut at +-3.46 */
+static float gaussian(uint32_t *s){
+    uint32_t sum = 0;
+    for (int i = 0; i < 4; i++)
+        sum += xorshift32(s) >> 16;
+    return ((float)sum / 65536.0f - 2.0f) * 1.7320508f;
+}
+
+void SigGen_init(SigChannel *ch, float base_mV, uint32_t seed){
+    memset(ch, 0, sizeof *ch);
+    ch->base_mV = base_mV;
+    ch->rng = seed ? seed : 0x9E3779B9u;
+}
+
+int SigGen_step(SigChannel *ch, uint64_t t0_ns, float delta_mV){
+    SigComponent c = { .kind = SIG_STEP, .t0_ns = t0_ns, .amp_mV = delta_mV };
+    return add(ch, &c);
+}
+
+int SigGen_ramp(SigChannel *ch, uint64_t t0_ns, uint64_t dur_ns, float delta_mV){
+    SigComponent c = { .kind = SIG_RAMP, .t0_ns = t0_ns, .dur_ns = dur_ns, .amp_mV = delta_mV };
+    return add(ch, &c);
+}
+
+int SigGen_noise(SigChannel *ch, float sigma_mV){
+    SigComponent c = { .kind = SIG_NOISE, .amp_mV = sigma_mV };
+    return add(ch, &c);
+}
+
+int SigGen_pwmRipple(SigChannel *ch, float freq_Hz, float duty, float pp_mV){
+    if (freq_Hz <= 0.0f || duty < 0.0f || duty > 1.0f)
+        return -1;
+    SigComponent c = { .kind = SIG_PWM, .amp_mV = pp_mV, .freq_Hz = freq_Hz, .duty = duty };
+    return add(ch, &c);
+}
+
+int SigGen_transient(SigChannel *ch, uint64_t t0_ns, uint64_t tau_ns, float peak_mV){
+    if (tau_ns == 0)
+        return -1;
+    SigComponent c = { .kind = SIG_TRANSIENT, .t0_ns = t0_ns, .dur_ns = tau_ns, .amp_mV = peak_mV };
+    return add(ch, &c);
+}
+
+/* Steps, ramps and transients */
+static float deterministic(const SigComponent *c, uint64_t t_ns){
+    if (t_ns < c->t0_ns)
+        return 0.0f;
+    uint64_t dt = t_ns - c->t0_ns;
+
+    switch (c->kind){
+    case SIG_STEP:
+        return c->amp_mV;
+    case SIG_RAMP:
+        if (dt >= c->dur_ns)
+            return c->amp_mV;
+        return c->amp_mV * (float)((double)dt / (double)c->dur_ns);
+    case SIG_TRANSIENT:
+        if (dt >= (uint64_t)TRANSIENT_TAUS * c->dur_ns)
+            return 0.0f;
+        return c->amp_mV * expf(-(float)((double)dt / (double)c->dur_ns));
+    default:
+        return 0.0f;
+    }
+}
+
+float SigGen_level_mV(const SigChannel *ch, uint64_t t_ns){
+    float v = ch->base_mV;
+    for (uint8_t i = 0; i < ch->count; i++)
+        v += deterministic(&ch->comp[i], t_ns);
+    return v;
+}
+
+float SigGen_sample_mV(SigChannel *ch, uint64_t t_ns){
+    float v = ch->base_mV;
+    for (uint8_t i = 0; i < ch->count; i++){
+        const SigComponent *c = &ch->comp[i];
+        switch (c->kind){
+        case SIG_NOISE:
+            v += c->amp_mV * gaussian(&ch->rng);
+            break;
+        case SIG_PWM: {
+            /* Phase in double: t_ns passes 2^32 after four seconds */
+            double cycles = (double)t_ns * 1e-9 * c->freq_Hz;
+            float phase = (float)(cycles - floor(cycles));
+            v += phase < c->duty ? c->amp_mV * (1.0f - c->duty) : -c->amp_mV * c->duty;
+            break;
+        }
+        default:
+            v += deterministic(c, t_ns);
+            break;
+        }
+    }
+    return v;
+}
+
+uint16_t SigGen_toCounts(float mV, float vref_mV, uint8_t bits){
+    uint32_t full = (1u << bits) - 1u;
+    float counts = mV / vref_mV * (float)(1u << bits);
+    if (counts <= 0.0f)
+        return 0;
+    if (counts >= (float)full)
+        return (uint16_t)full;
+    return (uint16_t)(counts + 0.5f);
+}
@@ -0,0 +1,80 @@
+/*
+ * siggen.h
+ *
+ *  Analog test signals for the host ADC simulation (adc_dma_sim.h). A
+ *  channel is a base level plus a list of components, all in millivolts at
+ *  the ADC pin and timed in nanoseconds of virtual time:
+ *
+ *    step       level changes by amp_mV at t0
+ *    ramp       level moves linearly by amp_mV over dur_ns from t0
+ *    noise      gaussian, sigma amp_mV (deterministic, seeded per channel)
+ *    pwm        zero-mean square ripple, amp_mV peak-to-peak at freq_Hz,
+ *               high for `duty` of the period (switching regulators)
+ *    transient  amp_mV at t0 decaying with time constant dur_ns (fault
+ *               spikes; a negative amp_mV gives a dropout)
+ *
+ *  SigGen_level_mV() is the ideal level (steps, ramps, transients only),
+ *  which is what a filter downstream of the ADC should converge on.
+ */
+
+#ifndef SIGGEN_H_
+#define SIGGEN_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#ifndef SIGGEN_MAX_COMPONENTS
+#define SIGGEN_MAX_COMPONENTS 8
+#endif
+
+typedef enum {
+    SIG_STEP,
+    SIG_RAMP,
+    SIG_NOISE,
+    SIG_PWM,
+    SIG_TRANSIENT
+} SigKind;
+
+typedef struct {
+    SigKind  kind;
+    uint64_t t0_ns;
+    uint64_t dur_ns;    /* ramp length, transient time constant */
+    float    amp_mV;    /* delta, sigma, peak-to-peak or peak, see above */
+    float    freq_Hz;   /* pwm */
+    float    duty;      /* pwm, 0..1 */
+} SigComponent;
+
+typedef struct {
+    float        base_mV;
+    uint8_t      count;
+    SigComponent comp[SIGGEN_MAX_COMPONENTS];
+    uint32_t     rng;   /* xorshift32 state for the noise components */
+} SigChannel;
+
+/* Constant base_mV, no components; seed 0 is replaced by a fixed value */
+void  SigGen_init(SigChannel *ch, float base_mV, uint32_t seed);
+
+/* Add a component. Return 0, or -1 if the channel is full. */
+int   SigGen_step(SigChannel *ch, uint64_t t0_ns, float delta_mV);
+int   SigGen_ramp(SigChannel *ch, uint64_t t0_ns, uint64_t dur_ns, float delta_mV);
+int   SigGen_noise(SigChannel *ch, float sigma_mV);
+int   SigGen_pwmRipple(SigChannel *ch, float freq_Hz, float duty, float pp_mV);
+int   SigGen_transient(SigChannel *ch, uint64_t t0_ns, uint64_t tau_ns, float peak_mV);
+
+/* Pin voltage at t_ns with every component (advances the noise state) */
+float SigGen_sample_mV(SigChannel *ch, uint64_t t_ns);
+
+/* Pin voltage at t_ns without noise and ripple */
+float SigGen_level_mV(const SigChannel *ch, uint64_t t_ns);
+
+/* Right-aligned conversion result, clamped to 0 .. 2^bits - 1 */
+uint16_t SigGen_toCounts(float mV, float vref_mV, uint8_t bits);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIGGEN_H_ */
@@ -25,9 +25,12 @@ typedef enum {
 typedef enum {
     BM_SRC_GENERIC = 0,
     BM_SRC_BQ25798 = 1,
-    BM_SRC_BQ76907 = 2
+    BM_SRC_BQ76907 = 2,
+    BM_SRC_COUNT
 } BM_ErrorSource;
 
+#define BM_ERR_CODE_COUNT  10   /* BM_OK .. BM_ERR_UNKNOWN, counted by -code */
+
 /* Compact error entry for ring buffer */
 typedef struct {
     uint32_t tick;     /* HAL_GetTick() snapshot */
@@ -39,25 +42,60 @@ typedef struct {
 } BM_ErrorEntry;
 
 #ifndef BM_ERROR_LOG_DEPTH
-#define BM_ERROR_LOG_DEPTH 16
+#define BM_ERROR_LOG_DEPTH 16   /* power of two */
+#endif
+#ifndef BM_ERROR_RATE_WINDOW_MS
+#define BM_ERROR_RATE_WINDOW_MS 10000u
 #endif
 
-/* Helper macro to push an error into a device-specific ring buffer.
- * Device struct MUST expose: BM_ErrorEntry errorLog[BM_ERROR_LOG_DEPTH]; uint8_t errorHead; int8_t lastError; */
+/* Per-device error history. Producers may be the main loop and interrupts
+ * (e.g. I2C DMA callbacks): a slot is reserved by bumping head inside a
+ * short PRIMASK section (Cortex-M0+ has no LDREX/STREX), the entry is
+ * filled outside it and published by writing its sequence number last.
+ * Readers copy an entry and accept it only if the sequence still matches. */
+typedef struct {
+    BM_ErrorEntry     entry[BM_ERROR_LOG_DEPTH];
+    volatile uint32_t seq[BM_ERROR_LOG_DEPTH];   /* reservation index + 1 once written */
+    volatile uint32_t head;                      /* reservations, free running */
+    volatile int8_t   lastError;
+} BM_ErrorRing;
+
+/* Aggregates over every ring since the last reset, saturating at 0xFFFF */
+typedef struct {
+    uint16_t bySource[BM_SRC_COUNT];
+    uint16_t byCode[BM_ERR_CODE_COUNT];
+    uint16_t byReg[BM_SRC_COUNT][256];
+} BM_ErrorCounters;
+
+/* Record an error: ring slot, counters and the flash fault log queue.
+ * Safe from interrupts. ring may be NULL (counters only). */
+void BM_ErrorPush(BM_ErrorRing *ring, uint8_t src, int8_t code, uint8_t detail, uint8_t reg, uint16_t value);
+
+/* n-th most recent entry (0 = newest). Returns 0 if the slot is empty,
+ * overwritten or being written. */
+uint8_t BM_ErrorRead(const BM_ErrorRing *ring, uint32_t n, BM_ErrorEntry *out);
+/* Entries currently held (at most BM_ERROR_LOG_DEPTH) */
+uint32_t BM_ErrorRingCount(const BM_ErrorRing *ring);
+
+/* O(1) queries */
+uint16_t BM_ErrorCountBySource(uint8_t src);
+uint16_t BM_ErrorCountByCode(int8_t code);
+uint16_t BM_ErrorCountByReg(uint8_t src, uint8_t reg);
+/* Errors from src over the last BM_ERROR_RATE_WINDOW_MS (two-window estimate) */
+uint32_t BM_ErrorRate(uint8_t src, uint32_t now_ms);
+
+const BM_ErrorCounters *BM_ErrorGetCounters(void);
+void BM_ErrorResetCounters(void);
+void BM_ErrorLogStats(void);
+
+/* Flash fault log (faultlog.c): every pushed entry is also queued there.
+ * RAM copy only; the flash is programmed later from the main loop. */
+void FaultLog_Enqueue(const BM_ErrorEntry *e);
+
+/* Push an error into a device's ring. Device struct MUST expose: BM_ErrorRing errors; */
 #define BM_PUSH_ERROR(devPtr, src, errCode, detailByte, regAddr, val) \
-    do { \
-        if ((devPtr)) { \
-            uint8_t idx = (devPtr)->errorHead % BM_ERROR_LOG_DEPTH; \
-            (devPtr)->errorLog[idx].tick = BM_GET_TICK(); \
-            (devPtr)->errorLog[idx].code = (int8_t)(errCode); \
-            (devPtr)->errorLog[idx].detail = (uint8_t)(detailByte); \
-            (devPtr)->errorLog[idx].source = (uint8_t)(src); \
-            (devPtr)->errorLog[idx].reg = (uint8_t)(regAddr); \
-            (devPtr)->errorLog[idx].value = (uint16_t)(val); \
-            (devPtr)->errorHead = (uint8_t)((devPtr)->errorHead + 1); \
-            (devPtr)->lastError = (int8_t)(errCode); \
-        } \
-    } while(0)
+    BM_ErrorPush((devPtr) ? &(devPtr)->errors : (BM_ErrorRing *)0, (uint8_t)(src), (int8_t)(errCode), \
+                 (uint8_t)(detailByte), (uint8_t)(regAddr), (uint16_t)(val))
 
 /* Abstract tick accessor so we can fall back if HAL not present */
 #ifndef BM_GET_TICK
@@ -0,0 +1,124 @@
+/*
+ * boot.h
+ *
+ *  Boot sequencer: brings the I2C devices up through the bus queue
+ *  (i2c_bus.h) instead of one blocking init after the other, and times the
+ *  boot phases.
+ *
+ *  Each device is described by a Boot_DeviceDesc: an identity register, an
+ *  optional configuration readback window with the register image it should
+ *  hold, and the write script that establishes it. Boot_Start queues the
+ *  identity read and the readback of every device at once; Boot_Service,
+ *  called between I2CBus_Service passes, then moves each device on by
+ *  itself:
+ *
+ *    PROBE  -> identity wrong / no answer         -> FAILED
+ *           -> readback hash equals image hash    -> READY (script skipped)
+ *           -> otherwise                          -> CONFIG
+ *    CONFIG -> script written (BOOT_WRITE_WINDOW
+ *              entries queued at a time)          -> READY or FAILED
+ *
+ *  Devices interleave on the bus in priority order, so a slow or absent
+ *  device does not hold up the others, and a device whose registers still
+ *  hold the configuration (MCU reset, device kept powered) costs one burst
+ *  read instead of the full script.
+ *
+ *  Times are microseconds since reset: HAL ticks up to Boot_Begin, TIM2
+ *  (Latency_NowUs) from there.
+ */
+
+#ifndef INC_BOOT_H_
+#define INC_BOOT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(USE_HAL_STUBS)
+#include "hal_stubs.h"
+#else
+#include "stm32g0xx_hal.h"
+#endif
+#include "bq_regdesc.h"
+#include "i2c_bus.h"
+#include <stdint.h>
+
+#ifndef BOOT_MAX_DEVICES
+#define BOOT_MAX_DEVICES   4
+#endif
+#ifndef BOOT_MAX_CFG_LEN
+#define BOOT_MAX_CFG_LEN   I2C_BUS_MAX_BURST   /* readback window, one merged burst */
+#endif
+#ifndef BOOT_WRITE_WINDOW
+#define BOOT_WRITE_WINDOW  4                   /* script writes queued per device */
+#endif
+
+typedef enum {
+    BOOT_PHASE_START = 0,     /* Boot_Begin: clocks and peripherals up */
+    BOOT_PHASE_DEVICES,       /* every device READY or FAILED */
+    BOOT_PHASE_PROTECTED,     /* first measurement with the protections configured */
+    BOOT_PHASE_RUNNING,       /* scheduler started */
+    BOOT_PHASE_COUNT
+} Boot_Phase;
+
+typedef enum {
+    BOOT_DEV_IDLE = 0,
+    BOOT_DEV_PROBE,           /* identity + readback queued */
+    BOOT_DEV_CONFIG,          /* script being written */
+    BOOT_DEV_READY,
+    BOOT_DEV_FAILED
+} Boot_DevState;
+
+typedef struct {
+    const char        *name;
+    uint16_t           devAddress;
+    uint8_t            source;      /* BM_ErrorSource for bus failures */
+    uint8_t            prio;        /* I2CBus_Priority of all its transfers */
+    uint8_t            idReg;
+    uint8_t          (*idValid)(uint8_t raw);   /* NULL = any answer will do */
+    uint8_t            cfgReg;
+    uint8_t            cfgLen;      /* readback window; 0 = always run the script */
+    const uint8_t     *cfgImage;    /* cfgLen bytes the window should hold */
+    const BQ_RegWrite *script;
+    uint8_t            scriptLen;
+} Boot_DeviceDesc;
+
+typedef struct {
+    const Boot_DeviceDesc *desc;
+    uint8_t  state;           /* Boot_DevState */
+    uint8_t  queued;          /* probe reads submitted */
+    uint8_t  next;            /* next script entry to queue */
+    uint8_t  inFlight;        /* queued, not yet completed */
+    uint8_t  errors;          /* failed transfers */
+    uint8_t  idRaw;
+    uint8_t  configSkipped;   /* readback matched: script not run */
+    uint32_t cfgHash;         /* hash of the readback (0 without a window) */
+    uint32_t probed_us;       /* boot time the probe completed */
+    uint32_t ready_us;        /* boot time it went READY / FAILED */
+    uint8_t  readback[BOOT_MAX_CFG_LEN];
+} Boot_Device;
+
+/* Take the time reference (HAL tick = ms since reset) and mark BOOT_PHASE_START.
+ * Needs Latency_Init first. */
+void     Boot_Begin(void);
+uint32_t Boot_NowUs(void);
+void     Boot_Mark(Boot_Phase phase);
+uint32_t Boot_PhaseUs(Boot_Phase phase);          /* 0 = not reached */
+
+/* Start bringing up count devices (state lives in devs until they finish) */
+void    Boot_Start(Boot_Device *devs, uint8_t count);
+/* Queue what the devices can take next; returns how many are still in
+ * progress. Marks BOOT_PHASE_DEVICES when that reaches 0. */
+uint8_t Boot_Service(void);
+
+/* FNV-1a, used for the configuration comparison */
+uint32_t Boot_Hash(const uint8_t *data, uint32_t len);
+
+/* "[BOOT]" lines: phases and per-device probe / ready times */
+void Boot_LogTimings(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_BOOT_H_ */
@@ -106,73 +106,10 @@ typedef enum {
 } BQ25798_Result;
 
 // Structs
-#include <stdint.h>
-
-// REG1B_Charger_Status_0 Register (Offset = 1Bh)
-typedef struct {
-    uint8_t iindpm_stat;       // Bit 7: IINDPM status
-    uint8_t vindpm_stat;       // Bit 6: VINDPM status
-    uint8_t wd_stat;           // Bit 5: Watchdog timer status
-    uint8_t pg_stat;           // Bit 3: Power Good Status
-    uint8_t ac2_present_stat;  // Bit 2: VAC2 present status
-    uint8_t ac1_present_stat;  // Bit 1: VAC1 present status
-    uint8_t vbus_present_stat; // Bit 0: VBUS present status
-} BQ25798_ChargerStatus0;
-#include <stdint.h>
-
-// REG1C_Charger_Status_1 Register (Offset = 1Ch)
-typedef struct {
-    uint8_t chg_stat;         // Bits 7-5: Charge Status
-    uint8_t vbus_stat;        // Bits 4-1: VBUS Status
-    uint8_t bc12_done_stat;   // Bit 0: BC1.2 status
-} BQ25798_ChargerStatus1;
-// REG1D_Charger_Status_2 Register
-typedef struct {
-    uint8_t ico_stat;          // Bits 7-6
-    uint8_t treg_stat;         // Bit 2
-    uint8_t dpdm_stat;         // Bit 1
-    uint8_t vbat_present_stat; // Bit 0
-} BQ25798_ChargerStatus2;
-
-// REG1E_Charger_Status_3 Register
-typedef struct {
-    uint8_t acrb2_stat;      // Bit 7
-    uint8_t acrb1_stat;      // Bit 6
-    uint8_t adc_done_stat;   // Bit 5
-    uint8_t vsys_stat;       // Bit 4
-    uint8_t chg_tmr_stat;    // Bit 3
-    uint8_t trichg_tmr_stat; // Bit 2
-    uint8_t prechg_tmr_stat; // Bit 1
-} BQ25798_ChargerStatus3;
-
-// REG1F_Charger_Status_4 Register
-typedef struct {
-    uint8_t vbatotg_low_stat; // Bit 4
-    uint8_t ts_cold_stat;     // Bit 3
-    uint8_t ts_cool_stat;     // Bit 2
-    uint8_t ts_warm_stat;     // Bit 1
-    uint8_t ts_hot_stat;      // Bit 0
-} BQ25798_ChargerStatus4;
-// REG20_FAULT_Status_0 Register
-typedef struct {
-    uint8_t ibat_reg_stat;  // Bit 7
-    uint8_t vbus_ovp_stat;  // Bit 6
-    uint8_t vbat_ovp_stat;  // Bit 5
-    uint8_t ibus_ocp_stat;  // Bit 4
-    uint8_t ibat_ocp_stat;  // Bit 3
-    uint8_t conv_ocp_stat;  // Bit 2
-    uint8_t vac2_ovp_stat;  // Bit 1
-    uint8_t vac1_ovp_stat;  // Bit 0
-} BQ25798_FaultStatus0;
-
-// REG21_FAULT_Status_1 Register
-typedef struct {
-    uint8_t vsys_short_stat; // Bit 7
-    uint8_t vsys_ovp_stat;   // Bit 6
-    uint8_t otg_ovp_stat;    // Bit 5
-    uint8_t otg_uvp_stat;    // Bit 4
-    uint8_t tshut_stat;      // Bit 2
-} BQ25798_FaultStatus1;
+/* BQ25798_ChargerStatus0..4 / BQ25798_FaultStatus0..1: one uint8_t per field,
+ * generated from the register map (bit positions documented there). */
+#include "bq25798_regmap.h"
+BQ25798_FIELD_REGS(BQ25798_GEN_FIELD_STRUCT)
 
 typedef struct{
 	I2C_HandleTypeDef *i2cHandle;
@@ -190,34 +127,72 @@ typedef struct{
 	BQ25798_FaultStatus1 faultStatus1;
 
     /* Error handling */
-    BM_ErrorEntry errorLog[BM_ERROR_LOG_DEPTH];
-    uint8_t errorHead;    /* next write index */
-    int8_t  lastError;    /* last BM_Result (negative on error) */
+    BM_ErrorRing errors;  /* recent errors + last BM_Result (BM_PUSH_ERROR) */
 } BQ25798;
 
 // INITIALISATION
 uint8_t BQ25798_init(BQ25798 *device, I2C_HandleTypeDef *i2cHandle);
+/* Charge / input regulation set points written at init (one charge profile) */
+typedef struct {
+	uint16_t chargeVoltage_mV;   /* VREG */
+	uint16_t chargeCurrent_mA;   /* ICHG */
+	uint16_t inputVoltage_mV;    /* VINDPM */
+	uint16_t inputCurrent_mA;    /* IINDPM */
+} BQ25798_ChargeLimits;
+/* 4S pack: 14.6 V / 5 A, input 3.6 V / 3.3 A (the values BQ25798_init uses) */
+#define BQ25798_DEFAULT_LIMITS { 14600, 5000, 3600, 3300 }
+/* Set point ranges (datasheet); initScript and the setters clamp to them so
+ * a bad profile cannot carry into reserved bits or wrap the 8-bit VINDPM */
+#define BQ25798_VREG_MIN_mV    3000u
+#define BQ25798_VREG_MAX_mV    18800u
+#define BQ25798_ICHG_MIN_mA    50u
+#define BQ25798_ICHG_MAX_mA    5000u
+#define BQ25798_VINDPM_MIN_mV  3600u
+#define BQ25798_VINDPM_MAX_mV  22000u
+#define BQ25798_IINDPM_MIN_mA  100u
+#define BQ25798_IINDPM_MAX_mA  3300u
+/* Copy of in with every set point clamped to the ranges above */
+void BQ25798_clampLimits(const BQ25798_ChargeLimits *in, BQ25798_ChargeLimits *out);
+/* The configuration writes of BQ25798_init as a script (BQ25798_INIT_SCRIPT_LEN
+ * entries, in order) for the given limits (NULL = BQ25798_DEFAULT_LIMITS);
+ * returns the count */
+#define BQ25798_INIT_SCRIPT_LEN 10
+uint8_t BQ25798_initScript(const BQ25798_ChargeLimits *limits, BQ_RegWrite *out);
 
 // DATA ACQUISATION
 #ifndef BQ25798_NO_HAL
-HAL_StatusTypeDef BQ25798_readBusVoltage(BQ25798 *device);
-HAL_StatusTypeDef BQ25798_readBusCurrent(BQ25798 *device);
-HAL_StatusTypeDef BQ25798_readBatteryVoltage(BQ25798 *device);
-HAL_StatusTypeDef BQ25798_readBatteryCurrent(BQ25798 *device);
+/* Blocking read of len (1..8) registers from reg, decoded through the register
+ * map. raw (optional) receives the bytes as read. */
+HAL_StatusTypeDef BQ25798_readDecoded(BQ25798 *device, uint8_t reg, uint8_t len, uint8_t *raw);
+#define BQ25798_readBusVoltage(device)     BQ25798_readDecoded((device), BQ25798_REG_VBUS_ADC, 2, NULL)
+#define BQ25798_readBusCurrent(device)     BQ25798_readDecoded((device), BQ25798_REG_IBUS_ADC, 2, NULL)
+#define BQ25798_readBatteryVoltage(device) BQ25798_readDecoded((device), BQ25798_REG_VBAT_ADC, 2, NULL)
+#define BQ25798_readBatteryCurrent(device) BQ25798_readDecoded((device), BQ25798_REG_IBAT_ADC, 2, NULL)
+/* Queue status/fault/ADC reads on the shared I2C bus (i2c_bus.h); the device
+ * struct is updated when I2CBus_Service() runs them. */
+HAL_StatusTypeDef BQ25798_queueStatusRefresh(BQ25798 *device, uint32_t deadline_ms);
 #endif
+/* Decode consecutive raw registers (as read from firstReg) into device */
+void BQ25798_decodeRegisters(BQ25798 *device, uint8_t firstReg, const uint8_t *data, uint8_t len);
+/* Re-pack a bit-field register from the decoded struct (0 for unknown registers) */
+uint8_t BQ25798_encodeRegister(const BQ25798 *device, uint8_t reg);
+/* Register descriptor table generated from bq25798_regmap.h */
+extern const BQ_RegDesc BQ25798_regDesc[];
+extern const uint8_t    BQ25798_regDescCount;
 
 
 // LOW LEVEL FUNCTIONS
 HAL_StatusTypeDef BQ25798_ReadRegisters(BQ25798 *device, uint8_t reg, uint8_t *data, uint8_t length);
 HAL_StatusTypeDef BQ25798_ReadRegister (BQ25798 *device, uint8_t reg, uint8_t *data);
 HAL_StatusTypeDef BQ25798_WriteRegister(BQ25798 *device, uint8_t reg, uint8_t *data);
-HAL_StatusTypeDef readChargerStatus0(BQ25798 *device, uint8_t *status);
-HAL_StatusTypeDef readChargerStatus1(BQ25798 *device, uint8_t *status);
-HAL_StatusTypeDef readChargerStatus2(BQ25798 *device, uint8_t *status);
-HAL_StatusTypeDef readChargerStatus3(BQ25798 *device, uint8_t *status);
-HAL_StatusTypeDef readChargerStatus4(BQ25798 *device, uint8_t *status);
-HAL_StatusTypeDef readFaultStatus0(BQ25798 *device, uint8_t *status);
-HAL_StatusTypeDef readFaultStatus1(BQ25798 *device, uint8_t *status);
+/* Read and decode one status register; *status gets the raw byte */
+#define readChargerStatus0(device, status) BQ25798_readDecoded((device), BQ25798_REG_CHARGER_STATUS_0, 1, (status))
+#define readChargerStatus1(device, status) BQ25798_readDecoded((device), BQ25798_REG_CHARGER_STATUS_1, 1, (status))
+#define readChargerStatus2(device, status) BQ25798_readDecoded((device), BQ25798_REG_CHARGER_STATUS_2, 1, (status))
+#define readChargerStatus3(device, status) BQ25798_readDecoded((device), BQ25798_REG_CHARGER_STATUS_3, 1, (status))
+#define readChargerStatus4(device, status) BQ25798_readDecoded((device), BQ25798_REG_CHARGER_STATUS_4, 1, (status))
+#define readFaultStatus0(device, status)   BQ25798_readDecoded((device), BQ25798_REG_FAULT_STATUS_0, 1, (status))
+#define readFaultStatus1(device, status)   BQ25798_readDecoded((device), BQ25798_REG_FAULT_STATUS_1, 1, (status))
 
 /* Part confirmation & helpers */
 /* NOTE: Datasheet review indicates PART_INFO may allocate 5 bits (bits 7:3) for part number, not 3.
@@ -240,6 +215,8 @@ typedef struct {
 #define BQ25798_EXPECTED_REVISION     BQ25798_DEV_REV_VAL /* reuse existing until verified */
 
 void BQ25798_decodePartInfo(uint8_t raw, BQ25798_PartInfo *out);
+/* 1 if a raw PART_INFO value identifies the part (the check behind confirmPart) */
+uint8_t BQ25798_partInfoValid(uint8_t raw);
 
 /* New confirmation API: returns BQ25798_Result and fills BQ25798_PartInfo (optional) */
 BQ25798_Result BQ25798_confirmPart(BQ25798 *device, BQ25798_PartInfo *infoOut);
@@ -267,6 +244,9 @@ HAL_StatusTypeDef BQ25798_Read16 (BQ25798 *device, uint8_t msbReg, uint16_t *val
  *  REG08 (Precharge Control current portion): codes 0x03,0x04,0x05 => 120,160,200mA => 40mA * code.
  */
 
+/* C only: C++ code uses the constexpr Field<> types in bq25798_regs.hpp
+ * (bq25798::ChargeVoltage::encode etc.), which add range checks and units. */
+#ifndef __cplusplus
 /* Charge voltage: 10 mV per LSB */
 static inline uint16_t BQ25798_encodeChargeVoltage_mV(uint16_t mV){ return (uint16_t)(mV / 10u); }
 static inline uint16_t BQ25798_decodeChargeVoltage_raw(uint16_t raw){ return (uint16_t)(raw * 10u); }
@@ -286,6 +266,7 @@ static inline uint16_t BQ25798_decodeInputVoltageLimit_raw(uint8_t raw){ return
 /* Precharge current: I_pre (mA) = code * 40mA (based on samples) */
 static inline uint8_t  BQ25798_encodePrechargeCurrent_mA(uint16_t mA){ return (uint8_t)(mA / 40u); }
 static inline uint16_t BQ25798_decodePrechargeCurrent_raw(uint8_t code){ return (uint16_t)(code * 40u); }
+#endif /* !__cplusplus */
 
 /* High-level control / profile API */
 HAL_StatusTypeDef BQ25798_setChargeVoltage(BQ25798 *dev, uint16_t mV);
@@ -298,6 +279,13 @@ HAL_StatusTypeDef BQ25798_readDieTemperature(BQ25798 *dev, int16_t *tempC_x10);
 
 /* Optional scaling self-test (pure arithmetic, no I2C). Implemented in bq25798_scale_test.c */
 void BQ25798_runScalingSelfTest(void);
+/* Exhaustive sweep of every encode/decode pair (and the BQ76907 scalers):
+ * round trip over the register field, monotonicity, max quantisation error.
+ * Returns the number of failing helpers; verbose prints one line each. */
+uint32_t BQ25798_verifyScaling(uint8_t verbose);
+/* Boundary subset of the sweep (field ends, clamped set point range, scaler
+ * ends): a few dozen helper calls, for the target at boot. Same return. */
+uint32_t BQ25798_checkScalingRanges(uint8_t verbose);
 /* Runtime assertion / validation report (includes PART_INFO read if device provided) */
 void BQ25798_runAssertionReport(BQ25798 *dev);
 
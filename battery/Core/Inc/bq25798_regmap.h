@@ -0,0 +1,104 @@
+/*
+ * bq25798_regmap.h
+ *
+ *  BQ25798 register descriptions, written once and expanded by bq25798.h
+ *  (decoded structs) and bq25798.c (compile-time checks, descriptor table).
+ *  See bq_regdesc.h for the scheme. Addresses come from the BQ25798_REG_*
+ *  defines in bq25798.h.
+ *
+ *  Bit-field registers: X(ID, access, member, Type)
+ *    ID      suffix of BQ25798_REG_<ID> and of BQ25798_<ID>_FIELDS
+ *    member  BQ25798 struct member holding the decoded fields
+ *    Type    generated struct type name
+ *  Fields:  F(arg, name, msb, lsb)
+ *
+ *  Value registers (16-bit, MSB first): V(ID, access, member, unit, flags, scale)
+ *    scale   BQ_ScaleFn applied to the raw value, NULL = raw
+ */
+
+#ifndef INC_BQ25798_REGMAP_H_
+#define INC_BQ25798_REGMAP_H_
+
+#include "bq_regdesc.h"
+
+#define BQ25798_FIELD_REGS(X) \
+    X(CHARGER_STATUS_0, BQ_ACCESS_RO, chargerStatus0, BQ25798_ChargerStatus0) \
+    X(CHARGER_STATUS_1, BQ_ACCESS_RO, chargerStatus1, BQ25798_ChargerStatus1) \
+    X(CHARGER_STATUS_2, BQ_ACCESS_RO, chargerStatus2, BQ25798_ChargerStatus2) \
+    X(CHARGER_STATUS_3, BQ_ACCESS_RO, chargerStatus3, BQ25798_ChargerStatus3) \
+    X(CHARGER_STATUS_4, BQ_ACCESS_RO, chargerStatus4, BQ25798_ChargerStatus4) \
+    X(FAULT_STATUS_0,   BQ_ACCESS_RO, faultStatus0,   BQ25798_FaultStatus0)   \
+    X(FAULT_STATUS_1,   BQ_ACCESS_RO, faultStatus1,   BQ25798_FaultStatus1)
+
+/* REG1B_Charger_Status_0 */
+#define BQ25798_CHARGER_STATUS_0_FIELDS(F, a) \
+    F(a, iindpm_stat,       7, 7)  /* IINDPM status */          \
+    F(a, vindpm_stat,       6, 6)  /* VINDPM status */          \
+    F(a, wd_stat,           5, 5)  /* Watchdog timer status */  \
+    F(a, pg_stat,           3, 3)  /* Power Good status */      \
+    F(a, ac2_present_stat,  2, 2)  /* VAC2 present */           \
+    F(a, ac1_present_stat,  1, 1)  /* VAC1 present */           \
+    F(a, vbus_present_stat, 0, 0)  /* VBUS present */
+
+/* REG1C_Charger_Status_1 */
+#define BQ25798_CHARGER_STATUS_1_FIELDS(F, a) \
+    F(a, chg_stat,          7, 5)  /* Charge status */          \
+    F(a, vbus_stat,         4, 1)  /* VBUS status */            \
+    F(a, bc12_done_stat,    0, 0)  /* BC1.2 detection done */
+
+/* REG1D_Charger_Status_2 */
+#define BQ25798_CHARGER_STATUS_2_FIELDS(F, a) \
+    F(a, ico_stat,          7, 6) \
+    F(a, treg_stat,         2, 2) \
+    F(a, dpdm_stat,         1, 1) \
+    F(a, vbat_present_stat, 0, 0)
+
+/* REG1E_Charger_Status_3 */
+#define BQ25798_CHARGER_STATUS_3_FIELDS(F, a) \
+    F(a, acrb2_stat,        7, 7) \
+    F(a, acrb1_stat,        6, 6) \
+    F(a, adc_done_stat,     5, 5) \
+    F(a, vsys_stat,         4, 4) \
+    F(a, chg_tmr_stat,      3, 3) \
+    F(a, trichg_tmr_stat,   2, 2) \
+    F(a, prechg_tmr_stat,   1, 1)
+
+/* REG1F_Charger_Status_4 */
+#define BQ25798_CHARGER_STATUS_4_FIELDS(F, a) \
+    F(a, vbatotg_low_stat,  4, 4) \
+    F(a, ts_cold_stat,      3, 3) \
+    F(a, ts_cool_stat,      2, 2) \
+    F(a, ts_warm_stat,      1, 1) \
+    F(a, ts_hot_stat,       0, 0)
+
+/* REG20_FAULT_Status_0 */
+#define BQ25798_FAULT_STATUS_0_FIELDS(F, a) \
+    F(a, ibat_reg_stat,     7, 7) \
+    F(a, vbus_ovp_stat,     6, 6) \
+    F(a, vbat_ovp_stat,     5, 5) \
+    F(a, ibus_ocp_stat,     4, 4) \
+    F(a, ibat_ocp_stat,     3, 3) \
+    F(a, conv_ocp_stat,     2, 2) \
+    F(a, vac2_ovp_stat,     1, 1) \
+    F(a, vac1_ovp_stat,     0, 0)
+
+/* REG21_FAULT_Status_1 */
+#define BQ25798_FAULT_STATUS_1_FIELDS(F, a) \
+    F(a, vsys_short_stat,   7, 7) \
+    F(a, vsys_ovp_stat,     6, 6) \
+    F(a, otg_ovp_stat,      5, 5) \
+    F(a, otg_uvp_stat,      4, 4) \
+    F(a, tshut_stat,        2, 2)
+
+/* ADC results, 1 mV / 1 mA per bit */
+#define BQ25798_VALUE_REGS(V) \
+    V(IBUS_ADC, BQ_ACCESS_RO, currentBus,     "mA", 0, NULL) \
+    V(IBAT_ADC, BQ_ACCESS_RO, currentBattery, "mA", 0, NULL) \
+    V(VBUS_ADC, BQ_ACCESS_RO, voltageBus,     "mV", 0, NULL) \
+    V(VBAT_ADC, BQ_ACCESS_RO, voltageBattery, "mV", 0, NULL)
+
+/* Generates the decoded struct for one bit-field register */
+#define BQ25798_GEN_FIELD_STRUCT(ID, access, member, Type) \
+    typedef struct { BQ25798_##ID##_FIELDS(BQ_FIELD_MEMBER, _) } Type;
+
+#endif /* INC_BQ25798_REGMAP_H_ */
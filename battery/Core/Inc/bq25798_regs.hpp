@@ -0,0 +1,117 @@
+/*
+ * bq25798_regs.hpp
+ *
+ *  BQ25798 register map as bq_regfield.hpp types, plus thin typed accessors
+ *  over the C driver. Status / fault fields are expanded from the same
+ *  X-macro lists as the C descriptor tables (bq25798_regmap.h), so the two
+ *  cannot drift apart.
+ *
+ *  Scaling follows the helpers in bq25798.h (10 mV / 10 mA / 100 mV / 40 mA
+ *  per LSB); in C++ code use these fields instead of BQ25798_encode* /
+ *  BQ25798_decode*:
+ *
+ *    BQ25798_writeField<bq25798::ChargeCurrent>(&charger, bq::Milliamps(4000));
+ */
+
+#ifndef INC_BQ25798_REGS_HPP_
+#define INC_BQ25798_REGS_HPP_
+
+#include "bq25798.h"
+#include "bq_regfield.hpp"
+
+namespace bq25798 {
+
+using bq::Register;
+using bq::Field;
+using bq::Layout;
+
+/* ---- Limits / setpoints ---- */
+using ChargeVoltageLimit = Register<BQ25798_REG_CHARGE_VOLTAGE_LIMIT, 2>;
+using ChargeVoltage      = Field<ChargeVoltageLimit, 10, 0, bq::mV<10>>;     /* VREG */
+
+using ChargeCurrentLimit = Register<BQ25798_REG_CHARGE_CURRENT_LIMIT, 2>;
+using ChargeCurrent      = Field<ChargeCurrentLimit, 8, 0, bq::mA<10>>;      /* ICHG */
+
+using InputVoltageLimit  = Register<BQ25798_REG_INPUT_VOLTAGE_LIMIT>;
+using InputVoltage       = Field<InputVoltageLimit, 7, 0, bq::mV<100>>;     /* VINDPM */
+
+using InputCurrentLimit  = Register<BQ25798_REG_INPUT_CURRENT_LIMIT, 2>;
+using InputCurrent       = Field<InputCurrentLimit, 8, 0, bq::mA<10>>;      /* IINDPM */
+
+using PrechargeCtrl      = Register<BQ25798_REG_PRECHARGE_CTRL>;
+using VbatLowV           = Field<PrechargeCtrl, 7, 6>;
+using PrechargeCurrent   = Field<PrechargeCtrl, 5, 0, bq::mA<40>>;          /* IPRECHG */
+static_assert(Layout<PrechargeCtrl, VbatLowV, PrechargeCurrent>::ok, "PRECHARGE_CTRL");
+
+/* Placeholder bit positions, as BQ25798_CHG_CTRL0_* in bq25798.h */
+using ChargerCtrl0       = Register<BQ25798_REG_CHARGER_CTRL_0>;
+using ChargeEnable       = Field<ChargerCtrl0, 7, 7>;
+using HizEnable          = Field<ChargerCtrl0, 6, 6>;
+static_assert(Layout<ChargerCtrl0, ChargeEnable, HizEnable>::ok, "CHARGER_CTRL_0");
+
+/* ---- Status / fault (from bq25798_regmap.h) ----
+ * bq25798::CHARGER_STATUS_1::chg_stat etc.; ::layout checks the field list. */
+#define BQ25798_CPP_FIELD_REG(ID, access, member, Type)                      \
+    namespace ID {                                                          \
+        using reg = Register<BQ25798_REG_##ID>;                             \
+        BQ25798_##ID##_FIELDS(BQ_CPP_FIELD, reg)                            \
+        using layout = Layout<reg, BQ25798_##ID##_FIELDS(BQ_CPP_FIELD_ARG, reg) BQ_CPP_END(reg)>; \
+        static_assert(layout::ok, #ID);                                     \
+    }
+BQ25798_FIELD_REGS(BQ25798_CPP_FIELD_REG)
+#undef BQ25798_CPP_FIELD_REG
+
+/* ---- ADC results (1 mV / 1 mA per LSB) ---- */
+using IbusAdc = Field<Register<BQ25798_REG_IBUS_ADC, 2>, 15, 0, bq::mA<1>>;
+using IbatAdc = Field<Register<BQ25798_REG_IBAT_ADC, 2>, 15, 0, bq::mA<1>>;
+using VbusAdc = Field<Register<BQ25798_REG_VBUS_ADC, 2>, 15, 0, bq::mV<1>>;
+using VbatAdc = Field<Register<BQ25798_REG_VBAT_ADC, 2>, 15, 0, bq::mV<1>>;
+
+/* Same sample points as the C compile-time checks in bq25798.h */
+static_assert(ChargeVoltage::encodeConst<14600>() == 1460, "VREG 10 mV/LSB");
+static_assert(ChargeVoltage::decode(1460) == bq::Millivolts(14600), "VREG decode");
+static_assert(ChargeCurrent::encodeConst<4000>() == 400, "ICHG 10 mA/LSB");
+static_assert(ChargeCurrent::encodeConst<5000>() == 500, "ICHG 5 A");
+static_assert(InputVoltage::encodeConst<3600>() == 36, "VINDPM 100 mV/LSB");
+static_assert(InputCurrent::encodeConst<3300>() == 330, "IINDPM 10 mA/LSB");
+static_assert(PrechargeCurrent::encodeConst<120>() == 3, "IPRECHG 40 mA/LSB");
+static_assert(PrechargeCurrent::decode(3) == bq::Milliamps(120), "IPRECHG decode");
+
+} /* namespace bq25798 */
+
+#ifndef BQ25798_NO_HAL
+/* ---- Typed access over the C driver (blocking, MSB first for 16-bit) ---- */
+template <class R>
+inline HAL_StatusTypeDef BQ25798_readReg(BQ25798 *dev, typename R::raw_type &out) {
+    uint8_t b[R::width];
+    HAL_StatusTypeDef st = BQ25798_ReadRegisters(dev, R::addr, b, R::width);
+    if (st == HAL_OK) out = R::fromBytes(b);
+    return st;
+}
+
+template <class R>
+inline HAL_StatusTypeDef BQ25798_writeReg(BQ25798 *dev, typename R::raw_type v) {
+    if (R::width == 2) return BQ25798_Write16(dev, R::addr, v);
+    uint8_t b = static_cast<uint8_t>(v);
+    return BQ25798_WriteRegister(dev, R::addr, &b);
+}
+
+template <class F>
+inline HAL_StatusTypeDef BQ25798_readField(BQ25798 *dev, typename F::value_type &out) {
+    typename F::raw_type v;
+    HAL_StatusTypeDef st = BQ25798_readReg<typename F::reg>(dev, v);
+    if (st == HAL_OK) out = F::decode(v);
+    return st;
+}
+
+/* Read-modify-write: bits outside the field are preserved */
+template <class F>
+inline HAL_StatusTypeDef BQ25798_writeField(BQ25798 *dev, typename F::value_type value) {
+    typename F::raw_type v;
+    HAL_StatusTypeDef st = BQ25798_readReg<typename F::reg>(dev, v);
+    if (st != HAL_OK) return st;
+    return BQ25798_writeReg<typename F::reg>(dev, F::update(v, value));
+}
+#endif /* BQ25798_NO_HAL */
+
+#endif /* INC_BQ25798_REGS_HPP_ */
@@ -53,7 +53,10 @@ extern "C" {
 #define BQ76907_REG_ADC_CONTROL               0x0D  /* TODO_VERIFY */
 #define BQ76907_REG_VCELL1_H                  0x0E  /* TODO_VERIFY */
 #define BQ76907_REG_VCELL1_L                  0x0F  /* TODO_VERIFY */
-/* ... Continue sequential VCELLx registers when validated ... */
+/* VCELLx assumed sequential (one 8-byte burst), verify with the datasheet */
+#define BQ76907_REG_VCELL2_H                  (BQ76907_REG_VCELL1_H + 2)  /* TODO_VERIFY */
+#define BQ76907_REG_VCELL3_H                  (BQ76907_REG_VCELL1_H + 4)  /* TODO_VERIFY */
+#define BQ76907_REG_VCELL4_H                  (BQ76907_REG_VCELL1_H + 6)  /* TODO_VERIFY */
 #define BQ76907_REG_PACK_V_H                  0x2A  /* TODO_VERIFY */
 #define BQ76907_REG_PACK_V_L                  0x2B  /* TODO_VERIFY */
 #define BQ76907_REG_TS1_H                     0x2C  /* TODO_VERIFY */
@@ -97,6 +100,22 @@ extern "C" {
 #define BQ76907_POWER_CONFIG_SLEEP_EN         (1u<<2) /* TODO_VERIFY */
 #define BQ76907_POWER_CONFIG_SLEEP_DIS        (1u<<3) /* TODO_VERIFY */
 
+/* Enabled Protections A bits (layout follows the bq769x2 family) */
+#define BQ76907_PROT_A_CUV                    (1u<<2) /* TODO_VERIFY */
+#define BQ76907_PROT_A_COV                    (1u<<3) /* TODO_VERIFY */
+#define BQ76907_PROT_A_OCC                    (1u<<4) /* TODO_VERIFY */
+#define BQ76907_PROT_A_OCD1                   (1u<<5) /* TODO_VERIFY */
+#define BQ76907_PROT_A_OCD2                   (1u<<6) /* TODO_VERIFY */
+#define BQ76907_PROT_A_SCD                    (1u<<7) /* TODO_VERIFY */
+
+/* Protection thresholds are one byte each: cell voltages at 20 mV, currents
+ * at 50 mA per LSB (TODO_VERIFY), so 5100 mV / 12750 mA is the most a
+ * register holds. Values between steps round down. */
+#define BQ76907_CELL_THRESH_LSB_mV            20u
+#define BQ76907_CURR_THRESH_LSB_mA            50u
+#define BQ76907_CELL_THRESH_MAX_mV            (0xFFu * BQ76907_CELL_THRESH_LSB_mV)
+#define BQ76907_CURR_THRESH_MAX_mA            (0xFFu * BQ76907_CURR_THRESH_LSB_mA)
+
 /* Structure capturing valued configuration registers */
 typedef struct {
     uint8_t  cellCount;          /* Number of series cells (used for VCELL_MODE) */
@@ -133,15 +152,10 @@ typedef struct {
 #define BQ76907_SYS_STAT_RESERVED             (1u << 0)  /* TODO_VERIFY */
 
 /* Data Structures */
-typedef struct {
-    uint8_t cc_ready;
-    uint8_t dev_ready;
-    uint8_t ov_fault;
-    uint8_t uv_fault;
-    uint8_t scd_fault;
-    uint8_t ocd_fault;
-    uint8_t ot_fault;
-} BQ76907_SystemStatus;
+/* BQ76907_SystemStatus: one uint8_t per SYS_STAT flag, generated from the
+ * register map (cc_ready, dev_ready, ov/uv/scd/ocd/ot_fault). */
+#include "bq76907_regmap.h"
+BQ76907_FIELD_REGS(BQ76907_GEN_FIELD_STRUCT)
 
 /* Main driver object */
 typedef struct {
@@ -153,9 +167,7 @@ typedef struct {
     BQ76907_Config       activeConfig; /* Snapshot of last applied configuration */
 
     /* Error handling */
-    BM_ErrorEntry errorLog[BM_ERROR_LOG_DEPTH];
-    uint8_t errorHead;
-    int8_t  lastError;
+    BM_ErrorRing errors;
 } BQ76907;
 
 /* ================= API PROTOTYPES ================= */
@@ -165,11 +177,21 @@ uint8_t BQ76907_init(BQ76907 *dev, I2C_HandleTypeDef *hi2c);
 
 // Data acquisition
 #ifndef BQ76907_NO_HAL
-HAL_StatusTypeDef BQ76907_readSystemStatus(BQ76907 *dev);
-HAL_StatusTypeDef BQ76907_readCellVoltages(BQ76907 *dev);
-HAL_StatusTypeDef BQ76907_readPackVoltage(BQ76907 *dev);
-HAL_StatusTypeDef BQ76907_readTemperature1(BQ76907 *dev);
+/* Blocking read of len (1..8) registers from reg, decoded through the register map */
+HAL_StatusTypeDef BQ76907_readDecoded(BQ76907 *dev, uint8_t reg, uint8_t len);
+#define BQ76907_readSystemStatus(dev) BQ76907_readDecoded((dev), BQ76907_REG_SYS_STAT, 1)
+#define BQ76907_readCellVoltages(dev) BQ76907_readDecoded((dev), BQ76907_REG_VCELL1_H, 8) /* 4 cells, one burst */
+#define BQ76907_readPackVoltage(dev)  BQ76907_readDecoded((dev), BQ76907_REG_PACK_V_H, 2)
+#define BQ76907_readTemperature1(dev) BQ76907_readDecoded((dev), BQ76907_REG_TS1_H, 2)
+/* Queue SYS_STAT/cells/pack/TS1 reads on the shared I2C bus (i2c_bus.h);
+ * the device struct is updated when I2CBus_Service() runs them. */
+HAL_StatusTypeDef BQ76907_queueStatusRefresh(BQ76907 *dev, uint32_t deadline_ms);
 #endif
+/* Decode consecutive raw registers (as read from firstReg) into dev */
+void BQ76907_decodeRegisters(BQ76907 *dev, uint8_t firstReg, const uint8_t *data, uint8_t len);
+/* Register descriptor table generated from bq76907_regmap.h */
+extern const BQ_RegDesc BQ76907_regDesc[];
+extern const uint8_t    BQ76907_regDescCount;
 
 // Low Level Access
 HAL_StatusTypeDef BQ76907_ReadRegister (BQ76907 *dev, uint8_t reg, uint8_t *data);
@@ -192,7 +214,24 @@ HAL_StatusTypeDef BQ76907_enterConfigUpdate(BQ76907 *dev);    /* SET_CFGUPDATE *
 HAL_StatusTypeDef BQ76907_exitConfigUpdate (BQ76907 *dev);    /* EXIT_CFGUPDATE */
 HAL_StatusTypeDef BQ76907_applyConfig      (BQ76907 *dev, const BQ76907_Config *cfg);
 
-/* Individual register write helpers (each writes raw or scaled value) */
+/* The configuration registers POWER_CONFIG..ALARM_ENABLE are contiguous, so
+ * what applyConfig leaves in the device can be read back in one burst and
+ * compared with the image of cfg (boot skips applyConfig when they match). */
+#define BQ76907_CFG_FIRST_REG    BQ76907_REG_POWER_CONFIG
+#define BQ76907_CFG_IMAGE_LEN    (BQ76907_REG_ALARM_ENABLE - BQ76907_REG_POWER_CONFIG + 1)  /* 20 */
+#define BQ76907_CFG_SCRIPT_LEN   (BQ76907_CFG_IMAGE_LEN + 2)   /* SET_CFGUPDATE, registers, EXIT_CFGUPDATE */
+/* 1 if every threshold of cfg fits its register and CUV lies below COV */
+uint8_t BQ76907_configValid (const BQ76907_Config *cfg);
+/* Register values applyConfig writes, in register order (thresholds past
+ * the register range saturate rather than wrap) */
+void    BQ76907_configImage (const BQ76907_Config *cfg, uint8_t img[BQ76907_CFG_IMAGE_LEN]);
+/* applyConfig as a write script (BQ76907_CFG_SCRIPT_LEN entries); returns the count */
+uint8_t BQ76907_configScript(const BQ76907_Config *cfg, BQ_RegWrite *out);
+/* Blocking readback: 1 if the device already holds cfg, 0 if not or on a bus error */
+uint8_t BQ76907_configMatches(BQ76907 *dev, const BQ76907_Config *cfg);
+
+/* Individual register write helpers (each writes raw or scaled value); the
+ * threshold setters return HAL_ERROR, without writing, past the range above */
 HAL_StatusTypeDef BQ76907_setPowerConfig         (BQ76907 *dev, uint8_t v);
 HAL_StatusTypeDef BQ76907_setDAConfig            (BQ76907 *dev, uint8_t v);
 HAL_StatusTypeDef BQ76907_setRegoutConfig        (BQ76907 *dev, uint8_t v);
@@ -240,8 +279,11 @@ HAL_StatusTypeDef BQ76907_configTemperatureProtection(BQ76907 *dev, uint8_t ot_C
 /* Debug / diagnostics */
 void BQ76907_debugDump(const BQ76907 *dev); /* Emits a concise state summary via BQ_LOG */
 /* Periodic concise status line; internally throttled by tick interval.
+ * Prints the values from the last refresh, it does not touch the bus, then
+ * only the SYS_STAT flags that changed since the previous line.
  * Example output:
- * [BQ] 76907 STAT Pack=15320mV Cells=3810,3820,3815,3875mV T=27.3C F:OV=0 UV=0 OCD=0 SCD=0 OT=0 Bal=0x0
+ * [BQ] 76907 STAT 00=C0 VCELL1_H=3810 mV VCELL2_H=3820 mV ... PACK_V_H=15320 mV TS1_H=273 0.1C
+ * [BQ] 76907 SYS_STAT.ov_fault 0->1
  */
 void BQ76907_logStatus(BQ76907 *dev);
 
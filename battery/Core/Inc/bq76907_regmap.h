@@ -0,0 +1,44 @@
+/*
+ * bq76907_regmap.h
+ *
+ *  BQ76907 register descriptions, written once and expanded by bq76907.h
+ *  (decoded struct) and bq76907.c (compile-time checks, descriptor table).
+ *  Same scheme as bq25798_regmap.h, see bq_regdesc.h.
+ *  Bit positions and addresses are the TODO_VERIFY placeholders of bq76907.h.
+ *
+ *  Bit-field registers: X(ID, access, member, Type)
+ *  Fields:  F(arg, name, msb, lsb)
+ *  Value registers (16-bit, MSB first): V(ID, access, member, unit, flags, scale)
+ */
+
+#ifndef INC_BQ76907_REGMAP_H_
+#define INC_BQ76907_REGMAP_H_
+
+#include "bq_regdesc.h"
+
+#define BQ76907_FIELD_REGS(X) \
+    X(SYS_STAT, BQ_ACCESS_RO, status, BQ76907_SystemStatus)
+
+/* SYS_STAT (bit 0 reserved) */
+#define BQ76907_SYS_STAT_FIELDS(F, a) \
+    F(a, cc_ready,  7, 7) \
+    F(a, dev_ready, 6, 6) \
+    F(a, ov_fault,  5, 5) \
+    F(a, uv_fault,  4, 4) \
+    F(a, scd_fault, 3, 3) \
+    F(a, ocd_fault, 2, 2) \
+    F(a, ot_fault,  1, 1)
+
+/* Measurements, scaled by the BQ76907_scale* helpers on decode */
+#define BQ76907_VALUE_REGS(V) \
+    V(VCELL1_H, BQ_ACCESS_RO, cellVoltage_mV[0], "mV",   0,             BQ76907_scaleCellVoltage) \
+    V(VCELL2_H, BQ_ACCESS_RO, cellVoltage_mV[1], "mV",   0,             BQ76907_scaleCellVoltage) \
+    V(VCELL3_H, BQ_ACCESS_RO, cellVoltage_mV[2], "mV",   0,             BQ76907_scaleCellVoltage) \
+    V(VCELL4_H, BQ_ACCESS_RO, cellVoltage_mV[3], "mV",   0,             BQ76907_scaleCellVoltage) \
+    V(PACK_V_H, BQ_ACCESS_RO, packVoltage_mV,    "mV",   0,             BQ76907_scalePackVoltage) \
+    V(TS1_H,    BQ_ACCESS_RO, ts1_degC_x10,      "0.1C", BQ_REG_SIGNED, scaleTs1)
+
+#define BQ76907_GEN_FIELD_STRUCT(ID, access, member, Type) \
+    typedef struct { BQ76907_##ID##_FIELDS(BQ_FIELD_MEMBER, _) } Type;
+
+#endif /* INC_BQ76907_REGMAP_H_ */
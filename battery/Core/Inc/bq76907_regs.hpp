@@ -0,0 +1,101 @@
+/*
+ * bq76907_regs.hpp
+ *
+ *  BQ76907 register map as bq_regfield.hpp types (see bq25798_regs.hpp).
+ *  Addresses, bit positions and LSB sizes are the TODO_VERIFY placeholders
+ *  of bq76907.h / bq76907.c; SYS_STAT comes from bq76907_regmap.h.
+ *
+ *  The 8-bit COV / CUV thresholds at 20 mV per LSB only reach 5100 mV:
+ *  CovThreshold::encodeConst<5200>() fails to compile, where the C setter
+ *  returns HAL_ERROR.
+ */
+
+#ifndef INC_BQ76907_REGS_HPP_
+#define INC_BQ76907_REGS_HPP_
+
+#include "bq76907.h"
+#include "bq_regfield.hpp"
+
+namespace bq76907 {
+
+using bq::Register;
+using bq::Field;
+using bq::Layout;
+
+/* ---- SYS_STAT (from bq76907_regmap.h): bq76907::SYS_STAT::uv_fault etc. ---- */
+#define BQ76907_CPP_FIELD_REG(ID, access, member, Type)                      \
+    namespace ID {                                                          \
+        using reg = Register<BQ76907_REG_##ID>;                             \
+        BQ76907_##ID##_FIELDS(BQ_CPP_FIELD, reg)                            \
+        using layout = Layout<reg, BQ76907_##ID##_FIELDS(BQ_CPP_FIELD_ARG, reg) BQ_CPP_END(reg)>; \
+        static_assert(layout::ok, #ID);                                     \
+    }
+BQ76907_FIELD_REGS(BQ76907_CPP_FIELD_REG)
+#undef BQ76907_CPP_FIELD_REG
+
+/* ---- Measurements (1 mV per LSB placeholder scaling) ---- */
+using Vcell1  = Field<Register<BQ76907_REG_VCELL1_H, 2>, 15, 0, bq::mV<1>>;
+using Vcell2  = Field<Register<BQ76907_REG_VCELL2_H, 2>, 15, 0, bq::mV<1>>;
+using Vcell3  = Field<Register<BQ76907_REG_VCELL3_H, 2>, 15, 0, bq::mV<1>>;
+using Vcell4  = Field<Register<BQ76907_REG_VCELL4_H, 2>, 15, 0, bq::mV<1>>;
+using PackV   = Field<Register<BQ76907_REG_PACK_V_H, 2>, 15, 0, bq::mV<1>>;
+
+/* ---- Protection thresholds (8-bit, as the BQ76907_set* helpers scale them) ---- */
+using CuvThreshold      = Field<Register<BQ76907_REG_CUV_THRESHOLD>,       7, 0, bq::mV<BQ76907_CELL_THRESH_LSB_mV>>;
+using CovThreshold      = Field<Register<BQ76907_REG_COV_THRESHOLD>,       7, 0, bq::mV<BQ76907_CELL_THRESH_LSB_mV>>;
+using OcChargeThreshold = Field<Register<BQ76907_REG_OCD_CHG_THRESHOLD>,   7, 0, bq::mA<BQ76907_CURR_THRESH_LSB_mA>>;
+using OcDisch1Threshold = Field<Register<BQ76907_REG_OCD_DISCH1_THRESHOLD>, 7, 0, bq::mA<BQ76907_CURR_THRESH_LSB_mA>>;
+using OcDisch2Threshold = Field<Register<BQ76907_REG_OCD_DISCH2_THRESHOLD>, 7, 0, bq::mA<BQ76907_CURR_THRESH_LSB_mA>>;
+using InternalOT        = Field<Register<BQ76907_REG_INT_OT_THRESHOLD>,    7, 0, bq::degC<1>>;
+using MaxInternalTemp   = Field<Register<BQ76907_REG_MAX_INTERNAL_TEMP>,   7, 0, bq::degC<1>>;
+
+/* ---- Protection enables (BQ76907_PROT_A_*) ---- */
+using ProtectionsA = Register<BQ76907_REG_ENABLED_PROTECTIONS_A>;
+using ProtCUV      = Field<ProtectionsA, 2, 2>;
+using ProtCOV      = Field<ProtectionsA, 3, 3>;
+using ProtOCC      = Field<ProtectionsA, 4, 4>;
+using ProtOCD1     = Field<ProtectionsA, 5, 5>;
+using ProtOCD2     = Field<ProtectionsA, 6, 6>;
+using ProtSCD      = Field<ProtectionsA, 7, 7>;
+static_assert(Layout<ProtectionsA, ProtCUV, ProtCOV, ProtOCC, ProtOCD1, ProtOCD2, ProtSCD>::ok, "PROTECTIONS_A");
+static_assert(ProtCUV::mask == BQ76907_PROT_A_CUV && ProtSCD::mask == BQ76907_PROT_A_SCD, "PROT_A bits");
+static_assert(SYS_STAT::uv_fault::mask == BQ76907_SYS_STAT_UV_FLAG, "SYS_STAT bits");
+
+/* ---- Control (SYS_CTRL1 placeholders) ---- */
+using SysCtrl1 = Register<BQ76907_REG_SYS_CTRL1>;
+using Sleep    = Field<SysCtrl1, 1, 1>;
+using AdcEn    = Field<SysCtrl1, 0, 0>;
+
+static_assert(CovThreshold::encodeConst<4200>() == 210, "COV 20 mV/LSB");
+static_assert(OcChargeThreshold::encodeConst<3000>() == 60, "OCC 50 mA/LSB");
+
+} /* namespace bq76907 */
+
+/* ---- Typed access over the C driver ---- */
+template <class R>
+inline HAL_StatusTypeDef BQ76907_readReg(BQ76907 *dev, typename R::raw_type &out) {
+    uint8_t b[R::width];
+    HAL_StatusTypeDef st = BQ76907_ReadRegisters(dev, R::addr, b, R::width);
+    if (st == HAL_OK) out = R::fromBytes(b);
+    return st;
+}
+
+template <class F>
+inline HAL_StatusTypeDef BQ76907_readField(BQ76907 *dev, typename F::value_type &out) {
+    typename F::raw_type v;
+    HAL_StatusTypeDef st = BQ76907_readReg<typename F::reg>(dev, v);
+    if (st == HAL_OK) out = F::decode(v);
+    return st;
+}
+
+/* Read-modify-write of one 8-bit register field */
+template <class F>
+inline HAL_StatusTypeDef BQ76907_writeField(BQ76907 *dev, typename F::value_type value) {
+    static_assert(F::reg::width == 1, "BQ76907 writes are single-byte");
+    typename F::raw_type v;
+    HAL_StatusTypeDef st = BQ76907_readReg<typename F::reg>(dev, v);
+    if (st != HAL_OK) return st;
+    return BQ76907_WriteRegister(dev, F::reg::addr, F::update(v, value));
+}
+
+#endif /* INC_BQ76907_REGS_HPP_ */
@@ -0,0 +1,122 @@
+/*
+ * bq_regdesc.h
+ *
+ *  Shared register descriptor types for the BQ25798 / BQ76907 drivers.
+ *
+ *  Each driver describes its registers once, as X-macro lists in
+ *  bq25798_regmap.h / bq76907_regmap.h:
+ *   - bit-field registers: one entry per register plus a field list
+ *     F(arg, name, msb, lsb); the decoded struct, the shift-and-mask decoder,
+ *     the encoder and the descriptor table are all expanded from it.
+ *   - value registers: 16-bit big-endian quantities with a unit and an
+ *     optional raw -> engineering-unit scaling function.
+ *
+ *  The descriptor tables are const (flash) and drive one shared decoder,
+ *  encoder, pretty-printer and snapshot diff below, replacing per-register
+ *  decode and printf code in both drivers. Decoding a field is a shift and a
+ *  mask with no data-dependent branches.
+ */
+
+#ifndef INC_BQ_REGDESC_H_
+#define INC_BQ_REGDESC_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum {
+    BQ_ACCESS_RO = 0,
+    BQ_ACCESS_RW,
+    BQ_ACCESS_W1C          /* write 1 to clear */
+} BQ_Access;
+
+/* Register flags */
+#define BQ_REG_SIGNED   0x01u   /* value register holds an int16_t */
+
+/* Mask of a field [msb:lsb] after shifting down by lsb */
+#define BQ_FIELD_BITS(msb, lsb)   ((uint8_t)((1u << ((msb) - (lsb) + 1u)) - 1u))
+
+/* Field list helpers for F(arg, name, msb, lsb):
+ *  BQ_FIELD_MEMBER          declares the decoded struct member
+ *  BQ_FIELD_MASK_OR/_SUM    fold the in-register masks; the two folds are equal
+ *                           only if no two fields overlap (checked at compile time)
+ *  BQ_FIELD_RANGE_OK        msb/lsb inside an 8-bit register, msb >= lsb
+ *  BQ_FIELD_DESC/_NAME      descriptor entry / packed name string */
+#define BQ_FIELD_MEMBER(arg, name, msb, lsb)   uint8_t name;
+#define BQ_FIELD_MASK_OR(arg, name, msb, lsb)  | ((unsigned)BQ_FIELD_BITS(msb, lsb) << (lsb))
+#define BQ_FIELD_MASK_SUM(arg, name, msb, lsb) + ((unsigned)BQ_FIELD_BITS(msb, lsb) << (lsb))
+#define BQ_FIELD_RANGE_OK(arg, name, msb, lsb) && ((msb) <= 7u && (lsb) <= (msb))
+#define BQ_FIELD_DESC(arg, name, msb, lsb)     { msb, lsb },
+#define BQ_FIELD_NAME(arg, name, msb, lsb)     "\0" #name
+
+/* Field i of a register is decoded into the uint8_t at reg->offset + i (the
+ * generated structs hold one uint8_t per field, in list order). Register and
+ * field names are kept as one NUL-separated string per register to keep
+ * pointers out of the table. */
+typedef struct {
+    uint8_t msb;
+    uint8_t lsb;
+} BQ_FieldDesc;
+
+typedef uint16_t (*BQ_ScaleFn)(uint16_t raw);
+
+typedef struct {
+    const char         *text;     /* "NAME\0" then field names "a\0b\0..." or the unit */
+    const BQ_FieldDesc *fields;   /* bit-field registers only */
+    BQ_ScaleFn          scale;    /* value registers, NULL = raw */
+    uint16_t            offset;   /* decoded struct / uint16_t member in the device */
+    uint8_t             addr;
+    uint8_t             width;    /* bytes on the bus */
+    uint8_t             access;   /* BQ_Access */
+    uint8_t             flags;    /* BQ_REG_* */
+    uint8_t             fieldCount;
+} BQ_RegDesc;
+
+/* One write of an init / configuration script. data is in bus order
+ * (16-bit values MSB first, as BQ25798_Write16). */
+typedef struct {
+    uint8_t reg;
+    uint8_t len;       /* 1..2 */
+    uint8_t data[2];
+} BQ_RegWrite;
+
+/* Raw image of every described register, rebuilt from the decoded state.
+ * Value registers are stored as the decoded 16-bit quantity. */
+#define BQ_SNAPSHOT_MAX_REGS 16
+typedef struct {
+    uint32_t tick;
+    uint8_t  valid;                         /* 0 until the first snapshot */
+    uint16_t value[BQ_SNAPSHOT_MAX_REGS];   /* indexed like the descriptor table */
+} BQ_Snapshot;
+
+/* Decode a block of consecutive registers read from firstReg into dev. 16-bit
+ * values are only taken when both bytes are inside the block. */
+void     BQ_RegDesc_decode(void *dev, const BQ_RegDesc *tab, uint8_t count,
+                           uint8_t firstReg, const uint8_t *data, uint8_t len);
+/* Pack a bit-field register back from the decoded struct (table driven) */
+uint8_t  BQ_RegDesc_encode(const void *dev, const BQ_RegDesc *reg);
+/* Current value of any described register (encoded fields or 16-bit value) */
+uint16_t BQ_RegDesc_value(const void *dev, const BQ_RegDesc *reg);
+
+/* One line per register: "[BQ] <tag> NAME(0xAA)=0xVV field=x ..." / "NAME(0xAA)=1234 mV" */
+void BQ_RegDesc_log(const char *tag, const void *dev, const BQ_RegDesc *tab, uint8_t count);
+/* One compact line "[BQ] <tag> STAT AA=VV ... NAME=1234 mV": raw bytes of
+ * bit-field registers and decoded values */
+void BQ_RegDesc_logCompact(const char *tag, const void *dev, const BQ_RegDesc *tab, uint8_t count);
+
+void BQ_RegDesc_snapshot(const void *dev, const BQ_RegDesc *tab, uint8_t count, uint32_t tick, BQ_Snapshot *out);
+/* Print fields / values that differ between two snapshots; returns how many changed */
+uint8_t BQ_RegDesc_logChanges(const char *tag, const BQ_RegDesc *tab, uint8_t count,
+                              const BQ_Snapshot *prev, const BQ_Snapshot *cur);
+/* Periodic status: compact line, then the fields changed since *last (updated) */
+void BQ_RegDesc_logStatus(const char *tag, const void *dev, const BQ_RegDesc *tab, uint8_t count,
+                          uint32_t tick, BQ_Snapshot *last);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_BQ_REGDESC_H_ */
@@ -0,0 +1,183 @@
+/*
+ * bq_regfield.hpp
+ *
+ *  Header-only C++ register / field types for the BQ25798 and BQ76907 maps
+ *  (bq25798_regs.hpp, bq76907_regs.hpp). Everything is constexpr and
+ *  resolves to the same shifts and masks the C drivers write by hand; no
+ *  objects, no virtuals, no RAM.
+ *
+ *    Register<addr, width>            width in bytes (1, or 2 = MSB first)
+ *    Field<Reg, msb, lsb, Unit>       bits [msb:lsb] of Reg, scaled by Unit
+ *    Layout<Reg, Fields...>           compile-time check that the fields of
+ *                                     one register do not overlap
+ *
+ *  Units carry the engineering quantity as a distinct type, so passing
+ *  milliamps where millivolts are expected does not compile:
+ *
+ *    uint16_t raw = VREG::encode(Millivolts(14600));      // 1460, masked to 11 bits
+ *    Millivolts v = VREG::decode(raw);                    // 14600
+ *    uint8_t  r  = COV::encodeConst<5200>();              // static_assert: 260 > 8 bits
+ *
+ *  The C drivers keep using bq_regdesc.h; this layer is for C++ code on
+ *  top of them. Requires C++14 (relaxed constexpr).
+ */
+
+#ifndef INC_BQ_REGFIELD_HPP_
+#define INC_BQ_REGFIELD_HPP_
+
+#include <stdint.h>
+#include <type_traits>
+
+namespace bq {
+
+/* ---- Quantities ---- */
+template <class Tag>
+struct Quantity {
+    uint16_t value;
+    constexpr explicit Quantity(uint16_t v) : value(v) {}
+    constexpr bool operator==(Quantity o) const { return value == o.value; }
+    constexpr bool operator!=(Quantity o) const { return value != o.value; }
+};
+using Millivolts = Quantity<struct MillivoltTag>;
+using Milliamps  = Quantity<struct MilliampTag>;
+using DegreesC   = Quantity<struct DegreeCTag>;
+
+/* ---- Units: raw field value <-> quantity ---- */
+/* Unscaled: the field value itself (flags, enums, codes) */
+struct Raw {
+    using value_type = uint16_t;
+    static constexpr uint32_t toRaw(uint32_t v)     { return v; }
+    static constexpr uint32_t toRaw(value_type v)   { return v; }   /* disambiguates uint16_t */
+    static constexpr value_type fromRaw(uint32_t r) { return static_cast<value_type>(r); }
+};
+
+/* Q per LSB, zero offset (all BQ25798 / BQ76907 limits used here are of this form) */
+template <class Q, uint16_t Lsb>
+struct Scaled {
+    static_assert(Lsb != 0, "LSB size must be non-zero");
+    using value_type = Q;
+    static constexpr uint16_t lsb = Lsb;
+    static constexpr uint32_t toRaw(uint32_t v)     { return v / Lsb; }
+    static constexpr uint32_t toRaw(value_type q)   { return q.value / Lsb; }
+    static constexpr value_type fromRaw(uint32_t r) { return value_type(static_cast<uint16_t>(r * Lsb)); }
+};
+
+template <uint16_t Lsb> using mV   = Scaled<Millivolts, Lsb>;
+template <uint16_t Lsb> using mA   = Scaled<Milliamps,  Lsb>;
+template <uint16_t Lsb> using degC = Scaled<DegreesC,   Lsb>;
+
+/* ---- Register ---- */
+template <uint8_t Addr, uint8_t Width = 1>
+struct Register {
+    static_assert(Width == 1 || Width == 2, "registers are 8 or 16 bits");
+    using raw_type = typename std::conditional<Width == 1, uint8_t, uint16_t>::type;
+    static constexpr uint8_t  addr  = Addr;
+    static constexpr uint8_t  width = Width;
+    static constexpr unsigned bits  = 8u * Width;
+
+    /* Big-endian wire bytes <-> register value */
+    static constexpr raw_type fromBytes(const uint8_t *b) {
+        return Width == 1 ? static_cast<raw_type>(b[0])
+                          : static_cast<raw_type>((b[0] << 8) | b[1]);
+    }
+    static void toBytes(raw_type v, uint8_t *b) {
+        if (Width == 1) { b[0] = static_cast<uint8_t>(v); }
+        else            { b[0] = static_cast<uint8_t>(v >> 8); b[1] = static_cast<uint8_t>(v); }
+    }
+};
+
+/* ---- Field ---- */
+template <class Reg, unsigned Msb, unsigned Lsb, class Unit = Raw>
+struct Field {
+    static_assert(Msb < Reg::bits, "field msb outside the register");
+    static_assert(Lsb <= Msb, "field lsb above msb");
+
+    using reg        = Reg;
+    using unit       = Unit;
+    using raw_type   = typename Reg::raw_type;
+    using value_type = typename Unit::value_type;
+
+    static constexpr unsigned msb   = Msb;
+    static constexpr unsigned lsb   = Lsb;
+    static constexpr uint32_t max   = (Msb - Lsb + 1u >= 32u) ? 0xFFFFFFFFu : ((1u << (Msb - Lsb + 1u)) - 1u);
+    static constexpr uint32_t mask  = max << Lsb;
+
+    /* Field bits out of / into a register value */
+    static constexpr raw_type get(raw_type regValue) {
+        return static_cast<raw_type>((regValue >> Lsb) & max);
+    }
+    static constexpr raw_type set(raw_type regValue, uint32_t fieldRaw) {
+        return static_cast<raw_type>((regValue & ~mask) | ((fieldRaw & max) << Lsb));
+    }
+
+    /* Quantity <-> register bits. encode() masks to the field width, the same
+     * truncation a hand-written (x / lsb) << shift & mask performs. */
+    static constexpr value_type decode(raw_type regValue) { return Unit::fromRaw(get(regValue)); }
+    static constexpr raw_type   encode(value_type v) {
+        return static_cast<raw_type>((Unit::toRaw(v) & max) << Lsb);
+    }
+    static constexpr raw_type   update(raw_type regValue, value_type v) {
+        return static_cast<raw_type>((regValue & ~mask) | encode(v));
+    }
+
+    /* Compile-time constant in engineering units; rejects values that do not fit */
+    template <uint32_t V>
+    static constexpr raw_type encodeConst() {
+        static_assert(Unit::toRaw(V) <= max, "constant out of range for this field");
+        return static_cast<raw_type>(Unit::toRaw(V) << Lsb);
+    }
+};
+
+/* ---- Layout: every field of Reg listed once, none overlapping ---- */
+/* Empty list terminator for macro-generated field lists */
+template <class Reg>
+struct NoField {
+    using reg = Reg;
+    static constexpr uint32_t mask = 0;
+};
+
+namespace detail {
+template <class Reg, class... Fs>
+constexpr bool sameRegister() {
+    const bool same[] = { true, std::is_same<typename Fs::reg, Reg>::value... };
+    for (bool s : same) { if (!s) return false; }
+    return true;
+}
+template <class... Fs>
+constexpr bool disjoint() {
+    const uint32_t masks[] = { 0u, Fs::mask... };
+    uint32_t seen = 0;
+    for (uint32_t m : masks) {
+        if (seen & m) return false;
+        seen |= m;
+    }
+    return true;
+}
+template <class... Fs>
+constexpr uint32_t usedMask() {
+    const uint32_t masks[] = { 0u, Fs::mask... };
+    uint32_t all = 0;
+    for (uint32_t m : masks) all |= m;
+    return all;
+}
+} /* namespace detail */
+
+template <class Reg, class... Fs>
+struct Layout {
+    static_assert(detail::sameRegister<Reg, Fs...>(), "field belongs to another register");
+    static_assert(detail::disjoint<Fs...>(), "overlapping fields");
+    static constexpr bool     ok       = true;   /* static_assert(L::ok) forces the checks */
+    static constexpr uint32_t used     = detail::usedMask<Fs...>();
+    static constexpr uint32_t reserved = ((Reg::bits >= 32u) ? 0xFFFFFFFFu : ((1u << Reg::bits) - 1u)) & ~used;
+};
+
+} /* namespace bq */
+
+/* Adapter for the X-macro field lists in bq25798_regmap.h / bq76907_regmap.h:
+ *  BQ_CPP_FIELD       -> "using name = bq::Field<Reg, msb, lsb>;"
+ *  BQ_CPP_FIELD_ARG   -> "bq::Field<Reg, msb, lsb>," (for Layout<>, list closed by BQ_CPP_END) */
+#define BQ_CPP_FIELD(Reg, name, msb, lsb)      using name = ::bq::Field<Reg, msb, lsb>;
+#define BQ_CPP_FIELD_ARG(Reg, name, msb, lsb)  ::bq::Field<Reg, msb, lsb>,
+#define BQ_CPP_END(Reg)                        ::bq::NoField<Reg>
+
+#endif /* INC_BQ_REGFIELD_HPP_ */
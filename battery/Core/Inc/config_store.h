@@ -0,0 +1,151 @@
+/*
+ * config_store.h
+ *
+ *  Flash-backed configuration: the BQ76907 protection configuration, the
+ *  charge profile table and calibration data, kept in two flash pages
+ *  (slots A and B) just below the fault log.
+ *
+ *  A slot holds one image: a 16-byte header and the ConfigStore_Data
+ *  payload exactly as it sits in RAM. ConfigStore_Init picks the valid slot
+ *  with the highest sequence number and, for the current schema, hands out
+ *  a pointer straight into flash: loading is one CRC pass over the image,
+ *  nothing is parsed or copied.
+ *
+ *  Commit (A/B): the new image goes to the other slot. The payload is
+ *  programmed first, then the header double word carrying {seq, crc}, and
+ *  the one carrying the magic last. Until that final double word lands the
+ *  slot is invalid, so a reset during a commit leaves the previous image in
+ *  charge. The old slot is only erased by the commit after next.
+ *
+ *  An image is only used if the monitor can hold its thresholds
+ *  (BQ76907_configValid): a slot that fails counts as invalid, so the other
+ *  slot or the defaults take over, and Commit refuses such data up front.
+ *
+ *  Run-time edits (console / debugger): ConfigStore_RequestCommit copies
+ *  the new image and the main loop commits it once the bus and the fault
+ *  log are idle, so the blocking erase never lands inside a task. The
+ *  devices pick the new values up at their next bring-up (boot, or a
+ *  device coming back from offline).
+ *
+ *  Schema changes are append-only: new fields go at the end of
+ *  ConfigStore_Data and CONFIG_STORE_SCHEMA is bumped. An older image is
+ *  copied over the defaults (so new fields hold their default), the
+ *  migration hooks from its schema up run on it, and the result is
+ *  committed so the next boot is a plain load again. An image from a newer
+ *  schema (firmware downgrade) is not used.
+ *
+ *  The flash access functions are ports like the fault log's: the target
+ *  versions in config_store.c, an emulated array on the host (host_hal.c).
+ */
+
+#ifndef INC_CONFIG_STORE_H_
+#define INC_CONFIG_STORE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(USE_HAL_STUBS)
+#include "hal_stubs.h"
+#else
+#include "stm32g0xx_hal.h"
+#endif
+#include "bq76907.h"
+#include "bq25798.h"
+#include <stdint.h>
+
+#ifndef CONFIG_STORE_BASE
+#define CONFIG_STORE_BASE       0x0807D000u   /* 2 pages below FAULTLOG_BASE (see linker scripts) */
+#endif
+#define CONFIG_STORE_PAGE_SIZE  2048u
+#define CONFIG_STORE_SLOTS      2
+#define CONFIG_STORE_MAGIC      0x47464331u   /* "1CFG" */
+#define CONFIG_STORE_SCHEMA     1u            /* bump when fields are appended */
+#ifndef CONFIG_STORE_PROFILES
+#define CONFIG_STORE_PROFILES   4
+#endif
+
+typedef struct {
+    char                 name[8];        /* NUL padded */
+    BQ25798_ChargeLimits limits;
+} ConfigStore_ChargeProfile;
+
+/* Offsets added to the raw readings */
+typedef struct {
+    int16_t cellOffset_mV[4];
+    int16_t packOffset_mV;
+    int16_t ts1Offset_C_x10;
+} ConfigStore_Calibration;
+
+/* Payload, schema CONFIG_STORE_SCHEMA. Append only (see above). */
+typedef struct {
+    BQ76907_Config            monitor;
+    ConfigStore_ChargeProfile profile[CONFIG_STORE_PROFILES];
+    uint8_t                   activeProfile;
+    uint8_t                   reserved[3];
+    ConfigStore_Calibration   cal;
+} ConfigStore_Data;
+
+/* Slot header: two double words, the first (magic) programmed last */
+typedef struct {
+    uint32_t magic;
+    uint16_t schema;
+    uint16_t size;       /* payload bytes */
+    uint32_t seq;        /* commit counter; the higher valid slot wins */
+    uint32_t crc;        /* CRC-32 over schema, size, seq and the payload */
+} ConfigStore_Header;
+
+typedef enum { config_store_fits = 1 / (sizeof(ConfigStore_Header) + sizeof(ConfigStore_Data) <= CONFIG_STORE_PAGE_SIZE ? 1u : 0u) } ConfigStore_SizeCheck;
+
+typedef enum {
+    CONFIG_SRC_DEFAULTS = 0,    /* no valid slot */
+    CONFIG_SRC_FLASH,           /* current schema, used in place */
+    CONFIG_SRC_MIGRATED         /* older schema, upgraded in RAM (and re-committed) */
+} ConfigStore_Source;
+
+typedef struct {
+    uint8_t  source;     /* ConfigStore_Source */
+    uint8_t  slot;       /* slot in use (0xFF: none) */
+    uint16_t schema;     /* schema of the image found */
+    uint32_t seq;
+    uint32_t invalid;    /* slots rejected at init (CRC, header, newer schema, thresholds) */
+    uint32_t rejected;   /* commits refused for thresholds the monitor cannot hold */
+    uint32_t commits;
+    uint32_t errors;     /* erase / program / verify failures */
+} ConfigStore_Stats;
+
+/* Validate both slots and select the configuration; defaults is used when
+ * no slot is valid and to fill fields an older schema does not have. */
+void ConfigStore_Init(const ConfigStore_Data *defaults);
+
+/* The configuration in force (flash or RAM); never NULL after Init */
+const ConfigStore_Data *ConfigStore_Get(void);
+/* Profile activeProfile (clamped to the table) */
+const ConfigStore_ChargeProfile *ConfigStore_ActiveProfile(void);
+
+/* Write data to the other slot and switch to it. Blocks for the page erase
+ * (~22 ms); HAL_ERROR (thresholds out of range, flash failure) leaves the
+ * current configuration in force. */
+HAL_StatusTypeDef ConfigStore_Commit(const ConfigStore_Data *data);
+
+/* Queue data for the main loop to commit (a newer request replaces it) */
+void ConfigStore_RequestCommit(const ConfigStore_Data *data);
+/* The queued image, or NULL; consumes the request */
+const ConfigStore_Data *ConfigStore_TakeCommitRequest(void);
+
+uint32_t ConfigStore_Crc32(uint32_t crc, const uint8_t *data, uint32_t len);
+
+const ConfigStore_Stats *ConfigStore_GetStats(void);
+void ConfigStore_LogStats(void);
+
+/* Flash access, offsets from CONFIG_STORE_BASE (slot n at n * page size).
+ * Erase blocks until done. */
+const uint8_t    *ConfigStore_FlashRead(uint32_t offset);
+HAL_StatusTypeDef ConfigStore_FlashProgram(uint32_t offset, uint64_t data);
+HAL_StatusTypeDef ConfigStore_FlashErase(uint32_t slot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_CONFIG_STORE_H_ */
@@ -0,0 +1,109 @@
+/*
+ * faultlog.h
+ *
+ *  Persistent fault log: every BM_PUSH_ERROR entry is also appended to a
+ *  log in the last FAULTLOG_PAGES flash pages, so the history survives a
+ *  reset.
+ *
+ *  BM_PUSH_ERROR only copies the entry into a small RAM queue
+ *  (FaultLog_Enqueue). FaultLog_Service(), called from the main loop when
+ *  it has nothing else to do, programs one record per call, or starts /
+ *  polls a page erase. The region sits at the end of bank 2, so the CPU
+ *  keeps fetching from bank 1 while an erase runs; the erase is started and
+ *  polled, never waited for.
+ *
+ *  Layout: pages are used round robin (every page sees the same number of
+ *  erases). Each page starts with a header double word {FAULTLOG_MAGIC,
+ *  page sequence}; the page with the highest sequence is the one being
+ *  written. Records follow, 16 bytes each, with a CRC-16 over the first
+ *  14 bytes. A record torn by a reset fails its CRC and is skipped; the
+ *  write position is always after the last programmed slot.
+ *
+ *  Host/faultlog_dump turns a raw dump of the region back into text.
+ */
+
+#ifndef INC_FAULTLOG_H_
+#define INC_FAULTLOG_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(USE_HAL_STUBS)
+#include "hal_stubs.h"
+#else
+#include "stm32g0xx_hal.h"
+#endif
+#include "bm_errors.h"
+#include <stdint.h>
+
+#ifndef FAULTLOG_BASE
+#define FAULTLOG_BASE        0x0807E000u  /* last 4 pages of bank 2 (see linker scripts) */
+#endif
+#ifndef FAULTLOG_PAGES
+#define FAULTLOG_PAGES       4
+#endif
+#define FAULTLOG_PAGE_SIZE   2048u
+#ifndef FAULTLOG_QUEUE_DEPTH
+#define FAULTLOG_QUEUE_DEPTH 16           /* entries waiting for the flash */
+#endif
+#define FAULTLOG_MAGIC       0x464C4731u  /* "1GLF" */
+#define FAULTLOG_REC_SIZE    16u
+#define FAULTLOG_REC_PER_PAGE ((FAULTLOG_PAGE_SIZE - 8u) / FAULTLOG_REC_SIZE)   /* 127 */
+
+/* One record, as programmed (two double words, little-endian) */
+typedef struct {
+    uint32_t tick;       /* BM_ErrorEntry.tick */
+    uint16_t boot;       /* boot counter (one more than the highest in the log at init) */
+    uint16_t value;
+    int8_t   code;       /* BM_Result */
+    uint8_t  detail;
+    uint8_t  source;     /* BM_ErrorSource */
+    uint8_t  reg;
+    uint16_t lost;       /* entries dropped from the RAM queue just before this one */
+    uint16_t crc;        /* CRC-16/CCITT-FALSE over the 14 bytes above */
+} FaultLog_Record;
+
+typedef enum { faultlog_rec_size_ok = 1 / (sizeof(FaultLog_Record) == FAULTLOG_REC_SIZE ? 1u : 0u) } FaultLog_SizeCheck;
+
+typedef struct {
+    uint32_t written;    /* records programmed */
+    uint32_t dropped;    /* RAM queue full */
+    uint32_t erases;
+    uint32_t errors;     /* program / erase failures */
+    uint32_t corrupt;    /* records with a bad CRC found at init */
+    uint16_t boot;
+    uint16_t records;    /* valid records in flash at init */
+} FaultLog_Stats;
+
+/* Scan the region: pick the newest page, the next free slot and the boot
+ * number. A region without a valid page is erased lazily by Service. */
+void FaultLog_Init(void);
+
+/* Copy an entry into the RAM queue (hot path; also from interrupts) */
+void FaultLog_Enqueue(const BM_ErrorEntry *e);
+
+/* Do at most one flash operation. Returns 1 if there is more to do. */
+uint8_t FaultLog_Service(void);
+
+/* Queued records plus a running erase; 0 when the flash is idle */
+uint32_t FaultLog_Pending(void);
+
+uint16_t FaultLog_Crc16(const uint8_t *data, uint32_t len);
+
+const FaultLog_Stats *FaultLog_GetStats(void);
+void FaultLog_LogStats(void);
+
+/* Flash access for the region, offsets from FAULTLOG_BASE. The target
+ * versions in faultlog.c use the FLASH peripheral; the host provides
+ * an emulated NOR array (host_hal.c). */
+const uint8_t    *FaultLog_FlashRead(uint32_t offset);
+HAL_StatusTypeDef FaultLog_FlashProgram(uint32_t offset, uint64_t data);
+HAL_StatusTypeDef FaultLog_FlashEraseStart(uint32_t page);
+uint8_t           FaultLog_FlashBusy(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_FAULTLOG_H_ */
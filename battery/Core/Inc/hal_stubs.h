@@ -1,14 +1,41 @@
 /* hal_stubs.h
  * Lightweight stand-in for STM32 HAL headers when building host-side tools/tests
  * Define USE_HAL_STUBS (or pass -DUSE_HAL_STUBS) before including driver headers.
+ *
+ * Only the subset of the HAL used by the BQ drivers is declared here. The
+ * implementation lives in battery/Host/host_hal.c, which routes I2C memory
+ * transfers to register-level device emulators and keeps a virtual tick.
  */
 #ifndef HAL_STUBS_H
 #define HAL_STUBS_H
+
+#include <stdint.h>
+
 typedef struct { int dummy; } I2C_HandleTypeDef;
 typedef int HAL_StatusTypeDef;
-#define HAL_OK 0
-#define HAL_ERROR (-1)
+/* Same numeric values as the real HAL_StatusTypeDef enum */
+#define HAL_OK      0
+#define HAL_ERROR   1
+#define HAL_BUSY    2
+#define HAL_TIMEOUT 3
 #define HAL_MAX_DELAY 0xFFFFFFFFu
+#define I2C_MEMADD_SIZE_8BIT 0x00000001u
 /* Minimal no-op macros */
 #define __NOP() do {} while(0)
+
+/* Virtual millisecond tick (advanced by the host harness, see host_hal.h) */
+uint32_t HAL_GetTick(void);
+void     HAL_Delay(uint32_t Delay);
+
+/* Blocking I2C memory access, dispatched to attached device emulators */
+HAL_StatusTypeDef HAL_I2C_Mem_Read (I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                    uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                    uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+
+/* Route bm_errors.h tick snapshots to the virtual tick instead of the real HAL */
+#ifndef BM_GET_TICK
+#define BM_GET_TICK() HAL_GetTick()
+#endif
+
 #endif
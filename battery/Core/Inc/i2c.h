@@ -29,6 +29,7 @@ extern "C" {
 #include "main.h"
 
 /* USER CODE BEGIN Includes */
+#include "i2c_bus.h"
 
 /* USER CODE END Includes */
 
@@ -0,0 +1,161 @@
+/*
+ * i2c_bus.h
+ *
+ *  Shared I2C bus scheduler. BQ25798 and BQ76907 both sit on hi2c1; every
+ *  driver transfer goes through this module so the bus has a single owner.
+ *
+ *  Two paths:
+ *   - I2CBus_MemRead/I2CBus_MemWrite: immediate blocking transfer (used by the
+ *     driver low-level wrappers), accounted in the statistics.
+ *   - I2CBus_Submit + I2CBus_Service: queued requests with a priority and a
+ *     deadline. Service() runs at most N transactions per call so the main
+ *     loop latency stays bounded, picks the highest priority (then earliest
+ *     deadline) first and merges queued reads of adjacent / overlapping
+ *     registers on the same device into one burst.
+ *
+ *  Writes are never merged (ALARM_STATUS style write-to-clear side effects).
+ *
+ *  Fault handling: every device seen on the bus gets a health score
+ *  (0..100). Failures lower it and put the device in an exponential backoff
+ *  window during which its transfers return HAL_BUSY without touching the
+ *  bus; I2CBus_PollInterval() stretches polling periods for low scores.
+ *  Repeated failures, or the HAL reporting the bus busy, trigger
+ *  I2CBus_RecoverHardware() (SCL clocking + peripheral re-init), itself
+ *  rate-limited by a bounded backoff.
+ *
+ *  Every physical transaction is timed with I2C_BUS_NOW_US and recorded in
+ *  a log2 histogram of its device (I2CBus_GetLatency).
+ */
+
+#ifndef INC_I2C_BUS_H_
+#define INC_I2C_BUS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(USE_HAL_STUBS)
+#include "hal_stubs.h"
+#else
+#include "stm32g0xx_hal.h"
+#endif
+#include "latency.h"
+#include <stdint.h>
+
+#ifndef I2C_BUS_QUEUE_DEPTH
+#define I2C_BUS_QUEUE_DEPTH   16   /* pending requests */
+#endif
+#ifndef I2C_BUS_MAX_XFER
+#define I2C_BUS_MAX_XFER      8    /* bytes carried by one request */
+#endif
+#ifndef I2C_BUS_MAX_BURST
+#define I2C_BUS_MAX_BURST     24   /* bytes in one merged transaction */
+#endif
+#ifndef I2C_BUS_TIMEOUT_MS
+#define I2C_BUS_TIMEOUT_MS    10   /* per transaction (replaces HAL_MAX_DELAY) */
+#endif
+#ifndef I2C_BUS_MAX_DEVICES
+#define I2C_BUS_MAX_DEVICES   4    /* health-tracked addresses */
+#endif
+#define I2C_BUS_HEALTH_MAX        100
+#define I2C_BUS_HEALTH_UP         2    /* per successful transfer */
+#define I2C_BUS_HEALTH_DOWN       20   /* per failed transfer */
+#define I2C_BUS_BACKOFF_MIN_MS    10   /* first backoff after a repeated failure */
+#define I2C_BUS_BACKOFF_MAX_MS    5000 /* upper bound for device and recovery backoff */
+#define I2C_BUS_RECOVER_AFTER     3    /* consecutive bus failures before recovery */
+/* Microsecond timestamp used for transaction timing (TIM2, see latency.h) */
+#ifndef I2C_BUS_NOW_US
+#define I2C_BUS_NOW_US()      Latency_NowUs()
+#endif
+
+#define I2C_BUS_ANY_DEVICE    0xFFFFu
+
+/* Lower value runs first. Fault reads preempt everything else in the queue. */
+typedef enum {
+    I2C_BUS_PRIO_FAULT = 0,      /* fault / safety status reads */
+    I2C_BUS_PRIO_CONTROL,        /* setpoint / FET / balancing writes */
+    I2C_BUS_PRIO_MEASURE,        /* periodic measurements */
+    I2C_BUS_PRIO_BACKGROUND,     /* diagnostics, logging */
+    I2C_BUS_PRIO_COUNT
+} I2CBus_Priority;
+
+/* Completion: data points at the bytes of this request (reads) or NULL (writes) */
+typedef void (*I2CBus_Callback)(void *ctx, uint8_t reg, const uint8_t *data, uint8_t len, HAL_StatusTypeDef st);
+
+typedef struct {
+    uint16_t        devAddress;   /* HAL convention (7-bit << 1) */
+    uint8_t         reg;
+    uint8_t         len;          /* 1..I2C_BUS_MAX_XFER */
+    uint8_t         write;        /* 0 = read, 1 = write */
+    uint8_t         prio;         /* I2CBus_Priority */
+    uint32_t        deadline_ms;  /* absolute HAL tick; 0 = none */
+    const uint8_t  *txData;       /* write payload, copied at submit */
+    I2CBus_Callback done;         /* optional */
+    void           *ctx;
+} I2CBus_Request;
+
+typedef struct {
+    uint16_t devAddress;
+    uint8_t  health;              /* 0..I2C_BUS_HEALTH_MAX */
+    uint8_t  consecutiveFails;
+    uint32_t retryAt;             /* HAL tick when backoff ends */
+    uint32_t failures;
+    uint32_t skipped;             /* transfers refused during backoff */
+} I2CBus_DeviceHealth;
+
+typedef struct {
+    uint32_t count;
+    uint32_t maxLatency_ms;       /* submit -> completion */
+} I2CBus_PrioStats;
+
+typedef struct {
+    uint32_t transactions;        /* physical bus transactions */
+    uint32_t requests;            /* queued requests completed */
+    uint32_t merged;              /* requests that rode along in another burst */
+    uint32_t bytes;
+    uint32_t errors;
+    uint32_t deadlineMisses;
+    uint32_t queueFull;
+    uint32_t recoveries;          /* I2CBus_RecoverHardware() attempts */
+    uint32_t recoveryFailures;
+    uint8_t  maxQueueDepth;
+    uint32_t minTxn_us;
+    uint32_t maxTxn_us;
+    uint64_t totalTxn_us;
+    I2CBus_PrioStats prio[I2C_BUS_PRIO_COUNT];
+} I2CBus_Stats;
+
+void I2CBus_Init(I2C_HandleTypeDef *hi2c);
+
+/* Immediate transfers (handle may be NULL to use the bus owner's handle) */
+HAL_StatusTypeDef I2CBus_MemRead (I2C_HandleTypeDef *hi2c, uint16_t devAddress, uint8_t reg, uint8_t *data, uint16_t len);
+HAL_StatusTypeDef I2CBus_MemWrite(I2C_HandleTypeDef *hi2c, uint16_t devAddress, uint8_t reg, const uint8_t *data, uint16_t len);
+
+/* Queue a request. Returns HAL_BUSY if the queue is full, HAL_ERROR if malformed. */
+HAL_StatusTypeDef I2CBus_Submit(const I2CBus_Request *req);
+/* Execute up to maxTransactions bus transactions. Returns how many ran. */
+uint8_t I2CBus_Service(uint8_t maxTransactions);
+/* Queued requests for one device (or I2C_BUS_ANY_DEVICE) */
+uint8_t I2CBus_Pending(uint16_t devAddress);
+
+/* Device health / backoff */
+const I2CBus_DeviceHealth *I2CBus_GetHealth(uint16_t devAddress);   /* NULL if never seen */
+uint8_t  I2CBus_DeviceAvailable(uint16_t devAddress);                 /* 0 while backing off */
+uint32_t I2CBus_PollInterval(uint16_t devAddress, uint32_t base_ms); /* base stretched x1..x8 by health */
+#define I2C_BUS_POLL_STRETCH_MAX  8u   /* largest I2CBus_PollInterval factor */
+
+/* Release a stuck bus and re-initialise the peripheral. Weak default does
+ * nothing and returns HAL_OK; the target version lives in i2c.c. */
+HAL_StatusTypeDef I2CBus_RecoverHardware(I2C_HandleTypeDef *hi2c);
+
+const I2CBus_Stats *I2CBus_GetStats(void);
+void I2CBus_ResetStats(void);
+/* Transaction time histogram of one device (NULL if never seen) */
+const Latency_Hist *I2CBus_GetLatency(uint16_t devAddress);
+void I2CBus_LogStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_I2C_BUS_H_ */
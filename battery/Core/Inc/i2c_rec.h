@@ -0,0 +1,79 @@
+/*
+ * i2c_rec.h
+ *
+ *  I2C flight recorder. i2c_bus.c reports every transaction that reached
+ *  the bus (tick, address, register, direction, length, payload, HAL
+ *  status); the recorder keeps the most recent ones in a byte ring,
+ *  overwriting the oldest. I2CRec_RequestDump (console / debugger) asks the
+ *  main loop to print the ring as "[I2CREC]" hex lines on the console,
+ *  where Host/i2c_replay picks them out of a capture and replays them
+ *  through the firmware.
+ *
+ *  Record (little-endian):
+ *    byte 0   write << 7 | status << 5 | len      (HAL status 0..3, len 1..24)
+ *    byte 1   7-bit device address
+ *    byte 2   register
+ *    byte 3-4 ms since the previous record
+ *    byte 5.. payload: the bytes written, or read (status OK only)
+ *  A gap longer than 65535 ms is bridged by a sync record: 0xFF followed by
+ *  the absolute 32-bit tick. The dump header carries the tick the first
+ *  record's delta counts from.
+ *
+ *  Main loop only (as i2c_bus.c). Transfers skipped by the bus backoff
+ *  never reach the device and are not recorded.
+ */
+
+#ifndef INC_I2C_REC_H_
+#define INC_I2C_REC_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#if defined(USE_HAL_STUBS)
+#include "hal_stubs.h"
+#else
+#include "stm32g0xx_hal.h"
+#endif
+
+#ifndef I2C_REC_RING_BYTES
+#define I2C_REC_RING_BYTES   4096u   /* power of two; ~20 s of normal polling */
+#endif
+#define I2C_REC_HEADER       5u
+#define I2C_REC_SYNC         0xFFu
+#define I2C_REC_SYNC_BYTES   5u
+#define I2C_REC_MAX_LEN      31u     /* len field; sync uses write | status 3 | 31 */
+#define I2C_REC_DUMP_LINE    32u     /* payload bytes per "[I2CREC]" line */
+
+typedef struct {
+    uint32_t records;      /* transactions recorded */
+    uint32_t overwritten;  /* oldest records dropped for new ones */
+    uint32_t dumps;
+} I2CRec_Stats;
+
+/* Clear the ring; the first record's delta counts from now */
+void I2CRec_Init(void);
+/* Called by i2c_bus.c after every transfer that reached the HAL */
+void I2CRec_Note(uint16_t devAddress, uint8_t reg, const uint8_t *data, uint16_t len,
+                 uint8_t write, HAL_StatusTypeDef status);
+
+/* Bytes currently held (records + syncs) */
+uint32_t I2CRec_Used(void);
+/* Copy the ring, oldest first, into out (up to max bytes); *baseTick gets
+ * the tick the first delta counts from. Returns the bytes copied. */
+uint32_t I2CRec_Snapshot(uint8_t *out, uint32_t max, uint32_t *baseTick);
+
+/* Print the ring as "[I2CREC]" lines (begin / hex / end) */
+void I2CRec_Dump(void);
+void I2CRec_RequestDump(void);
+uint8_t I2CRec_TakeDumpRequest(void);
+
+const I2CRec_Stats *I2CRec_GetStats(void);
+void I2CRec_LogStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_I2C_REC_H_ */
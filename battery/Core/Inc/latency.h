@@ -0,0 +1,78 @@
+/*
+ * latency.h
+ *
+ *  Microsecond timestamps and log2 latency histograms.
+ *
+ *  Latency_NowUs() reads TIM2, a 32-bit timer left free running at 1 MHz
+ *  (TIMPCLK 16 MHz / 16), so it wraps after ~71 minutes and differences of
+ *  two reads are valid across the wrap. TIM2 is clock-gated in Stop mode:
+ *  use it for intervals that never contain LowPower_Idle() (task bodies,
+ *  bus transactions), the HAL tick for everything else. i2c_bus.h and
+ *  scheduler.h take their I2C_BUS_NOW_US / SCHED_NOW_US defaults from it.
+ *
+ *  A Latency_Hist is a fixed block of LATENCY_BUCKETS counters: bucket 0
+ *  holds 0..1 us, bucket k holds [2^k, 2^(k+1)) us and the last bucket
+ *  everything from 2^(LATENCY_BUCKETS-1) us up. Recording is a count of
+ *  leading zeros and two increments, so it can stay in release builds.
+ *  Modules own their histograms (per task in Scheduler_TaskStats, per
+ *  device in i2c_bus.c); the application prints them with Latency_Print()
+ *  when a report is requested.
+ */
+
+#ifndef INC_LATENCY_H_
+#define INC_LATENCY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(USE_HAL_STUBS)
+#include "hal_stubs.h"
+#else
+#include "stm32g0xx_hal.h"
+#endif
+#include <stdint.h>
+
+#ifndef LATENCY_BUCKETS
+#define LATENCY_BUCKETS    20      /* last bucket starts at 2^19 us = 524 ms */
+#endif
+#define LATENCY_TIMER_HZ   1000000u
+
+typedef struct {
+    uint32_t count;
+    uint32_t max_us;
+    uint32_t bucket[LATENCY_BUCKETS];
+} Latency_Hist;
+
+#if defined(USE_HAL_STUBS)
+/* Provided by the host HAL (virtual clock) */
+uint32_t Latency_NowUs(void);
+#else
+static inline uint32_t Latency_NowUs(void){ return TIM2->CNT; }
+#endif
+
+/* Start TIM2 as the free-running microsecond counter */
+void Latency_Init(void);
+
+void Latency_Record(Latency_Hist *h, uint32_t dt_us);
+void Latency_Reset(Latency_Hist *h);
+
+/* Upper bound (us) of the bucket holding the pct-th percentile sample
+ * (0 if empty). Resolution is the bucket width, i.e. within 2x. */
+uint32_t Latency_Percentile(const Latency_Hist *h, uint8_t pct);
+
+/* One report line:
+ *   [LAT] <kind> <name> n=.. max=..us p50=..us p99=..us b=c0,c1,..
+ * Bucket counts stop at the last non-empty bucket. */
+void Latency_Print(const char *kind, const char *name, const Latency_Hist *h);
+
+/* Report requests, e.g. from a UART / CDC receive handler or a debugger
+ * write. Safe to call from interrupts; the main loop takes the request. */
+void Latency_RequestReport(void);
+uint8_t Latency_TakeReportRequest(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_LATENCY_H_ */
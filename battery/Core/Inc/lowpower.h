@@ -0,0 +1,67 @@
+/*
+ * lowpower.h
+ *
+ *  Tickless idle for the main loop. When no task is due, LowPower_Idle()
+ *  stops SysTick, arms LPTIM1 (LSI / 32 = 1 ms per count) for the time
+ *  until the next scheduled task and enters Stop 1. On wake-up the HAL
+ *  tick is advanced by the LPTIM count actually elapsed, so HAL_GetTick()
+ *  and every tick-based timeout stay consistent.
+ *
+ *  The BQ76907 ALERT (BMS_INTERRUPT), BQ25798 INT (MPPT_BQ_INTERRUPT) and
+ *  the light switch are EXTI inputs (falling edge) and end the sleep early;
+ *  the main loop collects them with LowPower_TakeWakeEvents().
+ *
+ *  Sleeps shorter than LOWPOWER_MIN_STOP_MS use Sleep mode (WFI with
+ *  SysTick running) since the Stop entry/exit cost would not pay off.
+ */
+
+#ifndef INC_LOWPOWER_H_
+#define INC_LOWPOWER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+#include <stdint.h>
+
+#ifndef LOWPOWER_MIN_STOP_MS
+#define LOWPOWER_MIN_STOP_MS   3       /* shorter idles use Sleep mode */
+#endif
+#ifndef LOWPOWER_MAX_STOP_MS
+#define LOWPOWER_MAX_STOP_MS   60000u  /* LPTIM1 ARR is 16 bits at 1 ms */
+#endif
+
+/* Wake event bits (LowPower_TakeWakeEvents) */
+#define LOWPOWER_WAKE_BMS      0x01u   /* BMS_INTERRUPT: BQ76907 ALERT */
+#define LOWPOWER_WAKE_CHARGER  0x02u   /* MPPT_BQ_INTERRUPT: BQ25798 INT */
+#define LOWPOWER_WAKE_SWITCH   0x04u   /* LIGHT_SWITCH */
+
+typedef struct {
+    uint32_t stopEntries;
+    uint32_t sleepEntries;         /* short idles in Sleep mode */
+    uint32_t earlyWakes;           /* Stop ended by EXTI before the LPTIM match */
+    uint32_t stop_ms;              /* total time spent in Stop */
+    uint32_t wakes[3];             /* EXTI events: BMS, charger, switch */
+} LowPower_Stats;
+
+/* LSI + LPTIM1 clocking, EXTI wake-up pins and their NVIC lines */
+void LowPower_Init(void);
+
+/* Idle for at most maxSleep_ms (0 returns at once). Returns the ms spent in Stop. */
+uint32_t LowPower_Idle(uint32_t maxSleep_ms);
+
+/* Wake events since the last call (LOWPOWER_WAKE_* bits), cleared on read */
+uint8_t LowPower_TakeWakeEvents(void);
+
+/* LPTIM1 interrupt (called from TIM6_DAC_LPTIM1_IRQHandler) */
+void LowPower_LptimIRQHandler(void);
+
+const LowPower_Stats *LowPower_GetStats(void);
+void LowPower_LogStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_LOWPOWER_H_ */
@@ -59,6 +59,15 @@ void Error_Handler(void);
 /* Private defines -----------------------------------------------------------*/
 
 /* USER CODE BEGIN Private defines */
+/* EXTI wake-up inputs (TODO_VERIFY against the battery board). The apc250
+ * board routes BMS_INTERRUPT / MPPT_BQ_INTERRUPT to PE7 / PE9, which the
+ * LQFP64 STM32G0B1RE does not have; PB0..PB2 are placeholders. */
+#define BMS_INTERRUPT_Pin GPIO_PIN_0
+#define BMS_INTERRUPT_GPIO_Port GPIOB
+#define MPPT_BQ_INTERRUPT_Pin GPIO_PIN_1
+#define MPPT_BQ_INTERRUPT_GPIO_Port GPIOB
+#define LIGHT_SWITCH_Pin GPIO_PIN_2
+#define LIGHT_SWITCH_GPIO_Port GPIOB
 
 /* USER CODE END Private defines */
 
@@ -0,0 +1,88 @@
+/*
+ * memstats.h
+ *
+ *  RAM headroom: static data, heap and stack watermarks.
+ *
+ *  RAM layout (linker scripts):
+ *
+ *    | .data | .bss | .noinit | heap (_sbrk) ->      <- stack (MSP) |
+ *    ^ RAM start            ^ _end                          _estack ^
+ *
+ *  MemStats_PaintStack fills everything between _end and the current stack
+ *  pointer with a pattern, once, at the top of main() before any interrupt
+ *  is enabled. The stack high-water mark is then the lowest word that no
+ *  longer holds the pattern, found by scanning up from the heap's peak
+ *  (cost proportional to the free space, so only on request). A stack that
+ *  outgrows _Min_Stack_Size is still measured until it meets the heap.
+ *  Interrupts share the MSP and are included.
+ *
+ *  _sbrk (sysmem.c) reports every call through MemStats_NoteSbrk: current
+ *  and peak heap size and refused requests. newlib's printf allocates its
+ *  buffers there on first use.
+ *
+ *  MemStats_RequestReport (console / debugger) asks the main loop to print
+ *  the full "[MEM]" report; MemStats_LogStats is the one-line summary in
+ *  the periodic statistics.
+ */
+
+#ifndef INC_MEMSTATS_H_
+#define INC_MEMSTATS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#define MEMSTATS_PAINT       0xC5C5C5C5u
+#ifndef MEMSTATS_PAINT_GUARD
+#define MEMSTATS_PAINT_GUARD 64u      /* bytes left unpainted below the SP at paint time */
+#endif
+
+/* Addresses from the linker script (host: an emulated RAM block) */
+typedef struct {
+    uintptr_t ramStart;
+    uintptr_t dataEnd;        /* _edata: end of .data */
+    uintptr_t staticEnd;      /* _end: end of .bss / .noinit, heap start */
+    uintptr_t heapLimit;      /* _estack - _Min_Stack_Size: _sbrk's ceiling */
+    uintptr_t stackTop;       /* _estack */
+} MemStats_Layout;
+
+typedef struct {
+    uint32_t heapSize;        /* bytes handed out by _sbrk */
+    uint32_t heapPeak;
+    uint32_t sbrkCalls;
+    uint32_t sbrkFailures;    /* requests refused (ENOMEM) */
+    uint32_t painted;         /* bytes painted at boot (0: not painted) */
+} MemStats_Stats;
+
+/* Paint the free stack area; call first thing in main(), IRQs still off */
+void MemStats_PaintStack(void);
+
+/* Deepest stack use since the paint, bytes below _estack (0: not painted) */
+uint32_t MemStats_StackHighWater(void);
+/* Bytes never touched between the heap peak and the deepest stack */
+uint32_t MemStats_StackFree(void);
+
+/* Called by _sbrk: new heap size in bytes, ok = 0 for a refused request */
+void MemStats_NoteSbrk(uint32_t heapSize, uint8_t ok);
+
+const MemStats_Stats *MemStats_GetStats(void);
+
+/* "[MEM]" one-liner for the periodic statistics */
+void MemStats_LogStats(void);
+/* Full report: static sizes, heap, stack, free RAM */
+void MemStats_Report(void);
+void MemStats_RequestReport(void);
+uint8_t MemStats_TakeReportRequest(void);
+
+/* Port: linker layout and current stack pointer. Target versions in
+ * memstats.c, host ones in host_hal.c. */
+void      MemStats_HwLayout(MemStats_Layout *out);
+uintptr_t MemStats_HwStackPointer(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_MEMSTATS_H_ */
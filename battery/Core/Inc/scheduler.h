@@ -0,0 +1,114 @@
+/*
+ * scheduler.h
+ *
+ *  Cooperative (run-to-completion) task scheduler for the main loop.
+ *
+ *  Tasks live in a static const table owned by the application; the index
+ *  in that table is the task ID. Each entry has a period, a phase offset
+ *  (first release = init tick + phase), a relative deadline and a priority.
+ *  A period of 0 makes the task event-driven: it only runs after
+ *  Scheduler_Release().
+ *
+ *  Scheduler_RunReady(n) runs at most n released tasks per call, lowest
+ *  priority value first, then earliest release. Releases stay on the
+ *  phase + k * period grid; releases missed while the loop was busy are
+ *  counted and dropped instead of being replayed back to back.
+ *
+ *  Tasks flagged SCHED_TASK_I2C generate bus traffic. Scheduler_Init()
+ *  checks that no two of them can ever be released within
+ *  SCHED_I2C_GUARD_MS of each other (phase distance modulo the gcd of the
+ *  periods), and at run time an I2C task is held back until the guard has
+ *  elapsed since the previous one started, so jitter cannot line them up.
+ *
+ *  Per task accounting: runs, execution time (last / max / total, in
+ *  SCHED_NOW_US units), worst release-to-start latency, deadline overruns
+ *  (finished later than release + deadline), missed releases and guard
+ *  deferrals, plus a log2 histogram of the execution time.
+ */
+
+#ifndef INC_SCHEDULER_H_
+#define INC_SCHEDULER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(USE_HAL_STUBS)
+#include "hal_stubs.h"
+#else
+#include "stm32g0xx_hal.h"
+#endif
+#include "latency.h"
+#include <stdint.h>
+
+#ifndef SCHED_MAX_TASKS
+#define SCHED_MAX_TASKS       8
+#endif
+#ifndef SCHED_I2C_GUARD_MS
+#define SCHED_I2C_GUARD_MS    20   /* minimum spacing between two I2C task releases */
+#endif
+/* Microsecond timestamp used for execution time (TIM2, see latency.h) */
+#ifndef SCHED_NOW_US
+#define SCHED_NOW_US()        Latency_NowUs()
+#endif
+
+#define SCHED_TASK_I2C        0x01u   /* task generates I2C traffic */
+#define SCHED_NO_TASK         0xFFu
+
+typedef void (*Scheduler_TaskFn)(void);
+
+typedef struct {
+    const char      *name;
+    Scheduler_TaskFn run;
+    uint32_t         period_ms;    /* 0 = event task (Scheduler_Release) */
+    uint32_t         phase_ms;     /* first release offset from Scheduler_Init */
+    uint32_t         deadline_ms;  /* relative to release; 0 = period */
+    uint8_t          prio;         /* lower value runs first */
+    uint8_t          flags;        /* SCHED_TASK_* */
+} Scheduler_Task;
+
+typedef struct {
+    uint32_t runs;
+    uint32_t overruns;             /* finished after release + deadline */
+    uint32_t missedReleases;       /* releases dropped while still late */
+    uint32_t deferred;             /* passes held back by the I2C guard */
+    uint32_t lastExec_us;
+    uint32_t maxExec_us;
+    uint64_t totalExec_us;
+    uint32_t maxLatency_ms;        /* release -> start */
+    Latency_Hist exec;             /* execution time distribution */
+} Scheduler_TaskStats;
+
+/* Install the task table (kept by reference) and schedule the first releases.
+ * Returns the number of I2C task pairs whose phases violate the guard. */
+uint8_t Scheduler_Init(const Scheduler_Task *table, uint8_t count, uint32_t now_ms);
+
+/* Run at most maxTasks released tasks. Returns how many ran. */
+uint8_t Scheduler_RunReady(uint8_t maxTasks);
+
+/* Make an event task (or a periodic one, early) ready to run */
+void Scheduler_Release(uint8_t id);
+
+/* Change a periodic task's period from its next release on. Keep it a
+ * multiple of the table period so the release grid (and the phase check)
+ * still holds. */
+void Scheduler_SetPeriod(uint8_t id, uint32_t period_ms);
+
+/* Milliseconds until a task can run: 0 if one is ready now, the remaining
+ * guard time for a ready I2C task, else the time to the next periodic
+ * release. 0xFFFFFFFF when nothing is scheduled. Used to size idle sleeps. */
+uint32_t Scheduler_TimeToNext(uint32_t now_ms);
+
+/* ID of the task in progress, SCHED_NO_TASK between tasks (safe from an ISR) */
+uint8_t Scheduler_Running(void);
+
+const Scheduler_TaskStats *Scheduler_GetStats(uint8_t id);   /* NULL if id is out of range */
+const char *Scheduler_TaskName(uint8_t id);                   /* NULL if id is out of range */
+void Scheduler_ResetStats(void);
+void Scheduler_LogStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_SCHEDULER_H_ */
@@ -52,6 +52,9 @@ void SVC_Handler(void);
 void PendSV_Handler(void);
 void SysTick_Handler(void);
 /* USER CODE BEGIN EFP */
+void EXTI0_1_IRQHandler(void);
+void EXTI2_3_IRQHandler(void);
+void TIM6_DAC_LPTIM1_IRQHandler(void);
 
 /* USER CODE END EFP */
 
@@ -0,0 +1,101 @@
+/*
+ * trace.h
+ *
+ *  Binary deferred logging for hot paths. TRACE("fmt", args...) does not
+ *  format anything: the format string is placed in the `trace_fmt` section
+ *  (kept in the ELF, not loaded into flash, see the linker scripts) and
+ *  the call site only stores its offset there, a timestamp and the raw
+ *  32-bit arguments in a RAM ring. Trace_Drain() moves whole records from
+ *  the ring to Trace_Output() from the main loop; Host/trace_decode
+ *  rebuilds the text from the firmware ELF.
+ *
+ *  Record on the wire (little-endian 32-bit words):
+ *    word 0   0xA5 | nargs << 8 | format offset << 16
+ *    word 1   TRACE_NOW() timestamp
+ *    word 2.. arguments
+ *  0xA5 never occurs in ASCII text, so records can share a stream with
+ *  plain printf output; the decoder passes other bytes through.
+ *
+ *  Arguments are integers, 32 bits each (%d %i %u %x %X %o %c, length
+ *  modifiers are ignored). Strings and floats are not supported. The
+ *  compiler still checks every format against its arguments as for printf.
+ *
+ *  Producers may be the main loop or interrupts. Cortex-M0+ has no
+ *  LDREX/STREX, so the ring reservation (two loads, a compare and a store)
+ *  runs with PRIMASK set; the copy of the arguments happens outside it.
+ *  Trace_Drain() must only be called from the main loop. A record that
+ *  does not fit is dropped and counted; the drain reports drops with a
+ *  TRACE_ID_DROPPED record.
+ *
+ *  Build with -DTRACE_TEXT to turn every TRACE() into a printf() line.
+ */
+
+#ifndef INC_TRACE_H_
+#define INC_TRACE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifndef TRACE_RING_WORDS
+#define TRACE_RING_WORDS   256     /* 1 KB, power of two */
+#endif
+#define TRACE_MAX_ARGS     8
+#define TRACE_MAGIC        0xA5u
+#define TRACE_ID_DROPPED   0xFFFFu /* one argument: records dropped since the last report */
+
+/* Record timestamp. Defaults to the HAL millisecond tick. */
+#ifndef TRACE_NOW
+#define TRACE_NOW()        HAL_GetTick()
+#endif
+
+typedef struct {
+    uint32_t records;      /* written */
+    uint32_t dropped;      /* ring full */
+    uint32_t drained;      /* handed to Trace_Output */
+    uint16_t maxUsed;      /* ring high-water mark, words */
+} Trace_Stats;
+
+/* Argument count of a TRACE call, 0..TRACE_MAX_ARGS (9 = too many) */
+#define TRACE_NARGS(...)   TRACE_NARGS_(0, ##__VA_ARGS__, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define TRACE_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, _9, N, ...) N
+
+extern const char __start_trace_fmt[];   /* provided by the linker */
+
+#if defined(TRACE_TEXT)
+#define TRACE(fmt, ...)    printf(fmt "\n", ##__VA_ARGS__)
+#else
+#define TRACE(fmt, ...) do { \
+        static const char trace_fmt_[] __attribute__((section("trace_fmt"), used)) = fmt; \
+        enum { trace_nargs_ = TRACE_NARGS(__VA_ARGS__), \
+               trace_nargs_ok_ = 1 / (trace_nargs_ <= TRACE_MAX_ARGS ? 1u : 0u) }; \
+        if (0) printf(fmt, ##__VA_ARGS__); \
+        Trace_Log((uint16_t)(trace_fmt_ - __start_trace_fmt), trace_nargs_, \
+                  (const uint32_t[]){ 0, ##__VA_ARGS__ } + 1); \
+    } while (0)
+#endif
+
+/* Append one record (use TRACE instead) */
+void Trace_Log(uint16_t id, uint8_t nargs, const uint32_t *args);
+
+/* Hand at most maxRecords whole records to Trace_Output. Returns how many. */
+uint32_t Trace_Drain(uint32_t maxRecords);
+
+/* Words waiting in the ring */
+uint32_t Trace_Pending(void);
+
+/* Byte sink for drained records. Weak default writes to the printf channel
+ * (syscalls.c _write, stdout on the host); override for DMA/UART. */
+void Trace_Output(const uint8_t *data, uint32_t len);
+
+const Trace_Stats *Trace_GetStats(void);
+void Trace_LogStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_TRACE_H_ */
@@ -0,0 +1,133 @@
+/*
+ * watchdog.h
+ *
+ *  Independent watchdog (IWDG) driven by a task supervisor.
+ *
+ *  Scheduler tasks put under supervision (Watchdog_Supervise) check in by
+ *  completing a run: the supervisor watches their run counters and a task
+ *  that has not finished a run within its deadline is starving. The main
+ *  loop checks in through Watchdog_Service. The IWDG is only refreshed
+ *  while every supervised task and the loop itself are on time, so a
+ *  blocked task (e.g. an I2C call stuck in the HAL) or a starved one ends
+ *  in a watchdog reset.
+ *
+ *  The supervision runs from SysTick (Watchdog_TickISR), every
+ *  WATCHDOG_CHECK_MS, so it still runs while the loop is stuck. On the
+ *  first failure it latches and stores a reset record in .noinit RAM:
+ *  which task starved, which task was running, and by how much. The next
+ *  Watchdog_Init reports the record and pushes it as a BM_ERR_TIMEOUT
+ *  entry, so it also reaches the flash fault log.
+ *
+ *  Stop mode: SysTick (and the supervision) is suspended while the IWDG
+ *  keeps counting, so the loop sleeps at most WATCHDOG_MAX_IDLE_MS at a
+ *  time (Watchdog_IdleLimit) and wakes to check in and refresh.
+ *
+ *  Cost in the loop: Watchdog_Service is a store and a compare per pass
+ *  (the IWDG refresh every WATCHDOG_KICK_MS); nothing is added to the task
+ *  path apart from the scheduler noting the running task.
+ */
+
+#ifndef INC_WATCHDOG_H_
+#define INC_WATCHDOG_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(USE_HAL_STUBS)
+#include "hal_stubs.h"
+#else
+#include "stm32g0xx_hal.h"
+#endif
+#include <stdint.h>
+
+#ifndef WATCHDOG_TIMEOUT_MS
+#define WATCHDOG_TIMEOUT_MS    2000u   /* IWDG period, LSI / 32 = 1 ms per count (max 4095) */
+#endif
+#ifndef WATCHDOG_CHECK_MS
+#define WATCHDOG_CHECK_MS      100u    /* supervision period (SysTick) */
+#endif
+#ifndef WATCHDOG_KICK_MS
+#define WATCHDOG_KICK_MS       250u    /* IWDG refresh period while healthy */
+#endif
+#ifndef WATCHDOG_LOOP_MS
+#define WATCHDOG_LOOP_MS       500u    /* main loop check-in deadline */
+#endif
+#ifndef WATCHDOG_MAX_IDLE_MS
+#define WATCHDOG_MAX_IDLE_MS   WATCHDOG_KICK_MS   /* longest tickless idle (Watchdog_IdleLimit) */
+#endif
+#ifndef WATCHDOG_MAX_TASKS
+#define WATCHDOG_MAX_TASKS     8
+#endif
+
+/* The IWDG keeps counting in Stop while SysTick does not: the tick jumps by
+ * the whole sleep on wake-up, and the check that follows must still see the
+ * loop on time and the IWDG not yet expired */
+typedef enum { watchdog_idle_fits = 1 / (WATCHDOG_MAX_IDLE_MS + WATCHDOG_CHECK_MS < WATCHDOG_LOOP_MS &&
+                                         WATCHDOG_MAX_IDLE_MS + WATCHDOG_KICK_MS + WATCHDOG_CHECK_MS < WATCHDOG_TIMEOUT_MS ? 1u : 0u) } Watchdog_IdleCheck;
+typedef enum { watchdog_kick_fits = 1 / (WATCHDOG_KICK_MS + WATCHDOG_CHECK_MS < WATCHDOG_TIMEOUT_MS && WATCHDOG_TIMEOUT_MS <= 4095u ? 1u : 0u) } Watchdog_TimingCheck;
+
+typedef enum {
+    WATCHDOG_OK = 0,
+    WATCHDOG_TASK_LATE,        /* supervised task missed its deadline */
+    WATCHDOG_LOOP_STALL,       /* main loop stopped checking in */
+    WATCHDOG_UNKNOWN           /* IWDG reset without a record (fault handler, ...) */
+} Watchdog_Reason;
+
+/* Kept in .noinit RAM across the reset */
+typedef struct {
+    uint32_t magic;
+    uint32_t tick;             /* HAL tick of the detection */
+    uint32_t late_ms;          /* past the deadline by */
+    uint8_t  reason;           /* Watchdog_Reason */
+    uint8_t  task;             /* starving task (SCHED_NO_TASK for a loop stall) */
+    uint8_t  running;          /* task in progress (SCHED_NO_TASK: between tasks) */
+    uint8_t  resets;           /* watchdog resets since power-up (saturates) */
+    uint32_t check;            /* integrity word over the fields above */
+} Watchdog_ResetRecord;
+
+typedef struct {
+    Watchdog_ResetRecord last; /* cause of the previous reset (reason WATCHDOG_OK: none) */
+    uint32_t kicks;
+    uint32_t checks;
+    uint8_t  tripped;          /* supervision failed, IWDG no longer refreshed */
+} Watchdog_Stats;
+
+/* Collect the previous reset's record, then start the IWDG. Call early;
+ * FaultLog_Init first so the reset is logged to flash. Until the first
+ * Watchdog_Service only the IWDG timeout bounds the boot. */
+void Watchdog_Init(void);
+
+/* Supervise scheduler task id: it must complete a run at least every
+ * deadline_ms. Periodic tasks only (an event task may legitimately idle). */
+void Watchdog_Supervise(uint8_t id, uint32_t deadline_ms);
+
+/* Main loop check-in, once per pass (the first one starts the supervision);
+ * refreshes the IWDG while healthy */
+void Watchdog_Service(uint32_t now_ms);
+
+/* Sleep length for the loop's idle: want_ms capped at WATCHDOG_MAX_IDLE_MS */
+static inline uint32_t Watchdog_IdleLimit(uint32_t want_ms){
+    return want_ms < WATCHDOG_MAX_IDLE_MS ? want_ms : WATCHDOG_MAX_IDLE_MS;
+}
+
+/* SysTick hook: runs Watchdog_Check every WATCHDOG_CHECK_MS */
+void Watchdog_TickISR(void);
+/* Supervision pass; latches and writes the reset record on the first failure */
+void Watchdog_Check(uint32_t now_ms);
+
+const Watchdog_Stats *Watchdog_GetStats(void);
+/* "[WDG]" line: previous reset cause, kicks, supervised tasks */
+void Watchdog_LogStats(void);
+
+/* IWDG access. Target versions in watchdog.c, host ones in host_hal.c.
+ * TookReset reports (and clears) an IWDG reset flag. */
+void    Watchdog_HwStart(uint32_t timeout_ms);
+void    Watchdog_HwKick(void);
+uint8_t Watchdog_HwTookReset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_WATCHDOG_H_ */
@@ -0,0 +1,134 @@
+/*
+ * bm_errors.c
+ *
+ *  Error rings and aggregate counters (see bm_errors.h).
+ */
+#if defined(USE_HAL_STUBS)
+#include "hal_stubs.h"
+#define BM_LOCK()     uint32_t bm_pm_ = 0
+#define BM_UNLOCK()   (void)bm_pm_
+#else
+#include "stm32g0xx_hal.h"
+#define BM_LOCK()     uint32_t bm_pm_ = __get_PRIMASK(); __disable_irq()
+#define BM_UNLOCK()   __set_PRIMASK(bm_pm_)
+#endif
+#include "bm_errors.h"
+#include <stdio.h>
+#include <string.h>
+
+#define W BM_ERROR_RATE_WINDOW_MS
+
+typedef enum { bm_ring_pow2 = 1 / ((BM_ERROR_LOG_DEPTH & (BM_ERROR_LOG_DEPTH - 1)) == 0 ? 1u : 0u) } BM_RingCheck;
+
+/* Fixed-window counts per source: rate = current + the overlapping part of the previous */
+typedef struct {
+    uint32_t windowStart;
+    uint32_t cur, prev;
+} BM_RateWindow;
+
+static BM_ErrorCounters counters;
+static BM_RateWindow rate[BM_SRC_COUNT];
+
+static inline void satInc(uint16_t *c){
+    if (*c != 0xFFFFu) (*c)++;
+}
+
+static uint8_t codeIndex(int8_t code){
+    return (code <= 0 && code > -BM_ERR_CODE_COUNT) ? (uint8_t)(-code) : (uint8_t)(-BM_ERR_UNKNOWN);
+}
+
+static void rateRoll(BM_RateWindow *r, uint32_t now){
+    uint32_t elapsed = now - r->windowStart;
+    if (elapsed < W) return;
+    r->prev = elapsed < 2u * W ? r->cur : 0;
+    r->cur = 0;
+    r->windowStart += (elapsed / W) * W;
+}
+
+void BM_ErrorPush(BM_ErrorRing *ring, uint8_t src, int8_t code, uint8_t detail, uint8_t reg, uint16_t value){
+    uint32_t now = BM_GET_TICK();
+    uint8_t s = src < BM_SRC_COUNT ? src : (uint8_t)BM_SRC_GENERIC;
+    uint32_t at = 0;
+    {
+        BM_LOCK();
+        if (ring){
+            at = ring->head++;
+            ring->seq[at & (BM_ERROR_LOG_DEPTH - 1u)] = 0;   /* slot in flux */
+            ring->lastError = code;
+        }
+        satInc(&counters.bySource[s]);
+        satInc(&counters.byCode[codeIndex(code)]);
+        satInc(&counters.byReg[s][reg]);
+        rateRoll(&rate[s], now);
+        rate[s].cur++;
+        BM_UNLOCK();
+    }
+    BM_ErrorEntry e = { .tick = now, .code = code, .detail = detail, .source = src, .reg = reg, .value = value };
+    if (ring){
+        uint32_t i = at & (BM_ERROR_LOG_DEPTH - 1u);
+        ring->entry[i] = e;
+        ring->seq[i] = at + 1u;                          /* publish */
+    }
+    FaultLog_Enqueue(&e);
+}
+
+uint8_t BM_ErrorRead(const BM_ErrorRing *ring, uint32_t n, BM_ErrorEntry *out){
+    uint32_t head = ring->head;
+    if (n >= BM_ERROR_LOG_DEPTH || n >= head) return 0;
+    uint32_t at = head - 1u - n;
+    uint32_t i = at & (BM_ERROR_LOG_DEPTH - 1u);
+    if (ring->seq[i] != at + 1u) return 0;
+    *out = ring->entry[i];
+    return ring->seq[i] == at + 1u;                      /* not overwritten meanwhile */
+}
+
+uint32_t BM_ErrorRingCount(const BM_ErrorRing *ring){
+    uint32_t head = ring->head;
+    return head < BM_ERROR_LOG_DEPTH ? head : BM_ERROR_LOG_DEPTH;
+}
+
+uint16_t BM_ErrorCountBySource(uint8_t src){
+    return src < BM_SRC_COUNT ? counters.bySource[src] : 0;
+}
+
+uint16_t BM_ErrorCountByCode(int8_t code){
+    return counters.byCode[codeIndex(code)];
+}
+
+uint16_t BM_ErrorCountByReg(uint8_t src, uint8_t reg){
+    return src < BM_SRC_COUNT ? counters.byReg[src][reg] : 0;
+}
+
+uint32_t BM_ErrorRate(uint8_t src, uint32_t now_ms){
+    if (src >= BM_SRC_COUNT) return 0;
+    BM_RateWindow r = rate[src];
+    uint32_t elapsed = now_ms - r.windowStart;
+    if (elapsed >= 2u * W) return 0;
+    if (elapsed >= W){                                   /* cur is already the previous window */
+        r.prev = r.cur;
+        r.cur = 0;
+        elapsed -= W;
+    }
+    return r.cur + (uint32_t)(((uint64_t)r.prev * (W - elapsed)) / W);
+}
+
+const BM_ErrorCounters *BM_ErrorGetCounters(void){
+    return &counters;
+}
+
+void BM_ErrorResetCounters(void){
+    BM_LOCK();
+    memset(&counters, 0, sizeof(counters));
+    memset(rate, 0, sizeof(rate));
+    BM_UNLOCK();
+}
+
+void BM_ErrorLogStats(void){
+    uint32_t now = BM_GET_TICK();
+    printf("[ERR] generic=%u bq25798=%u bq76907=%u (last %lus: %lu/%lu/%lu) i2c=%u timeout=%u\n",
+        (unsigned)counters.bySource[BM_SRC_GENERIC], (unsigned)counters.bySource[BM_SRC_BQ25798],
+        (unsigned)counters.bySource[BM_SRC_BQ76907], (unsigned long)(W / 1000u),
+        (unsigned long)BM_ErrorRate(BM_SRC_GENERIC, now), (unsigned long)BM_ErrorRate(BM_SRC_BQ25798, now),
+        (unsigned long)BM_ErrorRate(BM_SRC_BQ76907, now),
+        (unsigned)BM_ErrorCountByCode(BM_ERR_I2C), (unsigned)BM_ErrorCountByCode(BM_ERR_TIMEOUT));
+}
@@ -0,0 +1,201 @@
+/*
+ * boot.c
+ *
+ *  Boot sequencer and boot phase timing (see boot.h).
+ */
+#include "boot.h"
+#include "bm_errors.h"
+#include "latency.h"
+#include <stdio.h>
+#include <string.h>
+
+static uint32_t refMs, refUs;
+static uint32_t phaseUs[BOOT_PHASE_COUNT];
+static uint8_t  phaseReached;             /* bit per Boot_Phase */
+static Boot_Device *devices;
+static uint8_t  deviceCount;
+
+uint32_t Boot_Hash(const uint8_t *data, uint32_t len){
+    uint32_t h = 2166136261u;
+    while (len--){
+        h ^= *data++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+void Boot_Begin(void){
+    refMs = HAL_GetTick();
+    refUs = Latency_NowUs();
+    phaseReached = 0;
+    Boot_Mark(BOOT_PHASE_START);
+}
+
+uint32_t Boot_NowUs(void){
+    return refMs * 1000u + (Latency_NowUs() - refUs);
+}
+
+void Boot_Mark(Boot_Phase phase){
+    if (phase >= BOOT_PHASE_COUNT || (phaseReached & (1u << phase))) return;
+    phaseUs[phase] = Boot_NowUs();
+    phaseReached |= (uint8_t)(1u << phase);
+}
+
+uint32_t Boot_PhaseUs(Boot_Phase phase){
+    return (phase < BOOT_PHASE_COUNT && (phaseReached & (1u << phase))) ? phaseUs[phase] : 0;
+}
+
+/* ================= Bus completions ================= */
+static void probeDone(void *ctx, uint8_t reg, const uint8_t *data, uint8_t len, HAL_StatusTypeDef st){
+    Boot_Device *d = (Boot_Device *)ctx;
+    const Boot_DeviceDesc *desc = d->desc;
+    d->inFlight--;
+    if (st != HAL_OK){
+        d->errors++;
+        BM_ErrorPush(0, desc->source, BM_ERR_I2C, (uint8_t)st, reg, 0);
+        return;
+    }
+    if (desc->cfgLen && reg >= desc->cfgReg && reg < desc->cfgReg + desc->cfgLen){
+        memcpy(&d->readback[reg - desc->cfgReg], data, len);
+    } else {
+        d->idRaw = data[0];
+    }
+}
+
+static void writeDone(void *ctx, uint8_t reg, const uint8_t *data, uint8_t len, HAL_StatusTypeDef st){
+    Boot_Device *d = (Boot_Device *)ctx;
+    (void)data; (void)len;
+    d->inFlight--;
+    if (st != HAL_OK){
+        d->errors++;
+        BM_ErrorPush(0, d->desc->source, BM_ERR_I2C, (uint8_t)st, reg, 0);
+    }
+}
+
+static uint8_t queueRoom(void){
+    return (uint8_t)(I2C_BUS_QUEUE_DEPTH - I2CBus_Pending(I2C_BUS_ANY_DEVICE));
+}
+
+/* Identity read plus the readback window in I2C_BUS_MAX_XFER pieces (adjacent,
+ * so the bus merges them into one burst); all or nothing */
+static uint8_t queueProbe(Boot_Device *d){
+    const Boot_DeviceDesc *desc = d->desc;
+    uint8_t pieces = (uint8_t)((desc->cfgLen + I2C_BUS_MAX_XFER - 1u) / I2C_BUS_MAX_XFER);
+    if (queueRoom() < 1u + pieces) return 0;
+    I2CBus_Request r = { .devAddress = desc->devAddress, .reg = desc->idReg, .len = 1,
+                         .prio = desc->prio, .done = probeDone, .ctx = d };
+    if (I2CBus_Submit(&r) == HAL_OK) d->inFlight++;
+    for (uint8_t off = 0; off < desc->cfgLen; off = (uint8_t)(off + r.len)){
+        r.reg = (uint8_t)(desc->cfgReg + off);
+        r.len = (uint8_t)(desc->cfgLen - off < I2C_BUS_MAX_XFER ? desc->cfgLen - off : I2C_BUS_MAX_XFER);
+        if (I2CBus_Submit(&r) == HAL_OK) d->inFlight++;
+    }
+    return 1;
+}
+
+static void finish(Boot_Device *d, uint8_t state){
+    d->state = state;
+    d->ready_us = Boot_NowUs();
+}
+
+/* Identity and readback in: decide between FAILED, READY (config already in
+ * place) and CONFIG */
+static void probed(Boot_Device *d){
+    const Boot_DeviceDesc *desc = d->desc;
+    d->probed_us = Boot_NowUs();
+    if (d->errors){
+        finish(d, BOOT_DEV_FAILED);
+        return;
+    }
+    if (desc->idValid && !desc->idValid(d->idRaw)){
+        BM_ErrorPush(0, desc->source, BM_ERR_ID_MISMATCH, 0, desc->idReg, d->idRaw);
+        finish(d, BOOT_DEV_FAILED);
+        return;
+    }
+    if (desc->cfgLen){
+        d->cfgHash = Boot_Hash(d->readback, desc->cfgLen);
+        /* The bytes decide: a hash collision must not leave a threshold unwritten */
+        if (d->cfgHash == Boot_Hash(desc->cfgImage, desc->cfgLen) &&
+            memcmp(d->readback, desc->cfgImage, desc->cfgLen) == 0){
+            d->configSkipped = 1;
+            finish(d, BOOT_DEV_READY);
+            return;
+        }
+    }
+    d->state = BOOT_DEV_CONFIG;
+}
+
+/* Keep up to BOOT_WRITE_WINDOW script writes queued; stop at the first failure */
+static void configure(Boot_Device *d){
+    const Boot_DeviceDesc *desc = d->desc;
+    while (!d->errors && d->next < desc->scriptLen && d->inFlight < BOOT_WRITE_WINDOW && queueRoom()){
+        const BQ_RegWrite *w = &desc->script[d->next];
+        I2CBus_Request r = { .devAddress = desc->devAddress, .reg = w->reg, .len = w->len, .write = 1,
+                             .prio = desc->prio, .txData = w->data, .done = writeDone, .ctx = d };
+        if (I2CBus_Submit(&r) != HAL_OK) break;
+        d->inFlight++;
+        d->next++;
+    }
+    if (d->inFlight == 0 && (d->errors || d->next >= desc->scriptLen)){
+        finish(d, d->errors ? BOOT_DEV_FAILED : BOOT_DEV_READY);
+    }
+}
+
+void Boot_Start(Boot_Device *devs, uint8_t count){
+    devices = devs;
+    deviceCount = count < BOOT_MAX_DEVICES ? count : BOOT_MAX_DEVICES;
+    for (uint8_t i = 0; i < deviceCount; i++){
+        const Boot_DeviceDesc *desc = devs[i].desc;
+        memset(&devs[i], 0, sizeof(devs[i]));
+        devs[i].desc = desc;
+        if (desc->cfgLen > BOOT_MAX_CFG_LEN){
+            finish(&devs[i], BOOT_DEV_FAILED);
+            continue;
+        }
+        devs[i].state = BOOT_DEV_PROBE;
+        devs[i].queued = queueProbe(&devs[i]);
+    }
+}
+
+uint8_t Boot_Service(void){
+    uint8_t running = 0;
+    for (uint8_t i = 0; i < deviceCount; i++){
+        Boot_Device *d = &devices[i];
+        if (d->state == BOOT_DEV_PROBE){
+            if (!d->queued) d->queued = queueProbe(d);
+            if (d->queued && d->inFlight == 0) probed(d);
+        }
+        if (d->state == BOOT_DEV_CONFIG) configure(d);
+        if (d->state == BOOT_DEV_PROBE || d->state == BOOT_DEV_CONFIG) running++;
+    }
+    if (!running) Boot_Mark(BOOT_PHASE_DEVICES);
+    return running;
+}
+
+static const char *stateName(uint8_t s){
+    switch (s){
+    case BOOT_DEV_PROBE:  return "PROBE";
+    case BOOT_DEV_CONFIG: return "CONFIG";
+    case BOOT_DEV_READY:  return "READY";
+    case BOOT_DEV_FAILED: return "FAILED";
+    default:              return "IDLE";
+    }
+}
+
+void Boot_LogTimings(void){
+    static const char *const names[BOOT_PHASE_COUNT] = { "start", "devices", "protected", "running" };
+    printf("[BOOT]");
+    for (uint8_t p = 0; p < BOOT_PHASE_COUNT; p++){
+        if (phaseReached & (1u << p)) printf(" %s=%luus", names[p], (unsigned long)phaseUs[p]);
+        else printf(" %s=-", names[p]);
+    }
+    printf("\n");
+    for (uint8_t i = 0; i < deviceCount; i++){
+        const Boot_Device *d = &devices[i];
+        printf("[BOOT] %-8s %-6s id=0x%02X probe=%luus ready=%luus cfg=%s hash=0x%08lX writes=%u errors=%u\n",
+            d->desc->name, stateName(d->state), (unsigned)d->idRaw,
+            (unsigned long)d->probed_us, (unsigned long)d->ready_us,
+            d->configSkipped ? "kept" : (d->next ? "written" : "-"),
+            (unsigned long)d->cfgHash, (unsigned)d->next, (unsigned)d->errors);
+    }
+}
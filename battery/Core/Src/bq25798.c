@@ -6,7 +6,9 @@
  */
 #include "bq25798.h"
 #include "stm32g0xx_hal.h" /* Ensure HAL declarations visible here */
+#include "i2c_bus.h"
 #include <stdint.h>
+#include <stddef.h>
 
 uint8_t  BQ25798_init(BQ25798 *device, I2C_HandleTypeDef *i2cHandle){
 	device->i2cHandle = i2cHandle;
@@ -17,42 +19,72 @@ uint8_t  BQ25798_init(BQ25798 *device, I2C_HandleTypeDef *i2cHandle){
 		return 255; /* legacy error code path; consider replacing with enum everywhere */
 	}
 
+	/* Configuration writes; like before, a failed write does not fail init */
+	BQ_RegWrite script[BQ25798_INIT_SCRIPT_LEN];
+	uint8_t n = BQ25798_initScript(NULL, script);
+	for (uint8_t i = 0; i < n; i++){
+		if (script[i].len == 1) BQ25798_WriteRegister(device, script[i].reg, script[i].data);
+		else BQ25798_Write16(device, script[i].reg, (uint16_t)((script[i].data[0] << 8) | script[i].data[1]));
+	}
+	return 0;
+}
+
+static BQ_RegWrite write8(uint8_t reg, uint8_t v){
+	BQ_RegWrite w = { reg, 1, { v, 0 } };
+	return w;
+}
+
+static BQ_RegWrite write16(uint8_t msbReg, uint16_t v){
+	BQ_RegWrite w = { msbReg, 2, { (uint8_t)(v >> 8), (uint8_t)(v & 0xFF) } };
+	return w;
+}
+
+static uint16_t clamp16(uint16_t v, uint16_t lo, uint16_t hi){
+	return v < lo ? lo : (v > hi ? hi : v);
+}
+
+void BQ25798_clampLimits(const BQ25798_ChargeLimits *in, BQ25798_ChargeLimits *out){
+	out->chargeVoltage_mV = clamp16(in->chargeVoltage_mV, BQ25798_VREG_MIN_mV, BQ25798_VREG_MAX_mV);
+	out->chargeCurrent_mA = clamp16(in->chargeCurrent_mA, BQ25798_ICHG_MIN_mA, BQ25798_ICHG_MAX_mA);
+	out->inputVoltage_mV  = clamp16(in->inputVoltage_mV,  BQ25798_VINDPM_MIN_mV, BQ25798_VINDPM_MAX_mV);
+	out->inputCurrent_mA  = clamp16(in->inputCurrent_mA,  BQ25798_IINDPM_MIN_mA, BQ25798_IINDPM_MAX_mA);
+}
+
+/* Register writes of BQ25798_init, in order (also queued by the boot sequencer).
+ * The limits usually come from a stored profile, so they are clamped first. */
+uint8_t BQ25798_initScript(const BQ25798_ChargeLimits *limits, BQ_RegWrite *out){
+	static const BQ25798_ChargeLimits defaults = BQ25798_DEFAULT_LIMITS;
+	BQ25798_ChargeLimits clamped;
+	BQ25798_clampLimits(limits ? limits : &defaults, &clamped);
+	const BQ25798_ChargeLimits *lim = &clamped;
+	uint8_t n = 0;
 	/* Configuration writes (placeholders; TODO: replace magic values with masks) */
-	uint8_t reg;
-	reg = 0xD1; /* Recharge control: 4S, 256ms deglitch, 100mV below VREG (verify decomposition) */
-	BQ25798_WriteRegister(device, BQ25798_REG_RECHARGE_CTRL, &reg);
-	reg = 0x10; /* Charger Ctrl 1: disable watchdog, host mode, I2C watchdog reset (verify bits) */
-	BQ25798_WriteRegister(device, BQ25798_REG_CHARGER_CTRL_1, &reg);
+	/* Recharge control: 4S, 256ms deglitch, 100mV below VREG (verify decomposition) */
+	out[n++] = write8(BQ25798_REG_RECHARGE_CTRL, 0xD1);
+	/* Charger Ctrl 1: disable watchdog, host mode, I2C watchdog reset (verify bits) */
+	out[n++] = write8(BQ25798_REG_CHARGER_CTRL_1, 0x10);
 
 	/* Voltage / current limit setters using scaling helpers */
 	/* VSYSMIN left as previously set (complex mapping TBD). Keep existing raw 0x70 placeholder. */
-	uint8_t vsys_min = 0x70; /* TODO_VERIFY: derive proper encode for VSYSMIN */
-	BQ25798_WriteRegister(device, BQ25798_REG_MIN_SYS_VOLTAGE, &vsys_min);
+	out[n++] = write8(BQ25798_REG_MIN_SYS_VOLTAGE, 0x70); /* TODO_VERIFY: derive proper encode for VSYSMIN */
 
-	/* Charge voltage: 14600 mV -> raw 1460 (0x05B4) */
-	uint16_t vreg_raw = BQ25798_encodeChargeVoltage_mV(14600);
-	BQ25798_Write16(device, BQ25798_REG_CHARGE_VOLTAGE_LIMIT, vreg_raw);
+	/* Charge voltage: default 14600 mV -> raw 1460 (0x05B4) */
+	out[n++] = write16(BQ25798_REG_CHARGE_VOLTAGE_LIMIT, BQ25798_encodeChargeVoltage_mV(lim->chargeVoltage_mV));
 
-	/* Charge current: choose 5000 mA (raw 500 = 0x01F4); correcting earlier probable typo 0x03F4 */
-	uint16_t ichg_raw = BQ25798_encodeChargeCurrent_mA(5000);
-	BQ25798_Write16(device, BQ25798_REG_CHARGE_CURRENT_LIMIT, ichg_raw);
+	/* Charge current: default 5000 mA (raw 500 = 0x01F4); correcting earlier probable typo 0x03F4 */
+	out[n++] = write16(BQ25798_REG_CHARGE_CURRENT_LIMIT, BQ25798_encodeChargeCurrent_mA(lim->chargeCurrent_mA));
 
-	/* Input voltage limit: 3600 mV -> 0x24 */
-	uint8_t vindpm = BQ25798_encodeInputVoltageLimit_mV(3600);
-	BQ25798_WriteRegister(device, BQ25798_REG_INPUT_VOLTAGE_LIMIT, &vindpm);
+	/* Input voltage limit: default 3600 mV -> 0x24 */
+	out[n++] = write8(BQ25798_REG_INPUT_VOLTAGE_LIMIT, BQ25798_encodeInputVoltageLimit_mV(lim->inputVoltage_mV));
 
-	/* Input current limit: 3300 mA -> raw 330 (0x014A) */
-	uint16_t iin_raw = BQ25798_encodeInputCurrent_mA(3300);
-	BQ25798_Write16(device, BQ25798_REG_INPUT_CURRENT_LIMIT, iin_raw);
+	/* Input current limit: default 3300 mA -> raw 330 (0x014A) */
+	out[n++] = write16(BQ25798_REG_INPUT_CURRENT_LIMIT, BQ25798_encodeInputCurrent_mA(lim->inputCurrent_mA));
 
-	uint8_t prechg = 0x03; /* precharge current config placeholder */
-	BQ25798_WriteRegister(device, BQ25798_REG_PRECHARGE_CTRL, &prechg);
+	out[n++] = write8(BQ25798_REG_PRECHARGE_CTRL, 0x03); /* precharge current config placeholder */
 
-	reg = 0x8C; /* Charger Ctrl 0: enable charger etc. */
-	BQ25798_WriteRegister(device, BQ25798_REG_CHARGER_CTRL_0, &reg);
-	reg = 0x80; /* ADC control: all ADCs on */
-	BQ25798_WriteRegister(device, BQ25798_REG_ADC_CTRL, &reg);
-	return 0;
+	out[n++] = write8(BQ25798_REG_CHARGER_CTRL_0, 0x8C); /* Charger Ctrl 0: enable charger etc. */
+	out[n++] = write8(BQ25798_REG_ADC_CTRL, 0x80);       /* ADC control: all ADCs on */
+	return n;
 }
 
 /* ================= Part Info & Helpers ================= */
@@ -64,14 +96,19 @@ void BQ25798_decodePartInfo(uint8_t raw, BQ25798_PartInfo *out){
 	out->rev      = (raw & BQ25798_PART_INFO_REV_MASK);
 }
 
+uint8_t BQ25798_partInfoValid(uint8_t raw){
+	BQ25798_PartInfo tmp; BQ25798_decodePartInfo(raw, &tmp);
+	/* Validation strategy: accept if either legacy 3-bit matches AND rev matches, OR 5-bit matches (once verified). */
+	int legacy_ok = (tmp.part3bit == BQ25798_PART_NUM_VAL) && (tmp.rev == BQ25798_DEV_REV_VAL);
+	int full_ok   = (tmp.part5bit == BQ25798_EXPECTED_PARTNUM_5BIT) && (tmp.rev == BQ25798_EXPECTED_REVISION);
+	return (uint8_t)(legacy_ok || full_ok);
+}
+
 BQ25798_Result BQ25798_confirmPart(BQ25798 *device, BQ25798_PartInfo *infoOut){
 	uint8_t v;
 	if (BQ25798_ReadRegister(device, BQ25798_REG_PART_INFO, &v) != HAL_OK) return BQ25798_ERR_I2C;
 	BQ25798_PartInfo tmp; BQ25798_decodePartInfo(v, &tmp);
-	/* Validation strategy: accept if either legacy 3-bit matches AND rev matches, OR 5-bit matches (once verified). */
-	int legacy_ok = (tmp.part3bit == BQ25798_PART_NUM_VAL) && (tmp.rev == BQ25798_DEV_REV_VAL);
-	int full_ok   = (tmp.part5bit == BQ25798_EXPECTED_PARTNUM_5BIT) && (tmp.rev == BQ25798_EXPECTED_REVISION);
-	if (!(legacy_ok || full_ok)) {
+	if (!BQ25798_partInfoValid(v)) {
 		if (infoOut) *infoOut = tmp; /* still return captured info for diagnostics */
 		return BQ25798_ERR_ID_MISMATCH;
 	}
@@ -91,154 +128,102 @@ int BQ25798_confirmPart_Legacy(BQ25798 *device, uint8_t *rawVal, uint8_t *partNu
 /* ================= 16-bit Access Helpers ================= */
 HAL_StatusTypeDef BQ25798_Write16(BQ25798 *device, uint8_t msbReg, uint16_t value){
 	uint8_t buf[2] = { (uint8_t)(value >> 8), (uint8_t)(value & 0xFF) };
-	return HAL_I2C_Mem_Write(device->i2cHandle, BQ25798_I2C_ADDRESS, msbReg, I2C_MEMADD_SIZE_8BIT, buf, 2, HAL_MAX_DELAY);
+	return I2CBus_MemWrite(device->i2cHandle, BQ25798_I2C_ADDRESS, msbReg, buf, 2);
 }
 HAL_StatusTypeDef BQ25798_Read16(BQ25798 *device, uint8_t msbReg, uint16_t *value){
 	uint8_t buf[2];
-	HAL_StatusTypeDef st = HAL_I2C_Mem_Read(device->i2cHandle, BQ25798_I2C_ADDRESS, msbReg, I2C_MEMADD_SIZE_8BIT, buf, 2, HAL_MAX_DELAY);
+	HAL_StatusTypeDef st = I2CBus_MemRead(device->i2cHandle, BQ25798_I2C_ADDRESS, msbReg, buf, 2);
 	if (st == HAL_OK && value){ *value = (uint16_t)(buf[0] << 8 | buf[1]); }
 	return st;
 }
 
-// Read and interpret REG1B_Charger_Status_0
-HAL_StatusTypeDef readChargerStatus0(BQ25798 *device, uint8_t *status){
-    HAL_StatusTypeDef ret_val = BQ25798_ReadRegister(device, BQ25798_REG_CHARGER_STATUS_0, status);
-    if (ret_val == HAL_OK) {
-        device->chargerStatus0.iindpm_stat       = (*status >> 7) & 0x01;
-        device->chargerStatus0.vindpm_stat       = (*status >> 6) & 0x01;
-        device->chargerStatus0.wd_stat           = (*status >> 5) & 0x01;
-        device->chargerStatus0.pg_stat           = (*status >> 3) & 0x01;
-        device->chargerStatus0.ac2_present_stat  = (*status >> 2) & 0x01;
-        device->chargerStatus0.ac1_present_stat  = (*status >> 1) & 0x01;
-        device->chargerStatus0.vbus_present_stat = (*status >> 0) & 0x01;
-    }
-    return ret_val;
-}
-
-// Read and interpret REG1C_Charger_Status_1
-HAL_StatusTypeDef readChargerStatus1(BQ25798 *device, uint8_t *status){
-    HAL_StatusTypeDef ret_val = BQ25798_ReadRegister(device, BQ25798_REG_CHARGER_STATUS_1, status);
-    if (ret_val == HAL_OK) {
-        device->chargerStatus1.chg_stat        = (*status >> 5) & 0x07;
-        device->chargerStatus1.vbus_stat       = (*status >> 1) & 0x0F;
-        device->chargerStatus1.bc12_done_stat  = (*status >> 0) & 0x01;
-    }
-    return ret_val;
-}
-
-// Read and interpret REG1D_Charger_Status_2
-HAL_StatusTypeDef readChargerStatus2(BQ25798 *device, uint8_t *status){
-    HAL_StatusTypeDef ret_val = BQ25798_ReadRegister(device, BQ25798_REG_CHARGER_STATUS_2, status);
-    if (ret_val == HAL_OK) {
-        device->chargerStatus2.ico_stat          = (*status >> 6) & 0x03;
-        device->chargerStatus2.treg_stat         = (*status >> 2) & 0x01;
-        device->chargerStatus2.dpdm_stat         = (*status >> 1) & 0x01;
-        device->chargerStatus2.vbat_present_stat = (*status >> 0) & 0x01;
-    }
-    return ret_val;
-}
-
-// Read and interpret REG1E_Charger_Status_3
-HAL_StatusTypeDef readChargerStatus3(BQ25798 *device, uint8_t *status){
-    HAL_StatusTypeDef ret_val = BQ25798_ReadRegister(device, BQ25798_REG_CHARGER_STATUS_3, status);
-    if (ret_val == HAL_OK) {
-        device->chargerStatus3.acrb2_stat      = (*status >> 7) & 0x01;
-        device->chargerStatus3.acrb1_stat      = (*status >> 6) & 0x01;
-        device->chargerStatus3.adc_done_stat   = (*status >> 5) & 0x01;
-        device->chargerStatus3.vsys_stat       = (*status >> 4) & 0x01;
-        device->chargerStatus3.chg_tmr_stat    = (*status >> 3) & 0x01;
-        device->chargerStatus3.trichg_tmr_stat = (*status >> 2) & 0x01;
-        device->chargerStatus3.prechg_tmr_stat = (*status >> 1) & 0x01;
-    }
-    return ret_val;
+/* ================= Register map (generated from bq25798_regmap.h) ================= */
+/* Compile-time checks: fields inside 8 bits and no two fields overlapping */
+#define BQ25798_GEN_FIELD_CHECKS(ID, access, member, Type) \
+	bq_static_assert_##ID##_fields_in_range = 1 / ((1 BQ25798_##ID##_FIELDS(BQ_FIELD_RANGE_OK, _)) ? 1u : 0u), \
+	bq_static_assert_##ID##_fields_disjoint = 1 / (((0u BQ25798_##ID##_FIELDS(BQ_FIELD_MASK_OR, _)) == \
+	                                                (0u BQ25798_##ID##_FIELDS(BQ_FIELD_MASK_SUM, _))) ? 1u : 0u),
+#if !defined(BQ25798_NO_STATIC_ASSERTS)
+enum { BQ25798_FIELD_REGS(BQ25798_GEN_FIELD_CHECKS) };
+#endif
+
+/* Flash-resident descriptors: drive decode, encode, printing and snapshots */
+#define BQ25798_GEN_FIELD_DESC(ID, access, member, Type) \
+	static const BQ_FieldDesc fields_##ID[] = { BQ25798_##ID##_FIELDS(BQ_FIELD_DESC, _) };
+BQ25798_FIELD_REGS(BQ25798_GEN_FIELD_DESC)
+
+#define BQ25798_FIELD_REG_DESC(ID, access, member, Type) \
+	{ #ID BQ25798_##ID##_FIELDS(BQ_FIELD_NAME, _), fields_##ID, NULL, (uint16_t)offsetof(BQ25798, member), \
+	  BQ25798_REG_##ID, 1, access, 0, (uint8_t)(sizeof(fields_##ID) / sizeof(fields_##ID[0])) },
+#define BQ25798_VALUE_REG_DESC(ID, access, member, unit, flags, scale) \
+	{ #ID "\0" unit, NULL, scale, (uint16_t)offsetof(BQ25798, member), BQ25798_REG_##ID, 2, access, flags, 0 },
+const BQ_RegDesc BQ25798_regDesc[] = {
+	BQ25798_FIELD_REGS(BQ25798_FIELD_REG_DESC)
+	BQ25798_VALUE_REGS(BQ25798_VALUE_REG_DESC)
+};
+const uint8_t BQ25798_regDescCount = (uint8_t)(sizeof(BQ25798_regDesc) / sizeof(BQ25798_regDesc[0]));
+
+/* Decode a block of consecutive registers read from firstReg. Used by the
+ * blocking readers below and by the queued bus refresh. */
+void BQ25798_decodeRegisters(BQ25798 *device, uint8_t firstReg, const uint8_t *data, uint8_t len){
+	BQ_RegDesc_decode(device, BQ25798_regDesc, BQ25798_regDescCount, firstReg, data, len);
 }
 
-// Read and interpret REG1F_Charger_Status_4
-HAL_StatusTypeDef readChargerStatus4(BQ25798 *device, uint8_t *status){
-    HAL_StatusTypeDef ret_val = BQ25798_ReadRegister(device, BQ25798_REG_CHARGER_STATUS_4, status);
-    if (ret_val == HAL_OK) {
-        device->chargerStatus4.vbatotg_low_stat = (*status >> 4) & 0x01;
-        device->chargerStatus4.ts_cold_stat     = (*status >> 3) & 0x01;
-        device->chargerStatus4.ts_cool_stat     = (*status >> 2) & 0x01;
-        device->chargerStatus4.ts_warm_stat     = (*status >> 1) & 0x01;
-        device->chargerStatus4.ts_hot_stat      = (*status >> 0) & 0x01;
-    }
-    return ret_val;
+/* Pack the decoded fields of one bit-field register back into its raw value */
+uint8_t BQ25798_encodeRegister(const BQ25798 *device, uint8_t reg){
+	for (uint8_t r = 0; r < BQ25798_regDescCount; r++){
+		if (BQ25798_regDesc[r].addr == reg && BQ25798_regDesc[r].fields) return BQ_RegDesc_encode(device, &BQ25798_regDesc[r]);
+	}
+	return 0;
 }
 
-// Read and interpret REG20_FAULT_Status_0
-HAL_StatusTypeDef readFaultStatus0(BQ25798 *device, uint8_t *status){
-    HAL_StatusTypeDef ret_val = BQ25798_ReadRegister(device, BQ25798_REG_FAULT_STATUS_0, status);
-    if (ret_val == HAL_OK) {
-        device->faultStatus0.ibat_reg_stat  = (*status >> 7) & 0x01;
-        device->faultStatus0.vbus_ovp_stat  = (*status >> 6) & 0x01;
-        device->faultStatus0.vbat_ovp_stat  = (*status >> 5) & 0x01;
-        device->faultStatus0.ibus_ocp_stat  = (*status >> 4) & 0x01;
-        device->faultStatus0.ibat_ocp_stat  = (*status >> 3) & 0x01;
-        device->faultStatus0.conv_ocp_stat  = (*status >> 2) & 0x01;
-        device->faultStatus0.vac2_ovp_stat  = (*status >> 1) & 0x01;
-        device->faultStatus0.vac1_ovp_stat  = (*status >> 0) & 0x01;
-    }
-    return ret_val;
+HAL_StatusTypeDef BQ25798_readDecoded(BQ25798 *device, uint8_t reg, uint8_t len, uint8_t *raw){
+	uint8_t buf[8];
+	uint8_t *p = raw ? raw : buf;
+	if (len == 0 || len > sizeof(buf)) return HAL_ERROR;
+	HAL_StatusTypeDef st = BQ25798_ReadRegisters(device, reg, p, len);
+	if (st == HAL_OK) BQ25798_decodeRegisters(device, reg, p, len);
+	return st;
 }
 
-// Read and interpret REG21_FAULT_Status_1
-HAL_StatusTypeDef readFaultStatus1(BQ25798 *device, uint8_t *status){
-    HAL_StatusTypeDef ret_val = BQ25798_ReadRegister(device, BQ25798_REG_FAULT_STATUS_1, status);
-    if (ret_val == HAL_OK) {
-        device->faultStatus1.vsys_short_stat = (*status >> 7) & 0x01;
-        device->faultStatus1.vsys_ovp_stat   = (*status >> 6) & 0x01;
-        device->faultStatus1.otg_ovp_stat    = (*status >> 5) & 0x01;
-        device->faultStatus1.otg_uvp_stat    = (*status >> 4) & 0x01;
-        device->faultStatus1.tshut_stat      = (*status >> 2) & 0x01;
-    }
-    return ret_val;
+/* Bus scheduler completion: decode into the device or record the failure */
+static void busReadDone(void *ctx, uint8_t reg, const uint8_t *data, uint8_t len, HAL_StatusTypeDef st){
+	BQ25798 *device = (BQ25798 *)ctx;
+	if (st == HAL_OK){
+		BQ25798_decodeRegisters(device, reg, data, len);
+	} else {
+		BM_PUSH_ERROR(device, BM_SRC_BQ25798, BM_ERR_I2C, (uint8_t)st, reg, 0);
+	}
 }
 
-// Read input voltage and current
-HAL_StatusTypeDef BQ25798_readBusVoltage(BQ25798 *device){
-	// Read raw values from voltage registers (16 bits)
-	// we have a 16 bit ADC but 8bit RAM thus we read 2 addresses instead
-	uint8_t registerData[2];
-	HAL_StatusTypeDef status = BQ25798_ReadRegisters(device, BQ25798_REG_VBUS_ADC, registerData, 2); // bit resolution 1mV
-	uint16_t voltageRaw = (registerData[0] << 8) | registerData[1];
-	device->voltageBus = voltageRaw; // in mV
-	return status;
-}
-HAL_StatusTypeDef BQ25798_readBusCurrent(BQ25798 *device){
-	// Read raw values from voltage registers (16 bits)
-	// we have a 16 bit ADC but 8bit RAM thus we read 2 addresses instead
-	uint8_t registerData[2];
-	HAL_StatusTypeDef status = BQ25798_ReadRegisters(device, BQ25798_REG_IBUS_ADC, registerData, 2); // bit resolution 1mV
-	uint16_t currentRaw = (registerData[0] << 8) | registerData[1];
-	device->currentBus = currentRaw; // in mA
-	return status;
-}
-// Read output/ battery voltage and current
-
-HAL_StatusTypeDef BQ25798_readBatteryVoltage(BQ25798 *device){
-	// Read raw values from voltage registers (16 bits)
-	// we have a 16 bit ADC but 8bit RAM thus we read 2 addresses instead
-	uint8_t registerData[2];
-	HAL_StatusTypeDef status = BQ25798_ReadRegisters(device, BQ25798_REG_VBAT_ADC, registerData, 2); // bit resolution 1mV
-	uint16_t voltageRaw = (registerData[0] << 8) | registerData[1];
-	device->voltageBattery = voltageRaw; // in mV
-	return status;
-}
-HAL_StatusTypeDef BQ25798_readBatteryCurrent(BQ25798 *device){
-	// Read raw values from voltage registers (16 bits)
-	// we have a 16 bit ADC but 8bit RAM thus we read 2 addresses instead
-	uint8_t registerData[2];
-	HAL_StatusTypeDef status = BQ25798_ReadRegisters(device, BQ25798_REG_IBAT_ADC, registerData, 2); // bit resolution 1mA
-	uint16_t currentRaw = (registerData[0] << 8) | registerData[1];
-	device->currentBattery = currentRaw; // in mA
-	return status;
+/* Queue the periodic status/fault/ADC reads on the shared bus. Fault status
+ * runs at fault priority and absorbs the adjacent status block; the three
+ * contiguous ADC pairs merge into one burst. 11 transactions become 3. */
+HAL_StatusTypeDef BQ25798_queueStatusRefresh(BQ25798 *device, uint32_t deadline_ms){
+	static const struct { uint8_t reg, len, prio; } plan[] = {
+		{ BQ25798_REG_FAULT_STATUS_0,    2, I2C_BUS_PRIO_FAULT   },
+		{ BQ25798_REG_CHARGER_STATUS_0,  5, I2C_BUS_PRIO_MEASURE },
+		{ BQ25798_REG_IBUS_ADC,          2, I2C_BUS_PRIO_MEASURE },
+		{ BQ25798_REG_IBAT_ADC,          2, I2C_BUS_PRIO_MEASURE },
+		{ BQ25798_REG_VBUS_ADC,          2, I2C_BUS_PRIO_MEASURE },
+		{ BQ25798_REG_VBAT_ADC,          2, I2C_BUS_PRIO_MEASURE },
+	};
+	HAL_StatusTypeDef result = HAL_OK;
+	for (uint8_t i = 0; i < sizeof(plan) / sizeof(plan[0]); i++){
+		I2CBus_Request req = {
+			.devAddress = BQ25798_I2C_ADDRESS, .reg = plan[i].reg, .len = plan[i].len,
+			.prio = plan[i].prio, .deadline_ms = deadline_ms, .done = busReadDone, .ctx = device,
+		};
+		HAL_StatusTypeDef st = I2CBus_Submit(&req);
+		if (st != HAL_OK && result == HAL_OK) result = st;
+	}
+	return result;
 }
 
 // LOW LEVEL FUNCTIONS
 
 HAL_StatusTypeDef BQ25798_ReadRegister(BQ25798 *device, uint8_t reg, uint8_t *data){
-	HAL_StatusTypeDef st = HAL_I2C_Mem_Read(device->i2cHandle, BQ25798_I2C_ADDRESS, reg, I2C_MEMADD_SIZE_8BIT, data, 1, HAL_MAX_DELAY);
+	HAL_StatusTypeDef st = I2CBus_MemRead(device->i2cHandle, BQ25798_I2C_ADDRESS, reg, data, 1);
 	if (st != HAL_OK){
 		BM_PUSH_ERROR(device, BM_SRC_BQ25798, BM_ERR_I2C, (uint8_t)st, reg, 0);
 	}
@@ -246,7 +231,7 @@ HAL_StatusTypeDef BQ25798_ReadRegister(BQ25798 *device, uint8_t reg, uint8_t *da
 }
 
 HAL_StatusTypeDef BQ25798_ReadRegisters(BQ25798 *device, uint8_t reg, uint8_t *data, uint8_t length){
-	HAL_StatusTypeDef st = HAL_I2C_Mem_Read(device->i2cHandle, BQ25798_I2C_ADDRESS, reg, I2C_MEMADD_SIZE_8BIT, data, length, HAL_MAX_DELAY);
+	HAL_StatusTypeDef st = I2CBus_MemRead(device->i2cHandle, BQ25798_I2C_ADDRESS, reg, data, length);
 	if (st != HAL_OK){
 		BM_PUSH_ERROR(device, BM_SRC_BQ25798, BM_ERR_I2C, (uint8_t)st, reg, 0);
 	}
@@ -254,7 +239,7 @@ HAL_StatusTypeDef BQ25798_ReadRegisters(BQ25798 *device, uint8_t reg, uint8_t *d
 
 }
 HAL_StatusTypeDef BQ25798_WriteRegister(BQ25798 *device, uint8_t reg, uint8_t *data){
-	HAL_StatusTypeDef st = HAL_I2C_Mem_Write(device->i2cHandle, BQ25798_I2C_ADDRESS, reg, I2C_MEMADD_SIZE_8BIT, data, 1, HAL_MAX_DELAY);
+	HAL_StatusTypeDef st = I2CBus_MemWrite(device->i2cHandle, BQ25798_I2C_ADDRESS, reg, data, 1);
 	if (st != HAL_OK){
 		BM_PUSH_ERROR(device, BM_SRC_BQ25798, BM_ERR_I2C, (uint8_t)st, reg, *data);
 	}
@@ -264,15 +249,15 @@ HAL_StatusTypeDef BQ25798_WriteRegister(BQ25798 *device, uint8_t reg, uint8_t *d
 
 /* ================= High-Level Control / Profile Functions ================= */
 HAL_StatusTypeDef BQ25798_setChargeVoltage(BQ25798 *dev, uint16_t mV){
-    uint16_t raw = BQ25798_encodeChargeVoltage_mV(mV);
+    uint16_t raw = BQ25798_encodeChargeVoltage_mV(clamp16(mV, BQ25798_VREG_MIN_mV, BQ25798_VREG_MAX_mV));
     return BQ25798_Write16(dev, BQ25798_REG_CHARGE_VOLTAGE_LIMIT, raw);
 }
 HAL_StatusTypeDef BQ25798_setChargeCurrent(BQ25798 *dev, uint16_t mA){
-    uint16_t raw = BQ25798_encodeChargeCurrent_mA(mA);
+    uint16_t raw = BQ25798_encodeChargeCurrent_mA(clamp16(mA, BQ25798_ICHG_MIN_mA, BQ25798_ICHG_MAX_mA));
     return BQ25798_Write16(dev, BQ25798_REG_CHARGE_CURRENT_LIMIT, raw);
 }
 HAL_StatusTypeDef BQ25798_setInputCurrentLimit(BQ25798 *dev, uint16_t mA){
-    uint16_t raw = BQ25798_encodeInputCurrent_mA(mA);
+    uint16_t raw = BQ25798_encodeInputCurrent_mA(clamp16(mA, BQ25798_IINDPM_MIN_mA, BQ25798_IINDPM_MAX_mA));
     return BQ25798_Write16(dev, BQ25798_REG_INPUT_CURRENT_LIMIT, raw);
 }
 HAL_StatusTypeDef BQ25798_chargerEnable(BQ25798 *dev, uint8_t enable){
@@ -317,31 +302,7 @@ HAL_StatusTypeDef BQ25798_thermalGuard(BQ25798 *dev, int16_t tempC_x10_min, int1
 void BQ25798_debugDump(const BQ25798 *dev){
     if (!dev){ BQ_LOG("BQ25798: (null device)"); return; }
     BQ_LOG("BQ25798 Debug Dump:");
-    BQ_LOG("  VBUS  = %u mV",   (unsigned)dev->voltageBus);
-    BQ_LOG("  IBUS  = %u mA",   (unsigned)dev->currentBus);
-    BQ_LOG("  VBAT  = %u mV",   (unsigned)dev->voltageBattery);
-    BQ_LOG("  IBAT  = %u mA",   (unsigned)dev->currentBattery);
-    BQ_LOG("  CHG_STAT0: iindpm=%u vindpm=%u wd=%u pg=%u ac2=%u ac1=%u vbus=%u",
-	    dev->chargerStatus0.iindpm_stat,
-	    dev->chargerStatus0.vindpm_stat,
-	    dev->chargerStatus0.wd_stat,
-	    dev->chargerStatus0.pg_stat,
-	    dev->chargerStatus0.ac2_present_stat,
-	    dev->chargerStatus0.ac1_present_stat,
-	    dev->chargerStatus0.vbus_present_stat);
-    BQ_LOG("  CHG_STAT1: chg=%u vbus=%u bc12=%u",
-	    dev->chargerStatus1.chg_stat,
-	    dev->chargerStatus1.vbus_stat,
-	    dev->chargerStatus1.bc12_done_stat);
-    BQ_LOG("  FAULT0: ibat_reg=%u vbus_ovp=%u vbat_ovp=%u ibus_ocp=%u ibat_ocp=%u conv_ocp=%u vac2_ovp=%u vac1_ovp=%u",
-	    dev->faultStatus0.ibat_reg_stat,
-	    dev->faultStatus0.vbus_ovp_stat,
-	    dev->faultStatus0.vbat_ovp_stat,
-	    dev->faultStatus0.ibus_ocp_stat,
-	    dev->faultStatus0.ibat_ocp_stat,
-	    dev->faultStatus0.conv_ocp_stat,
-	    dev->faultStatus0.vac2_ovp_stat,
-	    dev->faultStatus0.vac1_ovp_stat);
+    BQ_RegDesc_log("25798", dev, BQ25798_regDesc, BQ25798_regDescCount);
 }
 
 /* ================= Periodic Status Logger ================= */
@@ -349,60 +310,25 @@ void BQ25798_logStatus(const BQ25798 *dev){
 	if (!dev) { BQ_LOG("(null dev)"); return; }
 	/* Simple throttle: only print every 500ms (relies on HAL tick). */
 	static uint32_t lastTick = 0;
+	static BQ_Snapshot last;
 	uint32_t now = HAL_GetTick();
 	if ((now - lastTick) < 500u) return; /* skip */
 	lastTick = now;
 
-	/* Derive human-readable charge state (chargerStatus1.chg_stat). Placeholder mapping per datasheet typical patterns. */
-	const char *chgState;
-	switch (dev->chargerStatus1.chg_stat & 0x7){
-		case 0: chgState = "Idle"; break;
-		case 1: chgState = "Trickle"; break;
-		case 2: chgState = "PreCharge"; break;
-		case 3: chgState = "Fast"; break;
-		case 4: chgState = "Taper"; break;
-		case 5: chgState = "Reserved5"; break;
-		case 6: chgState = "Reserved6"; break;
-		case 7: chgState = "Complete"; break;
-		default: chgState = "?"; break;
-	}
-	const char *vbusSrc;
-	switch (dev->chargerStatus1.vbus_stat & 0xF){
-		case 0: vbusSrc = "None"; break;
-		case 1: vbusSrc = "USB_SDP"; break; /* example mapping */
-		case 2: vbusSrc = "USB_CDP"; break;
-		case 3: vbusSrc = "USB_DCP"; break;
-		case 4: vbusSrc = "Adapter"; break;
-		default: vbusSrc = "Other"; break;
-	}
-	BQ_LOG("STAT t=%lu VBAT=%umV IBAT=%umA VBUS=%umV IBUS=%umA CHG=%s VBUS_SRC=%s PG=%u VBAT_PRES=%u TREG=%u FAULTv=%u%u%u%u%u%u",
-		   (unsigned long)now,
-		   (unsigned)dev->voltageBattery,
-		   (unsigned)dev->currentBattery,
-		   (unsigned)dev->voltageBus,
-		   (unsigned)dev->currentBus,
-		   chgState,
-		   vbusSrc,
-		   dev->chargerStatus0.pg_stat,
-		   dev->chargerStatus2.vbat_present_stat,
-		   dev->chargerStatus2.treg_stat,
-		   dev->faultStatus0.vbus_ovp_stat,
-		   dev->faultStatus0.vbat_ovp_stat,
-		   dev->faultStatus0.ibus_ocp_stat,
-		   dev->faultStatus0.ibat_ocp_stat,
-		   dev->faultStatus0.conv_ocp_stat,
-		   dev->faultStatus0.ibat_reg_stat);
+	/* One line of raw status bytes + ADC values, then only the fields that changed */
+	BQ_RegDesc_logStatus("25798", dev, BQ25798_regDesc, BQ25798_regDescCount, now, &last);
 }
 
 /* ================= Error API ================= */
-int8_t BQ25798_getLastError(const BQ25798 *dev){ return dev ? dev->lastError : (int8_t)BM_ERR_UNKNOWN; }
-uint8_t BQ25798_getErrorCount(const BQ25798 *dev){ return dev ? (dev->errorHead > BM_ERROR_LOG_DEPTH ? BM_ERROR_LOG_DEPTH : dev->errorHead) : 0; }
+int8_t BQ25798_getLastError(const BQ25798 *dev){ return dev ? dev->errors.lastError : (int8_t)BM_ERR_UNKNOWN; }
+uint8_t BQ25798_getErrorCount(const BQ25798 *dev){ return dev ? (uint8_t)BM_ErrorRingCount(&dev->errors) : 0; }
 void BQ25798_dumpErrors(const BQ25798 *dev){
 	if (!dev){ BQ_LOG("BQ25798 errors: (null)"); return; }
-	uint8_t count = (dev->errorHead > BM_ERROR_LOG_DEPTH)? BM_ERROR_LOG_DEPTH : dev->errorHead;
-	BQ_LOG("BQ25798 Error Log (most recent %u):", count);
-	for (uint8_t i=0;i<count;i++){
-		const BM_ErrorEntry *e = &dev->errorLog[i];
-		BQ_LOG("  t=%lu code=%d det=%u reg=0x%02X val=0x%04X", (unsigned long)e->tick, (int)e->code, e->detail, e->reg, e->value);
+	uint32_t count = BM_ErrorRingCount(&dev->errors);
+	BQ_LOG("BQ25798 Error Log (most recent %lu):", (unsigned long)count);
+	for (uint32_t i=0;i<count;i++){
+		BM_ErrorEntry e;
+		if (!BM_ErrorRead(&dev->errors, i, &e)) continue;   /* being written */
+		BQ_LOG("  t=%lu code=%d det=%u reg=0x%02X val=0x%04X", (unsigned long)e.tick, (int)e.code, e.detail, e.reg, e.value);
 	}
 }
@@ -6,6 +6,7 @@
  */
 #include <stdio.h>
 #include "bq25798.h"
+#include "bq76907.h"
 
 /* Table-driven samples (physical -> expected raw) excluding ambiguous entries */
 typedef struct { const char *label; uint32_t physical; uint32_t raw; uint32_t (*enc)(uint32_t); uint32_t (*dec)(uint32_t); } scale_case32;
@@ -76,6 +77,149 @@ void BQ25798_runScalingSelfTest(void){
     printf("[BQ][SCALE] Self-test complete: %u failure(s)\n", failures);
 }
 
+/* ================= Exhaustive verification =================
+ * Every raw code of the helper's type goes through decode and every 16-bit
+ * physical value through encode. Within the register field (fieldMax) and
+ * the driver's set point range (physMax) decode must round-trip through
+ * encode, both directions must be monotonic and the quantisation error of
+ * decode(encode(x)) must stay below one LSB. Past that the sweep reports
+ * where a helper's integer type wraps, which must lie outside the ranges. */
+typedef struct {
+    const char *name;
+    uint16_t lsb;          /* physical units per code */
+    uint16_t fieldMax;     /* largest raw code of the register field */
+    uint16_t physMax;      /* largest value the driver sends (clamped set points) */
+    uint32_t rawCount;     /* 256 or 65536: the helper's raw type */
+    uint16_t (*enc)(uint16_t);
+    uint16_t (*dec)(uint16_t);
+} scale_pair;
+
+/* 8-bit helpers behind the 16-bit signature of the table */
+static uint16_t encVindpm(uint16_t mV){ return BQ25798_encodeInputVoltageLimit_mV(mV); }
+static uint16_t decVindpm(uint16_t raw){ return BQ25798_decodeInputVoltageLimit_raw((uint8_t)raw); }
+static uint16_t encPrechg(uint16_t mA){ return BQ25798_encodePrechargeCurrent_mA(mA); }
+static uint16_t decPrechg(uint16_t raw){ return BQ25798_decodePrechargeCurrent_raw((uint8_t)raw); }
+
+static const scale_pair scalePairs[] = {
+    { "VREG",   10, 2047, BQ25798_VREG_MAX_mV,   65536u, BQ25798_encodeChargeVoltage_mV, BQ25798_decodeChargeVoltage_raw },
+    { "ICHG",   10,  511, BQ25798_ICHG_MAX_mA,   65536u, BQ25798_encodeChargeCurrent_mA, BQ25798_decodeChargeCurrent_raw },
+    { "IINDPM", 10,  511, BQ25798_IINDPM_MAX_mA, 65536u, BQ25798_encodeInputCurrent_mA,  BQ25798_decodeInputCurrent_raw },
+    { "VINDPM", 100, 255, BQ25798_VINDPM_MAX_mV,   256u, encVindpm, decVindpm },
+    { "PCHG",   40,   63, 2000,                    256u, encPrechg, decPrechg },   /* bits 5:0 */
+};
+
+/* BQ76907 scalers have no inverse (yet): monotonic over the whole raw range */
+static int32_t scaleCell(uint16_t raw){ return BQ76907_scaleCellVoltage(raw); }
+static int32_t scalePack(uint16_t raw){ return BQ76907_scalePackVoltage(raw); }
+static int32_t scaleTemp(uint16_t raw){ return BQ76907_scaleTemperature((int16_t)(raw ^ 0x8000u)); }
+static const struct { const char *name; int32_t (*scale)(uint16_t); } scalers[] = {
+    { "CELL", scaleCell }, { "PACK", scalePack },
+    { "TS",   scaleTemp },   /* raw swept in int16 order: -32768..32767 */
+};
+
+static unsigned verifyPair(const scale_pair *p, uint8_t verbose){
+    unsigned fail = 0;
+    uint32_t decWrap = p->rawCount, encWrap = 65536u, maxErr = 0;
+
+    uint16_t prev = 0;
+    for (uint32_t raw = 0; raw < p->rawCount; raw++){
+        uint16_t v = p->dec((uint16_t)raw);
+        if (v < prev && decWrap == p->rawCount) decWrap = raw;
+        prev = v;
+        if (raw <= p->fieldMax && p->enc(v) != raw){
+            if (!fail && verbose) printf("[BQ][SCALE] %-6s raw %lu -> %u -> %u round trip FAIL\n",
+                                         p->name, (unsigned long)raw, v, p->enc(v));
+            fail++;
+        }
+    }
+    prev = 0;
+    for (uint32_t x = 0; x < 65536u; x++){
+        uint16_t raw = p->enc((uint16_t)x);
+        if (raw < prev && encWrap == 65536u) encWrap = x;
+        prev = raw;
+        if (x <= p->physMax){
+            uint16_t back = p->dec(raw);
+            uint32_t err = back <= x ? x - back : p->lsb;   /* decode above the input: out of bounds */
+            if (err > maxErr) maxErr = err;
+        }
+    }
+    if (p->dec(1) - p->dec(0) != p->lsb) fail++;
+    if (decWrap <= p->fieldMax) fail++;
+    if (encWrap <= p->physMax) fail++;
+    if (maxErr >= p->lsb) fail++;
+    if (verbose){
+        char dw[12] = "none", ew[12] = "none";
+        if (decWrap < p->rawCount) snprintf(dw, sizeof(dw), "%lu", (unsigned long)decWrap);
+        if (encWrap < 65536u) snprintf(ew, sizeof(ew), "%lu", (unsigned long)encWrap);
+        printf("[BQ][SCALE] %-6s raw 0..%u lsb=%u max err=%lu wraps: decode %s encode %s %s\n",
+               p->name, p->fieldMax, p->lsb, (unsigned long)maxErr, dw, ew, fail ? "FAIL" : "OK");
+    }
+    return fail;
+}
+
+uint32_t BQ25798_verifyScaling(uint8_t verbose){
+    unsigned failures = 0;
+    for (unsigned i = 0; i < sizeof(scalePairs)/sizeof(scalePairs[0]); i++){
+        failures += verifyPair(&scalePairs[i], verbose) ? 1u : 0u;
+    }
+    for (unsigned i = 0; i < sizeof(scalers)/sizeof(scalers[0]); i++){
+        int32_t lo = scalers[i].scale(0), prev = lo;
+        uint32_t bad = 0;
+        for (uint32_t raw = 1; raw < 65536u; raw++){
+            int32_t v = scalers[i].scale((uint16_t)raw);
+            if (v < prev && !bad) bad = raw;
+            prev = v;
+        }
+        if (bad) failures++;
+        if (verbose){
+            printf("[BQ][SCALE] %-6s out %ld..%ld %s\n", scalers[i].name, (long)lo, (long)prev,
+                   bad ? "not monotonic FAIL" : "monotonic OK");
+        }
+    }
+    if (verbose) printf("[BQ][SCALE] Exhaustive sweep: %u failure(s)\n", failures);
+    return failures;
+}
+
+/* Boundary subset of the sweep, cheap enough for every boot: round trip at
+ * both ends of each register field, encode of the clamped set point range
+ * landing inside the field with under one LSB of error, and the BQ76907
+ * scalers ordered across their raw range. A few dozen helper calls against
+ * the ~780k of BQ25798_verifyScaling, which stays on the host. */
+static unsigned checkPairRanges(const scale_pair *p, uint8_t verbose){
+    unsigned fail = 0;
+    const uint16_t raws[] = { 0, 1, (uint16_t)(p->fieldMax - 1u), p->fieldMax };
+    const uint16_t xs[]   = { 0, p->lsb, (uint16_t)(p->physMax - 1u), p->physMax };
+
+    for (unsigned i = 0; i < sizeof(raws)/sizeof(raws[0]); i++){
+        if (p->enc(p->dec(raws[i])) != raws[i]) fail++;
+    }
+    for (unsigned i = 0; i < sizeof(xs)/sizeof(xs[0]); i++){
+        uint16_t raw = p->enc(xs[i]), back = p->dec(raw);
+        if (raw > p->fieldMax || back > xs[i] || xs[i] - back >= p->lsb) fail++;
+    }
+    if (p->enc(p->physMax) < p->enc((uint16_t)(p->physMax - 1u))) fail++;
+    if (p->dec(1) - p->dec(0) != p->lsb) fail++;
+    if (verbose) printf("[BQ][SCALE] %-6s ranges raw 0..%u phys 0..%u %s\n",
+                        p->name, p->fieldMax, p->physMax, fail ? "FAIL" : "OK");
+    return fail;
+}
+
+uint32_t BQ25798_checkScalingRanges(uint8_t verbose){
+    unsigned failures = 0;
+    for (unsigned i = 0; i < sizeof(scalePairs)/sizeof(scalePairs[0]); i++){
+        failures += checkPairRanges(&scalePairs[i], verbose) ? 1u : 0u;
+    }
+    for (unsigned i = 0; i < sizeof(scalers)/sizeof(scalers[0]); i++){
+        int32_t lo = scalers[i].scale(0), mid = scalers[i].scale(0x8000u), hi = scalers[i].scale(0xFFFFu);
+        int ok = lo <= mid && mid <= hi && lo < hi;
+        if (!ok) failures++;
+        if (verbose) printf("[BQ][SCALE] %-6s ends %ld..%ld %s\n", scalers[i].name, (long)lo, (long)hi,
+                            ok ? "ordered OK" : "not ordered FAIL");
+    }
+    if (verbose) printf("[BQ][SCALE] Range check: %u failure(s)\n", failures);
+    return failures;
+}
+
 /* Rich report: re-runs scaling tests with PASS/FAIL tags and (optionally) performs a live PART_INFO read */
 void BQ25798_runAssertionReport(BQ25798 *dev){
     unsigned failures = 0;
@@ -5,9 +5,9 @@
  * Each placeholder remains tagged in the header with TODO_VERIFY until confirmed.
  */
 #include "bq76907.h"
-
-/* -------- Internal Helper: Combine two bytes (MSB first) -------- */
-static inline uint16_t u16_be(uint8_t hi, uint8_t lo){ return ((uint16_t)hi << 8) | lo; }
+#include "i2c_bus.h"
+#include <stddef.h>
+#include <string.h>
 
 /**
  * @brief Initialise BQ76907 driver context.
@@ -33,69 +33,86 @@ uint8_t BQ76907_init(BQ76907 *dev, I2C_HandleTypeDef *hi2c){
     return 0; // success
 }
 
+/* ================= Register map (generated from bq76907_regmap.h) ================= */
+/* Compile-time checks: fields inside 8 bits and no two fields overlapping */
+#define BQ76907_GEN_FIELD_CHECKS(ID, access, member, Type) \
+    bq_static_assert_##ID##_fields_in_range = 1 / ((1 BQ76907_##ID##_FIELDS(BQ_FIELD_RANGE_OK, _)) ? 1u : 0u), \
+    bq_static_assert_##ID##_fields_disjoint = 1 / (((0u BQ76907_##ID##_FIELDS(BQ_FIELD_MASK_OR, _)) == \
+                                                    (0u BQ76907_##ID##_FIELDS(BQ_FIELD_MASK_SUM, _))) ? 1u : 0u),
+enum { BQ76907_FIELD_REGS(BQ76907_GEN_FIELD_CHECKS) };
+
+/* TS1 is signed; the descriptor scale hook works on the raw 16-bit pattern */
+static uint16_t scaleTs1(uint16_t raw){ return (uint16_t)BQ76907_scaleTemperature((int16_t)raw); }
+
+#define BQ76907_GEN_FIELD_DESC(ID, access, member, Type) \
+    static const BQ_FieldDesc fields_##ID[] = { BQ76907_##ID##_FIELDS(BQ_FIELD_DESC, _) };
+BQ76907_FIELD_REGS(BQ76907_GEN_FIELD_DESC)
+
+#define BQ76907_FIELD_REG_DESC(ID, access, member, Type) \
+    { #ID BQ76907_##ID##_FIELDS(BQ_FIELD_NAME, _), fields_##ID, NULL, (uint16_t)offsetof(BQ76907, member), \
+      BQ76907_REG_##ID, 1, access, 0, (uint8_t)(sizeof(fields_##ID) / sizeof(fields_##ID[0])) },
+#define BQ76907_VALUE_REG_DESC(ID, access, member, unit, flags, scale) \
+    { #ID "\0" unit, NULL, scale, (uint16_t)offsetof(BQ76907, member), BQ76907_REG_##ID, 2, access, flags, 0 },
+const BQ_RegDesc BQ76907_regDesc[] = {
+    BQ76907_FIELD_REGS(BQ76907_FIELD_REG_DESC)
+    BQ76907_VALUE_REGS(BQ76907_VALUE_REG_DESC)
+};
+const uint8_t BQ76907_regDescCount = (uint8_t)(sizeof(BQ76907_regDesc) / sizeof(BQ76907_regDesc[0]));
+
 /**
- * @brief Read system status register and decode fault / ready bits.
- * Updates dev->status structure with parsed flags.
+ * @brief Decode a block of consecutive registers starting at firstReg into dev.
+ * Shared by the blocking readers and the queued bus refresh. 16-bit values are
+ * only taken when both bytes are inside the block.
  */
-HAL_StatusTypeDef BQ76907_readSystemStatus(BQ76907 *dev){
-    uint8_t regVal;
-    HAL_StatusTypeDef st = BQ76907_ReadRegister(dev, BQ76907_REG_SYS_STAT, &regVal);
-    if (st == HAL_OK){
-        dev->status.cc_ready  = (regVal & BQ76907_SYS_STAT_CC_READY) ? 1:0;
-        dev->status.dev_ready = (regVal & BQ76907_SYS_STAT_DEVICE_XREADY) ? 1:0;
-        dev->status.ov_fault  = (regVal & BQ76907_SYS_STAT_OV_FLAG) ? 1:0;
-        dev->status.uv_fault  = (regVal & BQ76907_SYS_STAT_UV_FLAG) ? 1:0;
-        dev->status.scd_fault = (regVal & BQ76907_SYS_STAT_SCD_FLAG)? 1:0;
-        dev->status.ocd_fault = (regVal & BQ76907_SYS_STAT_OCD_FLAG)? 1:0;
-        dev->status.ot_fault  = (regVal & BQ76907_SYS_STAT_OVERTEMP_FLAG)?1:0;
-    }
-    return st;
+void BQ76907_decodeRegisters(BQ76907 *dev, uint8_t firstReg, const uint8_t *data, uint8_t len){
+    BQ_RegDesc_decode(dev, BQ76907_regDesc, BQ76907_regDescCount, firstReg, data, len);
 }
 
 /**
- * @brief Read all configured cell voltage registers (4s pack per requirements).
- * Adjust base address arithmetic once actual register map confirmed.
+ * @brief Blocking read of len (1..8) consecutive registers from reg, decoded
+ * through the register map (SYS_STAT flags, scaled cell / pack / TS1 values).
+ * The BQ76907_read* helpers in the header are thin wrappers around this.
  */
-HAL_StatusTypeDef BQ76907_readCellVoltages(BQ76907 *dev){
-    for (uint8_t cell = 0; cell < 4; ++cell){
-        uint8_t hi, lo;
-        uint8_t baseHigh = BQ76907_REG_VCELL1_H + (cell * 2);
-        HAL_StatusTypeDef st = BQ76907_ReadRegister(dev, baseHigh, &hi);
-        if (st != HAL_OK) return st;
-        st = BQ76907_ReadRegister(dev, baseHigh + 1, &lo);
-        if (st != HAL_OK) return st;
-        uint16_t raw = u16_be(hi, lo);
-        dev->cellVoltage_mV[cell] = BQ76907_scaleCellVoltage(raw);
-    }
-    return HAL_OK;
+HAL_StatusTypeDef BQ76907_readDecoded(BQ76907 *dev, uint8_t reg, uint8_t len){
+    uint8_t buf[8];
+    if (len == 0 || len > sizeof(buf)) return HAL_ERROR;
+    HAL_StatusTypeDef st = BQ76907_ReadRegisters(dev, reg, buf, len);
+    if (st == HAL_OK) BQ76907_decodeRegisters(dev, reg, buf, len);
+    return st;
 }
 
-/**
- * @brief Read pack voltage (two-byte) and scale to millivolts.
- */
-HAL_StatusTypeDef BQ76907_readPackVoltage(BQ76907 *dev){
-    uint8_t hi, lo;
-    HAL_StatusTypeDef st = BQ76907_ReadRegister(dev, BQ76907_REG_PACK_V_H, &hi);
-    if (st != HAL_OK) return st;
-    st = BQ76907_ReadRegister(dev, BQ76907_REG_PACK_V_L, &lo);
-    if (st != HAL_OK) return st;
-    uint16_t raw = u16_be(hi, lo);
-    dev->packVoltage_mV = BQ76907_scalePackVoltage(raw);
-    return HAL_OK;
+/* Bus scheduler completion: decode into the device or record the failure */
+static void busReadDone(void *ctx, uint8_t reg, const uint8_t *data, uint8_t len, HAL_StatusTypeDef st){
+    BQ76907 *dev = (BQ76907 *)ctx;
+    if (st == HAL_OK){
+        BQ76907_decodeRegisters(dev, reg, data, len);
+    } else {
+        BM_PUSH_ERROR(dev, BM_SRC_BQ76907, BM_ERR_I2C, (uint8_t)st, reg, 0);
+    }
 }
 
 /**
- * @brief Read temperature sensor 1 raw value and convert to 0.1 degC units.
+ * @brief Queue a full status refresh (SYS_STAT, cells, pack, TS1) on the shared
+ * bus. SYS_STAT goes at fault priority; PACK_V and TS1 are adjacent and get
+ * merged into one burst by the scheduler. Results land in dev when serviced.
  */
-HAL_StatusTypeDef BQ76907_readTemperature1(BQ76907 *dev){
-    uint8_t hi, lo;
-    HAL_StatusTypeDef st = BQ76907_ReadRegister(dev, BQ76907_REG_TS1_H, &hi);
-    if (st != HAL_OK) return st;
-    st = BQ76907_ReadRegister(dev, BQ76907_REG_TS1_L, &lo);
-    if (st != HAL_OK) return st;
-    int16_t raw = (int16_t)u16_be(hi, lo);
-    dev->ts1_degC_x10 = BQ76907_scaleTemperature(raw);
-    return HAL_OK;
+HAL_StatusTypeDef BQ76907_queueStatusRefresh(BQ76907 *dev, uint32_t deadline_ms){
+    static const struct { uint8_t reg, len, prio; } plan[] = {
+        { BQ76907_REG_SYS_STAT, 1, I2C_BUS_PRIO_FAULT   },
+        { BQ76907_REG_VCELL1_H, 8, I2C_BUS_PRIO_MEASURE },
+        { BQ76907_REG_PACK_V_H, 2, I2C_BUS_PRIO_MEASURE },
+        { BQ76907_REG_TS1_H,    2, I2C_BUS_PRIO_MEASURE },
+    };
+    HAL_StatusTypeDef result = HAL_OK;
+    for (uint8_t i = 0; i < sizeof(plan) / sizeof(plan[0]); i++){
+        I2CBus_Request req = {
+            .devAddress = BQ76907_I2C_ADDRESS, .reg = plan[i].reg, .len = plan[i].len,
+            .prio = plan[i].prio, .deadline_ms = deadline_ms, .done = busReadDone, .ctx = dev,
+        };
+        HAL_StatusTypeDef st = I2CBus_Submit(&req);
+        if (st != HAL_OK && result == HAL_OK) result = st;
+    }
+    return result;
 }
 
 /* Low level I2C wrappers */
@@ -103,7 +120,7 @@ HAL_StatusTypeDef BQ76907_readTemperature1(BQ76907 *dev){
  * @brief Low-level single register read helper.
  */
 HAL_StatusTypeDef BQ76907_ReadRegister(BQ76907 *dev, uint8_t reg, uint8_t *data){
-    HAL_StatusTypeDef st = HAL_I2C_Mem_Read(dev->i2cHandle, BQ76907_I2C_ADDRESS, reg, I2C_MEMADD_SIZE_8BIT, data, 1, HAL_MAX_DELAY);
+    HAL_StatusTypeDef st = I2CBus_MemRead(dev->i2cHandle, BQ76907_I2C_ADDRESS, reg, data, 1);
     if (st != HAL_OK){
         BM_PUSH_ERROR(dev, BM_SRC_BQ76907, BM_ERR_I2C, (uint8_t)st, reg, 0);
     }
@@ -114,7 +131,7 @@ HAL_StatusTypeDef BQ76907_ReadRegister(BQ76907 *dev, uint8_t reg, uint8_t *data)
  * @brief Low-level burst read helper for sequential registers.
  */
 HAL_StatusTypeDef BQ76907_ReadRegisters(BQ76907 *dev, uint8_t reg, uint8_t *data, uint8_t len){
-    HAL_StatusTypeDef st = HAL_I2C_Mem_Read(dev->i2cHandle, BQ76907_I2C_ADDRESS, reg, I2C_MEMADD_SIZE_8BIT, data, len, HAL_MAX_DELAY);
+    HAL_StatusTypeDef st = I2CBus_MemRead(dev->i2cHandle, BQ76907_I2C_ADDRESS, reg, data, len);
     if (st != HAL_OK){
         BM_PUSH_ERROR(dev, BM_SRC_BQ76907, BM_ERR_I2C, (uint8_t)st, reg, 0);
     }
@@ -125,7 +142,7 @@ HAL_StatusTypeDef BQ76907_ReadRegisters(BQ76907 *dev, uint8_t reg, uint8_t *data
  * @brief Low-level single register write helper.
  */
 HAL_StatusTypeDef BQ76907_WriteRegister(BQ76907 *dev, uint8_t reg, uint8_t data){
-    HAL_StatusTypeDef st = HAL_I2C_Mem_Write(dev->i2cHandle, BQ76907_I2C_ADDRESS, reg, I2C_MEMADD_SIZE_8BIT, &data, 1, HAL_MAX_DELAY);
+    HAL_StatusTypeDef st = I2CBus_MemWrite(dev->i2cHandle, BQ76907_I2C_ADDRESS, reg, &data, 1);
     if (st != HAL_OK){
         BM_PUSH_ERROR(dev, BM_SRC_BQ76907, BM_ERR_I2C, (uint8_t)st, reg, data);
     }
@@ -186,36 +203,79 @@ HAL_StatusTypeDef BQ76907_exitConfigUpdate(BQ76907 *dev){
     return BQ76907_WriteRegister(dev, BQ76907_CMD_EXIT_CFGUPDATE, 0x01); /* TODO_VERIFY */
 }
 
+/* One threshold byte; saturates instead of wrapping */
+static uint8_t thresholdRaw(uint16_t v, uint16_t lsb){
+    uint16_t raw = v / lsb;
+    return raw > 0xFFu ? 0xFFu : (uint8_t)raw;
+}
+
+uint8_t BQ76907_configValid(const BQ76907_Config *cfg){
+    return cfg->ovThreshold_mV <= BQ76907_CELL_THRESH_MAX_mV &&
+           cfg->uvThreshold_mV < cfg->ovThreshold_mV &&
+           cfg->ocCharge_mA <= BQ76907_CURR_THRESH_MAX_mA &&
+           cfg->ocDischarge1_mA <= BQ76907_CURR_THRESH_MAX_mA &&
+           cfg->ocDischarge2_mA <= BQ76907_CURR_THRESH_MAX_mA;
+}
+
+/* Register values in POWER_CONFIG..ALARM_ENABLE order, with the encodings of
+ * the individual setters below (BQ76907_*_THRESH_LSB, TODO_VERIFY) */
+void BQ76907_configImage(const BQ76907_Config *cfg, uint8_t img[BQ76907_CFG_IMAGE_LEN]){
+#define R(reg) img[(reg) - BQ76907_CFG_FIRST_REG]
+    R(BQ76907_REG_POWER_CONFIG)            = cfg->powerConfig;
+    R(BQ76907_REG_DA_CONFIG)               = cfg->daConfig;
+    R(BQ76907_REG_REGOUT_CONFIG)           = cfg->regoutConfig;
+    R(BQ76907_REG_VCELL_MODE)              = cfg->cellCount;
+    R(BQ76907_REG_ALARM_MASK_DEFAULT)      = cfg->alarmMaskDefault;
+    R(BQ76907_REG_FET_OPTIONS)             = cfg->fetOptions;
+    R(BQ76907_REG_ENABLED_PROTECTIONS_A)   = cfg->protectionsA;
+    R(BQ76907_REG_ENABLED_PROTECTIONS_B)   = cfg->protectionsB;
+    R(BQ76907_REG_DSG_FET_PROTECTIONS_A)   = cfg->dsgFetProtA;
+    R(BQ76907_REG_CHG_FET_PROTECTIONS_A)   = cfg->chgFetProtA;
+    R(BQ76907_REG_LATCH_LIMIT)             = cfg->latchLimit;
+    R(BQ76907_REG_MAX_INTERNAL_TEMP)       = cfg->maxInternalTemp_C;
+    R(BQ76907_REG_CUV_THRESHOLD)           = thresholdRaw(cfg->uvThreshold_mV, BQ76907_CELL_THRESH_LSB_mV);
+    R(BQ76907_REG_COV_THRESHOLD)           = thresholdRaw(cfg->ovThreshold_mV, BQ76907_CELL_THRESH_LSB_mV);
+    R(BQ76907_REG_OCD_CHG_THRESHOLD)       = thresholdRaw(cfg->ocCharge_mA, BQ76907_CURR_THRESH_LSB_mA);
+    R(BQ76907_REG_OCD_DISCH1_THRESHOLD)    = thresholdRaw(cfg->ocDischarge1_mA, BQ76907_CURR_THRESH_LSB_mA);
+    R(BQ76907_REG_OCD_DISCH2_THRESHOLD)    = thresholdRaw(cfg->ocDischarge2_mA, BQ76907_CURR_THRESH_LSB_mA);
+    R(BQ76907_REG_INT_OT_THRESHOLD)        = cfg->internalOT_C;
+    R(BQ76907_REG_VOLTAGE_TIME)            = cfg->voltageTimeUnits;
+    R(BQ76907_REG_ALARM_ENABLE)            = cfg->alarmEnableMask;
+#undef R
+}
+
+uint8_t BQ76907_configScript(const BQ76907_Config *cfg, BQ_RegWrite *out){
+    uint8_t img[BQ76907_CFG_IMAGE_LEN];
+    BQ76907_configImage(cfg, img);
+    uint8_t n = 0;
+    out[n++] = (BQ_RegWrite){ BQ76907_CMD_SET_CFGUPDATE, 1, { 0x01 } };   /* TODO_VERIFY */
+    for (uint8_t i = 0; i < BQ76907_CFG_IMAGE_LEN; i++){
+        out[n++] = (BQ_RegWrite){ (uint8_t)(BQ76907_CFG_FIRST_REG + i), 1, { img[i] } };
+    }
+    out[n++] = (BQ_RegWrite){ BQ76907_CMD_EXIT_CFGUPDATE, 1, { 0x01 } };  /* TODO_VERIFY */
+    return n;
+}
+
 HAL_StatusTypeDef BQ76907_applyConfig(BQ76907 *dev, const BQ76907_Config *cfg){
-    /* High level sequence: enter config, write registers, exit config */
-    HAL_StatusTypeDef st = BQ76907_enterConfigUpdate(dev); if (st!=HAL_OK) return st;
-    st = BQ76907_setPowerConfig(dev, cfg->powerConfig); if (st!=HAL_OK) return st;
-    st = BQ76907_setDAConfig(dev, cfg->daConfig); if (st!=HAL_OK) return st;
-    st = BQ76907_setRegoutConfig(dev, cfg->regoutConfig); if (st!=HAL_OK) return st;
-    st = BQ76907_setVcellMode(dev, cfg->cellCount); if (st!=HAL_OK) return st;
-    st = BQ76907_setAlarmMaskDefault(dev, cfg->alarmMaskDefault); if (st!=HAL_OK) return st;
-    st = BQ76907_setFETOptions(dev, cfg->fetOptions); if (st!=HAL_OK) return st;
-    st = BQ76907_enableProtectionsA(dev, cfg->protectionsA); if (st!=HAL_OK) return st;
-    st = BQ76907_enableProtectionsB(dev, cfg->protectionsB); if (st!=HAL_OK) return st;
-    st = BQ76907_setDSGFetProtectionsA(dev, cfg->dsgFetProtA); if (st!=HAL_OK) return st;
-    st = BQ76907_setCHGFetProtectionsA(dev, cfg->chgFetProtA); if (st!=HAL_OK) return st;
-    st = BQ76907_setLatchLimit(dev, cfg->latchLimit); if (st!=HAL_OK) return st;
-    st = BQ76907_setMaxInternalTemp(dev, cfg->maxInternalTemp_C); if (st!=HAL_OK) return st;
-    st = BQ76907_setCUVThreshold(dev, cfg->uvThreshold_mV); if (st!=HAL_OK) return st;
-    st = BQ76907_setCOVThreshold(dev, cfg->ovThreshold_mV); if (st!=HAL_OK) return st;
-    st = BQ76907_setOCChargeThreshold(dev, cfg->ocCharge_mA); if (st!=HAL_OK) return st;
-    st = BQ76907_setOCDischarge1Threshold(dev, cfg->ocDischarge1_mA); if (st!=HAL_OK) return st;
-    st = BQ76907_setOCDischarge2Threshold(dev, cfg->ocDischarge2_mA); if (st!=HAL_OK) return st;
-    st = BQ76907_setInternalOTThreshold(dev, cfg->internalOT_C); if (st!=HAL_OK) return st;
-    st = BQ76907_setVoltageTime(dev, cfg->voltageTimeUnits); if (st!=HAL_OK) return st;
-    st = BQ76907_setAlarmEnable(dev, cfg->alarmEnableMask); if (st!=HAL_OK) return st;
-    /* Additional host-side scheduling for balanceInterval_ms not written here */
-    HAL_StatusTypeDef st2 = BQ76907_exitConfigUpdate(dev);
-    if (st2 == HAL_OK) {
-        dev->activeConfig = *cfg; /* snapshot */
-        return st;
+    /* High level sequence: enter config, write registers, exit config. The
+     * register writes stop at the first failure (config update left open). */
+    BQ_RegWrite script[BQ76907_CFG_SCRIPT_LEN];
+    uint8_t n = BQ76907_configScript(cfg, script);
+    for (uint8_t i = 0; i + 1u < n; i++){
+        HAL_StatusTypeDef st = BQ76907_WriteRegister(dev, script[i].reg, script[i].data[0]);
+        if (st != HAL_OK) return st;
     }
-    return (st==HAL_OK)? st2 : st; /* return first failure or exit failure */
+    /* Additional host-side scheduling for balanceInterval_ms not written here */
+    HAL_StatusTypeDef st = BQ76907_WriteRegister(dev, script[n - 1u].reg, script[n - 1u].data[0]);
+    if (st == HAL_OK) dev->activeConfig = *cfg; /* snapshot */
+    return st;
+}
+
+uint8_t BQ76907_configMatches(BQ76907 *dev, const BQ76907_Config *cfg){
+    uint8_t want[BQ76907_CFG_IMAGE_LEN], have[BQ76907_CFG_IMAGE_LEN];
+    BQ76907_configImage(cfg, want);
+    if (BQ76907_ReadRegisters(dev, BQ76907_CFG_FIRST_REG, have, BQ76907_CFG_IMAGE_LEN) != HAL_OK) return 0;
+    return memcmp(want, have, sizeof(want)) == 0;
 }
 
 /* Individual register writers (placeholder conversions) */
@@ -233,11 +293,15 @@ HAL_StatusTypeDef BQ76907_setDSGFetProtectionsA(BQ76907 *dev, uint8_t mask){ ret
 HAL_StatusTypeDef BQ76907_setCHGFetProtectionsA(BQ76907 *dev, uint8_t mask){ return WRITE_RAW(dev, BQ76907_REG_CHG_FET_PROTECTIONS_A, mask); }
 HAL_StatusTypeDef BQ76907_setLatchLimit(BQ76907 *dev, uint8_t v){ return WRITE_RAW(dev, BQ76907_REG_LATCH_LIMIT, v); }
 HAL_StatusTypeDef BQ76907_setMaxInternalTemp(BQ76907 *dev, uint8_t degC){ return WRITE_RAW(dev, BQ76907_REG_MAX_INTERNAL_TEMP, degC); }
-HAL_StatusTypeDef BQ76907_setCUVThreshold(BQ76907 *dev, uint16_t mV){ /* scale to raw TODO */ return WRITE_RAW(dev, BQ76907_REG_CUV_THRESHOLD, (mV/10)); }
-HAL_StatusTypeDef BQ76907_setCOVThreshold(BQ76907 *dev, uint16_t mV){ return WRITE_RAW(dev, BQ76907_REG_COV_THRESHOLD, (mV/10)); }
-HAL_StatusTypeDef BQ76907_setOCChargeThreshold(BQ76907 *dev, uint16_t mA){ return WRITE_RAW(dev, BQ76907_REG_OCD_CHG_THRESHOLD, (mA/10)); }
-HAL_StatusTypeDef BQ76907_setOCDischarge1Threshold(BQ76907 *dev, uint16_t mA){ return WRITE_RAW(dev, BQ76907_REG_OCD_DISCH1_THRESHOLD, (mA/10)); }
-HAL_StatusTypeDef BQ76907_setOCDischarge2Threshold(BQ76907 *dev, uint16_t mA){ return WRITE_RAW(dev, BQ76907_REG_OCD_DISCH2_THRESHOLD, (mA/10)); }
+/* Thresholds past the register range are refused rather than clamped: a
+ * protection limit silently lowered or raised is worse than none written */
+#define WRITE_MV(dev, reg, mV) ((mV) > BQ76907_CELL_THRESH_MAX_mV ? HAL_ERROR : WRITE_RAW(dev, reg, (mV) / BQ76907_CELL_THRESH_LSB_mV))
+#define WRITE_MA(dev, reg, mA) ((mA) > BQ76907_CURR_THRESH_MAX_mA ? HAL_ERROR : WRITE_RAW(dev, reg, (mA) / BQ76907_CURR_THRESH_LSB_mA))
+HAL_StatusTypeDef BQ76907_setCUVThreshold(BQ76907 *dev, uint16_t mV){ return WRITE_MV(dev, BQ76907_REG_CUV_THRESHOLD, mV); }
+HAL_StatusTypeDef BQ76907_setCOVThreshold(BQ76907 *dev, uint16_t mV){ return WRITE_MV(dev, BQ76907_REG_COV_THRESHOLD, mV); }
+HAL_StatusTypeDef BQ76907_setOCChargeThreshold(BQ76907 *dev, uint16_t mA){ return WRITE_MA(dev, BQ76907_REG_OCD_CHG_THRESHOLD, mA); }
+HAL_StatusTypeDef BQ76907_setOCDischarge1Threshold(BQ76907 *dev, uint16_t mA){ return WRITE_MA(dev, BQ76907_REG_OCD_DISCH1_THRESHOLD, mA); }
+HAL_StatusTypeDef BQ76907_setOCDischarge2Threshold(BQ76907 *dev, uint16_t mA){ return WRITE_MA(dev, BQ76907_REG_OCD_DISCH2_THRESHOLD, mA); }
 HAL_StatusTypeDef BQ76907_setInternalOTThreshold(BQ76907 *dev, uint8_t degC){ return WRITE_RAW(dev, BQ76907_REG_INT_OT_THRESHOLD, degC); }
 HAL_StatusTypeDef BQ76907_setVoltageTime(BQ76907 *dev, uint8_t raw){ return WRITE_RAW(dev, BQ76907_REG_VOLTAGE_TIME, raw); }
 HAL_StatusTypeDef BQ76907_setAlarmEnable(BQ76907 *dev, uint8_t mask){ return WRITE_RAW(dev, BQ76907_REG_ALARM_ENABLE, mask); }
@@ -328,17 +392,8 @@ HAL_StatusTypeDef BQ76907_configTemperatureProtection(BQ76907 *dev, uint8_t ot_C
 /* ================= Debug Dump ================= */
 void BQ76907_debugDump(const BQ76907 *dev){
     if (!dev){ BQ_LOG("BQ76907: (null)"); return; }
-    BQ_LOG("BQ76907 Dump: Pack=%u mV T=%d.%uC", (unsigned)dev->packVoltage_mV,
-           dev->ts1_degC_x10/10, (unsigned)(dev->ts1_degC_x10%10));
-    for (int i=0;i<4;i++) BQ_LOG("  Cell%u=%u mV", i+1, (unsigned)dev->cellVoltage_mV[i]);
-    BQ_LOG("  Flags: OV=%u UV=%u OCD=%u SCD=%u OT=%u CC_RDY=%u DEV_RDY=%u",
-           dev->status.ov_fault,
-           dev->status.uv_fault,
-           dev->status.ocd_fault,
-           dev->status.scd_fault,
-           dev->status.ot_fault,
-           dev->status.cc_ready,
-           dev->status.dev_ready);
+    BQ_LOG("BQ76907 Dump:");
+    BQ_RegDesc_log("76907", dev, BQ76907_regDesc, BQ76907_regDescCount);
 }
 
 /* ================= Periodic Status Logger ================= */
@@ -346,28 +401,14 @@ void BQ76907_logStatus(BQ76907 *dev){
     if (!dev) return;
     /* Throttle: only every 2000 ms */
     static uint32_t lastTick = 0;
+    static BQ_Snapshot last;
     uint32_t now = HAL_GetTick();
     if ((now - lastTick) < 2000u) return;
     lastTick = now;
 
-    /* Ensure latest measurements (non-fatal if any fail; flags may be stale) */
-    (void)BQ76907_readSystemStatus(dev);
-    (void)BQ76907_readPackVoltage(dev);
-    (void)BQ76907_readCellVoltages(dev);
-    (void)BQ76907_readTemperature1(dev);
-
-    BQ_LOG("76907 STAT Pack=%umV Cells=%u,%u,%u,%u mV T=%d.%uC F:OV=%u UV=%u OCD=%u SCD=%u OT=%u CC=%u DEV=%u",
-        (unsigned)dev->packVoltage_mV,
-        (unsigned)dev->cellVoltage_mV[0], (unsigned)dev->cellVoltage_mV[1],
-        (unsigned)dev->cellVoltage_mV[2], (unsigned)dev->cellVoltage_mV[3],
-        dev->ts1_degC_x10/10, (unsigned)(dev->ts1_degC_x10%10),
-        dev->status.ov_fault,
-        dev->status.uv_fault,
-        dev->status.ocd_fault,
-        dev->status.scd_fault,
-        dev->status.ot_fault,
-        dev->status.cc_ready,
-        dev->status.dev_ready);
+    /* Values come from the last refresh (UpdateMonitor / queued bus refresh);
+     * re-reading here only doubled the bus traffic. */
+    BQ_RegDesc_logStatus("76907", dev, BQ76907_regDesc, BQ76907_regDescCount, now, &last);
 }
 
 /* ================= Config Logger ================= */
@@ -384,15 +425,16 @@ void BQ76907_logConfig(const BQ76907 *dev){
 }
 
 /* ================= Error API ================= */
-int8_t  BQ76907_getLastError(const BQ76907 *dev){ return dev ? dev->lastError : (int8_t)BM_ERR_UNKNOWN; }
-uint8_t BQ76907_getErrorCount(const BQ76907 *dev){ return dev ? (dev->errorHead > BM_ERROR_LOG_DEPTH ? BM_ERROR_LOG_DEPTH : dev->errorHead) : 0; }
+int8_t  BQ76907_getLastError(const BQ76907 *dev){ return dev ? dev->errors.lastError : (int8_t)BM_ERR_UNKNOWN; }
+uint8_t BQ76907_getErrorCount(const BQ76907 *dev){ return dev ? (uint8_t)BM_ErrorRingCount(&dev->errors) : 0; }
 void    BQ76907_dumpErrors(const BQ76907 *dev){
     if (!dev){ BQ_LOG("BQ76907 errors: (null)"); return; }
-    uint8_t count = (dev->errorHead > BM_ERROR_LOG_DEPTH)? BM_ERROR_LOG_DEPTH : dev->errorHead;
-    BQ_LOG("BQ76907 Error Log (most recent %u):", count);
-    for (uint8_t i=0;i<count;i++){
-        const BM_ErrorEntry *e = &dev->errorLog[i];
-        BQ_LOG("  t=%lu code=%d det=%u reg=0x%02X val=0x%04X", (unsigned long)e->tick, (int)e->code, e->detail, e->reg, e->value);
+    uint32_t count = BM_ErrorRingCount(&dev->errors);
+    BQ_LOG("BQ76907 Error Log (most recent %lu):", (unsigned long)count);
+    for (uint32_t i=0;i<count;i++){
+        BM_ErrorEntry e;
+        if (!BM_ErrorRead(&dev->errors, i, &e)) continue;   /* being written */
+        BQ_LOG("  t=%lu code=%d det=%u reg=0x%02X val=0x%04X", (unsigned long)e.tick, (int)e.code, e.detail, e.reg, e.value);
     }
 }
 
@@ -0,0 +1,131 @@
+/*
+ * bq_regdesc.c
+ *
+ *  Table-driven decode, encode, printing and snapshots over the register
+ *  descriptors (see bq_regdesc.h). One copy serves both drivers.
+ */
+#include "bq_regdesc.h"
+#include <stdio.h>
+#include <string.h>
+
+void BQ_RegDesc_decode(void *dev, const BQ_RegDesc *tab, uint8_t count,
+                       uint8_t firstReg, const uint8_t *data, uint8_t len){
+    uint8_t *base = (uint8_t *)dev;
+    for (uint8_t r = 0; r < count; r++){
+        const BQ_RegDesc *reg = &tab[r];
+        uint8_t i = (uint8_t)(reg->addr - firstReg);
+        if (reg->addr < firstReg || i + reg->width > len) continue;
+        if (reg->fields){
+            for (uint8_t f = 0; f < reg->fieldCount; f++){
+                base[reg->offset + f] = (uint8_t)((data[i] >> reg->fields[f].lsb) &
+                                                  BQ_FIELD_BITS(reg->fields[f].msb, reg->fields[f].lsb));
+            }
+        } else {
+            uint16_t v = (uint16_t)((data[i] << 8) | data[i + 1]);
+            if (reg->scale) v = reg->scale(v);
+            memcpy(base + reg->offset, &v, sizeof(v));
+        }
+    }
+}
+
+uint8_t BQ_RegDesc_encode(const void *dev, const BQ_RegDesc *reg){
+    const uint8_t *base = (const uint8_t *)dev;
+    uint8_t v = 0;
+    for (uint8_t i = 0; i < reg->fieldCount; i++){
+        const BQ_FieldDesc *f = &reg->fields[i];
+        v |= (uint8_t)((base[reg->offset + i] & BQ_FIELD_BITS(f->msb, f->lsb)) << f->lsb);
+    }
+    return v;
+}
+
+uint16_t BQ_RegDesc_value(const void *dev, const BQ_RegDesc *reg){
+    if (reg->fields) return BQ_RegDesc_encode(dev, reg);
+    const uint8_t *p = (const uint8_t *)dev + reg->offset;
+    uint16_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/* Next string in a NUL-separated name list */
+static const char *nextName(const char *s){ return s + strlen(s) + 1; }
+
+static void printValue(const BQ_RegDesc *reg, uint16_t v){
+    if (reg->flags & BQ_REG_SIGNED) printf("%d", (int)(int16_t)v);
+    else                            printf("%u", (unsigned)v);
+    printf(" %s", nextName(reg->text));
+}
+
+void BQ_RegDesc_log(const char *tag, const void *dev, const BQ_RegDesc *tab, uint8_t count){
+    const uint8_t *base = (const uint8_t *)dev;
+    for (uint8_t r = 0; r < count; r++){
+        const BQ_RegDesc *reg = &tab[r];
+        printf("[BQ] %s %s(0x%02X)=", tag, reg->text, reg->addr);
+        if (reg->fields){
+            const char *name = reg->text;
+            printf("0x%02X", BQ_RegDesc_encode(dev, reg));
+            for (uint8_t i = 0; i < reg->fieldCount; i++){
+                name = nextName(name);
+                printf(" %s=%u", name, base[reg->offset + i]);
+            }
+        } else {
+            printValue(reg, BQ_RegDesc_value(dev, reg));
+        }
+        printf("\n");
+    }
+}
+
+void BQ_RegDesc_logCompact(const char *tag, const void *dev, const BQ_RegDesc *tab, uint8_t count){
+    printf("[BQ] %s STAT", tag);
+    for (uint8_t r = 0; r < count; r++){
+        const BQ_RegDesc *reg = &tab[r];
+        if (reg->fields){
+            printf(" %02X=%02X", reg->addr, BQ_RegDesc_encode(dev, reg));
+        } else {
+            printf(" %s=", reg->text);
+            printValue(reg, BQ_RegDesc_value(dev, reg));
+        }
+    }
+    printf("\n");
+}
+
+void BQ_RegDesc_snapshot(const void *dev, const BQ_RegDesc *tab, uint8_t count, uint32_t tick, BQ_Snapshot *out){
+    if (count > BQ_SNAPSHOT_MAX_REGS) count = BQ_SNAPSHOT_MAX_REGS;
+    out->tick = tick;
+    out->valid = 1;
+    for (uint8_t r = 0; r < count; r++) out->value[r] = BQ_RegDesc_value(dev, &tab[r]);
+}
+
+uint8_t BQ_RegDesc_logChanges(const char *tag, const BQ_RegDesc *tab, uint8_t count,
+                              const BQ_Snapshot *prev, const BQ_Snapshot *cur){
+    uint8_t changed = 0;
+    if (count > BQ_SNAPSHOT_MAX_REGS) count = BQ_SNAPSHOT_MAX_REGS;
+    for (uint8_t r = 0; r < count; r++){
+        const BQ_RegDesc *reg = &tab[r];
+        uint16_t a = prev->value[r], b = cur->value[r];
+        if (a == b) continue;
+        if (!reg->fields){
+            /* Measurements move every sample; only bit-field changes are events */
+            continue;
+        }
+        const char *name = reg->text;
+        for (uint8_t i = 0; i < reg->fieldCount; i++){
+            const BQ_FieldDesc *f = &reg->fields[i];
+            name = nextName(name);
+            uint8_t fa = (uint8_t)((a >> f->lsb) & BQ_FIELD_BITS(f->msb, f->lsb));
+            uint8_t fb = (uint8_t)((b >> f->lsb) & BQ_FIELD_BITS(f->msb, f->lsb));
+            if (fa == fb) continue;
+            printf("[BQ] %s %s.%s %u->%u\n", tag, reg->text, name, fa, fb);
+            changed++;
+        }
+    }
+    return changed;
+}
+
+void BQ_RegDesc_logStatus(const char *tag, const void *dev, const BQ_RegDesc *tab, uint8_t count,
+                          uint32_t tick, BQ_Snapshot *last){
+    BQ_Snapshot cur;
+    BQ_RegDesc_snapshot(dev, tab, count, tick, &cur);
+    BQ_RegDesc_logCompact(tag, dev, tab, count);
+    if (last->valid) BQ_RegDesc_logChanges(tag, tab, count, last, &cur);
+    *last = cur;
+}
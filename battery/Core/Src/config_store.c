@@ -0,0 +1,229 @@
+/*
+ * config_store.c
+ *
+ *  Flash-backed configuration store (see config_store.h).
+ */
+#include "config_store.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define NO_SLOT   0xFFu
+#define HDR_SIZE  ((uint32_t)sizeof(ConfigStore_Header))
+
+typedef enum { config_store_hdr_dw = 1 / (sizeof(ConfigStore_Header) == 16u ? 1u : 0u) } ConfigStore_HeaderCheck;
+
+/* Upgrade hooks: migrations[v] turns a schema v image (already laid over the
+ * defaults) into schema v + 1. NULL when the defaults of the appended fields
+ * are all the upgrade needs. */
+typedef void (*ConfigStore_Migration)(ConfigStore_Data *data);
+static const ConfigStore_Migration migrations[CONFIG_STORE_SCHEMA] = {
+    NULL,   /* 0 -> 1: calibration appended, defaults apply */
+};
+
+static const ConfigStore_Data *current;
+static ConfigStore_Data ram;               /* defaults / migrated image */
+static ConfigStore_Data pending;           /* RequestCommit image */
+static uint8_t commitRequested;
+static ConfigStore_Stats stats;
+
+/* CRC-32 (reflected, poly 0xEDB88320), bitwise: runs once per boot and per commit */
+uint32_t ConfigStore_Crc32(uint32_t crc, const uint8_t *data, uint32_t len){
+    crc = ~crc;
+    while (len--){
+        crc ^= *data++;
+        for (uint8_t b = 0; b < 8; b++) crc = (crc & 1u) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+    }
+    return ~crc;
+}
+
+/* CRC over the header fields after the magic, then the payload */
+static uint32_t imageCrc(const ConfigStore_Header *h, const uint8_t *payload){
+    uint32_t crc = ConfigStore_Crc32(0, (const uint8_t *)&h->schema, sizeof(h->schema) + sizeof(h->size) + sizeof(h->seq));
+    return ConfigStore_Crc32(crc, payload, h->size);
+}
+
+static uint32_t slotOffset(uint8_t slot){
+    return (uint32_t)slot * CONFIG_STORE_PAGE_SIZE;
+}
+
+/* Header of a slot that holds a complete image of any schema, else NULL */
+static const ConfigStore_Header *validSlot(uint8_t slot){
+    const ConfigStore_Header *h = (const ConfigStore_Header *)ConfigStore_FlashRead(slotOffset(slot));
+    if (h->magic != CONFIG_STORE_MAGIC) return NULL;
+    if (h->size == 0 || HDR_SIZE + h->size > CONFIG_STORE_PAGE_SIZE) return NULL;
+    if (imageCrc(h, ConfigStore_FlashRead(slotOffset(slot) + HDR_SIZE)) != h->crc) return NULL;
+    return h;
+}
+
+/* Never written since erase (a torn commit has at least part of the header) */
+static uint8_t slotEmpty(uint8_t slot){
+    const uint8_t *p = ConfigStore_FlashRead(slotOffset(slot));
+    for (uint32_t i = 0; i < HDR_SIZE; i++) if (p[i] != 0xFFu) return 0;
+    return 1;
+}
+
+/* Older schema: its fields over the defaults, then the upgrade hooks */
+static void upgrade(uint8_t slot, const ConfigStore_Header *h, const ConfigStore_Data *defaults, ConfigStore_Data *out){
+    *out = *defaults;
+    memcpy(out, ConfigStore_FlashRead(slotOffset(slot) + HDR_SIZE), h->size < sizeof(*out) ? h->size : sizeof(*out));
+    for (uint16_t v = h->schema; v < CONFIG_STORE_SCHEMA; v++){
+        if (migrations[v]) migrations[v](out);
+    }
+}
+
+static uint8_t inPlace(const ConfigStore_Header *h){
+    return h->schema == CONFIG_STORE_SCHEMA && h->size == sizeof(ConfigStore_Data);
+}
+
+/* Values the devices can hold: a CRC only proves the image is the one
+ * committed, not that the monitor can be programmed with it */
+static uint8_t dataValid(const ConfigStore_Data *d){
+    return BQ76907_configValid(&d->monitor);
+}
+
+static uint8_t slotUsable(uint8_t slot, const ConfigStore_Header *h, const ConfigStore_Data *defaults){
+    if (inPlace(h)) return dataValid((const ConfigStore_Data *)ConfigStore_FlashRead(slotOffset(slot) + HDR_SIZE));
+    upgrade(slot, h, defaults, &ram);
+    return dataValid(&ram);
+}
+
+void ConfigStore_Init(const ConfigStore_Data *defaults){
+    const ConfigStore_Header *best = NULL;
+    uint8_t bestSlot = NO_SLOT;
+    memset(&stats, 0, sizeof(stats));
+    commitRequested = 0;
+
+    for (uint8_t s = 0; s < CONFIG_STORE_SLOTS; s++){
+        const ConfigStore_Header *h = validSlot(s);
+        if (!h || h->schema > CONFIG_STORE_SCHEMA || !slotUsable(s, h, defaults)){
+            if (!slotEmpty(s)) stats.invalid++;
+            continue;
+        }
+        if (!best || (int32_t)(h->seq - best->seq) > 0){
+            best = h;
+            bestSlot = s;
+        }
+    }
+
+    stats.slot = bestSlot;
+    if (!best){
+        ram = *defaults;
+        current = &ram;
+        stats.source = CONFIG_SRC_DEFAULTS;
+        return;
+    }
+    stats.schema = best->schema;
+    stats.seq = best->seq;
+    if (inPlace(best)){
+        current = (const ConfigStore_Data *)ConfigStore_FlashRead(slotOffset(bestSlot) + HDR_SIZE);
+        stats.source = CONFIG_SRC_FLASH;
+        return;
+    }
+
+    upgrade(bestSlot, best, defaults, &ram);
+    current = &ram;
+    stats.source = CONFIG_SRC_MIGRATED;
+    ConfigStore_Commit(&ram);    /* on failure the migrated copy stays in RAM */
+}
+
+const ConfigStore_Data *ConfigStore_Get(void){
+    return current;
+}
+
+const ConfigStore_ChargeProfile *ConfigStore_ActiveProfile(void){
+    uint8_t p = current->activeProfile;
+    return &current->profile[p < CONFIG_STORE_PROFILES ? p : 0];
+}
+
+HAL_StatusTypeDef ConfigStore_Commit(const ConfigStore_Data *data){
+    if (!dataValid(data)){
+        stats.rejected++;
+        return HAL_ERROR;
+    }
+    uint8_t slot = stats.slot == NO_SLOT ? 0u : (uint8_t)((stats.slot + 1u) % CONFIG_STORE_SLOTS);
+    uint32_t base = slotOffset(slot);
+    ConfigStore_Header h = {
+        .magic = CONFIG_STORE_MAGIC, .schema = CONFIG_STORE_SCHEMA,
+        .size = (uint16_t)sizeof(ConfigStore_Data), .seq = stats.seq + 1u };
+    h.crc = imageCrc(&h, (const uint8_t *)data);
+
+    if (ConfigStore_FlashErase(slot) != HAL_OK) goto fail;
+    for (uint32_t off = 0; off < sizeof(ConfigStore_Data); off += 8u){
+        uint64_t dw = ~(uint64_t)0;    /* tail of the last double word stays erased */
+        uint32_t n = sizeof(ConfigStore_Data) - off < 8u ? (uint32_t)sizeof(ConfigStore_Data) - off : 8u;
+        memcpy(&dw, (const uint8_t *)data + off, n);
+        if (ConfigStore_FlashProgram(base + HDR_SIZE + off, dw) != HAL_OK) goto fail;
+    }
+    uint64_t dw[2];
+    memcpy(dw, &h, sizeof(dw));
+    /* {seq, crc} first, the magic last: the image only counts once complete */
+    if (ConfigStore_FlashProgram(base + 8u, dw[1]) != HAL_OK) goto fail;
+    if (ConfigStore_FlashProgram(base, dw[0]) != HAL_OK) goto fail;
+    if (validSlot(slot) == NULL ||
+        memcmp(ConfigStore_FlashRead(base + HDR_SIZE), data, sizeof(ConfigStore_Data)) != 0) goto fail;
+
+    current = (const ConfigStore_Data *)ConfigStore_FlashRead(base + HDR_SIZE);
+    stats.slot = slot;
+    stats.seq = h.seq;
+    stats.commits++;
+    return HAL_OK;
+
+fail:
+    stats.errors++;
+    return HAL_ERROR;
+}
+
+void ConfigStore_RequestCommit(const ConfigStore_Data *data){
+    pending = *data;
+    commitRequested = 1;
+}
+
+const ConfigStore_Data *ConfigStore_TakeCommitRequest(void){
+    if (!commitRequested) return NULL;
+    commitRequested = 0;
+    return &pending;
+}
+
+const ConfigStore_Stats *ConfigStore_GetStats(void){
+    return &stats;
+}
+
+void ConfigStore_LogStats(void){
+    static const char *const src[] = { "defaults", "flash", "migrated" };
+    printf("[CFG] source=%s slot=%d seq=%lu schema=%u/%u commits=%lu invalid=%lu rejected=%lu errors=%lu profile=%s\n",
+        src[stats.source < 3u ? stats.source : 0], stats.slot == NO_SLOT ? -1 : (int)stats.slot,
+        (unsigned long)stats.seq, (unsigned)stats.schema, (unsigned)CONFIG_STORE_SCHEMA,
+        (unsigned long)stats.commits, (unsigned long)stats.invalid, (unsigned long)stats.rejected,
+        (unsigned long)stats.errors,
+        current ? ConfigStore_ActiveProfile()->name : "-");
+}
+
+#if !defined(USE_HAL_STUBS)
+/* ================= Target flash access ================= */
+/* Bank 2 page numbers start at 256 in FLASH_CR.PNB on the dual-bank G0B1 (TODO_VERIFY RM0444) */
+#define CONFIG_STORE_FIRST_PAGE  (256u + (CONFIG_STORE_BASE - FLASH_BASE - FLASH_BANK_SIZE) / FLASH_PAGE_SIZE)
+
+const uint8_t *ConfigStore_FlashRead(uint32_t offset){
+    return (const uint8_t *)(CONFIG_STORE_BASE + offset);
+}
+
+HAL_StatusTypeDef ConfigStore_FlashProgram(uint32_t offset, uint64_t data){
+    HAL_FLASH_Unlock();
+    HAL_StatusTypeDef st = HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, CONFIG_STORE_BASE + offset, data);
+    HAL_FLASH_Lock();
+    return st;
+}
+
+/* Blocking; a fault log erase in progress is waited out by the HAL */
+HAL_StatusTypeDef ConfigStore_FlashErase(uint32_t slot){
+    FLASH_EraseInitTypeDef erase = {
+        .TypeErase = FLASH_TYPEERASE_PAGES, .Banks = FLASH_BANK_2,
+        .Page = CONFIG_STORE_FIRST_PAGE + slot, .NbPages = 1 };
+    uint32_t pageError = 0;
+    HAL_FLASH_Unlock();
+    HAL_StatusTypeDef st = HAL_FLASHEx_Erase(&erase, &pageError);
+    HAL_FLASH_Lock();
+    return st;
+}
+#endif
@@ -0,0 +1,198 @@
+/*
+ * faultlog.c
+ *
+ *  Flash-backed fault log (see faultlog.h).
+ */
+#include "faultlog.h"
+#include <stdio.h>
+#include <string.h>
+#if defined(USE_HAL_STUBS)
+#define FAULTLOG_LOCK()     uint32_t faultlog_pm_ = 0
+#define FAULTLOG_UNLOCK()   (void)faultlog_pm_
+#else
+#define FAULTLOG_LOCK()     uint32_t faultlog_pm_ = __get_PRIMASK(); __disable_irq()
+#define FAULTLOG_UNLOCK()   __set_PRIMASK(faultlog_pm_)
+#endif
+
+#define NO_PAGE   0xFFu
+
+static BM_ErrorEntry queue[FAULTLOG_QUEUE_DEPTH];
+static uint16_t queueLost[FAULTLOG_QUEUE_DEPTH];
+static volatile uint32_t qHead, qTail;     /* free running */
+static uint16_t lostPending;               /* drops since the last queued entry */
+
+static uint8_t  curPage = NO_PAGE;         /* page being written */
+static uint32_t curSeq;                    /* its header sequence */
+static uint32_t nextSlot;                  /* next free record slot in curPage */
+static uint8_t  erasePage = NO_PAGE;       /* erase in progress */
+static FaultLog_Stats stats;
+
+/* CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF), bitwise: a few records a minute */
+uint16_t FaultLog_Crc16(const uint8_t *data, uint32_t len){
+    uint16_t crc = 0xFFFFu;
+    while (len--){
+        crc ^= (uint16_t)(*data++ << 8);
+        for (uint8_t b = 0; b < 8; b++) crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+static uint32_t slotOffset(uint8_t page, uint32_t slot){
+    return (uint32_t)page * FAULTLOG_PAGE_SIZE + 8u + slot * FAULTLOG_REC_SIZE;
+}
+
+static uint8_t slotErased(const uint8_t *p){
+    for (uint32_t i = 0; i < FAULTLOG_REC_SIZE; i++) if (p[i] != 0xFFu) return 0;
+    return 1;
+}
+
+void FaultLog_Init(void){
+    uint16_t maxBoot = 0;
+    memset(&stats, 0, sizeof(stats));
+    curPage = NO_PAGE;
+    curSeq = 0;
+    nextSlot = 0;
+    erasePage = NO_PAGE;
+    qHead = qTail = 0;
+    lostPending = 0;
+
+    for (uint8_t p = 0; p < FAULTLOG_PAGES; p++){
+        uint32_t hdr[2];
+        memcpy(hdr, FaultLog_FlashRead((uint32_t)p * FAULTLOG_PAGE_SIZE), sizeof(hdr));
+        if (hdr[0] != FAULTLOG_MAGIC) continue;
+        uint32_t used = 0;
+        for (uint32_t s = 0; s < FAULTLOG_REC_PER_PAGE; s++){
+            const uint8_t *raw = FaultLog_FlashRead(slotOffset(p, s));
+            if (slotErased(raw)) continue;
+            used = s + 1u;
+            FaultLog_Record r;
+            memcpy(&r, raw, sizeof(r));
+            if (FaultLog_Crc16(raw, FAULTLOG_REC_SIZE - 2u) != r.crc){
+                stats.corrupt++;
+                continue;
+            }
+            stats.records++;
+            if (r.boot > maxBoot) maxBoot = r.boot;
+        }
+        if (curPage == NO_PAGE || (int32_t)(hdr[1] - curSeq) > 0){
+            curPage = p;
+            curSeq = hdr[1];
+            nextSlot = used;
+        }
+    }
+    stats.boot = (uint16_t)(maxBoot + 1u);
+}
+
+void FaultLog_Enqueue(const BM_ErrorEntry *e){
+    FAULTLOG_LOCK();
+    if (qHead - qTail >= FAULTLOG_QUEUE_DEPTH){
+        stats.dropped++;
+        if (lostPending < 0xFFFFu) lostPending++;
+    } else {
+        uint32_t i = qHead % FAULTLOG_QUEUE_DEPTH;
+        queue[i] = *e;
+        queueLost[i] = lostPending;
+        lostPending = 0;
+        qHead++;
+    }
+    FAULTLOG_UNLOCK();
+}
+
+uint8_t FaultLog_Service(void){
+    if (erasePage != NO_PAGE){
+        if (FaultLog_FlashBusy()) return 1;
+        uint64_t hdr = FAULTLOG_MAGIC | ((uint64_t)(curSeq + 1u) << 32);
+        if (FaultLog_FlashProgram((uint32_t)erasePage * FAULTLOG_PAGE_SIZE, hdr) != HAL_OK){
+            stats.errors++;
+        }
+        curPage = erasePage;
+        curSeq++;
+        nextSlot = 0;
+        erasePage = NO_PAGE;
+        return qHead != qTail;
+    }
+    if (qHead == qTail) return 0;
+
+    /* Current page full (or none yet): the oldest page is recycled */
+    if (curPage == NO_PAGE || nextSlot >= FAULTLOG_REC_PER_PAGE){
+        uint8_t next = curPage == NO_PAGE ? 0u : (uint8_t)((curPage + 1u) % FAULTLOG_PAGES);
+        if (FaultLog_FlashEraseStart(next) != HAL_OK){
+            stats.errors++;
+            return 1;
+        }
+        erasePage = next;
+        stats.erases++;
+        return 1;
+    }
+
+    uint32_t i = qTail % FAULTLOG_QUEUE_DEPTH;
+    const BM_ErrorEntry *e = &queue[i];
+    FaultLog_Record r = {
+        .tick = e->tick, .boot = stats.boot, .value = e->value, .code = e->code,
+        .detail = e->detail, .source = e->source, .reg = e->reg, .lost = queueLost[i],
+    };
+    r.crc = FaultLog_Crc16((const uint8_t *)&r, FAULTLOG_REC_SIZE - 2u);
+    uint64_t dw[2];
+    memcpy(dw, &r, sizeof(dw));
+    uint32_t off = slotOffset(curPage, nextSlot);
+    /* A failed slot is left behind: it reads back as a corrupt record */
+    nextSlot++;
+    if (FaultLog_FlashProgram(off, dw[0]) != HAL_OK || FaultLog_FlashProgram(off + 8u, dw[1]) != HAL_OK){
+        stats.errors++;
+    } else {
+        stats.written++;
+    }
+    qTail++;
+    return qHead != qTail;
+}
+
+uint32_t FaultLog_Pending(void){
+    return (qHead - qTail) + (erasePage != NO_PAGE ? 1u : 0u);
+}
+
+const FaultLog_Stats *FaultLog_GetStats(void){
+    return &stats;
+}
+
+void FaultLog_LogStats(void){
+    printf("[FLOG] boot=%u stored=%u corrupt=%lu written=%lu dropped=%lu erases=%lu errors=%lu page=%u/%lu\n",
+        (unsigned)stats.boot, (unsigned)stats.records, (unsigned long)stats.corrupt,
+        (unsigned long)stats.written, (unsigned long)stats.dropped, (unsigned long)stats.erases,
+        (unsigned long)stats.errors, (unsigned)curPage, (unsigned long)nextSlot);
+}
+
+#if !defined(USE_HAL_STUBS)
+/* ================= Target flash access ================= */
+/* Bank 2 page numbers start at 256 in FLASH_CR.PNB on the dual-bank G0B1 (TODO_VERIFY RM0444) */
+#define FAULTLOG_FIRST_PAGE  (256u + (FAULTLOG_BASE - FLASH_BASE - FLASH_BANK_SIZE) / FLASH_PAGE_SIZE)
+
+const uint8_t *FaultLog_FlashRead(uint32_t offset){
+    return (const uint8_t *)(FAULTLOG_BASE + offset);
+}
+
+HAL_StatusTypeDef FaultLog_FlashProgram(uint32_t offset, uint64_t data){
+    HAL_FLASH_Unlock();
+    HAL_StatusTypeDef st = HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, FAULTLOG_BASE + offset, data);
+    HAL_FLASH_Lock();
+    return st;
+}
+
+/* Starts the erase and returns; FaultLog_FlashBusy() reports completion.
+ * The CPU keeps running from bank 1 meanwhile. */
+HAL_StatusTypeDef FaultLog_FlashEraseStart(uint32_t page){
+    if (FLASH->SR & (FLASH_SR_BSY1 | FLASH_SR_BSY2)) return HAL_BUSY;
+    HAL_FLASH_Unlock();
+    FLASH->SR = FLASH_SR_ERRORS;   /* rc_w1: clear stale errors before PER */
+    FLASH_PageErase(FLASH_BANK_2, FAULTLOG_FIRST_PAGE + page);
+    return HAL_OK;
+}
+
+uint8_t FaultLog_FlashBusy(void){
+    if (FLASH->SR & (FLASH_SR_BSY1 | FLASH_SR_BSY2)) return 1;
+    if (FLASH->CR & FLASH_CR_PER){
+        CLEAR_BIT(FLASH->CR, FLASH_CR_PER | FLASH_CR_BKER);
+        HAL_FLASH_Lock();
+    }
+    return 0;
+}
+#endif
@@ -137,4 +137,67 @@ void HAL_I2C_MspDeInit(I2C_HandleTypeDef* i2cHandle)
 
 /* USER CODE BEGIN 1 */
 
+#define I2C1_SCL_PIN          GPIO_PIN_9
+#define I2C1_SDA_PIN          GPIO_PIN_10
+#define I2C1_RECOVERY_CLOCKS  9
+
+/* ~5 us at 16 MHz HSI: keeps the bit-banged clock well under 100 kHz */
+static void I2C1_RecoveryDelay(void)
+{
+  for (volatile uint32_t i = 0; i < 20u; i++) { __NOP(); }
+}
+
+/**
+  * @brief  Free a bus held by a slave stuck mid-byte and re-initialise I2C1.
+  *         SCL/SDA are taken over as open-drain GPIO, SCL is clocked until the
+  *         slave releases SDA (at most 9 clocks), a STOP condition is generated
+  *         and the peripheral is brought back up with the MX_I2C1_Init settings.
+  *         Unlike MX_I2C1_Init this never calls Error_Handler.
+  * @retval HAL_OK if SDA was released and the peripheral re-initialised
+  */
+HAL_StatusTypeDef I2CBus_RecoverHardware(I2C_HandleTypeDef *hi2c)
+{
+  if (hi2c == NULL || hi2c->Instance != I2C1) return HAL_ERROR;
+
+  (void)HAL_I2C_DeInit(hi2c);
+
+  GPIO_InitTypeDef GPIO_InitStruct = {0};
+  __HAL_RCC_GPIOA_CLK_ENABLE();
+  HAL_GPIO_WritePin(GPIOA, I2C1_SCL_PIN | I2C1_SDA_PIN, GPIO_PIN_SET);
+  GPIO_InitStruct.Pin = I2C1_SCL_PIN | I2C1_SDA_PIN;
+  GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_OD;
+  GPIO_InitStruct.Pull = GPIO_NOPULL;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+  HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+  I2C1_RecoveryDelay();
+
+  for (uint8_t i = 0; i < I2C1_RECOVERY_CLOCKS &&
+       HAL_GPIO_ReadPin(GPIOA, I2C1_SDA_PIN) == GPIO_PIN_RESET; i++)
+  {
+    HAL_GPIO_WritePin(GPIOA, I2C1_SCL_PIN, GPIO_PIN_RESET);
+    I2C1_RecoveryDelay();
+    HAL_GPIO_WritePin(GPIOA, I2C1_SCL_PIN, GPIO_PIN_SET);
+    I2C1_RecoveryDelay();
+  }
+
+  /* STOP: SDA low -> high while SCL is high */
+  HAL_GPIO_WritePin(GPIOA, I2C1_SCL_PIN, GPIO_PIN_RESET);
+  I2C1_RecoveryDelay();
+  HAL_GPIO_WritePin(GPIOA, I2C1_SDA_PIN, GPIO_PIN_RESET);
+  I2C1_RecoveryDelay();
+  HAL_GPIO_WritePin(GPIOA, I2C1_SCL_PIN, GPIO_PIN_SET);
+  I2C1_RecoveryDelay();
+  HAL_GPIO_WritePin(GPIOA, I2C1_SDA_PIN, GPIO_PIN_SET);
+  I2C1_RecoveryDelay();
+
+  uint8_t released = (HAL_GPIO_ReadPin(GPIOA, I2C1_SDA_PIN) == GPIO_PIN_SET);
+  HAL_GPIO_DeInit(GPIOA, I2C1_SCL_PIN | I2C1_SDA_PIN);
+
+  /* HAL_I2C_Init re-runs HAL_I2C_MspInit (AF6 pin mux, clocks); Init fields are kept */
+  if (HAL_I2C_Init(hi2c) != HAL_OK) return HAL_ERROR;
+  if (HAL_I2CEx_ConfigAnalogFilter(hi2c, I2C_ANALOGFILTER_ENABLE) != HAL_OK) return HAL_ERROR;
+  if (HAL_I2CEx_ConfigDigitalFilter(hi2c, 0) != HAL_OK) return HAL_ERROR;
+  return released ? HAL_OK : HAL_ERROR;
+}
+
 /* USER CODE END 1 */
@@ -0,0 +1,325 @@
+/*
+ * i2c_bus.c
+ *
+ *  Shared I2C bus scheduler (see i2c_bus.h). Single-threaded: Submit and
+ *  Service are called from the main loop only, never from interrupts.
+ */
+#include "i2c_bus.h"
+#include "i2c_rec.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+    I2CBus_Request req;
+    uint8_t  buf[I2C_BUS_MAX_XFER];   /* write payload / read result */
+    uint32_t submitTick;
+    uint32_t seq;                     /* FIFO tie-break */
+    uint8_t  used;
+} I2CBus_Slot;
+
+static I2C_HandleTypeDef *busHandle;
+static I2CBus_Slot slots[I2C_BUS_QUEUE_DEPTH];
+static uint8_t  pendingCount;
+static uint32_t nextSeq;
+static I2CBus_Stats stats;
+static I2CBus_DeviceHealth health[I2C_BUS_MAX_DEVICES];
+static Latency_Hist txnHist[I2C_BUS_MAX_DEVICES];   /* per health slot */
+static uint8_t  busFailStreak;          /* consecutive failures, any device */
+static uint32_t recoverBackoff_ms;
+static uint32_t recoverAt;
+
+void I2CBus_Init(I2C_HandleTypeDef *hi2c){
+    busHandle = hi2c;
+    memset(slots, 0, sizeof(slots));
+    pendingCount = 0;
+    nextSeq = 0;
+    memset(health, 0, sizeof(health));
+    busFailStreak = 0;
+    recoverBackoff_ms = I2C_BUS_BACKOFF_MIN_MS;
+    recoverAt = HAL_GetTick();
+    I2CBus_ResetStats();
+}
+
+/* ================= Health / recovery ================= */
+static I2CBus_DeviceHealth *healthFor(uint16_t devAddress, uint8_t create){
+    for (uint8_t i = 0; i < I2C_BUS_MAX_DEVICES; i++){
+        if (health[i].health && health[i].devAddress == devAddress) return &health[i];
+    }
+    if (!create) return NULL;
+    for (uint8_t i = 0; i < I2C_BUS_MAX_DEVICES; i++){
+        if (!health[i].health){
+            memset(&health[i], 0, sizeof(health[i]));
+            health[i].devAddress = devAddress;
+            health[i].health = I2C_BUS_HEALTH_MAX;
+            Latency_Reset(&txnHist[i]);
+            return &health[i];
+        }
+    }
+    return NULL;   /* table full: device runs untracked */
+}
+
+/* 0 for the first failure (transients retry at once), then MIN, 2*MIN, ... MAX */
+static uint32_t backoffFor(uint8_t fails){
+    if (fails < 2) return 0;
+    uint8_t shift = (uint8_t)(fails - 2);
+    if (shift > 16) shift = 16;
+    uint32_t ms = (uint32_t)I2C_BUS_BACKOFF_MIN_MS << shift;
+    return ms > I2C_BUS_BACKOFF_MAX_MS ? I2C_BUS_BACKOFF_MAX_MS : ms;
+}
+
+static void recordResult(I2CBus_DeviceHealth *h, HAL_StatusTypeDef st){
+    if (st == HAL_OK){
+        busFailStreak = 0;
+        recoverBackoff_ms = I2C_BUS_BACKOFF_MIN_MS;
+        if (h){
+            h->consecutiveFails = 0;
+            h->health = (h->health + I2C_BUS_HEALTH_UP > I2C_BUS_HEALTH_MAX)
+                      ? I2C_BUS_HEALTH_MAX : (uint8_t)(h->health + I2C_BUS_HEALTH_UP);
+        }
+        return;
+    }
+    if (busFailStreak < 0xFF) busFailStreak++;
+    if (h){
+        h->failures++;
+        if (h->consecutiveFails < 0xFF) h->consecutiveFails++;
+        /* Never reach 0: that marks a free table entry */
+        h->health = (h->health > I2C_BUS_HEALTH_DOWN) ? (uint8_t)(h->health - I2C_BUS_HEALTH_DOWN) : 1;
+        h->retryAt = HAL_GetTick() + backoffFor(h->consecutiveFails);
+    }
+}
+
+static void maybeRecover(I2C_HandleTypeDef *hi2c, HAL_StatusTypeDef st){
+    /* HAL_BUSY from the HAL means the BUSY flag never cleared: SDA held low */
+    if (st != HAL_BUSY && busFailStreak < I2C_BUS_RECOVER_AFTER) return;
+    uint32_t now = HAL_GetTick();
+    if ((int32_t)(now - recoverAt) < 0) return;
+
+    stats.recoveries++;
+    if (I2CBus_RecoverHardware(hi2c) != HAL_OK) stats.recoveryFailures++;
+    busFailStreak = 0;
+    recoverAt = now + recoverBackoff_ms;
+    recoverBackoff_ms = (recoverBackoff_ms * 2u > I2C_BUS_BACKOFF_MAX_MS)
+                      ? I2C_BUS_BACKOFF_MAX_MS : recoverBackoff_ms * 2u;
+}
+
+__attribute__((weak)) HAL_StatusTypeDef I2CBus_RecoverHardware(I2C_HandleTypeDef *hi2c){
+    (void)hi2c;
+    return HAL_OK;
+}
+
+const I2CBus_DeviceHealth *I2CBus_GetHealth(uint16_t devAddress){
+    return healthFor(devAddress, 0);
+}
+
+uint8_t I2CBus_DeviceAvailable(uint16_t devAddress){
+    const I2CBus_DeviceHealth *h = healthFor(devAddress, 0);
+    return !h || (int32_t)(HAL_GetTick() - h->retryAt) >= 0;
+}
+
+uint32_t I2CBus_PollInterval(uint16_t devAddress, uint32_t base_ms){
+    const I2CBus_DeviceHealth *h = healthFor(devAddress, 0);
+    if (!h || h->health >= 80) return base_ms;
+    if (h->health >= 50) return base_ms * 2u;
+    if (h->health >= 20) return base_ms * 4u;
+    return base_ms * I2C_BUS_POLL_STRETCH_MAX;
+}
+
+/* ================= Physical transfer + timing ================= */
+static HAL_StatusTypeDef transfer(I2C_HandleTypeDef *hi2c, uint16_t devAddress, uint8_t reg,
+                                  uint8_t *data, uint16_t len, uint8_t write){
+    if (!hi2c) hi2c = busHandle;
+    if (!hi2c || !data || len == 0) return HAL_ERROR;
+
+    I2CBus_DeviceHealth *h = healthFor(devAddress, 1);
+    if (h && h->consecutiveFails && (int32_t)(HAL_GetTick() - h->retryAt) < 0){
+        h->skipped++;
+        return HAL_BUSY;
+    }
+
+    uint32_t t0 = I2C_BUS_NOW_US();
+    HAL_StatusTypeDef st = write
+        ? HAL_I2C_Mem_Write(hi2c, devAddress, reg, I2C_MEMADD_SIZE_8BIT, data, len, I2C_BUS_TIMEOUT_MS)
+        : HAL_I2C_Mem_Read (hi2c, devAddress, reg, I2C_MEMADD_SIZE_8BIT, data, len, I2C_BUS_TIMEOUT_MS);
+    uint32_t dt = I2C_BUS_NOW_US() - t0;
+    I2CRec_Note(devAddress, reg, data, len, write, st);
+
+    stats.transactions++;
+    stats.bytes += len;
+    stats.totalTxn_us += dt;
+    if (dt < stats.minTxn_us) stats.minTxn_us = dt;
+    if (dt > stats.maxTxn_us) stats.maxTxn_us = dt;
+    if (h) Latency_Record(&txnHist[h - health], dt);
+    if (st != HAL_OK) stats.errors++;
+    recordResult(h, st);
+    if (st != HAL_OK) maybeRecover(hi2c, st);
+    return st;
+}
+
+HAL_StatusTypeDef I2CBus_MemRead(I2C_HandleTypeDef *hi2c, uint16_t devAddress, uint8_t reg, uint8_t *data, uint16_t len){
+    return transfer(hi2c, devAddress, reg, data, len, 0);
+}
+
+HAL_StatusTypeDef I2CBus_MemWrite(I2C_HandleTypeDef *hi2c, uint16_t devAddress, uint8_t reg, const uint8_t *data, uint16_t len){
+    /* HAL takes a non-const pointer but does not modify the payload */
+    return transfer(hi2c, devAddress, reg, (uint8_t *)data, len, 1);
+}
+
+/* ================= Queue ================= */
+HAL_StatusTypeDef I2CBus_Submit(const I2CBus_Request *req){
+    if (!req || req->len == 0 || req->len > I2C_BUS_MAX_XFER || req->prio >= I2C_BUS_PRIO_COUNT) return HAL_ERROR;
+    if (req->write && !req->txData) return HAL_ERROR;
+
+    for (uint8_t i = 0; i < I2C_BUS_QUEUE_DEPTH; i++){
+        I2CBus_Slot *s = &slots[i];
+        if (s->used) continue;
+        s->req = *req;
+        if (req->write) memcpy(s->buf, req->txData, req->len);
+        s->req.txData = NULL;          /* caller's buffer may go out of scope */
+        s->submitTick = HAL_GetTick();
+        s->seq = nextSeq++;
+        s->used = 1;
+        pendingCount++;
+        if (pendingCount > stats.maxQueueDepth) stats.maxQueueDepth = pendingCount;
+        return HAL_OK;
+    }
+    stats.queueFull++;
+    return HAL_BUSY;
+}
+
+uint8_t I2CBus_Pending(uint16_t devAddress){
+    if (devAddress == I2C_BUS_ANY_DEVICE) return pendingCount;
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < I2C_BUS_QUEUE_DEPTH; i++){
+        if (slots[i].used && slots[i].req.devAddress == devAddress) n++;
+    }
+    return n;
+}
+
+/* Priority first, then earliest deadline (none = last), then submission order */
+static int runsBefore(const I2CBus_Slot *a, const I2CBus_Slot *b){
+    if (a->req.prio != b->req.prio) return a->req.prio < b->req.prio;
+    uint32_t da = a->req.deadline_ms, db = b->req.deadline_ms;
+    if (da != db){
+        if (!da) return 0;
+        if (!db) return 1;
+        return (int32_t)(da - db) < 0;
+    }
+    return (int32_t)(a->seq - b->seq) < 0;
+}
+
+static int pickNext(void){
+    int best = -1;
+    for (uint8_t i = 0; i < I2C_BUS_QUEUE_DEPTH; i++){
+        if (!slots[i].used) continue;
+        if (best < 0 || runsBefore(&slots[i], &slots[best])) best = i;
+    }
+    return best;
+}
+
+static void complete(I2CBus_Slot *s, HAL_StatusTypeDef st){
+    uint32_t now = HAL_GetTick();
+    I2CBus_PrioStats *ps = &stats.prio[s->req.prio];
+    uint32_t latency = now - s->submitTick;
+    ps->count++;
+    if (latency > ps->maxLatency_ms) ps->maxLatency_ms = latency;
+    if (s->req.deadline_ms && (int32_t)(now - s->req.deadline_ms) > 0) stats.deadlineMisses++;
+    stats.requests++;
+
+    /* Free the slot before the callback so it can resubmit */
+    I2CBus_Request req = s->req;
+    uint8_t buf[I2C_BUS_MAX_XFER];
+    memcpy(buf, s->buf, req.len);
+    s->used = 0;
+    pendingCount--;
+    if (req.done) req.done(req.ctx, req.reg, req.write ? NULL : buf, req.len, st);
+}
+
+uint8_t I2CBus_Service(uint8_t maxTransactions){
+    uint8_t ran = 0;
+    while (ran < maxTransactions && pendingCount){
+        int head = pickNext();
+        I2CBus_Slot *h = &slots[head];
+        ran++;
+
+        if (h->req.write){
+            complete(h, transfer(NULL, h->req.devAddress, h->req.reg, h->buf, h->req.len, 1));
+            continue;
+        }
+
+        /* Grow a contiguous read window around the head with other queued reads
+         * of the same device that touch or overlap it. */
+        uint8_t  inBurst[I2C_BUS_QUEUE_DEPTH] = {0};
+        uint16_t lo = h->req.reg, hi = (uint16_t)(h->req.reg + h->req.len);
+        uint8_t  grew = 1;
+        inBurst[head] = 1;
+        while (grew){
+            grew = 0;
+            for (uint8_t i = 0; i < I2C_BUS_QUEUE_DEPTH; i++){
+                const I2CBus_Slot *s = &slots[i];
+                if (!s->used || inBurst[i] || s->req.write || s->req.devAddress != h->req.devAddress) continue;
+                uint16_t rlo = s->req.reg, rhi = (uint16_t)(s->req.reg + s->req.len);
+                if (rlo > hi || rhi < lo) continue;
+                uint16_t nlo = rlo < lo ? rlo : lo, nhi = rhi > hi ? rhi : hi;
+                if (nhi - nlo > I2C_BUS_MAX_BURST || nhi > 0x100u) continue;
+                lo = nlo; hi = nhi;
+                inBurst[i] = 1;
+                grew = 1;
+            }
+        }
+
+        uint8_t burst[I2C_BUS_MAX_BURST];
+        HAL_StatusTypeDef st = transfer(NULL, h->req.devAddress, (uint8_t)lo, burst, (uint16_t)(hi - lo), 0);
+        uint8_t members = 0;
+        for (uint8_t i = 0; i < I2C_BUS_QUEUE_DEPTH; i++){
+            if (!inBurst[i]) continue;
+            I2CBus_Slot *s = &slots[i];
+            /* On failure burst[] holds nothing read from the bus: hand the
+             * callback zeroes, not stack bytes or a previous request's data */
+            if (st == HAL_OK) memcpy(s->buf, &burst[s->req.reg - lo], s->req.len);
+            else memset(s->buf, 0, s->req.len);
+            members++;
+            complete(s, st);
+        }
+        stats.merged += (uint32_t)(members - 1u);
+    }
+    return ran;
+}
+
+/* ================= Statistics ================= */
+const I2CBus_Stats *I2CBus_GetStats(void){ return &stats; }
+
+void I2CBus_ResetStats(void){
+    memset(&stats, 0, sizeof(stats));
+    memset(txnHist, 0, sizeof(txnHist));
+    stats.minTxn_us = UINT32_MAX;
+}
+
+const Latency_Hist *I2CBus_GetLatency(uint16_t devAddress){
+    const I2CBus_DeviceHealth *h = healthFor(devAddress, 0);
+    return h ? &txnHist[h - health] : NULL;
+}
+
+void I2CBus_LogStats(void){
+    uint32_t avg = stats.transactions ? (uint32_t)(stats.totalTxn_us / stats.transactions) : 0;
+    printf("[I2C] txn=%lu req=%lu merged=%lu bytes=%lu err=%lu miss=%lu full=%lu depth=%u t=%lu/%lu/%luus\n",
+        (unsigned long)stats.transactions, (unsigned long)stats.requests, (unsigned long)stats.merged,
+        (unsigned long)stats.bytes, (unsigned long)stats.errors, (unsigned long)stats.deadlineMisses,
+        (unsigned long)stats.queueFull, (unsigned)stats.maxQueueDepth,
+        (unsigned long)(stats.transactions ? stats.minTxn_us : 0), (unsigned long)avg,
+        (unsigned long)stats.maxTxn_us);
+    if (stats.recoveries){
+        printf("[I2C] recoveries=%lu failed=%lu\n",
+            (unsigned long)stats.recoveries, (unsigned long)stats.recoveryFailures);
+    }
+    for (uint8_t i = 0; i < I2C_BUS_MAX_DEVICES; i++){
+        const I2CBus_DeviceHealth *h = &health[i];
+        if (!h->health) continue;
+        printf("[I2C]   dev 0x%02X health=%u fails=%lu skipped=%lu%s\n", (unsigned)(h->devAddress >> 1),
+            (unsigned)h->health, (unsigned long)h->failures, (unsigned long)h->skipped,
+            I2CBus_DeviceAvailable(h->devAddress) ? "" : " (backoff)");
+    }
+    for (uint8_t p = 0; p < I2C_BUS_PRIO_COUNT; p++){
+        printf("[I2C]   prio%u n=%lu maxLat=%lums\n", (unsigned)p,
+            (unsigned long)stats.prio[p].count, (unsigned long)stats.prio[p].maxLatency_ms);
+    }
+}
@@ -0,0 +1,134 @@
+/*
+ * i2c_rec.c
+ *
+ *  I2C flight recorder (see i2c_rec.h).
+ */
+#include "i2c_rec.h"
+#include <stdio.h>
+#include <string.h>
+
+#define REC_MASK (I2C_REC_RING_BYTES - 1u)
+
+#if (I2C_REC_RING_BYTES & (I2C_REC_RING_BYTES - 1u)) != 0
+#error "I2C_REC_RING_BYTES must be a power of two"
+#endif
+
+static uint8_t  ring[I2C_REC_RING_BYTES];
+static uint32_t head, tail;            /* free running byte indices */
+static uint32_t baseTick;              /* the record at tail counts from here */
+static uint32_t lastTick;              /* tick of the newest record */
+static uint8_t  dumpRequested;
+static I2CRec_Stats stats;
+
+static uint8_t at(uint32_t i){ return ring[i & REC_MASK]; }
+
+static uint32_t recordSize(uint32_t i){
+    uint8_t b0 = at(i);
+    if (b0 == I2C_REC_SYNC) return I2C_REC_SYNC_BYTES;
+    uint8_t len = b0 & 0x1Fu;
+    uint8_t payload = (b0 & 0x80u) || ((b0 >> 5) & 3u) == HAL_OK;
+    return I2C_REC_HEADER + (payload ? len : 0u);
+}
+
+/* Drop the oldest record, moving baseTick to its time */
+static void dropOldest(void){
+    if (at(tail) == I2C_REC_SYNC){
+        baseTick = (uint32_t)at(tail + 1) | (uint32_t)at(tail + 2) << 8 |
+                   (uint32_t)at(tail + 3) << 16 | (uint32_t)at(tail + 4) << 24;
+    } else {
+        baseTick += (uint32_t)at(tail + 3) | (uint32_t)at(tail + 4) << 8;
+    }
+    tail += recordSize(tail);
+    stats.overwritten++;
+}
+
+static void put(const uint8_t *p, uint32_t n){
+    while (I2C_REC_RING_BYTES - (head - tail) < n) dropOldest();
+    for (uint32_t i = 0; i < n; i++) ring[(head + i) & REC_MASK] = p[i];
+    head += n;
+}
+
+void I2CRec_Init(void){
+    head = tail = 0;
+    baseTick = lastTick = HAL_GetTick();
+    dumpRequested = 0;
+    memset(&stats, 0, sizeof(stats));
+}
+
+void I2CRec_Note(uint16_t devAddress, uint8_t reg, const uint8_t *data, uint16_t len,
+                 uint8_t write, HAL_StatusTypeDef status){
+    if (len == 0 || len >= I2C_REC_MAX_LEN) return;
+    uint32_t now = HAL_GetTick();
+    uint32_t dt = now - lastTick;
+    if (dt > 0xFFFFu){
+        uint8_t sync[I2C_REC_SYNC_BYTES] = { I2C_REC_SYNC, (uint8_t)now, (uint8_t)(now >> 8),
+                                             (uint8_t)(now >> 16), (uint8_t)(now >> 24) };
+        put(sync, sizeof(sync));
+        dt = 0;
+    }
+    lastTick = now;
+
+    uint8_t payload = write || status == HAL_OK;
+    uint8_t rec[I2C_REC_HEADER + I2C_REC_MAX_LEN];
+    rec[0] = (uint8_t)((write ? 0x80u : 0u) | ((uint8_t)(status & 3u) << 5) | len);
+    rec[1] = (uint8_t)(devAddress >> 1);
+    rec[2] = reg;
+    rec[3] = (uint8_t)dt;
+    rec[4] = (uint8_t)(dt >> 8);
+    if (payload) memcpy(&rec[I2C_REC_HEADER], data, len);
+    put(rec, I2C_REC_HEADER + (payload ? len : 0u));
+    stats.records++;
+}
+
+uint32_t I2CRec_Used(void){
+    return head - tail;
+}
+
+uint32_t I2CRec_Snapshot(uint8_t *out, uint32_t max, uint32_t *base){
+    uint32_t n = head - tail;
+    if (n > max) n = max;
+    for (uint32_t i = 0; i < n; i++) out[i] = at(tail + i);
+    if (base) *base = baseTick;
+    return n;
+}
+
+void I2CRec_Dump(void){
+    uint32_t n = head - tail;
+    printf("[I2CREC] begin tick=%lu bytes=%lu records=%lu overwritten=%lu\n",
+        (unsigned long)baseTick, (unsigned long)n, (unsigned long)stats.records,
+        (unsigned long)stats.overwritten);
+    for (uint32_t off = 0; off < n; off += I2C_REC_DUMP_LINE){
+        char line[2u * I2C_REC_DUMP_LINE + 1u];
+        uint32_t k = n - off < I2C_REC_DUMP_LINE ? n - off : I2C_REC_DUMP_LINE;
+        for (uint32_t i = 0; i < k; i++){
+            static const char hex[] = "0123456789ABCDEF";
+            uint8_t b = at(tail + off + i);
+            line[2u * i] = hex[b >> 4];
+            line[2u * i + 1u] = hex[b & 0x0Fu];
+        }
+        line[2u * k] = '\0';
+        printf("[I2CREC] %s\n", line);
+    }
+    printf("[I2CREC] end\n");
+    stats.dumps++;
+}
+
+void I2CRec_RequestDump(void){
+    dumpRequested = 1;
+}
+
+uint8_t I2CRec_TakeDumpRequest(void){
+    uint8_t r = dumpRequested;
+    if (r) dumpRequested = 0;
+    return r;
+}
+
+const I2CRec_Stats *I2CRec_GetStats(void){
+    return &stats;
+}
+
+void I2CRec_LogStats(void){
+    printf("[I2CREC] records=%lu overwritten=%lu dumps=%lu ring=%lu/%u bytes\n",
+        (unsigned long)stats.records, (unsigned long)stats.overwritten, (unsigned long)stats.dumps,
+        (unsigned long)(head - tail), (unsigned)I2C_REC_RING_BYTES);
+}
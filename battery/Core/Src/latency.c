@@ -0,0 +1,75 @@
+/*
+ * latency.c
+ *
+ *  Microsecond timer and log2 latency histograms (see latency.h).
+ */
+#include "latency.h"
+#include <stdio.h>
+#include <string.h>
+
+static volatile uint8_t reportRequested;
+
+void Latency_Init(void){
+#if !defined(USE_HAL_STUBS)
+    /* Register level, like LPTIM1 in lowpower.c: no TIM HAL module needed.
+     * APB prescaler is 1, so the timer kernel clock is PCLK. */
+    __HAL_RCC_TIM2_CLK_ENABLE();
+    TIM2->CR1 = 0;
+    TIM2->PSC = HAL_RCC_GetPCLK1Freq() / LATENCY_TIMER_HZ - 1u;
+    TIM2->ARR = 0xFFFFFFFFu;
+    TIM2->CNT = 0;
+    TIM2->EGR = TIM_EGR_UG;        /* load PSC now */
+    TIM2->CR1 = TIM_CR1_CEN;
+#endif
+}
+
+void Latency_Record(Latency_Hist *h, uint32_t dt_us){
+    /* Bucket = floor(log2(dt)); no CLZ instruction on M0+, libgcc's
+     * __clzsi2 is a short table lookup */
+    uint32_t b = dt_us > 1u ? 31u - (uint32_t)__builtin_clz(dt_us) : 0u;
+    if (b >= LATENCY_BUCKETS) b = LATENCY_BUCKETS - 1u;
+    h->bucket[b]++;
+    h->count++;
+    if (dt_us > h->max_us) h->max_us = dt_us;
+}
+
+void Latency_Reset(Latency_Hist *h){
+    memset(h, 0, sizeof(*h));
+}
+
+uint32_t Latency_Percentile(const Latency_Hist *h, uint8_t pct){
+    if (!h->count) return 0;
+    /* Rank of the sample, rounded up (p100 = the last one) */
+    uint32_t rank = (uint32_t)(((uint64_t)h->count * pct + 99u) / 100u);
+    if (rank == 0) rank = 1;
+    uint32_t seen = 0;
+    for (uint32_t b = 0; b < LATENCY_BUCKETS - 1u; b++){
+        seen += h->bucket[b];
+        if (seen >= rank){
+            uint32_t top = (2u << b) - 1u;
+            return top < h->max_us ? top : h->max_us;
+        }
+    }
+    return h->max_us;
+}
+
+void Latency_Print(const char *kind, const char *name, const Latency_Hist *h){
+    uint32_t last = 0;
+    for (uint32_t b = 0; b < LATENCY_BUCKETS; b++) if (h->bucket[b]) last = b;
+    printf("[LAT] %s %-8s n=%lu max=%luus p50=%luus p99=%luus b=", kind, name,
+        (unsigned long)h->count, (unsigned long)h->max_us,
+        (unsigned long)Latency_Percentile(h, 50), (unsigned long)Latency_Percentile(h, 99));
+    for (uint32_t b = 0; b <= last; b++) printf(b ? ",%lu" : "%lu", (unsigned long)h->bucket[b]);
+    printf("\n");
+}
+
+void Latency_RequestReport(void){
+    reportRequested = 1;
+}
+
+uint8_t Latency_TakeReportRequest(void){
+    /* A request landing between the two accesses is served by this report */
+    uint8_t r = reportRequested;
+    if (r) reportRequested = 0;
+    return r;
+}
@@ -0,0 +1,141 @@
+/*
+ * lowpower.c
+ *
+ *  Tickless Stop-mode idle (see lowpower.h). LPTIM1 is driven at register
+ *  level so no extra HAL module (and CubeMX peripheral) is needed; it runs
+ *  from the LSI, which keeps counting in Stop.
+ *
+ *  Wake-up from Stop restarts on HSISYS = HSI16 / 1, the same clock
+ *  SystemClock_Config() selects, so the clock tree needs no restore.
+ */
+#include "lowpower.h"
+#include <stdio.h>
+
+#define LPTIM_HZ   1000u   /* LSI 32 kHz / 32 */
+
+static volatile uint8_t wakeEvents;
+static LowPower_Stats stats;
+static uint32_t initTick;
+
+void LowPower_Init(void){
+    GPIO_InitTypeDef gpio = {0};
+
+    __HAL_RCC_LSI_ENABLE();
+    while (__HAL_RCC_GET_FLAG(RCC_FLAG_LSIRDY) == 0) {}
+    __HAL_RCC_LPTIM1_CONFIG(RCC_LPTIM1CLKSOURCE_LSI);
+    __HAL_RCC_LPTIM1_CLK_ENABLE();
+    LPTIM1->CR = 0;
+    LPTIM1->CFGR = LPTIM_CFGR_PRESC_2 | LPTIM_CFGR_PRESC_0;   /* /32 */
+    LPTIM1->IER = LPTIM_IER_ARRMIE;                          /* written while disabled */
+    EXTI->IMR1 |= EXTI_IMR1_IM29;                            /* LPTIM1 wake-up line */
+    HAL_NVIC_SetPriority(TIM6_DAC_LPTIM1_IRQn, 3, 0);
+    HAL_NVIC_EnableIRQ(TIM6_DAC_LPTIM1_IRQn);
+
+    /* Open-drain, active-low interrupt outputs */
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    gpio.Mode = GPIO_MODE_IT_FALLING;
+    gpio.Pull = GPIO_PULLUP;
+    gpio.Pin = BMS_INTERRUPT_Pin;
+    HAL_GPIO_Init(BMS_INTERRUPT_GPIO_Port, &gpio);
+    gpio.Pin = MPPT_BQ_INTERRUPT_Pin;
+    HAL_GPIO_Init(MPPT_BQ_INTERRUPT_GPIO_Port, &gpio);
+    gpio.Pin = LIGHT_SWITCH_Pin;
+    HAL_GPIO_Init(LIGHT_SWITCH_GPIO_Port, &gpio);
+    HAL_NVIC_SetPriority(EXTI0_1_IRQn, 2, 0);
+    HAL_NVIC_EnableIRQ(EXTI0_1_IRQn);
+    HAL_NVIC_SetPriority(EXTI2_3_IRQn, 2, 0);
+    HAL_NVIC_EnableIRQ(EXTI2_3_IRQn);
+
+#ifdef DEBUG
+    HAL_DBGMCU_EnableDBGStopMode();   /* keep SWD alive in Stop */
+#endif
+    initTick = HAL_GetTick();
+}
+
+/* CNT is clocked asynchronously: read until two reads agree */
+static uint32_t lptimCount(void){
+    uint32_t a, b;
+    do { a = LPTIM1->CNT; b = LPTIM1->CNT; } while (a != b);
+    return a;
+}
+
+uint32_t LowPower_Idle(uint32_t maxSleep_ms){
+    if (maxSleep_ms == 0) return 0;
+    if (maxSleep_ms < LOWPOWER_MIN_STOP_MS){
+        stats.sleepEntries++;
+        HAL_PWR_EnterSLEEPMode(PWR_MAINREGULATOR_ON, PWR_SLEEPENTRY_WFI);   /* next SysTick wakes */
+        return 0;
+    }
+    if (maxSleep_ms > LOWPOWER_MAX_STOP_MS) maxSleep_ms = LOWPOWER_MAX_STOP_MS;
+
+    /* An EXTI that fires from here on still ends the WFI (pending with PRIMASK set) */
+    __disable_irq();
+    if (wakeEvents){
+        __enable_irq();
+        return 0;
+    }
+    HAL_SuspendTick();
+    LPTIM1->CR = LPTIM_CR_ENABLE;
+    LPTIM1->ICR = LPTIM_ICR_ARROKCF | LPTIM_ICR_ARRMCF;
+    LPTIM1->ARR = (maxSleep_ms * LPTIM_HZ) / 1000u;
+    while ((LPTIM1->ISR & LPTIM_ISR_ARROK) == 0) {}
+    LPTIM1->CR = LPTIM_CR_ENABLE | LPTIM_CR_SNGSTRT;
+
+    HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI);
+
+    uint32_t slept;
+    if (LPTIM1->ISR & LPTIM_ISR_ARRM){
+        slept = maxSleep_ms;
+    } else {
+        slept = (lptimCount() * 1000u) / LPTIM_HZ;
+        stats.earlyWakes++;
+    }
+    LPTIM1->CR = 0;
+    HAL_NVIC_ClearPendingIRQ(TIM6_DAC_LPTIM1_IRQn);
+    uwTick += slept;                 /* time SysTick did not count */
+    HAL_ResumeTick();
+    __enable_irq();                  /* EXTI handlers run now */
+
+    stats.stopEntries++;
+    stats.stop_ms += slept;
+    return slept;
+}
+
+void LowPower_LptimIRQHandler(void){
+    /* Only reached if the match raced the disable in LowPower_Idle */
+    LPTIM1->ICR = LPTIM_ICR_ARRMCF;
+}
+
+void HAL_GPIO_EXTI_Falling_Callback(uint16_t GPIO_Pin){
+    if (GPIO_Pin == BMS_INTERRUPT_Pin){
+        wakeEvents |= LOWPOWER_WAKE_BMS;
+        stats.wakes[0]++;
+    } else if (GPIO_Pin == MPPT_BQ_INTERRUPT_Pin){
+        wakeEvents |= LOWPOWER_WAKE_CHARGER;
+        stats.wakes[1]++;
+    } else if (GPIO_Pin == LIGHT_SWITCH_Pin){
+        wakeEvents |= LOWPOWER_WAKE_SWITCH;
+        stats.wakes[2]++;
+    }
+}
+
+uint8_t LowPower_TakeWakeEvents(void){
+    __disable_irq();
+    uint8_t ev = wakeEvents;
+    wakeEvents = 0;
+    __enable_irq();
+    return ev;
+}
+
+const LowPower_Stats *LowPower_GetStats(void){
+    return &stats;
+}
+
+void LowPower_LogStats(void){
+    uint32_t up = HAL_GetTick() - initTick;
+    printf("[PWR] stop=%lu (%lums, %lu%% of %lums) sleep=%lu early=%lu wake bms=%lu chg=%lu sw=%lu\n",
+        (unsigned long)stats.stopEntries, (unsigned long)stats.stop_ms,
+        (unsigned long)(up ? (uint32_t)(((uint64_t)stats.stop_ms * 100u) / up) : 0), (unsigned long)up,
+        (unsigned long)stats.sleepEntries, (unsigned long)stats.earlyWakes,
+        (unsigned long)stats.wakes[0], (unsigned long)stats.wakes[1], (unsigned long)stats.wakes[2]);
+}
@@ -25,10 +25,33 @@
 /* USER CODE BEGIN Includes */
 #include "bq25798.h" // Include the BQ25798 driver header
 #include "bq76907.h" // Battery monitor / protector (placeholder driver)
+#include "i2c_bus.h" // Shared hi2c1 scheduler (priorities, burst merging)
+#include "scheduler.h" // Cooperative task table (phases, deadlines, overrun accounting)
+#include "lowpower.h" // Tickless Stop-mode idle, EXTI wake-up
+#include "trace.h" // Binary deferred logging (TRACE) for the update paths
+#include "latency.h" // TIM2 microsecond clock, task / I2C latency histograms
+#include "faultlog.h" // Persistent fault log in flash (BM_PUSH_ERROR entries)
+#include "boot.h" // Queued device bring-up, boot phase timing
+#include "config_store.h" // Protection config, charge profiles, calibration in flash
+#include "watchdog.h" // IWDG, refreshed only while every supervised task is on time
+#include "memstats.h" // Stack paint / high-water mark, _sbrk accounting
+#include "i2c_rec.h" // I2C flight recorder, dumped for Host/i2c_replay
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
 /* USER CODE BEGIN PTD */
+// Scheduler task IDs (index into task_table)
+enum {
+  TASK_CHG_POLL,     // queue charger status refresh
+  TASK_MON_POLL,     // queue monitor status refresh
+  TASK_CHG_UPDATE,   // UpdateCharger, released when the charger reads completed
+  TASK_MON_UPDATE,   // UpdateMonitor, released when the monitor reads completed
+  TASK_BALANCE,      // EvaluateBalancing
+  TASK_HEALTH,       // offline detection / re-init
+  TASK_LED,          // error LED blink
+  TASK_STATS,        // bus + scheduler statistics
+  TASK_COUNT
+};
 
 /* USER CODE END PTD */
 
@@ -40,6 +63,19 @@
 #define BALANCE_THRESHOLD_MV    25   // Start balancing if delta > 25mV (placeholder)
 #define BALANCE_HYSTERESIS_MV   10   // Stop when delta < 10mV (placeholder)
 #define ERROR_LED_BLINK_RATE_MS 200 // Blink the error LED every 200 milliseconds
+#define I2C_TXN_PER_LOOP        2    // Bus transactions per loop pass (bounds loop latency)
+#define TASKS_PER_LOOP          1    // Scheduler tasks per loop pass (bus service runs in between)
+#define TRACE_RECORDS_PER_LOOP  4    // Trace records drained per loop pass
+#define HEALTH_CHECK_INTERVAL_MS 250 // Offline detection / retry check
+#define LED_TASK_INTERVAL_MS    50   // Error LED task period (blink rates are multiples of it)
+#define UPDATE_DEADLINE_MS      50   // Reads completed -> UpdateCharger/UpdateMonitor finished
+#define I2C_STATS_INTERVAL_MS   10000 // Print bus statistics every 10 seconds
+#define DEVICE_RETRY_INTERVAL_MS 2000 // Retry init of an offline device (bus backoff permitting)
+#define DEVICE_OFFLINE_FAILS    8    // Consecutive bus failures before a device is taken offline
+#define MONITOR_LOST_REFRESHES  1    // Failed monitor status refreshes before charging is disabled
+#define DEGRADED_LED_BLINK_MS   1000 // Slow blink while running with a device offline
+#define WATCHDOG_TASK_PERIODS   3    // A periodic task starves after this many periods without a run
+#define SCALE_VERIFY_AT_BOOT    1    // Scaling range check (BQ25798_checkScalingRanges) before bring-up; the full sweep is host only
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -52,18 +88,78 @@
 /* USER CODE BEGIN PV */
 BQ25798 bq25798_charger;              // Charger instance
 BQ76907 bq76907_monitor;              // Monitor instance (placeholder implementation)
-static uint32_t last_bq_update_tick = 0;          // Last charger status update
-static uint32_t last_bq76907_update_tick = 0;     // Last monitor update
-static uint32_t last_balance_eval_tick = 0;       // Last balancing evaluation
 static uint32_t last_error_led_toggle_tick = 0;   // Last time the error LED was toggled
+static uint8_t charger_refresh_pending = 0;       // Charger reads queued, not yet all serviced
+static uint8_t monitor_refresh_pending = 0;       // Monitor reads queued, not yet all serviced
+static uint8_t charger_online = 0;                // Charger initialised and answering
+static uint8_t monitor_online = 0;                // Monitor initialised and configured
+static uint32_t last_device_retry_tick = 0;       // Last init retry of an offline device
+static uint32_t monitor_errors_at_poll = 0;       // Monitor bus failures + skips when the refresh was queued
+static uint8_t monitor_failed_refreshes = 0;      // Consecutive monitor refreshes with a failed read
+static uint8_t charge_inhibited = 0;              // Charging disabled for lost cell supervision
+
+// Built-in configuration, used until one has been committed to the flash
+// store (config_store.h) and to fill fields an older stored image lacks.
+// Monitor values are placeholders (TBD after datasheet validation).
+static const ConfigStore_Data config_defaults = {
+  .monitor = {
+    .cellCount = 4,
+    .uvThreshold_mV = 2500, .ovThreshold_mV = 4200,
+    .ocCharge_mA = 3000, .ocDischarge1_mA = 5000, .ocDischarge2_mA = 8000,
+    .internalOT_C = 85, .maxInternalTemp_C = 90,
+    .balanceInterval_ms = 5000,
+    .voltageTimeUnits = 0x00,
+    .fetOptions = 0x00,
+    .protectionsA = 0x00, .protectionsB = 0x00,
+    .dsgFetProtA = 0x00, .chgFetProtA = 0x00,
+    .latchLimit = 0x00,
+    .alarmMaskDefault = 0x00, .alarmEnableMask = 0x00,
+    .daConfig = 0x00, .regoutConfig = 0x00, .powerConfig = 0x00
+  },
+  .profile = { { "std", BQ25798_DEFAULT_LIMITS } },
+  .activeProfile = 0
+};
+
+// Boot sequencer scripts (boot.h), built from the drivers and the stored config at boot
+static BQ_RegWrite charger_init_script[BQ25798_INIT_SCRIPT_LEN];
+static BQ_RegWrite monitor_cfg_script[BQ76907_CFG_SCRIPT_LEN];
+static uint8_t monitor_cfg_image[BQ76907_CFG_IMAGE_LEN];
 
 // Forward static helpers
+static void BringUpDevices(void);
+static uint8_t BringUpCharger(void);
+static uint8_t BringUpMonitor(void);
+static void CheckDeviceHealth(void);
+static void MonitorRefreshDone(uint8_t failed);
+static void PollCharger(void);
+static void PollMonitor(void);
+static void CommitConfig(const ConfigStore_Data *edit);
 static void UpdateCharger(void);
 static void UpdateMonitor(void);
 static void EvaluateBalancing(void);
+static void UpdateErrorLed(void);
+static void LogStatistics(void);
+static void ReportLatency(void);
 static uint16_t findMaxCell(uint16_t *vals, uint8_t count);
 static uint16_t findMinCell(uint16_t *vals, uint8_t count);
 static void applyCellBalancingMask(uint8_t mask);
+
+// Task table. Phases keep the I2C tasks (charger / monitor polls, balancing,
+// health) at least 62 ms apart on every release: the charger polls on 0 mod 250,
+// the monitor on 125, balancing on 62 and the health check on 187 (mod 250).
+// Poll periods stretch by whole multiples (I2CBus_PollInterval), which keeps
+// them on the same grid.
+static const Scheduler_Task task_table[TASK_COUNT] = {
+  //                  name       run                period                      phase deadline            prio flags
+  [TASK_CHG_POLL]   = { "chgPoll", PollCharger,       BQ_UPDATE_INTERVAL_MS,      0,    0,                  2, SCHED_TASK_I2C },
+  [TASK_MON_POLL]   = { "monPoll", PollMonitor,       BQ76907_UPDATE_INTERVAL_MS, 125,  0,                  2, SCHED_TASK_I2C },
+  [TASK_CHG_UPDATE] = { "chgUpd",  UpdateCharger,     0,                          0,    UPDATE_DEADLINE_MS, 0, 0 },
+  [TASK_MON_UPDATE] = { "monUpd",  UpdateMonitor,     0,                          0,    UPDATE_DEADLINE_MS, 0, 0 },
+  [TASK_BALANCE]    = { "balance", EvaluateBalancing, BALANCE_INTERVAL_MS,        62,   0,                  3, SCHED_TASK_I2C },
+  [TASK_HEALTH]     = { "health",  CheckDeviceHealth, HEALTH_CHECK_INTERVAL_MS,   187,  0,                  1, SCHED_TASK_I2C },
+  [TASK_LED]        = { "led",     UpdateErrorLed,    LED_TASK_INTERVAL_MS,       0,    0,                  4, 0 },
+  [TASK_STATS]      = { "stats",   LogStatistics,     I2C_STATS_INTERVAL_MS,      0,    0,                  5, 0 },
+};
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -83,6 +179,8 @@ void SystemClock_Config(void);
 int main(void)
 {
   /* USER CODE BEGIN 1 */
+  // Before anything uses the stack below this frame: high-water marks start here
+  MemStats_PaintStack();
   /* USER CODE END 1 */
 
   /* MCU Configuration--------------------------------------------------------*/
@@ -108,87 +206,94 @@ int main(void)
   /* USER CODE BEGIN 2 */
 
   printf("[MAIN] Init start\n");
-
-  // Initialize the BQ25798 charger
-  uint32_t t0 = HAL_GetTick();
-  if (BQ25798_init(&bq25798_charger, &hi2c1) != 0) {
-    Error_Handler();
-  }
-  printf("[MAIN] Charger init done (+%lums)\n", (unsigned long)(HAL_GetTick()-t0));
-  // Initialize the BQ76907 monitor (placeholder init – returns 0 on success)
-  t0 = HAL_GetTick();
-  if (BQ76907_init(&bq76907_monitor, &hi2c1) != 0) {
-    // If monitor init fails we continue charger operation but could flag a warning
-    // For now treat as critical
-    Error_Handler();
-  }
-  printf("[MAIN] Monitor init done (+%lums)\n", (unsigned long)(HAL_GetTick()-t0));
-
-  // Apply a placeholder safe configuration snapshot (values TBD after datasheet validation)
-  BQ76907_Config cfg = {
-      .cellCount = 4,
-      .uvThreshold_mV = 2500, .ovThreshold_mV = 4200,
-      .ocCharge_mA = 3000, .ocDischarge1_mA = 5000, .ocDischarge2_mA = 8000,
-      .internalOT_C = 85, .maxInternalTemp_C = 90,
-      .balanceInterval_ms = 5000,
-      .voltageTimeUnits = 0x00,
-      .fetOptions = 0x00,
-      .protectionsA = 0x00, .protectionsB = 0x00,
-      .dsgFetProtA = 0x00, .chgFetProtA = 0x00,
-      .latchLimit = 0x00,
-      .alarmMaskDefault = 0x00, .alarmEnableMask = 0x00,
-      .daConfig = 0x00, .regoutConfig = 0x00, .powerConfig = 0x00
-  };
-  t0 = HAL_GetTick();
-  if (BQ76907_applyConfig(&bq76907_monitor, &cfg) == HAL_OK){
-      BQ76907_logConfig(&bq76907_monitor);
-  printf("[MAIN] Monitor config applied (+%lums)\n", (unsigned long)(HAL_GetTick()-t0));
-  } else {
-  printf("[MAIN] Monitor config apply FAILED\n");
+#if SCALE_VERIFY_AT_BOOT
+  // Field ends and set point range only: microseconds, where the ~780k-call sweep took seconds. Logged, not fatal
+  if (BQ25798_checkScalingRanges(0) != 0) BQ25798_checkScalingRanges(1);
+#endif
+  Latency_Init();
+  Boot_Begin();
+  FaultLog_Init();   // before bring-up so init failures are kept
+  Watchdog_Init();   // after the fault log, which keeps the previous reset's record
+  ConfigStore_Init(&config_defaults);
+  I2CRec_Init();     // bring-up traffic is recorded too
+  I2CBus_Init(&hi2c1);
+  LowPower_Init();
+
+  // Bring up both devices. A device that does not answer no longer halts the
+  // system: it stays offline (degraded mode) and is retried from the main loop.
+  BringUpDevices();
+  if (charger_online && !monitor_online) {
+    // No cell supervision: do not charge blind
+    BQ25798_chargerEnable(&bq25798_charger, 0);
   }
 
-  // Initialize timers for immediate first update
+  // First releases are the task phases from now (charger poll immediately)
   uint32_t now = HAL_GetTick();
-  last_bq_update_tick       = now;
-  last_bq76907_update_tick  = now;
-  last_balance_eval_tick    = now;
+  last_device_retry_tick    = now;
+  if (Scheduler_Init(task_table, TASK_COUNT, now) != 0) {
+    printf("[MAIN] Task phases violate the I2C guard\n");
+  }
+  // Every periodic task is supervised; the update tasks only run on events.
+  // The poll tasks' periods stretch with device health (I2CBus_PollInterval).
+  for (uint8_t i = 0; i < TASK_COUNT; i++) {
+    uint32_t deadline = WATCHDOG_TASK_PERIODS * task_table[i].period_ms;
+    if (i == TASK_CHG_POLL || i == TASK_MON_POLL) deadline *= I2C_BUS_POLL_STRETCH_MAX;
+    if (deadline) Watchdog_Supervise(i, deadline);
+  }
+  // The boot measurement is evaluated right away
+  if (monitor_online) Scheduler_Release(TASK_MON_UPDATE);
+  Boot_Mark(BOOT_PHASE_RUNNING);
+  Boot_LogTimings();
+  Watchdog_LogStats();
+  if (monitor_online) BQ76907_logConfig(&bq76907_monitor);
   /* USER CODE END 2 */
 
   /* Infinite loop */
   /* USER CODE BEGIN WHILE */
   while (1)
   {
-    uint32_t tick = HAL_GetTick();
-    if ((tick - last_bq_update_tick) >= BQ_UPDATE_INTERVAL_MS) {
-      last_bq_update_tick = tick;
-      UpdateCharger();
+    // Periodic reads are only queued by the poll tasks; the bus scheduler runs at
+    // most I2C_TXN_PER_LOOP transactions per pass (fault reads first) and the
+    // update tasks are released once all reads of a device have completed.
+    I2CBus_Service(I2C_TXN_PER_LOOP);
+    if (charger_refresh_pending && I2CBus_Pending(BQ25798_I2C_ADDRESS) == 0) {
+      charger_refresh_pending = 0;
+      Scheduler_Release(TASK_CHG_UPDATE);
     }
-    if ((tick - last_bq76907_update_tick) >= BQ76907_UPDATE_INTERVAL_MS) {
-      last_bq76907_update_tick = tick;
-      UpdateMonitor();
+    if (monitor_refresh_pending && I2CBus_Pending(BQ76907_I2C_ADDRESS) == 0) {
+      monitor_refresh_pending = 0;
+      const I2CBus_DeviceHealth *h = I2CBus_GetHealth(BQ76907_I2C_ADDRESS);
+      MonitorRefreshDone(h && h->failures + h->skipped != monitor_errors_at_poll);
+      Scheduler_Release(TASK_MON_UPDATE);
     }
-    if ((tick - last_balance_eval_tick) >= BALANCE_INTERVAL_MS) {
-      last_balance_eval_tick = tick;
-      EvaluateBalancing();
-    }
-
-      // --- Non-blocking Error LED (Orange LED) handling ---
-      // This is for demonstration, assuming GPIO_PIN_5 (orange LED) is for a general fault indicator.
-      // You would typically turn this on or blink it in your Error_Handler or if a specific fault is detected.
-      if (bq25798_charger.faultStatus1.tshut_stat == 1) {
-          if ((HAL_GetTick() - last_error_led_toggle_tick) >= ERROR_LED_BLINK_RATE_MS) {
-              last_error_led_toggle_tick = HAL_GetTick();
-              HAL_GPIO_TogglePin(GPIOA, GPIO_PIN_5); // Toggle Orange LED
-          }
+    Scheduler_RunReady(TASKS_PER_LOOP);
+    Trace_Drain(TRACE_RECORDS_PER_LOOP);
+    if (Latency_TakeReportRequest()) ReportLatency();
+    if (MemStats_TakeReportRequest()) MemStats_Report();
+    if (I2CRec_TakeDumpRequest()) I2CRec_Dump();
+    Watchdog_Service(HAL_GetTick());
+
+    // Device interrupts poll the device at once instead of at its next slot
+    uint8_t wake = LowPower_TakeWakeEvents();
+    if ((wake & LOWPOWER_WAKE_BMS) && monitor_online) Scheduler_Release(TASK_MON_POLL);
+    if ((wake & LOWPOWER_WAKE_CHARGER) && charger_online) Scheduler_Release(TASK_CHG_POLL);
+
+    // Nothing in flight: program queued fault records (one flash operation per
+    // pass), then a requested configuration edit (ConfigStore_RequestCommit from
+    // a console / debugger, ~22 ms blocking erase), then sleep (Stop mode) until
+    // the next task is due or an EXTI fires, at most WATCHDOG_MAX_IDLE_MS so the
+    // loop checks in and the IWDG is refreshed
+    if (!charger_refresh_pending && !monitor_refresh_pending && I2CBus_Pending(I2C_BUS_ANY_DEVICE) == 0 &&
+        Trace_Pending() == 0) {
+      const ConfigStore_Data *config_edit;
+      if (FaultLog_Pending()) {
+        if (Scheduler_TimeToNext(HAL_GetTick()) > 0) FaultLog_Service();
+      } else if (Scheduler_TimeToNext(HAL_GetTick()) > 0 && (config_edit = ConfigStore_TakeCommitRequest()) != NULL) {
+        CommitConfig(config_edit);
       } else {
-          HAL_GPIO_WritePin(GPIOA, GPIO_PIN_5, GPIO_PIN_SET); // Keep Orange LED OFF (assuming active low)
+        LowPower_Idle(Watchdog_IdleLimit(Scheduler_TimeToNext(HAL_GetTick())));
       }
-    /* main loop continues indefinitely */
-
-
-      /* Add other non-blocking tasks here */
-      // e.g., Read sensors, process user input, update displays, communicate over other peripherals
-      // These tasks will execute continuously while the BQ25798 update timer is counting down.
+    }
 
     /* USER CODE END WHILE */
 
@@ -242,22 +347,226 @@ void SystemClock_Config(void)
 
 // ---------------- Internal helper implementations ----------------
 
+// Boot bring-up of both devices through the bus queue (boot.h). The monitor
+// runs at higher priority, keeps its configuration when the registers still
+// hold the stored configuration, and its first status refresh is queued the moment it is
+// configured, ahead of the rest of the charger init. Nothing is printed until
+// the scheduler runs (Boot_LogTimings).
+static void BringUpDevices(void) {
+  enum { BOOT_MON, BOOT_CHG, BOOT_DEV_COUNT };
+  static Boot_DeviceDesc desc[BOOT_DEV_COUNT];
+  static Boot_Device dev[BOOT_DEV_COUNT];
+  const BQ76907_Config *monitor_cfg = &ConfigStore_Get()->monitor;
+  BQ76907_configImage(monitor_cfg, monitor_cfg_image);
+  desc[BOOT_MON] = (Boot_DeviceDesc){
+    .name = "BQ76907", .devAddress = BQ76907_I2C_ADDRESS, .source = BM_SRC_BQ76907, .prio = I2C_BUS_PRIO_CONTROL,
+    .idReg = BQ76907_REG_DEVICE_ID, .cfgReg = BQ76907_CFG_FIRST_REG, .cfgLen = BQ76907_CFG_IMAGE_LEN,
+    .cfgImage = monitor_cfg_image,
+    .script = monitor_cfg_script, .scriptLen = BQ76907_configScript(monitor_cfg, monitor_cfg_script) };
+  desc[BOOT_CHG] = (Boot_DeviceDesc){
+    .name = "BQ25798", .devAddress = BQ25798_I2C_ADDRESS, .source = BM_SRC_BQ25798, .prio = I2C_BUS_PRIO_MEASURE,
+    .idReg = BQ25798_REG_PART_INFO, .idValid = BQ25798_partInfoValid,
+    .script = charger_init_script, .scriptLen = BQ25798_initScript(&ConfigStore_ActiveProfile()->limits, charger_init_script) };
+  bq25798_charger.i2cHandle = &hi2c1;
+  bq76907_monitor.i2cHandle = &hi2c1;
+  dev[BOOT_MON].desc = &desc[BOOT_MON];
+  dev[BOOT_CHG].desc = &desc[BOOT_CHG];
+
+  Boot_Start(dev, BOOT_DEV_COUNT);
+  uint8_t measured = 0, measuring = 0;
+  for (;;) {
+    uint8_t running = Boot_Service();
+    uint8_t monReady = dev[BOOT_MON].state == BOOT_DEV_READY;
+    if (monReady && !measuring && !measured &&
+        BQ76907_queueStatusRefresh(&bq76907_monitor, HAL_GetTick() + UPDATE_DEADLINE_MS) == HAL_OK) {
+      measuring = 1;
+    }
+    if (measuring && I2CBus_Pending(BQ76907_I2C_ADDRESS) == 0) {
+      measuring = 0;
+      measured = 1;
+      Boot_Mark(BOOT_PHASE_PROTECTED);
+    }
+    if (!running && (measured || !monReady)) break;
+    I2CBus_Service(I2C_TXN_PER_LOOP);
+  }
+
+  charger_online = dev[BOOT_CHG].state == BOOT_DEV_READY;
+  monitor_online = dev[BOOT_MON].state == BOOT_DEV_READY;
+  if (monitor_online) bq76907_monitor.activeConfig = *monitor_cfg;
+  if (!charger_online) printf("[MAIN] Charger init FAILED - running degraded\n");
+  if (!monitor_online) printf("[MAIN] Monitor init FAILED - running degraded\n");
+}
+
+// Initialise the charger; returns 1 when it answered (offline retries).
+static uint8_t BringUpCharger(void) {
+  uint32_t t0 = HAL_GetTick();
+  if (BQ25798_init(&bq25798_charger, &hi2c1) != 0) {
+    printf("[MAIN] Charger init FAILED - running degraded\n");
+    return 0;
+  }
+  printf("[MAIN] Charger init done (+%lums)\n", (unsigned long)(HAL_GetTick()-t0));
+  return 1;
+}
+
+// Initialise the monitor and apply the stored configuration unless its
+// registers still hold it; returns 1 when both succeeded (offline retries).
+static uint8_t BringUpMonitor(void) {
+  const BQ76907_Config *monitor_cfg = &ConfigStore_Get()->monitor;
+  uint32_t t0 = HAL_GetTick();
+  if (BQ76907_init(&bq76907_monitor, &hi2c1) != 0) {
+    printf("[MAIN] Monitor init FAILED - running degraded\n");
+    return 0;
+  }
+  printf("[MAIN] Monitor init done (+%lums)\n", (unsigned long)(HAL_GetTick()-t0));
+  t0 = HAL_GetTick();
+  if (BQ76907_configMatches(&bq76907_monitor, monitor_cfg)) {
+    bq76907_monitor.activeConfig = *monitor_cfg;
+    printf("[MAIN] Monitor config kept (+%lums)\n", (unsigned long)(HAL_GetTick()-t0));
+    return 1;
+  }
+  if (BQ76907_applyConfig(&bq76907_monitor, monitor_cfg) != HAL_OK) {
+    printf("[MAIN] Monitor config apply FAILED\n");
+    return 0;
+  }
+  BQ76907_logConfig(&bq76907_monitor);
+  printf("[MAIN] Monitor config applied (+%lums)\n", (unsigned long)(HAL_GetTick()-t0));
+  return 1;
+}
+
+// Take devices offline after sustained bus failures and retry offline ones.
+// Retries are rate limited by DEVICE_RETRY_INTERVAL_MS and the bus backoff.
+static void CheckDeviceHealth(void) {
+  uint32_t tick = HAL_GetTick();
+  const I2CBus_DeviceHealth *h;
+  h = I2CBus_GetHealth(BQ25798_I2C_ADDRESS);
+  if (charger_online && h && h->consecutiveFails >= DEVICE_OFFLINE_FAILS) {
+    charger_online = 0;
+    charger_refresh_pending = 0;
+    printf("[MAIN] Charger OFFLINE (health=%u)\n", (unsigned)h->health);
+  }
+  h = I2CBus_GetHealth(BQ76907_I2C_ADDRESS);
+  if (monitor_online && h && h->consecutiveFails >= DEVICE_OFFLINE_FAILS) {
+    monitor_online = 0;
+    monitor_refresh_pending = 0;
+    printf("[MAIN] Monitor OFFLINE (health=%u)\n", (unsigned)h->health);
+    if (charger_online) BQ25798_chargerEnable(&bq25798_charger, 0);
+  }
+
+  if ((charger_online && monitor_online) || (tick - last_device_retry_tick) < DEVICE_RETRY_INTERVAL_MS) return;
+  last_device_retry_tick = tick;
+  if (!charger_online && I2CBus_DeviceAvailable(BQ25798_I2C_ADDRESS)) {
+    charger_online = BringUpCharger();
+    if (charger_online && !monitor_online) BQ25798_chargerEnable(&bq25798_charger, 0);
+  }
+  if (!monitor_online && I2CBus_DeviceAvailable(BQ76907_I2C_ADDRESS)) {
+    monitor_online = BringUpMonitor();
+    if (monitor_online && charger_online) {
+      BQ25798_chargerEnable(&bq25798_charger, 1);
+      charge_inhibited = 0;
+      monitor_failed_refreshes = 0;
+    }
+  }
+}
+
+// Fail safe on lost cell supervision: charging stops on the first failed (or
+// unqueueable) monitor status refresh, long before DEVICE_OFFLINE_FAILS takes
+// the monitor offline, and resumes with the next complete refresh.
+static void MonitorRefreshDone(uint8_t failed) {
+  if (!failed) {
+    monitor_failed_refreshes = 0;
+    if (charge_inhibited && charger_online) {
+      BQ25798_chargerEnable(&bq25798_charger, 1);
+      printf("[MAIN] Monitor refresh OK - charging re-enabled\n");
+    }
+    charge_inhibited = 0;
+    return;
+  }
+  if (monitor_failed_refreshes < UINT8_MAX) monitor_failed_refreshes++;
+  if (monitor_failed_refreshes >= MONITOR_LOST_REFRESHES && !charge_inhibited && charger_online) {
+    BQ25798_chargerEnable(&bq25798_charger, 0);
+    charge_inhibited = 1;
+    printf("[MAIN] Monitor refresh FAILED - charging disabled\n");
+  }
+}
+
+// Queue the charger reads; flaky devices are polled less often
+// (I2CBus_PollInterval stretches the period by health).
+static void PollCharger(void) {
+  if (!charger_online) return;
+  uint32_t interval = I2CBus_PollInterval(BQ25798_I2C_ADDRESS, BQ_UPDATE_INTERVAL_MS);
+  Scheduler_SetPeriod(TASK_CHG_POLL, interval);
+  if (BQ25798_queueStatusRefresh(&bq25798_charger, HAL_GetTick() + interval) == HAL_OK)
+    charger_refresh_pending = 1;
+}
+
+static void PollMonitor(void) {
+  if (!monitor_online) return;
+  uint32_t interval = I2CBus_PollInterval(BQ76907_I2C_ADDRESS, BQ76907_UPDATE_INTERVAL_MS);
+  Scheduler_SetPeriod(TASK_MON_POLL, interval);
+  const I2CBus_DeviceHealth *h = I2CBus_GetHealth(BQ76907_I2C_ADDRESS);
+  monitor_errors_at_poll = h ? h->failures + h->skipped : 0;
+  if (BQ76907_queueStatusRefresh(&bq76907_monitor, HAL_GetTick() + interval) == HAL_OK)
+    monitor_refresh_pending = 1;
+  else
+    MonitorRefreshDone(1);
+}
+
+// --- Non-blocking Error LED (Orange LED) handling ---
+// This is for demonstration, assuming GPIO_PIN_5 (orange LED) is for a general fault indicator.
+// You would typically turn this on or blink it in your Error_Handler or if a specific fault is detected.
+static void UpdateErrorLed(void) {
+  if (bq25798_charger.faultStatus1.tshut_stat == 1) {
+    if ((HAL_GetTick() - last_error_led_toggle_tick) >= ERROR_LED_BLINK_RATE_MS) {
+      last_error_led_toggle_tick = HAL_GetTick();
+      HAL_GPIO_TogglePin(GPIOA, GPIO_PIN_5); // Toggle Orange LED
+    }
+  } else if (!charger_online || !monitor_online) {
+    // Degraded mode: slow blink while a device is offline
+    if ((HAL_GetTick() - last_error_led_toggle_tick) >= DEGRADED_LED_BLINK_MS) {
+      last_error_led_toggle_tick = HAL_GetTick();
+      HAL_GPIO_TogglePin(GPIOA, GPIO_PIN_5);
+    }
+  } else {
+    HAL_GPIO_WritePin(GPIOA, GPIO_PIN_5, GPIO_PIN_SET); // Keep Orange LED OFF (assuming active low)
+  }
+}
+
+static void LogStatistics(void) {
+  I2CBus_LogStats();
+  Scheduler_LogStats();
+  LowPower_LogStats();
+  Trace_LogStats();
+  BM_ErrorLogStats();
+  FaultLog_LogStats();
+  ConfigStore_LogStats();
+  Watchdog_LogStats();
+  MemStats_LogStats();
+  I2CRec_LogStats();
+}
+
+// Configuration edit on request: the store refuses thresholds the monitor
+// cannot hold; the devices take the new values at their next bring-up
+static void CommitConfig(const ConfigStore_Data *edit) {
+  if (ConfigStore_Commit(edit) != HAL_OK) printf("[MAIN] Config commit FAILED\n");
+  ConfigStore_LogStats();
+}
+
+// Latency histograms on request (Latency_RequestReport from a console / debugger)
+static void ReportLatency(void) {
+  for (uint8_t i = 0; i < TASK_COUNT; i++) {
+    Latency_Print("task", task_table[i].name, &Scheduler_GetStats(i)->exec);
+  }
+  const Latency_Hist *h = I2CBus_GetLatency(BQ25798_I2C_ADDRESS);
+  if (h) Latency_Print("i2c", "bq25798", h);
+  h = I2CBus_GetLatency(BQ76907_I2C_ADDRESS);
+  if (h) Latency_Print("i2c", "bq76907", h);
+}
+
 static void UpdateCharger(void) {
   uint32_t tStart = HAL_GetTick();
-  printf("[FUNC] UpdateCharger BEGIN\n");
-  printf("[CHG] Update begin\n");
-  uint8_t b=0;
-  readChargerStatus0(&bq25798_charger, &b);
-  readChargerStatus1(&bq25798_charger, &b);
-  readChargerStatus2(&bq25798_charger, &b);
-  readChargerStatus3(&bq25798_charger, &b);
-  readChargerStatus4(&bq25798_charger, &b);
-  readFaultStatus0(&bq25798_charger, &b);
-  readFaultStatus1(&bq25798_charger, &b);
-  BQ25798_readBusVoltage(&bq25798_charger);
-  BQ25798_readBusCurrent(&bq25798_charger);
-  BQ25798_readBatteryVoltage(&bq25798_charger);
-  BQ25798_readBatteryCurrent(&bq25798_charger);
+  TRACE("[FUNC] UpdateCharger BEGIN");
+  TRACE("[CHG] Update begin");
+  // Status / fault / ADC registers were refreshed by the queued bus reads
 
   if (bq25798_charger.chargerStatus2.vbat_present_stat == 1) {
     HAL_GPIO_WritePin(GPIOC, GPIO_PIN_13, GPIO_PIN_RESET);
@@ -266,25 +575,21 @@ static void UpdateCharger(void) {
   }
   /* Emit a concise status line */
   BQ25798_logStatus(&bq25798_charger);
-  printf("[CHG] Update end (%lums) VBAT=%umV IBAT=%dmA BUS=%umV/%dmA Fault1.tshut=%u\n",
+  TRACE("[CHG] Update end (%lums) VBAT=%umV IBAT=%dmA BUS=%umV/%dmA Fault1.tshut=%u",
     (unsigned long)(HAL_GetTick()-tStart),
     (unsigned)bq25798_charger.voltageBattery,
-    (unsigned)bq25798_charger.currentBattery,
+    (int)bq25798_charger.currentBattery,
     (unsigned)bq25798_charger.voltageBus,
-    (unsigned)bq25798_charger.currentBus,
+    (int)bq25798_charger.currentBus,
     (unsigned)bq25798_charger.faultStatus1.tshut_stat);
-  printf("[FUNC] UpdateCharger END\n");
+  TRACE("[FUNC] UpdateCharger END");
 }
 
 static void UpdateMonitor(void) {
   uint32_t tStart = HAL_GetTick();
-  printf("[FUNC] UpdateMonitor BEGIN\n");
-  printf("[MON] Update begin\n");
-  // Read system status & cell voltages
-  BQ76907_readSystemStatus(&bq76907_monitor);
-  BQ76907_readCellVoltages(&bq76907_monitor);
-  BQ76907_readPackVoltage(&bq76907_monitor);
-  BQ76907_readTemperature1(&bq76907_monitor);
+  TRACE("[FUNC] UpdateMonitor BEGIN");
+  TRACE("[MON] Update begin");
+  // System status & cell voltages were refreshed by the queued bus reads
   BQ76907_logStatus(&bq76907_monitor);
   // Monitor fault indication (aggregate)
   uint8_t anyFault = bq76907_monitor.status.ov_fault || bq76907_monitor.status.uv_fault ||
@@ -301,28 +606,30 @@ static void UpdateMonitor(void) {
   if (lastFaultState != anyFault){
     lastFaultState = anyFault;
     if (anyFault){
-      printf("[MON] FAULT: OV=%u UV=%u OCD=%u SCD=%u OT=%u\n", bq76907_monitor.status.ov_fault,
+      TRACE("[MON] FAULT: OV=%u UV=%u OCD=%u SCD=%u OT=%u", bq76907_monitor.status.ov_fault,
              bq76907_monitor.status.uv_fault, bq76907_monitor.status.ocd_fault,
              bq76907_monitor.status.scd_fault, bq76907_monitor.status.ot_fault);
     } else {
-      printf("[MON] FAULT CLEARED\n");
+      TRACE("[MON] FAULT CLEARED");
       // Ensure LED off (inactive state high per earlier assumption)
       HAL_GPIO_WritePin(GPIOA, GPIO_PIN_5, GPIO_PIN_SET);
     }
   }
-  printf("[MON] Update end (%lums) Pack=%umV Cells=%u,%u,%u,%u mV Flags OV=%u UV=%u OCD=%u SCD=%u OT=%u\n",
+  // Two records: TRACE carries at most 8 arguments
+  TRACE("[MON] Update end (%lums) Pack=%umV Cells=%u,%u,%u,%u mV",
     (unsigned long)(HAL_GetTick()-tStart),
     (unsigned)bq76907_monitor.packVoltage_mV,
     (unsigned)bq76907_monitor.cellVoltage_mV[0],
     (unsigned)bq76907_monitor.cellVoltage_mV[1],
     (unsigned)bq76907_monitor.cellVoltage_mV[2],
-    (unsigned)bq76907_monitor.cellVoltage_mV[3],
+    (unsigned)bq76907_monitor.cellVoltage_mV[3]);
+  TRACE("[MON] Flags OV=%u UV=%u OCD=%u SCD=%u OT=%u",
     (unsigned)bq76907_monitor.status.ov_fault,
     (unsigned)bq76907_monitor.status.uv_fault,
     (unsigned)bq76907_monitor.status.ocd_fault,
     (unsigned)bq76907_monitor.status.scd_fault,
     (unsigned)bq76907_monitor.status.ot_fault);
-  printf("[FUNC] UpdateMonitor END\n");
+  TRACE("[FUNC] UpdateMonitor END");
 }
 
 static uint16_t findMaxCell(uint16_t *vals, uint8_t count) {
@@ -333,9 +640,10 @@ static uint16_t findMinCell(uint16_t *vals, uint8_t count) {
 }
 
 static void EvaluateBalancing(void) {
+  if (!monitor_online) return;
   uint32_t tStart = HAL_GetTick();
-  printf("[FUNC] EvaluateBalancing BEGIN\n");
-  printf("[BAL] Evaluate begin\n");
+  TRACE("[FUNC] EvaluateBalancing BEGIN");
+  TRACE("[BAL] Evaluate begin");
   // Placeholder simple balancing: compute delta and decide a mask
   uint8_t cellCount = 4; // 4-series pack
   uint16_t vmax = findMaxCell(bq76907_monitor.cellVoltage_mV, cellCount);
@@ -359,20 +667,20 @@ static void EvaluateBalancing(void) {
       balancingActive = 0;
     }
   }
-  printf("[BAL] Evaluate end (%lums) delta=%u mV active=%u\n",
+  TRACE("[BAL] Evaluate end (%lums) delta=%u mV active=%u",
     (unsigned long)(HAL_GetTick()-tStart),
     (unsigned)(vmax - vmin),
     (unsigned)balancingActive);
-  printf("[FUNC] EvaluateBalancing END\n");
+  TRACE("[FUNC] EvaluateBalancing END");
 }
 
 static void applyCellBalancingMask(uint8_t mask) {
-  printf("[FUNC] applyCellBalancingMask BEGIN\n");
-  printf("[BAL] Apply mask=0x%02X\n", mask);
+  TRACE("[FUNC] applyCellBalancingMask BEGIN");
+  TRACE("[BAL] Apply mask=0x%02X", mask);
   // Placeholder: would write mask bits into CELLBAL1/2 registers after verification.
   // Splitting across two registers if needed (e.g., lower 3 bits in CELLBAL1, next in CELLBAL2).
   (void)mask; // suppress unused warning until implemented
-  printf("[FUNC] applyCellBalancingMask END\n");
+  TRACE("[FUNC] applyCellBalancingMask END");
 }
 
 /* USER CODE END 4 */
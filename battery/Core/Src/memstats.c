@@ -0,0 +1,128 @@
+/*
+ * memstats.c
+ *
+ *  Stack painting, heap accounting and the memory report (see memstats.h).
+ */
+#include "memstats.h"
+#include <stdio.h>
+#include <string.h>
+#if !defined(USE_HAL_STUBS)
+#include "stm32g0xx_hal.h"
+#endif
+
+static MemStats_Stats stats;
+static uintptr_t paintLow, paintHigh;    /* painted words: [paintLow, paintHigh) */
+static uintptr_t heapStart;
+static volatile uint8_t reportRequested;
+
+/* Runs before anything else and must not use the area it paints: no calls
+ * inside the loop, and the words below SP - guard are free at this point. */
+void MemStats_PaintStack(void){
+    MemStats_Layout l;
+    MemStats_HwLayout(&l);
+    uintptr_t lo = (l.staticEnd + 3u) & ~(uintptr_t)3u;    /* nothing allocated yet */
+    uintptr_t hi = (MemStats_HwStackPointer() - MEMSTATS_PAINT_GUARD) & ~(uintptr_t)3u;
+    if (hi <= lo) return;
+    for (volatile uint32_t *p = (volatile uint32_t *)lo; (uintptr_t)p < hi; p++) *p = MEMSTATS_PAINT;
+    heapStart = l.staticEnd;
+    paintLow = lo;
+    paintHigh = hi;
+    stats.painted = (uint32_t)(hi - lo);
+}
+
+/* Painted area above the heap's peak: heap blocks overwrite the paint too */
+static uintptr_t scanStart(void){
+    uintptr_t s = (heapStart + stats.heapPeak + 3u) & ~(uintptr_t)3u;
+    return s > paintLow ? s : paintLow;
+}
+
+/* Lowest word above the heap that the stack overwrote (paintHigh if none) */
+static uintptr_t lowestTouched(void){
+    const volatile uint32_t *p = (const volatile uint32_t *)scanStart();
+    while ((uintptr_t)p < paintHigh && *p == MEMSTATS_PAINT) p++;
+    return (uintptr_t)p;
+}
+
+uint32_t MemStats_StackHighWater(void){
+    if (!stats.painted) return 0;
+    MemStats_Layout l;
+    MemStats_HwLayout(&l);
+    return (uint32_t)(l.stackTop - lowestTouched());
+}
+
+uint32_t MemStats_StackFree(void){
+    if (!stats.painted) return 0;
+    uintptr_t t = lowestTouched(), s = scanStart();
+    return t > s ? (uint32_t)(t - s) : 0;
+}
+
+void MemStats_NoteSbrk(uint32_t heapSize, uint8_t ok){
+    stats.sbrkCalls++;
+    if (!ok){
+        stats.sbrkFailures++;
+        return;
+    }
+    stats.heapSize = heapSize;
+    if (heapSize > stats.heapPeak) stats.heapPeak = heapSize;
+}
+
+const MemStats_Stats *MemStats_GetStats(void){
+    return &stats;
+}
+
+void MemStats_LogStats(void){
+    printf("[MEM] stack max=%lu free=%lu heap=%lu peak=%lu sbrkFail=%lu\n",
+        (unsigned long)MemStats_StackHighWater(), (unsigned long)MemStats_StackFree(),
+        (unsigned long)stats.heapSize, (unsigned long)stats.heapPeak, (unsigned long)stats.sbrkFailures);
+}
+
+void MemStats_Report(void){
+    MemStats_Layout l;
+    MemStats_HwLayout(&l);
+    uint32_t ram = (uint32_t)(l.stackTop - l.ramStart);
+    uint32_t stat = (uint32_t)(l.staticEnd - l.ramStart);
+    uint32_t stackMax = MemStats_StackHighWater();
+    printf("[MEM] ram=%lu static=%lu (.data=%lu .bss/.noinit=%lu)\n",
+        (unsigned long)ram, (unsigned long)stat, (unsigned long)(l.dataEnd - l.ramStart),
+        (unsigned long)(l.staticEnd - l.dataEnd));
+    printf("[MEM] heap size=%lu peak=%lu limit=%lu calls=%lu failures=%lu\n",
+        (unsigned long)stats.heapSize, (unsigned long)stats.heapPeak,
+        (unsigned long)(l.heapLimit - l.staticEnd), (unsigned long)stats.sbrkCalls,
+        (unsigned long)stats.sbrkFailures);
+    printf("[MEM] stack max=%lu reserved=%lu painted=%lu untouched=%lu%s\n",
+        (unsigned long)stackMax, (unsigned long)(l.stackTop - l.heapLimit),
+        (unsigned long)stats.painted, (unsigned long)MemStats_StackFree(),
+        stackMax > l.stackTop - l.heapLimit ? " OVER RESERVE" : "");
+    /* Headroom: RAM neither static data, the heap peak nor the stack peak reached */
+    uint32_t untouched = MemStats_StackFree();
+    printf("[MEM] headroom=%lu of %lu (%lu%%)\n", (unsigned long)untouched, (unsigned long)ram,
+        (unsigned long)(ram ? (uint64_t)untouched * 100u / ram : 0));
+}
+
+void MemStats_RequestReport(void){
+    reportRequested = 1;
+}
+
+uint8_t MemStats_TakeReportRequest(void){
+    uint8_t r = reportRequested;
+    if (r) reportRequested = 0;
+    return r;
+}
+
+#if !defined(USE_HAL_STUBS)
+/* ================= Target layout ================= */
+extern uint8_t _sdata, _edata, _end, _estack;
+extern uint8_t _Min_Stack_Size;      /* absolute symbol: its address is the size */
+
+void MemStats_HwLayout(MemStats_Layout *out){
+    out->ramStart = (uintptr_t)&_sdata;
+    out->dataEnd = (uintptr_t)&_edata;
+    out->staticEnd = (uintptr_t)&_end;
+    out->stackTop = (uintptr_t)&_estack;
+    out->heapLimit = (uintptr_t)&_estack - (uintptr_t)&_Min_Stack_Size;
+}
+
+uintptr_t MemStats_HwStackPointer(void){
+    return (uintptr_t)__get_MSP();
+}
+#endif
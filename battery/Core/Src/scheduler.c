@@ -0,0 +1,218 @@
+/*
+ * scheduler.c
+ *
+ *  Cooperative task scheduler (see scheduler.h). Single-threaded: every
+ *  call comes from the main loop, never from interrupts (Scheduler_Running
+ *  and Scheduler_GetStats reads excepted).
+ */
+#include "scheduler.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+    uint32_t nextRelease;        /* next periodic release (HAL tick) */
+    uint32_t period_ms;          /* current period, 0 = event task */
+    uint32_t eventRelease;       /* tick of the pending Scheduler_Release() */
+    uint8_t  eventPending;
+    uint8_t  heldByGuard;        /* current release already counted as deferred */
+} Scheduler_TaskState;
+
+static const Scheduler_Task *tasks;
+static uint8_t taskCount;
+static Scheduler_TaskState state[SCHED_MAX_TASKS];
+static Scheduler_TaskStats stats[SCHED_MAX_TASKS];
+static uint32_t lastI2CStart;
+static uint8_t  i2cStarted;      /* lastI2CStart is valid */
+static volatile uint8_t running = SCHED_NO_TASK;   /* read by the watchdog from SysTick */
+
+static uint32_t gcd(uint32_t a, uint32_t b){
+    while (b){ uint32_t t = a % b; a = b; b = t; }
+    return a;
+}
+
+/* Closest two releases of periodic tasks a and b can ever get:
+ * releases differ by (phaseA - phaseB) + i*Pa - j*Pb, i.e. the phase
+ * difference modulo gcd(Pa, Pb). */
+static uint32_t releaseDistance(const Scheduler_Task *a, const Scheduler_Task *b){
+    uint32_t g = gcd(a->period_ms, b->period_ms);
+    uint32_t d = (a->phase_ms % g + g - b->phase_ms % g) % g;
+    return d < g - d ? d : g - d;
+}
+
+uint8_t Scheduler_Init(const Scheduler_Task *table, uint8_t count, uint32_t now_ms){
+    uint8_t clashes = 0;
+    tasks = table;
+    taskCount = count > SCHED_MAX_TASKS ? SCHED_MAX_TASKS : count;
+    memset(state, 0, sizeof(state));
+    i2cStarted = 0;
+    Scheduler_ResetStats();
+
+    for (uint8_t i = 0; i < taskCount; i++){
+        state[i].period_ms = tasks[i].period_ms;
+        state[i].nextRelease = now_ms + tasks[i].phase_ms;
+    }
+    for (uint8_t i = 0; i < taskCount; i++){
+        const Scheduler_Task *a = &tasks[i];
+        if (!(a->flags & SCHED_TASK_I2C) || !a->period_ms) continue;
+        for (uint8_t j = i + 1; j < taskCount; j++){
+            const Scheduler_Task *b = &tasks[j];
+            if (!(b->flags & SCHED_TASK_I2C) || !b->period_ms) continue;
+            uint32_t d = releaseDistance(a, b);
+            if (d < SCHED_I2C_GUARD_MS){
+                clashes++;
+                printf("[SCHED] phase clash %s/%s: releases %lums apart (guard %ums)\n",
+                    a->name, b->name, (unsigned long)d, (unsigned)SCHED_I2C_GUARD_MS);
+            }
+        }
+    }
+    if (count > SCHED_MAX_TASKS){
+        printf("[SCHED] %u tasks, only %u scheduled\n", (unsigned)count, (unsigned)SCHED_MAX_TASKS);
+    }
+    return clashes;
+}
+
+/* 1 if task i is ready at `now`; *release gets the tick it was released at */
+static uint8_t readyAt(uint8_t i, uint32_t now, uint32_t *release){
+    const Scheduler_TaskState *s = &state[i];
+    if (s->eventPending){
+        *release = s->eventRelease;
+        return 1;
+    }
+    if (s->period_ms && (int32_t)(now - s->nextRelease) >= 0){
+        *release = s->nextRelease;
+        return 1;
+    }
+    return 0;
+}
+
+static uint8_t guardHolds(uint8_t i, uint32_t now){
+    return (tasks[i].flags & SCHED_TASK_I2C) && i2cStarted &&
+           (now - lastI2CStart) < SCHED_I2C_GUARD_MS;
+}
+
+static void runTask(uint8_t i, uint32_t release, uint32_t now){
+    const Scheduler_Task *t = &tasks[i];
+    Scheduler_TaskState *s = &state[i];
+    Scheduler_TaskStats *st = &stats[i];
+
+    if (s->eventPending){
+        s->eventPending = 0;
+    } else {
+        /* Stay on the phase grid; drop releases that are already late */
+        s->nextRelease += s->period_ms;
+        while ((int32_t)(now - s->nextRelease) >= 0){
+            s->nextRelease += s->period_ms;
+            st->missedReleases++;
+        }
+    }
+    s->heldByGuard = 0;
+    if (t->flags & SCHED_TASK_I2C){
+        lastI2CStart = now;
+        i2cStarted = 1;
+    }
+
+    uint32_t lat = now - release;
+    if (lat > st->maxLatency_ms) st->maxLatency_ms = lat;
+
+    uint32_t t0 = SCHED_NOW_US();
+    running = i;
+    t->run();
+    running = SCHED_NO_TASK;
+    uint32_t dt = SCHED_NOW_US() - t0;
+
+    st->runs++;
+    st->lastExec_us = dt;
+    st->totalExec_us += dt;
+    if (dt > st->maxExec_us) st->maxExec_us = dt;
+    Latency_Record(&st->exec, dt);
+    uint32_t deadline = t->deadline_ms ? t->deadline_ms : s->period_ms;
+    if (deadline && (HAL_GetTick() - release) > deadline) st->overruns++;
+}
+
+uint8_t Scheduler_RunReady(uint8_t maxTasks){
+    uint8_t ran = 0;
+    while (ran < maxTasks){
+        uint32_t now = HAL_GetTick();
+        uint8_t best = 0xFF;
+        uint32_t bestRelease = 0;
+        for (uint8_t i = 0; i < taskCount; i++){
+            uint32_t release;
+            if (!readyAt(i, now, &release)) continue;
+            if (guardHolds(i, now)){
+                if (!state[i].heldByGuard){
+                    state[i].heldByGuard = 1;
+                    stats[i].deferred++;
+                }
+                continue;
+            }
+            if (best == 0xFF || tasks[i].prio < tasks[best].prio ||
+                (tasks[i].prio == tasks[best].prio && (int32_t)(release - bestRelease) < 0)){
+                best = i;
+                bestRelease = release;
+            }
+        }
+        if (best == 0xFF) break;
+        runTask(best, bestRelease, now);
+        ran++;
+    }
+    return ran;
+}
+
+uint8_t Scheduler_Running(void){
+    return running;
+}
+
+void Scheduler_Release(uint8_t id){
+    if (id >= taskCount) return;
+    if (state[id].eventPending){
+        stats[id].missedReleases++;   /* coalesced into the pending one */
+        return;
+    }
+    state[id].eventPending = 1;
+    state[id].eventRelease = HAL_GetTick();
+}
+
+void Scheduler_SetPeriod(uint8_t id, uint32_t period_ms){
+    if (id >= taskCount || !tasks[id].period_ms || !period_ms) return;
+    state[id].period_ms = period_ms;
+}
+
+uint32_t Scheduler_TimeToNext(uint32_t now_ms){
+    uint32_t best = 0xFFFFFFFFu;
+    for (uint8_t i = 0; i < taskCount; i++){
+        uint32_t release, wait;
+        if (readyAt(i, now_ms, &release)){
+            if (!guardHolds(i, now_ms)) return 0;
+            wait = SCHED_I2C_GUARD_MS - (now_ms - lastI2CStart);
+        } else if (state[i].period_ms){
+            wait = state[i].nextRelease - now_ms;
+        } else {
+            continue;
+        }
+        if (wait < best) best = wait;
+    }
+    return best;
+}
+
+const Scheduler_TaskStats *Scheduler_GetStats(uint8_t id){
+    return id < taskCount ? &stats[id] : NULL;
+}
+
+const char *Scheduler_TaskName(uint8_t id){
+    return id < taskCount ? tasks[id].name : NULL;
+}
+
+void Scheduler_ResetStats(void){
+    memset(stats, 0, sizeof(stats));
+}
+
+void Scheduler_LogStats(void){
+    for (uint8_t i = 0; i < taskCount; i++){
+        const Scheduler_TaskStats *st = &stats[i];
+        uint32_t avg = st->runs ? (uint32_t)(st->totalExec_us / st->runs) : 0;
+        printf("[SCHED] %-8s runs=%lu exec=%lu/%luus lat=%lums over=%lu miss=%lu defer=%lu\n",
+            tasks[i].name, (unsigned long)st->runs, (unsigned long)avg, (unsigned long)st->maxExec_us,
+            (unsigned long)st->maxLatency_ms, (unsigned long)st->overruns,
+            (unsigned long)st->missedReleases, (unsigned long)st->deferred);
+    }
+}
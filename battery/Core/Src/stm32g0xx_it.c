@@ -22,6 +22,8 @@
 #include "stm32g0xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "lowpower.h"
+#include "watchdog.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -129,6 +131,7 @@ void SysTick_Handler(void)
   /* USER CODE END SysTick_IRQn 0 */
   HAL_IncTick();
   /* USER CODE BEGIN SysTick_IRQn 1 */
+  Watchdog_TickISR();
 
   /* USER CODE END SysTick_IRQn 1 */
 }
@@ -142,4 +145,29 @@ void SysTick_Handler(void)
 
 /* USER CODE BEGIN 1 */
 
+/**
+  * @brief EXTI lines 0 and 1: BMS_INTERRUPT, MPPT_BQ_INTERRUPT (tickless idle wake-up).
+  */
+void EXTI0_1_IRQHandler(void)
+{
+  HAL_GPIO_EXTI_IRQHandler(BMS_INTERRUPT_Pin);
+  HAL_GPIO_EXTI_IRQHandler(MPPT_BQ_INTERRUPT_Pin);
+}
+
+/**
+  * @brief EXTI lines 2 and 3: LIGHT_SWITCH.
+  */
+void EXTI2_3_IRQHandler(void)
+{
+  HAL_GPIO_EXTI_IRQHandler(LIGHT_SWITCH_Pin);
+}
+
+/**
+  * @brief LPTIM1 (shared vector with TIM6/DAC): tickless idle wake-up timer.
+  */
+void TIM6_DAC_LPTIM1_IRQHandler(void)
+{
+  LowPower_LptimIRQHandler();
+}
+
 /* USER CODE END 1 */
@@ -23,6 +23,7 @@
 /* Includes */
 #include <errno.h>
 #include <stdint.h>
+#include "memstats.h"
 
 /**
  * Pointer to the current high watermark of the heap usage
@@ -68,12 +69,14 @@ void *_sbrk(ptrdiff_t incr)
   /* Protect heap from growing into the reserved MSP stack */
   if (__sbrk_heap_end + incr > max_heap)
   {
+    MemStats_NoteSbrk((uint32_t)(__sbrk_heap_end - &_end), 0);
     errno = ENOMEM;
     return (void *)-1;
   }
 
   prev_heap_end = __sbrk_heap_end;
   __sbrk_heap_end += incr;
+  MemStats_NoteSbrk((uint32_t)(__sbrk_heap_end - &_end), 1);
 
   return (void *)prev_heap_end;
 }
@@ -0,0 +1,96 @@
+/*
+ * trace.c
+ *
+ *  Binary deferred logging (see trace.h).
+ */
+#include "trace.h"
+#include <string.h>
+#if defined(USE_HAL_STUBS)
+#include "hal_stubs.h"
+#define TRACE_LOCK()     uint32_t trace_pm_ = 0
+#define TRACE_UNLOCK()   (void)trace_pm_
+#else
+#include "stm32g0xx_hal.h"
+#define TRACE_LOCK()     uint32_t trace_pm_ = __get_PRIMASK(); __disable_irq()
+#define TRACE_UNLOCK()   __set_PRIMASK(trace_pm_)
+#endif
+
+#define TRACE_MASK (TRACE_RING_WORDS - 1u)
+
+typedef enum { trace_ring_pow2 = 1 / ((TRACE_RING_WORDS & TRACE_MASK) == 0 ? 1u : 0u) } Trace_RingCheck;
+
+static uint32_t ring[TRACE_RING_WORDS];
+static volatile uint32_t head;         /* next word to reserve (free running) */
+static volatile uint32_t tail;         /* next word to drain (free running) */
+static uint32_t droppedReported;
+static Trace_Stats stats;
+
+void Trace_Log(uint16_t id, uint8_t nargs, const uint32_t *args){
+    uint32_t need = 2u + nargs;
+    uint32_t at;
+    {
+        TRACE_LOCK();
+        at = head;
+        uint32_t used = at - tail;
+        if (TRACE_RING_WORDS - used < need){
+            stats.dropped++;
+            TRACE_UNLOCK();
+            return;
+        }
+        head = at + need;
+        if (used + need > stats.maxUsed) stats.maxUsed = (uint16_t)(used + need);
+        stats.records++;
+        TRACE_UNLOCK();
+    }
+    ring[at & TRACE_MASK] = TRACE_MAGIC | ((uint32_t)nargs << 8) | ((uint32_t)id << 16);
+    ring[(at + 1u) & TRACE_MASK] = TRACE_NOW();
+    for (uint8_t i = 0; i < nargs; i++) ring[(at + 2u + i) & TRACE_MASK] = args[i];
+}
+
+__attribute__((weak)) void Trace_Output(const uint8_t *data, uint32_t len){
+#if defined(USE_HAL_STUBS)
+    fwrite(data, 1, len, stdout);
+#else
+    extern int _write(int file, char *ptr, int len);
+    _write(1, (char *)data, (int)len);
+#endif
+}
+
+uint32_t Trace_Drain(uint32_t maxRecords){
+    uint32_t n = 0;
+    while (n < maxRecords && tail != head){
+        uint32_t t = tail;
+        uint32_t words = 2u + ((ring[t & TRACE_MASK] >> 8) & 0xFFu);
+        uint32_t first = TRACE_RING_WORDS - (t & TRACE_MASK);   /* words before the wrap */
+        if (first > words) first = words;
+        Trace_Output((const uint8_t *)&ring[t & TRACE_MASK], first * 4u);
+        if (words > first) Trace_Output((const uint8_t *)&ring[0], (words - first) * 4u);
+        tail = t + words;
+        stats.drained++;
+        n++;
+    }
+    /* Report drops once the records written before them are out */
+    if (tail == head && stats.dropped != droppedReported){
+        uint32_t rec[3] = {
+            TRACE_MAGIC | (1u << 8) | ((uint32_t)TRACE_ID_DROPPED << 16),
+            TRACE_NOW(), stats.dropped - droppedReported,
+        };
+        droppedReported = stats.dropped;
+        Trace_Output((const uint8_t *)rec, sizeof(rec));
+    }
+    return n;
+}
+
+uint32_t Trace_Pending(void){
+    return head - tail;
+}
+
+const Trace_Stats *Trace_GetStats(void){
+    return &stats;
+}
+
+void Trace_LogStats(void){
+    printf("[TRACE] records=%lu drained=%lu dropped=%lu ring=%u/%u words\n",
+        (unsigned long)stats.records, (unsigned long)stats.drained, (unsigned long)stats.dropped,
+        (unsigned)stats.maxUsed, (unsigned)TRACE_RING_WORDS);
+}
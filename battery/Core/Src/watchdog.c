@@ -0,0 +1,167 @@
+/*
+ * watchdog.c
+ *
+ *  IWDG task supervisor (see watchdog.h).
+ */
+#include "watchdog.h"
+#include "scheduler.h"
+#include "bm_errors.h"
+#include <stdio.h>
+#include <string.h>
+
+#define WATCHDOG_MAGIC  0x57444F47u   /* "WDOG" */
+
+#if defined(USE_HAL_STUBS)
+#define WATCHDOG_NOINIT
+#else
+#define WATCHDOG_NOINIT __attribute__((section(".noinit")))
+#endif
+
+typedef struct {
+    uint8_t  id;
+    uint32_t deadline_ms;
+    uint32_t lastRuns;         /* run counter at the last progress */
+    uint32_t lastProgress;     /* tick the run counter last moved */
+} Watchdog_Task;
+
+static Watchdog_ResetRecord record WATCHDOG_NOINIT;
+static Watchdog_Task sup[WATCHDOG_MAX_TASKS];
+static uint8_t supCount;
+static volatile uint32_t lastService;   /* loop check-in (written by the loop, read by SysTick) */
+static volatile uint8_t tripped;
+static volatile uint8_t armed;          /* loop running: supervision active */
+static uint32_t lastKick;
+static uint32_t tickDivider;
+static Watchdog_Stats stats;
+
+static uint32_t recordCheck(const Watchdog_ResetRecord *r){
+    return ~(r->magic ^ r->tick ^ r->late_ms ^
+             ((uint32_t)r->reason | (uint32_t)r->task << 8 | (uint32_t)r->running << 16 | (uint32_t)r->resets << 24));
+}
+
+static uint8_t recordValid(void){
+    return record.magic == WATCHDOG_MAGIC && record.check == recordCheck(&record);
+}
+
+void Watchdog_Init(void){
+    uint8_t resets = recordValid() ? record.resets : 0;   /* 0 after power-up (RAM content random) */
+    memset(&stats, 0, sizeof(stats));
+    if (Watchdog_HwTookReset()){
+        if (recordValid() && record.reason != WATCHDOG_OK){
+            stats.last = record;
+        } else {
+            memset(&stats.last, 0, sizeof(stats.last));
+            stats.last.reason = WATCHDOG_UNKNOWN;
+            stats.last.task = stats.last.running = SCHED_NO_TASK;
+        }
+        if (resets < 0xFFu) resets++;
+        stats.last.resets = resets;
+        BM_ErrorPush(0, BM_SRC_GENERIC, BM_ERR_TIMEOUT, stats.last.reason, stats.last.task,
+                     (uint16_t)(stats.last.late_ms > 0xFFFFu ? 0xFFFFu : stats.last.late_ms));
+    }
+    /* Armed but empty: a reset from here on without a trip reads as UNKNOWN */
+    memset(&record, 0, sizeof(record));
+    record.magic = WATCHDOG_MAGIC;
+    record.resets = resets;
+    record.check = recordCheck(&record);
+
+    supCount = 0;
+    tripped = 0;
+    armed = 0;
+    tickDivider = 0;
+    lastService = lastKick = HAL_GetTick();
+    Watchdog_HwStart(WATCHDOG_TIMEOUT_MS);
+}
+
+void Watchdog_Supervise(uint8_t id, uint32_t deadline_ms){
+    const Scheduler_TaskStats *st = Scheduler_GetStats(id);
+    if (!st || supCount >= WATCHDOG_MAX_TASKS) return;
+    sup[supCount] = (Watchdog_Task){ id, deadline_ms, st->runs, HAL_GetTick() };
+    supCount++;
+}
+
+void Watchdog_Service(uint32_t now_ms){
+    lastService = now_ms;
+    armed = 1;
+    if (!tripped && now_ms - lastKick >= WATCHDOG_KICK_MS){
+        Watchdog_HwKick();
+        lastKick = now_ms;
+        stats.kicks++;
+    }
+}
+
+static void trip(uint8_t reason, uint8_t task, uint32_t late_ms, uint32_t now_ms){
+    record.tick = now_ms;
+    record.late_ms = late_ms;
+    record.reason = reason;
+    record.task = task;
+    record.running = Scheduler_Running();
+    record.check = recordCheck(&record);
+    tripped = 1;
+    stats.tripped = 1;
+}
+
+void Watchdog_Check(uint32_t now_ms){
+    if (!armed || tripped) return;
+    stats.checks++;
+    uint32_t idle = now_ms - lastService;
+    if (idle > WATCHDOG_LOOP_MS){
+        trip(WATCHDOG_LOOP_STALL, SCHED_NO_TASK, idle - WATCHDOG_LOOP_MS, now_ms);
+        return;
+    }
+    for (uint8_t i = 0; i < supCount; i++){
+        Watchdog_Task *t = &sup[i];
+        uint32_t runs = Scheduler_GetStats(t->id)->runs;
+        if (runs != t->lastRuns){
+            t->lastRuns = runs;
+            t->lastProgress = now_ms;
+        } else if (now_ms - t->lastProgress > t->deadline_ms){
+            trip(WATCHDOG_TASK_LATE, t->id, now_ms - t->lastProgress - t->deadline_ms, now_ms);
+            return;
+        }
+    }
+}
+
+void Watchdog_TickISR(void){
+    if (++tickDivider < WATCHDOG_CHECK_MS) return;
+    tickDivider = 0;
+    Watchdog_Check(HAL_GetTick());
+}
+
+const Watchdog_Stats *Watchdog_GetStats(void){
+    return &stats;
+}
+
+void Watchdog_LogStats(void){
+    static const char *const reasons[] = { "none", "task-late", "loop-stall", "unknown" };
+    const Watchdog_ResetRecord *r = &stats.last;
+    printf("[WDG] last=%s task=%d running=%d late=%lums resets=%u kicks=%lu supervised=%u%s\n",
+        reasons[r->reason <= WATCHDOG_UNKNOWN ? r->reason : WATCHDOG_UNKNOWN],
+        r->task == SCHED_NO_TASK ? -1 : (int)r->task, r->running == SCHED_NO_TASK ? -1 : (int)r->running,
+        (unsigned long)r->late_ms, (unsigned)r->resets, (unsigned long)stats.kicks, (unsigned)supCount,
+        stats.tripped ? " TRIPPED" : "");
+}
+
+#if !defined(USE_HAL_STUBS)
+/* ================= Target IWDG access ================= */
+void Watchdog_HwStart(uint32_t timeout_ms){
+    __HAL_RCC_DBGMCU_CLK_ENABLE();
+    __HAL_DBGMCU_FREEZE_IWDG();       /* no resets while halted in the debugger */
+    IWDG->KR = 0xCCCCu;               /* start; turns the LSI on */
+    IWDG->KR = 0x5555u;               /* unlock PR / RLR */
+    IWDG->PR = 3u;                    /* LSI / 32: ~1 ms per count */
+    IWDG->RLR = timeout_ms;
+    while (IWDG->SR) {}               /* PR / RLR update done */
+    IWDG->KR = 0xAAAAu;
+}
+
+void Watchdog_HwKick(void){
+    IWDG->KR = 0xAAAAu;
+}
+
+uint8_t Watchdog_HwTookReset(void){
+    uint8_t iwdg = __HAL_RCC_GET_FLAG(RCC_FLAG_IWDGRST) != 0u;
+    __HAL_RCC_CLEAR_RESET_FLAGS();
+    return iwdg;
+}
+#endif
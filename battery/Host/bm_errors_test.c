@@ -0,0 +1,66 @@
+/*
+ * bm_errors_test.c
+ *
+ *  Error rings and counters (bm_errors.h): a driver's bus failures land in
+ *  its ring and the per source / code / register counters, a ring keeps
+ *  the newest entries and skips a slot its producer has not published,
+ *  the rate window ages old errors out and the counters saturate.
+ *
+ *    bm_errors_test
+ *
+ *  Exits non-zero if a check fails (`make run`).
+ */
+#include <stdio.h>
+#include "host_hal.h"
+#include "bq76907_emu.h"
+#include "i2c_bus.h"
+#include "bm_errors.h"
+
+#define HOST_CHECK_TAG "[ERR]"
+#include "host_check.h"
+
+int main(void){
+    static I2C_HandleTypeDef hi2c1;
+    static BQ76907 mon;
+    PackModel pack; PackModel_SimpleState packState;
+    BQ76907_Emu emu;
+
+    HostHal_reset();
+    PackModel_initSimple(&pack, &packState, 4, 200, 60);
+    BQ76907_Emu_init(&emu, &pack);
+    BQ76907_Emu_attach(&emu);
+    I2CBus_Init(&hi2c1);
+    CHECK(BQ76907_init(&mon, &hi2c1) == 0, "monitor up on the emulator");
+
+    /* Three timeouts on SYS_STAT: the driver records each one */
+    HostHal_injectI2CErrors(BQ76907_I2C_ADDRESS, 3, HAL_TIMEOUT);
+    uint8_t v = 0;
+    for (int i = 0; i < 3; i++) BQ76907_ReadRegister(&mon, BQ76907_REG_SYS_STAT, &v);
+    CHECK(BQ76907_getLastError(&mon) == BM_ERR_I2C && BQ76907_getErrorCount(&mon) > 0 &&
+          BM_ErrorCountByReg(BM_SRC_BQ76907, BQ76907_REG_SYS_STAT) >= 3, "driver errors land in ring and counters");
+
+    BM_ErrorResetCounters();
+    static BM_ErrorRing ring;
+    for (int i = 0; i < 20; i++) BM_ErrorPush(&ring, BM_SRC_BQ25798, BM_ERR_I2C, HAL_TIMEOUT, 0x1B, (uint16_t)i);
+    BM_ErrorEntry ee;
+    CHECK(BM_ErrorRingCount(&ring) == BM_ERROR_LOG_DEPTH && BM_ErrorRead(&ring, 0, &ee) && ee.value == 19 &&
+          BM_ErrorRead(&ring, BM_ERROR_LOG_DEPTH - 1, &ee) && ee.value == 20 - BM_ERROR_LOG_DEPTH &&
+          !BM_ErrorRead(&ring, BM_ERROR_LOG_DEPTH, &ee), "error ring keeps the newest entries");
+    ring.seq[(ring.head - 1u) % BM_ERROR_LOG_DEPTH] = 0;   /* producer interrupted before publishing */
+    CHECK(!BM_ErrorRead(&ring, 0, &ee) && BM_ErrorRead(&ring, 1, &ee), "unpublished slot is not read");
+    CHECK(BM_ErrorCountBySource(BM_SRC_BQ25798) == 20 && BM_ErrorCountByCode(BM_ERR_I2C) == 20 &&
+          BM_ErrorCountByReg(BM_SRC_BQ25798, 0x1B) == 20 && BM_ErrorCountByReg(BM_SRC_BQ25798, 0x1C) == 0 &&
+          BM_ErrorCountBySource(BM_SRC_BQ76907) == 0, "per source / code / register counters");
+
+    CHECK(BM_ErrorRate(BM_SRC_BQ25798, HostHal_nowMs()) == 20, "error rate within the window");
+    HostHal_advanceMs(2u * BM_ERROR_RATE_WINDOW_MS);
+    for (int i = 0; i < 5; i++) BM_ErrorPush(NULL, BM_SRC_BQ25798, BM_ERR_TIMEOUT, 0, 0x1B, 0);
+    CHECK(BM_ErrorRate(BM_SRC_BQ25798, HostHal_nowMs()) == 5 &&
+          BM_ErrorRate(BM_SRC_BQ25798, HostHal_nowMs() + 2u * BM_ERROR_RATE_WINDOW_MS) == 0, "old errors age out of the rate");
+    for (uint32_t i = 0; i < 70000u; i++) BM_ErrorPush(NULL, BM_SRC_GENERIC, BM_ERR_STATE, 0, 0, 0);
+    CHECK(BM_ErrorCountBySource(BM_SRC_GENERIC) == 0xFFFFu && BM_ErrorCountByCode(BM_ERR_STATE) == 0xFFFFu,
+          "counters saturate");
+    BM_ErrorLogStats();
+
+    return HostCheck_result();
+}
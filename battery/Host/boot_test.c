@@ -0,0 +1,134 @@
+/*
+ * boot_test.c
+ *
+ *  Boot sequencer (boot.h) against the blocking bring-up it replaced:
+ *  charger init script, monitor init / applyConfig and the first status
+ *  read, on a 100 kHz bus. The BQ76907 emulator is the monitor and a plain
+ *  register file stands in for the charger. Checked: a config that does
+ *  not read back is rewritten (cold), a matching one is kept (warm), the
+ *  monitor is measured before the charger finishes and an absent charger
+ *  does not hold it up.
+ *
+ *    boot_test
+ *
+ *  Exits non-zero if a check fails (`make run`).
+ */
+#include <stdio.h>
+#include <string.h>
+#include "host_hal.h"
+#include "bq76907_emu.h"
+#include "i2c_bus.h"
+#include "latency.h"
+#include "boot.h"
+#include "bq25798.h"
+
+#define HOST_CHECK_TAG "[BOOT]"
+#include "host_check.h"
+
+/* Stand-in charger: a plain register file at the BQ25798 address */
+static uint8_t chgRegs[256];
+static HAL_StatusTypeDef chgRead(void *ctx, uint8_t reg, uint8_t *data, uint16_t len){
+    (void)ctx;
+    for (uint16_t i = 0; i < len; i++) data[i] = chgRegs[(uint8_t)(reg + i)];
+    return HAL_OK;
+}
+static HAL_StatusTypeDef chgWrite(void *ctx, uint8_t reg, const uint8_t *data, uint16_t len){
+    (void)ctx;
+    for (uint16_t i = 0; i < len; i++) chgRegs[(uint8_t)(reg + i)] = data[i];
+    return HAL_OK;
+}
+
+/* main.c's BringUpDevices: boot both, queue the monitor's first refresh as
+ * soon as it is READY. Returns reset -> protected measurement (0 = none). */
+static uint32_t bootRun(Boot_Device *devs, uint8_t n, BQ76907 *mon){
+    uint8_t measuring = 0, measured = 0;
+    Boot_Begin();
+    Boot_Start(devs, n);
+    for (;;){
+        uint8_t running = Boot_Service();
+        uint8_t monReady = devs[0].state == BOOT_DEV_READY;
+        if (monReady && !measuring && !measured &&
+            BQ76907_queueStatusRefresh(mon, HostHal_nowMs() + 50) == HAL_OK) measuring = 1;
+        if (measuring && I2CBus_Pending(BQ76907_I2C_ADDRESS) == 0){
+            measuring = 0;
+            measured = 1;
+            Boot_Mark(BOOT_PHASE_PROTECTED);
+        }
+        if (!running && (measured || !monReady)) break;
+        I2CBus_Service(2);
+    }
+    return measured ? Boot_PhaseUs(BOOT_PHASE_PROTECTED) - Boot_PhaseUs(BOOT_PHASE_START) : 0;
+}
+
+int main(void){
+    static I2C_HandleTypeDef hi2c1;
+    static BQ76907 bootMon;
+    PackModel pack; PackModel_SimpleState packState;
+    BQ76907_Emu emu;
+
+    HostHal_reset();
+    PackModel_initSimple(&pack, &packState, 4, 200, 60);
+    BQ76907_Emu_init(&emu, &pack);
+    BQ76907_Emu_attach(&emu);
+    HostI2C_Device chg = { .devAddress = BQ25798_I2C_ADDRESS, .read = chgRead, .write = chgWrite };
+    HostHal_attachI2C(&chg);
+    I2CBus_Init(&hi2c1);
+    Latency_Init();
+    HostHal_setI2CTiming(300, 90);                      /* 100 kHz */
+
+    BQ76907_Config bootCfg = {
+        .cellCount = 4, .uvThreshold_mV = 2500, .ovThreshold_mV = 4150, .ocDischarge1_mA = 4000,
+        .protectionsA = BQ76907_PROT_A_CUV,
+        .alarmEnableMask = BQ76907_SYS_STAT_UV_FLAG | BQ76907_SYS_STAT_OV_FLAG,
+    };
+    uint8_t cfgImage[BQ76907_CFG_IMAGE_LEN];
+    BQ_RegWrite monScript[BQ76907_CFG_SCRIPT_LEN], chgScript[10];
+    BQ76907_configImage(&bootCfg, cfgImage);
+    for (uint8_t i = 0; i < 10; i++) chgScript[i] = (BQ_RegWrite){ (uint8_t)(0x10 + i), 1, { (uint8_t)(0xA0 + i) } };
+    const Boot_DeviceDesc bootDesc[2] = {
+        { .name = "BQ76907", .devAddress = BQ76907_I2C_ADDRESS, .source = BM_SRC_BQ76907, .prio = I2C_BUS_PRIO_CONTROL,
+          .idReg = BQ76907_REG_DEVICE_ID, .cfgReg = BQ76907_CFG_FIRST_REG, .cfgLen = BQ76907_CFG_IMAGE_LEN,
+          .cfgImage = cfgImage, .script = monScript, .scriptLen = BQ76907_configScript(&bootCfg, monScript) },
+        { .name = "BQ25798", .devAddress = BQ25798_I2C_ADDRESS, .source = BM_SRC_BQ25798, .prio = I2C_BUS_PRIO_MEASURE,
+          .idReg = BQ25798_REG_PART_INFO, .script = chgScript, .scriptLen = 10 },
+    };
+    Boot_Device bootDev[2] = { { .desc = &bootDesc[0] }, { .desc = &bootDesc[1] } };
+    bootMon.i2cHandle = &hi2c1;
+
+    /* Blocking bring-up, as main.c did it before the sequencer */
+    uint32_t b0 = Latency_NowUs();
+    for (uint8_t i = 0; i < 10; i++) I2CBus_MemWrite(&hi2c1, BQ25798_I2C_ADDRESS, chgScript[i].reg, chgScript[i].data, 1);
+    BQ76907_init(&bootMon, &hi2c1);
+    BQ76907_applyConfig(&bootMon, &bootCfg);
+    BQ76907_readSystemStatus(&bootMon);
+    BQ76907_readCellVoltages(&bootMon);
+    uint32_t legacyUs = Latency_NowUs() - b0;
+    CHECK(memcmp(&emu.regs[BQ76907_CFG_FIRST_REG], cfgImage, BQ76907_CFG_IMAGE_LEN) == 0,
+          "config image matches applyConfig writes");
+
+    memset(&emu.regs[BQ76907_REG_ENABLED_PROTECTIONS_A], 0, 4);   /* device lost part of its config */
+    memset(chgRegs, 0, sizeof(chgRegs));
+    uint32_t entries = emu.stats.cfgUpdateEntries;
+    uint32_t coldUs = bootRun(bootDev, 2, &bootMon);
+    CHECK(bootDev[0].state == BOOT_DEV_READY && !bootDev[0].configSkipped && emu.stats.cfgUpdateEntries == entries + 1 &&
+          memcmp(&emu.regs[BQ76907_CFG_FIRST_REG], cfgImage, BQ76907_CFG_IMAGE_LEN) == 0,
+          "boot rewrites a config that does not read back");
+    CHECK(bootDev[1].state == BOOT_DEV_READY && chgRegs[0x19] == 0xA9 && coldUs && coldUs <= legacyUs &&
+          Boot_PhaseUs(BOOT_PHASE_PROTECTED) < Boot_PhaseUs(BOOT_PHASE_DEVICES),
+          "monitor measured before the charger init ends");
+
+    uint32_t warmUs = bootRun(bootDev, 2, &bootMon);
+    Boot_LogTimings();
+    CHECK(bootDev[0].configSkipped && emu.stats.cfgUpdateEntries == entries + 1 && warmUs && warmUs * 2u < legacyUs,
+          "warm boot keeps config, first measurement < half");
+    printf("[BOOT] reset -> protected measurement: blocking %luus, cold %luus, warm %luus\n",
+           (unsigned long)legacyUs, (unsigned long)coldUs, (unsigned long)warmUs);
+
+    HostHal_injectI2CErrors(BQ25798_I2C_ADDRESS, 1, HAL_ERROR);
+    uint32_t aloneUs = bootRun(bootDev, 2, &bootMon);
+    CHECK(bootDev[1].state == BOOT_DEV_FAILED && bootDev[0].state == BOOT_DEV_READY && aloneUs && aloneUs <= warmUs,
+          "absent charger does not hold up the monitor");
+    HostHal_setI2CTiming(0, 0);
+
+    return HostCheck_result();
+}
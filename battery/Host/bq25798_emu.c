@@ -0,0 +1,127 @@
+/*
+ * bq25798_emu.c
+ *
+ *  Register-level BQ25798 model. See bq25798_emu.h for the modelled subset.
+ */
+#include "bq25798_emu.h"
+#include "host_hal.h"
+#include <string.h>
+
+#define STATUS_FIRST  BQ25798_REG_ICO_CURRENT_LIMIT
+#define STATUS_LAST   BQ25798_REG_FAULT_FLAG_1
+#define ADC_FIRST     BQ25798_REG_IBUS_ADC
+#define ADC_LAST      BQ25798_REG_PART_INFO
+
+static inline void put_be16(uint8_t *p, uint16_t v){ p[0] = (uint8_t)(v >> 8); p[1] = (uint8_t)v; }
+static inline uint16_t get_be16(const uint8_t *p){ return (uint16_t)((p[0] << 8) | p[1]); }
+
+static int isReadOnly(uint8_t reg){
+    return (reg >= STATUS_FIRST && reg <= STATUS_LAST) || (reg >= ADC_FIRST && reg <= ADC_LAST);
+}
+
+static uint32_t packVoltage_mV(const BQ25798_Emu *emu){
+    uint32_t v = 0;
+    for (uint8_t i = 0; i < emu->pack->cellCount; i++) v += PackModel_cellVoltage_mV(emu->pack, i);
+    return v;
+}
+
+/* ---------- charge model ---------- */
+static uint8_t updateCharge(BQ25798_Emu *emu, uint32_t vbat){
+    const uint8_t *r = emu->regs;
+    uint8_t ctrl0 = r[BQ25798_REG_CHARGER_CTRL_0];
+    uint32_t vreg   = BQ25798_decodeChargeVoltage_raw(get_be16(&r[BQ25798_REG_CHARGE_VOLTAGE_LIMIT]));
+    uint32_t ichg   = BQ25798_decodeChargeCurrent_raw(get_be16(&r[BQ25798_REG_CHARGE_CURRENT_LIMIT]));
+    uint32_t vindpm = BQ25798_decodeInputVoltageLimit_raw(r[BQ25798_REG_INPUT_VOLTAGE_LIMIT]);
+    uint32_t iindpm = BQ25798_decodeInputCurrent_raw(get_be16(&r[BQ25798_REG_INPUT_CURRENT_LIMIT]));
+
+    emu->ibat_mA = 0;
+    if (!(ctrl0 & BQ25798_CHG_CTRL0_CHG_EN) || (ctrl0 & BQ25798_CHG_CTRL0_HIZ_EN) || emu->tshut ||
+        emu->vbus_mV <= vindpm || vbat == 0) return BQ25798_EMU_CHG_NONE;
+    if (vbat >= vreg) return BQ25798_EMU_CHG_DONE;
+
+    /* Input power limit: IINDPM at VBUS, less the conversion loss */
+    uint32_t i = ichg;
+    uint32_t inputLimit = (uint32_t)(((uint64_t)iindpm * emu->vbus_mV * BQ25798_EMU_EFFICIENCY) / (100u * vbat));
+    if (i > inputLimit) i = inputLimit;
+    uint8_t stat = BQ25798_EMU_CHG_FAST;
+    if (vreg - vbat < BQ25798_EMU_TAPER_mV){
+        i = i * (vreg - vbat) / BQ25798_EMU_TAPER_mV;
+        stat = BQ25798_EMU_CHG_TAPER;
+    }
+    emu->ibat_mA = (int32_t)i;
+    return stat;
+}
+
+void BQ25798_Emu_step(BQ25798_Emu *emu, uint32_t dt_ms){
+    uint8_t *r = emu->regs;
+    uint32_t vbat = packVoltage_mV(emu);
+    uint8_t chgStat = updateCharge(emu, vbat);
+    if (emu->ibat_mA > 0) emu->stats.charge_ms += dt_ms;
+
+    uint32_t ibus = emu->vbus_mV
+        ? (uint32_t)(((uint64_t)emu->ibat_mA * vbat * 100u) / ((uint64_t)BQ25798_EMU_EFFICIENCY * emu->vbus_mV)) : 0;
+    put_be16(&r[BQ25798_REG_IBUS_ADC], (uint16_t)(ibus > 0xFFFF ? 0xFFFF : ibus));
+    put_be16(&r[BQ25798_REG_IBAT_ADC], (uint16_t)emu->ibat_mA);
+    put_be16(&r[BQ25798_REG_VBUS_ADC], emu->vbus_mV);
+    put_be16(&r[BQ25798_REG_VBAT_ADC], (uint16_t)(vbat > 0xFFFF ? 0xFFFF : vbat));
+
+    uint8_t vbusPresent = emu->vbus_mV != 0;
+    r[BQ25798_REG_CHARGER_STATUS_0] = (uint8_t)(vbusPresent ? (1u << 3) | (1u << 0) : 0u);   /* pg, vbus_present */
+    r[BQ25798_REG_CHARGER_STATUS_1] = (uint8_t)(chgStat << 5);
+    r[BQ25798_REG_CHARGER_STATUS_2] = (uint8_t)(vbat ? 1u : 0u);                              /* vbat_present */
+    r[BQ25798_REG_CHARGER_STATUS_3] = (uint8_t)((r[BQ25798_REG_ADC_CTRL] & 0x80u) ? 1u << 5 : 0u);   /* adc_done */
+    r[BQ25798_REG_FAULT_STATUS_1] = (uint8_t)(emu->tshut ? 1u << 2 : 0u);                    /* tshut */
+}
+
+/* ---------- bus callbacks ---------- */
+static HAL_StatusTypeDef emu_read(void *ctx, uint8_t reg, uint8_t *data, uint16_t len){
+    BQ25798_Emu *emu = (BQ25798_Emu *)ctx;
+    if (reg <= BQ25798_REG_PART_INFO && reg + len > BQ25798_REG_PART_INFO) emu->stats.idReads++;
+    if (reg <= BQ25798_REG_VBAT_ADC && reg + len > BQ25798_REG_VBAT_ADC) emu->stats.adcReads++;
+    for (uint16_t i = 0; i < len; i++) data[i] = emu->regs[(uint8_t)(reg + i)];
+    return HAL_OK;
+}
+
+static HAL_StatusTypeDef emu_write(void *ctx, uint8_t reg, const uint8_t *data, uint16_t len){
+    BQ25798_Emu *emu = (BQ25798_Emu *)ctx;
+    for (uint16_t i = 0; i < len; i++){
+        uint8_t r = (uint8_t)(reg + i);
+        if (isReadOnly(r)){
+            emu->stats.readOnlyWrites++;
+            continue;
+        }
+        if (r == BQ25798_REG_CHARGER_CTRL_0 && ((emu->regs[r] ^ data[i]) & BQ25798_CHG_CTRL0_CHG_EN))
+            emu->stats.chgEnableChanges++;
+        emu->regs[r] = data[i];
+    }
+    return HAL_OK;
+}
+
+static void emu_hostStep(void *ctx, uint32_t now_ms, uint32_t dt_ms){
+    (void)now_ms;
+    BQ25798_Emu_step((BQ25798_Emu *)ctx, dt_ms);
+}
+
+void BQ25798_Emu_init(BQ25798_Emu *emu, PackModel *pack){
+    static const BQ25798_ChargeLimits por = BQ25798_DEFAULT_LIMITS;
+    memset(emu, 0, sizeof(*emu));
+    emu->pack = pack;
+    emu->regs[BQ25798_REG_PART_INFO] = BQ25798_EMU_PART_INFO;
+    emu->regs[BQ25798_REG_CHARGER_CTRL_0] = BQ25798_CHG_CTRL0_CHG_EN;
+    put_be16(&emu->regs[BQ25798_REG_CHARGE_VOLTAGE_LIMIT], BQ25798_encodeChargeVoltage_mV(por.chargeVoltage_mV));
+    put_be16(&emu->regs[BQ25798_REG_CHARGE_CURRENT_LIMIT], BQ25798_encodeChargeCurrent_mA(por.chargeCurrent_mA));
+    emu->regs[BQ25798_REG_INPUT_VOLTAGE_LIMIT] = BQ25798_encodeInputVoltageLimit_mV(por.inputVoltage_mV);
+    put_be16(&emu->regs[BQ25798_REG_INPUT_CURRENT_LIMIT], BQ25798_encodeInputCurrent_mA(por.inputCurrent_mA));
+    BQ25798_Emu_step(emu, 0);
+}
+
+int BQ25798_Emu_attach(BQ25798_Emu *emu){
+    HostI2C_Device d = {
+        .devAddress = BQ25798_I2C_ADDRESS,
+        .ctx   = emu,
+        .read  = emu_read,
+        .write = emu_write,
+        .step  = emu_hostStep,
+    };
+    return HostHal_attachI2C(&d);
+}
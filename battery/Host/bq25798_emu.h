@@ -0,0 +1,77 @@
+/*
+ * bq25798_emu.h
+ *
+ *  Register-level BQ25798 model for host builds. Attaches to host_hal.c at
+ *  BQ25798_I2C_ADDRESS and serves the register map of bq25798.h /
+ *  bq25798_regmap.h, so the unmodified driver and main.c's charger paths
+ *  run against it.
+ *
+ *  Modelled behaviour:
+ *   - PART_INFO answers BQ25798_EMU_PART_INFO (passes BQ25798_partInfoValid).
+ *   - Control registers are a plain register file; VREG, ICHG, VINDPM and
+ *     IINDPM are decoded with the driver's scaling helpers.
+ *   - Charging (CHARGER_CTRL_0 CHG_EN set, HIZ clear, VBUS above VINDPM, no
+ *     thermal shutdown) drives min(ICHG, input power / VBAT) into the pack,
+ *     tapering linearly over the last BQ25798_EMU_TAPER_mV below VREG.
+ *     The current is only computed here: the harness routes it through the
+ *     pack (BQ76907_Emu_setPackCurrent) together with the system load.
+ *   - Status / fault registers and the IBUS / IBAT / VBUS / VBAT ADC results
+ *     follow the model every step (1 mV / 1 mA per LSB, as in the regmap).
+ *
+ *  Bit positions follow the driver's placeholders (TODO_VERIFY there).
+ */
+
+#ifndef BQ25798_EMU_H_
+#define BQ25798_EMU_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "bq25798.h"
+#include "pack_model.h"
+
+#define BQ25798_EMU_PART_INFO     0x19u   /* part 011b (bits 5:3), rev 001b */
+#define BQ25798_EMU_EFFICIENCY    90u     /* % input power reaching the battery */
+#define BQ25798_EMU_TAPER_mV      200u    /* CV taper below VREG (pack voltage) */
+
+/* CHARGER_STATUS_1 chg_stat codes used by the model */
+#define BQ25798_EMU_CHG_NONE      0u
+#define BQ25798_EMU_CHG_FAST      3u
+#define BQ25798_EMU_CHG_TAPER     4u
+#define BQ25798_EMU_CHG_DONE      7u
+
+typedef struct {
+    uint32_t idReads;              /* reads covering PART_INFO */
+    uint32_t adcReads;             /* reads covering VBAT_ADC */
+    uint32_t readOnlyWrites;       /* writes to status / ADC registers */
+    uint32_t chgEnableChanges;     /* CHG_EN transitions written by the host */
+    uint32_t charge_ms;            /* time spent delivering current */
+} BQ25798_EmuStats;
+
+typedef struct {
+    uint8_t    regs[256];
+    PackModel *pack;
+    uint16_t   vbus_mV;          /* input source, 0 = absent (set by the harness) */
+    uint8_t    tshut;            /* thermal shutdown (set by the harness) */
+    int32_t    ibat_mA;          /* charge current into the pack */
+    BQ25798_EmuStats stats;
+} BQ25798_Emu;
+
+/* POR register file (CHG_EN set), bind the pack whose voltage is VBAT */
+void BQ25798_Emu_init(BQ25798_Emu *emu, PackModel *pack);
+/* Attach to the host HAL bus at BQ25798_I2C_ADDRESS. Returns 0 on success. */
+int  BQ25798_Emu_attach(BQ25798_Emu *emu);
+
+/* Recompute charge current and status (also called by HostHal_advanceMs) */
+void BQ25798_Emu_step(BQ25798_Emu *emu, uint32_t dt_ms);
+
+static inline uint8_t BQ25798_Emu_chargeEnabled(const BQ25798_Emu *emu){
+    return (emu->regs[BQ25798_REG_CHARGER_CTRL_0] & BQ25798_CHG_CTRL0_CHG_EN) != 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BQ25798_EMU_H_ */
@@ -0,0 +1,212 @@
+/*
+ * bq76907_emu.c
+ *
+ *  Register-level BQ76907 model. See bq76907_emu.h for the modelled subset.
+ */
+#include "bq76907_emu.h"
+#include "host_hal.h"
+#include <string.h>
+
+#define CFG_FIRST  BQ76907_REG_POWER_CONFIG
+#define CFG_LAST   BQ76907_REG_VOLTAGE_TIME
+
+/* Internal overtemperature is not part of ENABLED_PROTECTIONS_A; track it in bit 0 */
+#define EMU_FAULT_OT      (1u<<0)
+#define EMU_FAULT_CHG     (BQ76907_PROT_A_COV | BQ76907_PROT_A_OCC | EMU_FAULT_OT)
+#define EMU_FAULT_DSG     (BQ76907_PROT_A_CUV | BQ76907_PROT_A_OCD1 | BQ76907_PROT_A_OCD2 | BQ76907_PROT_A_SCD | EMU_FAULT_OT)
+
+static uint8_t activeCells(const BQ76907_Emu *emu){
+    uint8_t n = emu->regs[BQ76907_REG_VCELL_MODE];
+    if (n == 0 || n > emu->pack->cellCount) n = emu->pack->cellCount;
+    if (n > 4) n = 4; /* driver exposes VCELL1..4 only */
+    return n;
+}
+
+static inline void put_be16(uint8_t *p, uint16_t v){ p[0] = (uint8_t)(v >> 8); p[1] = (uint8_t)v; }
+
+static int isReadOnly(uint8_t reg){
+    return reg == BQ76907_REG_SYS_STAT || reg == BQ76907_REG_DEVICE_ID ||
+           (reg >= BQ76907_REG_VCELL1_H && reg < BQ76907_REG_VCELL1_H + 8) ||
+           (reg >= BQ76907_REG_PACK_V_H && reg <= BQ76907_REG_TS1_L) ||
+           reg == BQ76907_REG_SAFETY_STATUS_A || reg == BQ76907_REG_SAFETY_STATUS_B ||
+           reg == BQ76907_REG_PASSQ;
+}
+
+uint16_t BQ76907_Emu_covThreshold_mV(const BQ76907_Emu *emu){ return (uint16_t)(emu->regs[BQ76907_REG_COV_THRESHOLD] * BQ76907_CELL_THRESH_LSB_mV); }
+uint16_t BQ76907_Emu_cuvThreshold_mV(const BQ76907_Emu *emu){ return (uint16_t)(emu->regs[BQ76907_REG_CUV_THRESHOLD] * BQ76907_CELL_THRESH_LSB_mV); }
+
+/* ---------- measurement + protection ---------- */
+static void refreshMeasurements(BQ76907_Emu *emu){
+    uint8_t n = activeCells(emu);
+    uint32_t pack = 0;
+    for (uint8_t i = 0; i < n; i++){
+        uint16_t v = PackModel_cellVoltage_mV(emu->pack, i);
+        put_be16(&emu->regs[BQ76907_REG_VCELL1_H + 2*i], v);
+        pack += v;
+    }
+    put_be16(&emu->regs[BQ76907_REG_PACK_V_H], (uint16_t)(pack > 0xFFFF ? 0xFFFF : pack));
+    put_be16(&emu->regs[BQ76907_REG_TS1_H], (uint16_t)PackModel_temperature_x10(emu->pack));
+}
+
+static void evaluateProtections(BQ76907_Emu *emu){
+    const uint8_t *r = emu->regs;
+    uint8_t enabled = r[BQ76907_REG_ENABLED_PROTECTIONS_A];
+    uint8_t n = activeCells(emu);
+    uint16_t vmax = 0, vmin = 0xFFFF;
+    for (uint8_t i = 0; i < n; i++){
+        uint16_t v = PackModel_cellVoltage_mV(emu->pack, i);
+        if (v > vmax) vmax = v;
+        if (v < vmin) vmin = v;
+    }
+    uint16_t cov = BQ76907_Emu_covThreshold_mV(emu);
+    uint16_t cuv = BQ76907_Emu_cuvThreshold_mV(emu);
+    uint32_t occ  = r[BQ76907_REG_OCD_CHG_THRESHOLD]    * BQ76907_CURR_THRESH_LSB_mA;
+    uint32_t ocd1 = r[BQ76907_REG_OCD_DISCH1_THRESHOLD] * BQ76907_CURR_THRESH_LSB_mA;
+    uint32_t ocd2 = r[BQ76907_REG_OCD_DISCH2_THRESHOLD] * BQ76907_CURR_THRESH_LSB_mA;
+    int32_t  i_mA = emu->packCurrent_mA;
+    uint8_t before = emu->faults;
+
+    /* Trip */
+    if ((enabled & BQ76907_PROT_A_COV)  && cov  && vmax > cov)                 emu->faults |= BQ76907_PROT_A_COV;
+    if ((enabled & BQ76907_PROT_A_CUV)  && cuv  && vmin < cuv)                 emu->faults |= BQ76907_PROT_A_CUV;
+    if ((enabled & BQ76907_PROT_A_OCC)  && occ  && i_mA > (int32_t)occ)        emu->faults |= BQ76907_PROT_A_OCC;
+    if ((enabled & BQ76907_PROT_A_OCD1) && ocd1 && -i_mA > (int32_t)ocd1)      emu->faults |= BQ76907_PROT_A_OCD1;
+    if ((enabled & BQ76907_PROT_A_OCD2) && ocd2 && -i_mA > (int32_t)ocd2)      emu->faults |= BQ76907_PROT_A_OCD2;
+    int16_t t_x10 = PackModel_temperature_x10(emu->pack);
+    uint8_t ot = r[BQ76907_REG_INT_OT_THRESHOLD];
+    if (ot && t_x10 > (int16_t)(ot * 10)) emu->faults |= EMU_FAULT_OT;
+
+    /* Auto-recovery once the condition has cleared (with hysteresis for voltages) */
+    if ((emu->faults & BQ76907_PROT_A_COV) && vmax + BQ76907_EMU_RECOVERY_HYST_mV < cov) emu->faults &= ~BQ76907_PROT_A_COV;
+    if ((emu->faults & BQ76907_PROT_A_CUV) && vmin > cuv + BQ76907_EMU_RECOVERY_HYST_mV) emu->faults &= ~BQ76907_PROT_A_CUV;
+    if ((emu->faults & BQ76907_PROT_A_OCC) && i_mA <= 0) emu->faults &= ~BQ76907_PROT_A_OCC;
+    if ((emu->faults & EMU_FAULT_OT) && t_x10 < (int16_t)(ot * 10 - 50)) emu->faults &= ~EMU_FAULT_OT;
+    /* OCD1/OCD2 stay latched until PROT_RECOVERY is written */
+
+    if ((emu->faults & ~before) != 0) emu->stats.protectionTrips++;
+}
+
+static uint8_t composeSysStat(const BQ76907_Emu *emu){
+    uint8_t f = emu->faults, s = 0;
+    if (!emu->cfgUpdate)                                   s |= BQ76907_SYS_STAT_CC_READY | BQ76907_SYS_STAT_DEVICE_XREADY;
+    if (f & BQ76907_PROT_A_COV)                            s |= BQ76907_SYS_STAT_OV_FLAG;
+    if (f & BQ76907_PROT_A_CUV)                            s |= BQ76907_SYS_STAT_UV_FLAG;
+    if (f & BQ76907_PROT_A_SCD)                            s |= BQ76907_SYS_STAT_SCD_FLAG;
+    if (f & (BQ76907_PROT_A_OCD1 | BQ76907_PROT_A_OCD2))   s |= BQ76907_SYS_STAT_OCD_FLAG;
+    if (f & EMU_FAULT_OT)                                  s |= BQ76907_SYS_STAT_OVERTEMP_FLAG;
+    return s;
+}
+
+static void updateStatusRegisters(BQ76907_Emu *emu){
+    uint8_t sys = composeSysStat(emu);
+    uint8_t rising = (uint8_t)(sys & ~emu->lastSysStat);
+    if (sys & BQ76907_SYS_STAT_CC_READY) rising |= BQ76907_SYS_STAT_CC_READY; /* new scan every step */
+    emu->regs[BQ76907_REG_ALARM_STATUS] |= rising & emu->regs[BQ76907_REG_ALARM_ENABLE];
+    emu->regs[BQ76907_REG_SYS_STAT] = sys;
+    emu->regs[BQ76907_REG_SAFETY_STATUS_A] = (uint8_t)(emu->faults & ~EMU_FAULT_OT);
+    emu->regs[BQ76907_REG_SAFETY_STATUS_B] = (emu->faults & EMU_FAULT_OT) ? 0x01 : 0x00;
+    emu->lastSysStat = sys;
+}
+
+void BQ76907_Emu_step(BQ76907_Emu *emu, uint32_t dt_ms){
+    uint8_t n = emu->pack->cellCount;
+    int32_t current = emu->packCurrent_mA;
+    memset(emu->bleed_mA, 0, sizeof(emu->bleed_mA));
+
+    if (emu->cfgUpdate){
+        current = 0; /* FETs off, no balancing while configuring */
+    } else {
+        if (current > 0 && (emu->faults & EMU_FAULT_CHG)) current = 0;
+        if (current < 0 && (emu->faults & EMU_FAULT_DSG)) current = 0;
+        uint8_t mask = emu->regs[BQ76907_REG_CB_ACTIVE_CELLS];
+        for (uint8_t i = 0; i < n; i++){
+            if (mask & (1u << i)){
+                emu->bleed_mA[i] = (uint16_t)(PackModel_cellVoltage_mV(emu->pack, i) / emu->balanceR_ohm);
+                emu->stats.balance_ms[i] += dt_ms;
+            }
+        }
+    }
+    PackModel_step(emu->pack, current, emu->bleed_mA, dt_ms);
+
+    if (!emu->cfgUpdate){
+        refreshMeasurements(emu);
+        evaluateProtections(emu);
+    }
+    updateStatusRegisters(emu);
+}
+
+/* ---------- bus callbacks ---------- */
+static HAL_StatusTypeDef emu_read(void *ctx, uint8_t reg, uint8_t *data, uint16_t len){
+    BQ76907_Emu *emu = (BQ76907_Emu *)ctx;
+    for (uint16_t i = 0; i < len; i++) data[i] = emu->regs[(uint8_t)(reg + i)];
+    return HAL_OK;
+}
+
+static void writeByte(BQ76907_Emu *emu, uint8_t reg, uint8_t v){
+    switch (reg){
+    case BQ76907_CMD_SET_CFGUPDATE:
+        if (!emu->cfgUpdate) emu->stats.cfgUpdateEntries++;
+        emu->cfgUpdate = 1;
+        emu->regs[BQ76907_REG_CB_ACTIVE_CELLS] = 0;
+        return;
+    case BQ76907_CMD_EXIT_CFGUPDATE:
+        emu->cfgUpdate = 0;
+        return;
+    case BQ76907_REG_ALARM_STATUS: {
+        uint8_t cleared = emu->regs[reg] & v;
+        for (; cleared; cleared &= (uint8_t)(cleared - 1)) emu->stats.alarmClears++;
+        emu->regs[reg] &= (uint8_t)~v;
+        return;
+    }
+    case BQ76907_REG_CB_ACTIVE_CELLS:
+        if (!emu->cfgUpdate) emu->regs[reg] = v & (uint8_t)((1u << activeCells(emu)) - 1u);
+        return;
+    case BQ76907_REG_PROT_RECOVERY:
+        emu->faults &= (uint8_t)~(v & (BQ76907_PROT_A_OCD1 | BQ76907_PROT_A_OCD2 | BQ76907_PROT_A_SCD));
+        return;
+    default:
+        break;
+    }
+    if (reg >= CFG_FIRST && reg <= CFG_LAST){
+        if (emu->cfgUpdate) emu->regs[reg] = v;
+        else emu->stats.rejectedConfigWrites++;
+        return;
+    }
+    if (isReadOnly(reg)){
+        emu->stats.readOnlyWrites++;
+        return;
+    }
+    emu->regs[reg] = v;
+}
+
+static HAL_StatusTypeDef emu_write(void *ctx, uint8_t reg, const uint8_t *data, uint16_t len){
+    BQ76907_Emu *emu = (BQ76907_Emu *)ctx;
+    for (uint16_t i = 0; i < len; i++) writeByte(emu, (uint8_t)(reg + i), data[i]);
+    return HAL_OK;
+}
+
+static void emu_hostStep(void *ctx, uint32_t now_ms, uint32_t dt_ms){
+    (void)now_ms;
+    BQ76907_Emu_step((BQ76907_Emu *)ctx, dt_ms);
+}
+
+void BQ76907_Emu_init(BQ76907_Emu *emu, PackModel *pack){
+    memset(emu, 0, sizeof(*emu));
+    emu->pack = pack;
+    emu->balanceR_ohm = BQ76907_EMU_BALANCE_R_OHM;
+    emu->regs[BQ76907_REG_DEVICE_ID]  = BQ76907_EMU_DEVICE_ID;
+    emu->regs[BQ76907_REG_VCELL_MODE] = pack->cellCount;
+    refreshMeasurements(emu);
+    updateStatusRegisters(emu);
+}
+
+int BQ76907_Emu_attach(BQ76907_Emu *emu){
+    HostI2C_Device d = {
+        .devAddress = BQ76907_I2C_ADDRESS,
+        .ctx   = emu,
+        .read  = emu_read,
+        .write = emu_write,
+        .step  = emu_hostStep,
+    };
+    return HostHal_attachI2C(&d);
+}
@@ -0,0 +1,85 @@
+/*
+ * bq76907_emu.h
+ *
+ *  Register-level BQ76907 model for host builds. Attaches to host_hal.c at
+ *  BQ76907_I2C_ADDRESS and serves the same (placeholder) register map the
+ *  driver in bq76907.h uses, so the unmodified driver, balancing and
+ *  protection code can run on a Linux box.
+ *
+ *  Modelled behaviour:
+ *   - Cell / pack / TS1 registers are refreshed from a PackModel every step.
+ *   - Config registers (POWER_CONFIG..VOLTAGE_TIME) only accept writes while
+ *     in CONFIG_UPDATE mode (entered/exited through the SET/EXIT_CFGUPDATE
+ *     command registers). Writes outside that window are dropped and counted.
+ *     While in CONFIG_UPDATE the FETs are off, measurements freeze and
+ *     balancing is cancelled, as on the real part.
+ *   - Protections enabled in ENABLED_PROTECTIONS_A are evaluated against the
+ *     thresholds using the driver's encodings (BQ76907_*_THRESH_LSB).
+ *   - SYS_STAT shows live flags; ALARM_STATUS latches rising SYS_STAT bits
+ *     (same bit positions) gated by ALARM_ENABLE and is write-1-to-clear.
+ *   - CB_ACTIVE_CELLS bleeds V/R from each selected cell through the pack.
+ *
+ *  Scaling follows the driver's placeholders; keep both in step while the
+ *  register map is still TODO_VERIFY.
+ */
+
+#ifndef BQ76907_EMU_H_
+#define BQ76907_EMU_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "bq76907.h"
+#include "pack_model.h"
+
+#define BQ76907_EMU_DEVICE_ID          0x69u   /* value served from DEVICE_ID */
+#define BQ76907_EMU_BALANCE_R_OHM      100u    /* external bleed resistor */
+#define BQ76907_EMU_RECOVERY_HYST_mV   100u    /* COV/CUV release hysteresis */
+
+typedef struct {
+    uint32_t rejectedConfigWrites; /* config writes outside CONFIG_UPDATE */
+    uint32_t readOnlyWrites;       /* writes to measurement/status registers */
+    uint32_t cfgUpdateEntries;
+    uint32_t alarmClears;          /* ALARM_STATUS bits cleared by the host */
+    uint32_t protectionTrips;
+    uint32_t balance_ms[PACK_MODEL_MAX_CELLS]; /* accumulated bleed time per cell */
+} BQ76907_EmuStats;
+
+typedef struct {
+    uint8_t    regs[256];
+    PackModel *pack;
+    uint8_t    cfgUpdate;        /* 1 while in CONFIG_UPDATE mode */
+    uint8_t    faults;           /* latched protections, ENABLED_PROTECTIONS_A layout */
+    uint8_t    lastSysStat;      /* for ALARM_STATUS edge detection */
+    int32_t    packCurrent_mA;   /* external current, positive = charging */
+    uint16_t   balanceR_ohm;
+    uint16_t   bleed_mA[PACK_MODEL_MAX_CELLS];
+    BQ76907_EmuStats stats;
+} BQ76907_Emu;
+
+/* Reset the register file to POR defaults and bind a pack model */
+void BQ76907_Emu_init(BQ76907_Emu *emu, PackModel *pack);
+/* Attach to the host HAL bus at BQ76907_I2C_ADDRESS. Returns 0 on success. */
+int  BQ76907_Emu_attach(BQ76907_Emu *emu);
+
+/* Advance the model (also called automatically by HostHal_advanceMs) */
+void BQ76907_Emu_step(BQ76907_Emu *emu, uint32_t dt_ms);
+
+/* External load / charge current seen by the sense resistor */
+static inline void BQ76907_Emu_setPackCurrent(BQ76907_Emu *emu, int32_t mA){ emu->packCurrent_mA = mA; }
+
+/* ALERT pin: asserted while any ALARM_STATUS bit is set */
+static inline uint8_t BQ76907_Emu_alertAsserted(const BQ76907_Emu *emu){
+    return emu->regs[BQ76907_REG_ALARM_STATUS] != 0;
+}
+
+/* Thresholds as the emulator decodes them from the register file */
+uint16_t BQ76907_Emu_covThreshold_mV(const BQ76907_Emu *emu);
+uint16_t BQ76907_Emu_cuvThreshold_mV(const BQ76907_Emu *emu);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BQ76907_EMU_H_ */
@@ -0,0 +1,163 @@
+/*
+ * bq76907_emu_demo.c
+ *
+ *  Drives the unmodified BQ76907 driver against the register-level emulator:
+ *  config-update gating, host balancing on an imbalanced pack, an undervoltage
+ *  trip, ALARM_STATUS write-to-clear, and queued refreshes, bus faults and
+ *  recovery through the bus scheduler. The firmware modules without a
+ *  device behind them have their own host tests (*_test.c). Exits non-zero
+ *  if any check fails so it can be used as a quick regression run
+ *  (`make run`).
+ */
+#include <stdio.h>
+#include <string.h>
+#include "host_hal.h"
+#include "bq76907_emu.h"
+#include "i2c_bus.h"
+
+#define HOST_CHECK_TAG "[EMU]"
+#include "host_check.h"
+
+static uint16_t spread_mV(const BQ76907 *mon){
+    uint16_t lo = 0xFFFF, hi = 0;
+    for (int i = 0; i < 4; i++){
+        if (mon->cellVoltage_mV[i] < lo) lo = mon->cellVoltage_mV[i];
+        if (mon->cellVoltage_mV[i] > hi) hi = mon->cellVoltage_mV[i];
+    }
+    return (uint16_t)(hi - lo);
+}
+
+/* Failed burst: what each member's callback was handed */
+static uint8_t burstSeen[4];
+static uint8_t burstDone;
+static HAL_StatusTypeDef burstStatus;
+static void burstDoneCb(void *ctx, uint8_t reg, const uint8_t *data, uint8_t len, HAL_StatusTypeDef st){
+    (void)reg;
+    memcpy(ctx, data, len);
+    burstStatus = st;
+    burstDone++;
+}
+
+int main(void){
+    static I2C_HandleTypeDef hi2c1;
+    static BQ76907 mon;
+    PackModel pack; PackModel_SimpleState packState;
+    BQ76907_Emu emu;
+
+    HostHal_reset();
+    PackModel_initSimple(&pack, &packState, 4, 200, 60);   /* small cells so balancing converges quickly */
+    PackModel_setSimpleCellSoc(&pack, 3, 70);               /* cell 4 ~120 mV high */
+    BQ76907_Emu_init(&emu, &pack);
+    BQ76907_Emu_attach(&emu);
+
+    CHECK(BQ76907_init(&mon, &hi2c1) == 0, "init reads DEVICE_ID");
+
+    /* Writes to config registers outside CONFIG_UPDATE are dropped */
+    BQ76907_enableProtectionsA(&mon, BQ76907_PROT_A_CUV);
+    CHECK(emu.regs[BQ76907_REG_ENABLED_PROTECTIONS_A] == 0 && emu.stats.rejectedConfigWrites == 1,
+          "config write outside CONFIG_UPDATE ignored");
+
+    BQ76907_Config cfg = {
+        .cellCount = 4, .uvThreshold_mV = 2500, .ovThreshold_mV = 4200,
+        .protectionsA = BQ76907_PROT_A_CUV,
+        .alarmEnableMask = BQ76907_SYS_STAT_UV_FLAG | BQ76907_SYS_STAT_OV_FLAG,
+    };
+    CHECK(BQ76907_applyConfig(&mon, &cfg) == HAL_OK, "applyConfig");
+    CHECK(emu.regs[BQ76907_REG_ENABLED_PROTECTIONS_A] == BQ76907_PROT_A_CUV, "protections latched in CONFIG_UPDATE");
+    CHECK(BQ76907_Emu_cuvThreshold_mV(&emu) == cfg.uvThreshold_mV && BQ76907_Emu_covThreshold_mV(&emu) == cfg.ovThreshold_mV,
+          "thresholds decode to the requested values");
+    BQ76907_Config wide = cfg;
+    wide.ovThreshold_mV = BQ76907_CELL_THRESH_MAX_mV + BQ76907_CELL_THRESH_LSB_mV;
+    CHECK(!BQ76907_configValid(&wide) && BQ76907_setCOVThreshold(&mon, wide.ovThreshold_mV) == HAL_ERROR &&
+          BQ76907_setOCDischarge1Threshold(&mon, BQ76907_CURR_THRESH_MAX_mA + 1u) == HAL_ERROR &&
+          BQ76907_Emu_covThreshold_mV(&emu) == cfg.ovThreshold_mV, "threshold past the register range refused");
+
+    /* Balancing: run the driver heuristic every 5 s of virtual time */
+    HostHal_advanceMs(10);
+    BQ76907_readCellVoltages(&mon);
+    uint16_t before = spread_mV(&mon);
+    for (uint32_t t = 0; t < 6u * 3600u * 1000u; t += 5000u){
+        BQ76907_evaluateAndBalance(&mon, 25, 10, 3000);
+        HostHal_advanceMs(5000);
+    }
+    BQ76907_readCellVoltages(&mon);
+    uint16_t after = spread_mV(&mon);
+    printf("[EMU] balancing spread %u mV -> %u mV, cell4 bled %lus\n",
+           before, after, (unsigned long)(emu.stats.balance_ms[3] / 1000u));
+    CHECK(after < before && after <= 25, "balancing reduced spread");
+    CHECK(emu.stats.balance_ms[0] == 0 || emu.stats.balance_ms[0] < emu.stats.balance_ms[3],
+          "high cell bled longest");
+
+    /* Undervoltage: discharge until CUV trips, then confirm FET cut-off and W1C */
+    BQ76907_setActiveBalancingMask(&mon, 0);
+    BQ76907_Emu_setPackCurrent(&emu, -2000);
+    uint32_t guard = 0;
+    do {
+        HostHal_advanceMs(1000);
+        BQ76907_readSystemStatus(&mon);
+    } while (!mon.status.uv_fault && ++guard < 3600u);
+    CHECK(mon.status.uv_fault == 1, "CUV trips under discharge");
+    CHECK(BQ_RegDesc_encode(&mon, &BQ76907_regDesc[0]) == (emu.regs[BQ76907_REG_SYS_STAT] & 0xFEu),
+          "SYS_STAT re-encodes from descriptor table");
+    BQ76907_debugDump(&mon);
+    BQ76907_readCellVoltages(&mon);
+    uint16_t atTrip = mon.cellVoltage_mV[0];
+    HostHal_advanceMs(60000);
+    BQ76907_readCellVoltages(&mon);
+    CHECK(mon.cellVoltage_mV[0] == atTrip, "discharge blocked after trip");
+
+    uint8_t alarm = 0;
+    BQ76907_readAlarmStatus(&mon, &alarm);
+    CHECK(alarm & BQ76907_SYS_STAT_UV_FLAG, "ALARM_STATUS latched UV");
+    CHECK(BQ76907_Emu_alertAsserted(&emu), "ALERT asserted");
+    BQ76907_clearAlarmStatus(&mon, BQ76907_SYS_STAT_UV_FLAG);
+    BQ76907_readAlarmStatus(&mon, &alarm);
+    CHECK((alarm & BQ76907_SYS_STAT_UV_FLAG) == 0, "ALARM_STATUS write-1-to-clear");
+
+    /* Queued refresh: SYS_STAT first, PACK_V + TS1 merged into one burst */
+    I2CBus_Init(&hi2c1);
+    mon.packVoltage_mV = 0;
+    CHECK(BQ76907_queueStatusRefresh(&mon, HostHal_nowMs() + 750) == HAL_OK, "queue status refresh");
+    CHECK(I2CBus_Service(1) == 1 && I2CBus_GetStats()->prio[I2C_BUS_PRIO_FAULT].count == 1,
+          "fault read serviced first");
+    while (I2CBus_Service(1)) {}
+    const I2CBus_Stats *bs = I2CBus_GetStats();
+    CHECK(bs->requests == 4 && bs->transactions == 3 && bs->merged == 1, "adjacent reads merged (4 req, 3 txn)");
+    CHECK(mon.packVoltage_mV != 0 && I2CBus_Pending(I2C_BUS_ANY_DEVICE) == 0, "refresh decoded into device");
+
+    /* Bus faults: backoff, stretched polling, recovery, then healing */
+    HostHal_injectI2CErrors(BQ76907_I2C_ADDRESS, 3, HAL_TIMEOUT);
+    uint8_t v = 0;
+    BQ76907_ReadRegister(&mon, BQ76907_REG_SYS_STAT, &v);
+    BQ76907_ReadRegister(&mon, BQ76907_REG_SYS_STAT, &v);
+    CHECK(BQ76907_ReadRegister(&mon, BQ76907_REG_SYS_STAT, &v) == HAL_BUSY &&
+          !I2CBus_DeviceAvailable(BQ76907_I2C_ADDRESS), "device backs off after repeated failure");
+    CHECK(I2CBus_PollInterval(BQ76907_I2C_ADDRESS, 750) > 750, "poll interval stretched for flaky device");
+    HostHal_advanceMs(I2C_BUS_BACKOFF_MAX_MS);
+    BQ76907_ReadRegister(&mon, BQ76907_REG_SYS_STAT, &v);
+    CHECK(bs->recoveries == 1, "bus recovery after consecutive failures");
+    HostHal_advanceMs(I2C_BUS_BACKOFF_MAX_MS);
+    CHECK(BQ76907_ReadRegister(&mon, BQ76907_REG_SYS_STAT, &v) == HAL_OK &&
+          I2CBus_GetHealth(BQ76907_I2C_ADDRESS)->consecutiveFails == 0, "device usable again after backoff");
+
+    /* A failed burst completes every member with an error and no data */
+    memset(burstSeen, 0xAA, sizeof burstSeen);
+    burstDone = 0;
+    for (uint8_t r = 0; r < 2; r++){
+        I2CBus_Request req = { .devAddress = BQ76907_I2C_ADDRESS, .reg = (uint8_t)(BQ76907_REG_SYS_STAT + 2u * r),
+                               .len = 2, .prio = I2C_BUS_PRIO_MEASURE, .done = burstDoneCb, .ctx = &burstSeen[2u * r] };
+        I2CBus_Submit(&req);
+    }
+    HostHal_injectI2CErrors(BQ76907_I2C_ADDRESS, 1, HAL_ERROR);
+    I2CBus_Service(1);
+    BQ76907_ReadRegister(&mon, BQ76907_REG_SYS_STAT, &v);   /* heal */
+    CHECK(burstDone == 2 && burstStatus != HAL_OK && burstSeen[0] == 0 && burstSeen[1] == 0 &&
+          burstSeen[2] == 0 && burstSeen[3] == 0, "failed burst hands its members no data");
+    I2CBus_LogStats();
+
+    HostI2C_Stats s = HostHal_getI2CStats(BQ76907_I2C_ADDRESS);
+    printf("[EMU] bus: %lu reads %lu writes %lu bytes %lu errors, virtual time %lus\n",
+           (unsigned long)s.reads, (unsigned long)s.writes, (unsigned long)s.bytes,
+           (unsigned long)s.errors, (unsigned long)(HostHal_nowMs() / 1000u));
+    return HostCheck_result();
+}
@@ -0,0 +1,299 @@
+/*
+ * bus_bench.c
+ *
+ *  Control-cycle bus cost of the firmware: main.c runs against the
+ *  emulators (charging, one cell 10 % high so balancing has work) and every
+ *  I2C transaction is charged to a path:
+ *
+ *    charger    chgPoll / chgUpd tasks, and the queued reads to the BQ25798
+ *    monitor    monPoll / monUpd tasks, and the queued reads to the BQ76907
+ *    balancing  the balance task
+ *
+ *  (transactions inside a task go to that task's path, the ones the bus
+ *  scheduler runs between tasks to the device's). After a warm-up the run
+ *  lasts N monitor cycles; per path and per cycle of that path (update or
+ *  evaluation runs) it reports transactions, payload bytes, bus time at
+ *  100 and 400 kHz (7-bit address, register, repeated start for reads, no
+ *  clock stretching) and host CPU time in the path's tasks minus the time
+ *  spent in the emulators. The firmware's scheduler is built with
+ *  SCHED_NOW_US() = HostHal_cycles() for that, so CPU figures are host
+ *  cycles: compare them between commits on one machine, not with the M0+.
+ *
+ *    bus_bench [-n cycles] [-b budget.csv] [-o results.csv] [-l log]
+ *
+ *  Results are written as CSV (build/bus_bench.csv); every column of the
+ *  budget file (bus_budget.csv, '-' = unchecked) is a per-cycle ceiling.
+ *  Exits non-zero if a path exceeds its budget (`make run`).
+ */
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "host_hal.h"
+#include "main.h"
+#include "bq76907_emu.h"
+#include "bq25798_emu.h"
+#include "scheduler.h"
+#include "watchdog.h"
+
+#define BENCH_WARMUP_MS     10000u   /* boot and first balancing evaluation excluded */
+#define BENCH_CYCLES        400u     /* monitor cycles, -n */
+#define BENCH_LOAD_mA       2000
+#define BENCH_VBUS_mV       20000
+#define BENCH_IMBALANCE     10       /* last cell SOC above the others, % */
+
+int Firmware_main(void);
+
+typedef enum { PATH_CHARGER, PATH_MONITOR, PATH_BALANCE, PATH_COUNT } BenchPath;
+
+static const char *const pathName[PATH_COUNT] = { "charger", "monitor", "balancing" };
+/* Task whose runs count the path's cycles */
+static const char *const cycleTask[PATH_COUNT] = { "chgUpd", "monUpd", "balance" };
+static const uint32_t busHz[2] = { 100000u, 400000u };
+
+typedef struct {
+    uint64_t txn, bytes, bits;
+    uint64_t emuCycles;           /* spent in the emulators during the path's tasks */
+    uint64_t taskCycles;
+    uint32_t cycles;
+} PathCost;
+
+typedef struct {
+    HostI2C_Device inner;
+    BenchPath      path;          /* when no task is running */
+} BenchDevice;
+
+static PathCost cost[PATH_COUNT];
+static BenchDevice devices[2];
+static uint8_t taskPath[SCHED_MAX_TASKS];
+static uint32_t runsAt[SCHED_MAX_TASKS];
+static uint64_t execAt[SCHED_MAX_TASKS];
+static PackModel pack;
+static PackModel_SimpleState packState;
+static BQ76907_Emu mon;
+static BQ25798_Emu chg;
+static jmp_buf benchEnd;
+static uint32_t cyclesWanted, wdgExpiredAt;
+static uint8_t measuring, alert, monUpdId = SCHED_NO_TASK;
+
+static uint8_t pathOfTask(const char *name){
+    if (!strncmp(name, "chg", 3)) return PATH_CHARGER;
+    if (!strncmp(name, "mon", 3)) return PATH_MONITOR;
+    if (!strcmp(name, "balance")) return PATH_BALANCE;
+    return PATH_COUNT;
+}
+
+static BenchPath pathNow(const BenchDevice *d){
+    uint8_t t = Scheduler_Running();
+    if (t != SCHED_NO_TASK && t < SCHED_MAX_TASKS && taskPath[t] < PATH_COUNT) return (BenchPath)taskPath[t];
+    return d->path;
+}
+
+/* START, address + W, register, [repeated START, address + R], data, STOP */
+static void charge(BenchDevice *d, uint16_t len, uint8_t write, uint64_t emu){
+    if (!measuring) return;
+    PathCost *c = &cost[pathNow(d)];
+    c->txn++;
+    c->bytes += len;
+    c->bits += write ? 2u + 9u * (2u + len) : 3u + 9u * (3u + len);
+    if (Scheduler_Running() != SCHED_NO_TASK) c->emuCycles += emu;
+}
+
+static HAL_StatusTypeDef benchRead(void *ctx, uint8_t reg, uint8_t *data, uint16_t len){
+    BenchDevice *d = ctx;
+    uint64_t t0 = HostHal_cycles();
+    HAL_StatusTypeDef st = d->inner.read(d->inner.ctx, reg, data, len);
+    charge(d, len, 0, HostHal_cycles() - t0);
+    return st;
+}
+
+static HAL_StatusTypeDef benchWrite(void *ctx, uint8_t reg, const uint8_t *data, uint16_t len){
+    BenchDevice *d = ctx;
+    uint64_t t0 = HostHal_cycles();
+    HAL_StatusTypeDef st = d->inner.write(d->inner.ctx, reg, data, len);
+    charge(d, len, 1, HostHal_cycles() - t0);
+    return st;
+}
+
+static void benchStep(void *ctx, uint32_t now_ms, uint32_t dt_ms){
+    BenchDevice *d = ctx;
+    if (d->inner.step) d->inner.step(d->inner.ctx, now_ms, dt_ms);
+}
+
+static void interpose(BenchDevice *d, uint16_t devAddress, BenchPath path){
+    HostI2C_Device dev = {
+        .devAddress = devAddress,
+        .ctx   = d,
+        .read  = benchRead,
+        .write = benchWrite,
+        .step  = benchStep,
+    };
+    d->path = path;
+    HostHal_interposeI2C(&dev, &d->inner);
+}
+
+static void snapshotTasks(void){
+    for (uint8_t i = 0; i < SCHED_MAX_TASKS && Scheduler_GetStats(i); i++){
+        const char *name = Scheduler_TaskName(i);
+        taskPath[i] = pathOfTask(name);
+        if (!strcmp(name, "monUpd")) monUpdId = i;
+        runsAt[i] = Scheduler_GetStats(i)->runs;
+        execAt[i] = Scheduler_GetStats(i)->totalExec_us;
+    }
+}
+
+/* SysTick: watchdog, pack current, ALERT, warm-up and end of the run */
+static void benchTick(void){
+    uint32_t now = HostHal_nowMs();
+    Watchdog_TickISR();
+    if (HostHal_watchdogExpired()){
+        wdgExpiredAt = now;
+        longjmp(benchEnd, 1);
+    }
+    BQ76907_Emu_setPackCurrent(&mon, chg.ibat_mA - BENCH_LOAD_mA);
+    uint8_t a = BQ76907_Emu_alertAsserted(&mon);
+    if (a && !alert) HostHal_extiFalling(BMS_INTERRUPT_Pin);
+    alert = a;
+    if (now == BENCH_WARMUP_MS){
+        snapshotTasks();
+        measuring = 1;
+    }
+    if (measuring && monUpdId != SCHED_NO_TASK &&
+        Scheduler_GetStats(monUpdId)->runs - runsAt[monUpdId] >= cyclesWanted)
+        longjmp(benchEnd, 1);
+}
+
+static double perCycle(uint64_t v, uint32_t cycles){
+    return cycles ? (double)v / cycles : 0.0;
+}
+
+static double busUs(const PathCost *c, uint8_t speed){
+    return perCycle(c->bits, c->cycles) * 1e6 / busHz[speed];
+}
+
+/* Budget: path,txn,bytes,bus_us_100k,bus_us_400k,cpu ('-' = unchecked) */
+static unsigned checkBudget(const char *path, const double measured[PATH_COUNT][5]){
+    static const char *const column[5] = { "txn", "bytes", "bus_us_100k", "bus_us_400k", "cpu" };
+    FILE *f = fopen(path, "r");
+    if (!f){
+        perror(path);
+        return 1;
+    }
+    char line[256];
+    unsigned failed = 0, checked = 0;
+    while (fgets(line, sizeof line, f)){
+        if (line[0] == '#' || !strncmp(line, "path,", 5)) continue;
+        char *field = strtok(line, ",\n");
+        if (!field) continue;
+        int p = -1;
+        for (int i = 0; i < PATH_COUNT; i++) if (!strcmp(field, pathName[i])) p = i;
+        if (p < 0){
+            printf("[BUS] budget: unknown path '%s'\n", field);
+            failed++;
+            continue;
+        }
+        for (int col = 0; col < 5 && (field = strtok(NULL, ",\n")); col++){
+            if (!strcmp(field, "-")) continue;
+            double limit = atof(field);
+            int ok = measured[p][col] <= limit;
+            checked++;
+            if (!ok) failed++;
+            if (!ok || col < 2)
+                printf("[BUS] budget %-9s %-11s %10.2f <= %-10s %s\n", pathName[p], column[col],
+                       measured[p][col], field, ok ? "OK" : "FAIL");
+        }
+    }
+    fclose(f);
+    printf("[BUS] %u budget(s) checked, %u exceeded\n", checked, failed);
+    return failed;
+}
+
+int main(int argc, char **argv){
+    const char *budget = "bus_budget.csv", *results = "build/bus_bench.csv", *log = "build/bus_bench.log";
+    int opt;
+    cyclesWanted = BENCH_CYCLES;
+    while ((opt = getopt(argc, argv, "n:b:o:l:")) != -1){
+        switch (opt){
+        case 'n': cyclesWanted = (uint32_t)atol(optarg); break;
+        case 'b': budget = optarg; break;
+        case 'o': results = optarg; break;
+        case 'l': log = optarg; break;
+        default:
+            fprintf(stderr, "usage: %s [-n cycles] [-b budget.csv] [-o results.csv] [-l log]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (cyclesWanted == 0) cyclesWanted = 1;
+
+    fflush(stdout);
+    int console = dup(fileno(stdout));
+    if (console < 0 || !freopen(log, "wb", stdout)){
+        perror(log);
+        return 1;
+    }
+    HostHal_reset();                                    /* bus time is computed, not played */
+    PackModel_initSimple(&pack, &packState, 4, 20000, 50);
+    PackModel_setSimpleCellSoc(&pack, 3, 50 + BENCH_IMBALANCE);
+    BQ25798_Emu_init(&chg, &pack);
+    BQ76907_Emu_init(&mon, &pack);
+    chg.vbus_mV = BENCH_VBUS_mV;
+    BQ25798_Emu_attach(&chg);
+    BQ76907_Emu_attach(&mon);
+    interpose(&devices[0], BQ25798_I2C_ADDRESS, PATH_CHARGER);
+    interpose(&devices[1], BQ76907_I2C_ADDRESS, PATH_MONITOR);
+    HostHal_setTickHook(benchTick);
+    if (setjmp(benchEnd) == 0) Firmware_main();        /* never returns */
+    fflush(stdout);
+    dup2(console, fileno(stdout));
+    close(console);
+
+    uint32_t elapsed = HostHal_nowMs() - BENCH_WARMUP_MS;
+    for (uint8_t i = 0; i < SCHED_MAX_TASKS && Scheduler_GetStats(i); i++){
+        const Scheduler_TaskStats *st = Scheduler_GetStats(i);
+        if (taskPath[i] < PATH_COUNT) cost[taskPath[i]].taskCycles += st->totalExec_us - execAt[i];
+        for (uint8_t p = 0; p < PATH_COUNT; p++){
+            if (!strcmp(Scheduler_TaskName(i), cycleTask[p])) cost[p].cycles = st->runs - runsAt[i];
+        }
+    }
+
+    FILE *out = fopen(results, "w");
+    if (!out){
+        perror(results);
+        return 1;
+    }
+    fprintf(out, "path,cycles,txn,bytes,bus_us_100k,bus_us_400k,cpu,cpu_unit\n");
+    double measured[PATH_COUNT][5];
+    printf("[BUS] %lu ms after warm-up, per cycle of each path:\n", (unsigned long)elapsed);
+    printf("[BUS] %-9s %6s %6s %7s %10s %10s %10s\n", "path", "cycles", "txn", "bytes", "us@100k", "us@400k",
+           HOST_HAL_CYCLE_UNIT);
+    for (uint8_t p = 0; p < PATH_COUNT; p++){
+        const PathCost *c = &cost[p];
+        uint64_t cpu = c->taskCycles > c->emuCycles ? c->taskCycles - c->emuCycles : 0;
+        measured[p][0] = perCycle(c->txn, c->cycles);
+        measured[p][1] = perCycle(c->bytes, c->cycles);
+        measured[p][2] = busUs(c, 0);
+        measured[p][3] = busUs(c, 1);
+        measured[p][4] = perCycle(cpu, c->cycles);
+        printf("[BUS] %-9s %6lu %6.2f %7.2f %10.1f %10.1f %10.0f\n", pathName[p], (unsigned long)c->cycles,
+               measured[p][0], measured[p][1], measured[p][2], measured[p][3], measured[p][4]);
+        fprintf(out, "%s,%lu,%.2f,%.2f,%.1f,%.1f,%.0f,%s\n", pathName[p], (unsigned long)c->cycles,
+                measured[p][0], measured[p][1], measured[p][2], measured[p][3], measured[p][4], HOST_HAL_CYCLE_UNIT);
+    }
+    fclose(out);
+    printf("[BUS] results in %s, firmware log in %s\n", results, log);
+
+    unsigned failed = checkBudget(budget, measured);
+    if (wdgExpiredAt){
+        printf("[BUS] IWDG reset at %lu ms\n", (unsigned long)wdgExpiredAt);
+        failed++;
+    }
+    for (uint8_t p = 0; p < PATH_COUNT; p++){
+        if (!cost[p].cycles){
+            printf("[BUS] no %s cycles measured\n", pathName[p]);
+            failed++;
+        }
+    }
+    printf("[BUS] %u failure(s)\n", failed);
+    return failed ? 1 : 0;
+}
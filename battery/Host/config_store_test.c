@@ -0,0 +1,128 @@
+/*
+ * config_store_test.c
+ *
+ *  Flash configuration store (config_store.h) on the host config pages:
+ *  an empty store runs on defaults, commits alternate between slots A and
+ *  B with the higher sequence number winning, a torn commit falls back to
+ *  the previous slot, an older schema is migrated over the defaults and
+ *  re-committed, an image from a newer schema is not used, and thresholds
+ *  the monitor cannot hold are refused on load and on commit. A commit
+ *  request hands its own copy of the image to the main loop, once.
+ *
+ *    config_store_test
+ *
+ *  Exits non-zero if a check fails (`make run`).
+ */
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "host_hal.h"
+#include "config_store.h"
+
+#define HOST_CHECK_TAG "[CFG]"
+#include "host_check.h"
+
+int main(void){
+    HostHal_reset();
+
+    static ConfigStore_Data cfgDefaults = { .activeProfile = 0 };
+    cfgDefaults.monitor = (BQ76907_Config){
+        .cellCount = 4, .uvThreshold_mV = 2500, .ovThreshold_mV = 4150, .ocDischarge1_mA = 4000,
+        .protectionsA = BQ76907_PROT_A_CUV,
+        .alarmEnableMask = BQ76907_SYS_STAT_UV_FLAG | BQ76907_SYS_STAT_OV_FLAG,
+    };
+    cfgDefaults.profile[0] = (ConfigStore_ChargeProfile){ "std", BQ25798_DEFAULT_LIMITS };
+    cfgDefaults.profile[1] = (ConfigStore_ChargeProfile){ "storage", { 13200, 2000, 3600, 3300 } };
+    cfgDefaults.cal.packOffset_mV = 12;
+    uint8_t *cfgFlash = HostHal_configImage();
+    ConfigStore_Init(&cfgDefaults);
+    const ConfigStore_Data *live = ConfigStore_Get();
+    CHECK(ConfigStore_GetStats()->source == CONFIG_SRC_DEFAULTS && live->monitor.ovThreshold_mV == 4150 &&
+          ConfigStore_ActiveProfile()->limits.chargeVoltage_mV == 14600, "empty store runs on defaults");
+
+    ConfigStore_Data edit = *live;
+    edit.monitor.uvThreshold_mV = 2600;
+    edit.activeProfile = 1;
+    uint32_t c0 = HostHal_nowMs();
+    CHECK(ConfigStore_Commit(&edit) == HAL_OK && ConfigStore_GetStats()->slot == 0 &&
+          HostHal_nowMs() - c0 == HOST_HAL_FLASH_ERASE_MS, "commit programs slot A");
+    ConfigStore_Init(&cfgDefaults);
+    live = ConfigStore_Get();
+    CHECK(ConfigStore_GetStats()->source == CONFIG_SRC_FLASH &&
+          (const uint8_t *)live == cfgFlash + sizeof(ConfigStore_Header) &&
+          live->monitor.uvThreshold_mV == 2600 && !strcmp(ConfigStore_ActiveProfile()->name, "storage"),
+          "reload uses the flash image in place");
+
+    edit.monitor.uvThreshold_mV = 2700;
+    ConfigStore_Commit(&edit);
+    ConfigStore_Init(&cfgDefaults);
+    CHECK(ConfigStore_GetStats()->slot == 1 && ConfigStore_GetStats()->seq == 2 &&
+          ConfigStore_Get()->monitor.uvThreshold_mV == 2700, "second commit goes to slot B, higher seq wins");
+
+    edit.monitor.uvThreshold_mV = 2800;
+    HostHal_failConfigProgramAfter((sizeof(ConfigStore_Data) + 7u) / 8u + 2u);   /* payload and {seq,crc}, no magic */
+    CHECK(ConfigStore_Commit(&edit) == HAL_ERROR && ConfigStore_Get()->monitor.uvThreshold_mV == 2700,
+          "failed commit keeps the current config");
+    HostHal_failConfigProgramAfter(0);
+    ConfigStore_Init(&cfgDefaults);
+    CHECK(ConfigStore_GetStats()->slot == 1 && ConfigStore_GetStats()->invalid == 1 &&
+          ConfigStore_Get()->monitor.uvThreshold_mV == 2700, "torn commit falls back to the previous slot");
+    CHECK(ConfigStore_Commit(&edit) == HAL_OK && ConfigStore_GetStats()->slot == 0 && ConfigStore_GetStats()->seq == 3,
+          "next commit reuses the torn slot");
+
+    /* Schema 0 had no calibration block: the image ends before cal */
+    ConfigStore_Header old = { CONFIG_STORE_MAGIC, 0, (uint16_t)offsetof(ConfigStore_Data, cal), 7, 0 };
+    edit.monitor.uvThreshold_mV = 2550;
+    old.crc = ConfigStore_Crc32(ConfigStore_Crc32(0, (const uint8_t *)&old.schema, 8), (const uint8_t *)&edit, old.size);
+    memset(cfgFlash + CONFIG_STORE_PAGE_SIZE, 0xFF, CONFIG_STORE_PAGE_SIZE);
+    memcpy(cfgFlash + CONFIG_STORE_PAGE_SIZE, &old, sizeof(old));
+    memcpy(cfgFlash + CONFIG_STORE_PAGE_SIZE + sizeof(old), &edit, old.size);
+    ConfigStore_Init(&cfgDefaults);
+    live = ConfigStore_Get();
+    CHECK(ConfigStore_GetStats()->source == CONFIG_SRC_MIGRATED && ConfigStore_GetStats()->commits == 1 &&
+          live->monitor.uvThreshold_mV == 2550 && live->cal.packOffset_mV == 12 && ConfigStore_GetStats()->slot == 0,
+          "older schema migrated over defaults and re-committed");
+    ConfigStore_Init(&cfgDefaults);
+    CHECK(ConfigStore_GetStats()->source == CONFIG_SRC_FLASH && ConfigStore_GetStats()->seq == 8 &&
+          ConfigStore_Get()->monitor.uvThreshold_mV == 2550, "migrated image loads as current schema");
+
+    ConfigStore_Header *hdrA = (ConfigStore_Header *)cfgFlash;
+    ConfigStore_Header *hdrB = (ConfigStore_Header *)(cfgFlash + CONFIG_STORE_PAGE_SIZE);
+    hdrA->schema = CONFIG_STORE_SCHEMA + 1u;
+    hdrA->crc = ConfigStore_Crc32(ConfigStore_Crc32(0, (const uint8_t *)&hdrA->schema, 8),
+                                  cfgFlash + sizeof(ConfigStore_Header), hdrA->size);
+    ConfigStore_Init(&cfgDefaults);
+    CHECK(ConfigStore_GetStats()->source == CONFIG_SRC_MIGRATED && ConfigStore_GetStats()->schema == 0 &&
+          ConfigStore_GetStats()->invalid == 1 && hdrB->seq == 7 && ConfigStore_Get()->monitor.uvThreshold_mV == 2550,
+          "newer schema image not used");
+
+    /* A CRC-clean image whose COV the monitor cannot hold (the 8-bit
+     * register would wrap it) is skipped like a corrupt one */
+    ConfigStore_Data wide = *ConfigStore_Get();
+    wide.monitor.ovThreshold_mV = BQ76907_CELL_THRESH_MAX_mV + BQ76907_CELL_THRESH_LSB_mV;
+    ConfigStore_Header bad = { CONFIG_STORE_MAGIC, CONFIG_STORE_SCHEMA, (uint16_t)sizeof(wide), 9, 0 };
+    bad.crc = ConfigStore_Crc32(ConfigStore_Crc32(0, (const uint8_t *)&bad.schema, 8), (const uint8_t *)&wide, bad.size);
+    memset(cfgFlash, 0xFF, CONFIG_STORE_PAGE_SIZE);
+    memcpy(cfgFlash, &bad, sizeof(bad));
+    memcpy(cfgFlash + sizeof(bad), &wide, sizeof(wide));
+    ConfigStore_Init(&cfgDefaults);
+    CHECK(ConfigStore_GetStats()->invalid == 1 && ConfigStore_GetStats()->schema == 0 &&
+          ConfigStore_Get()->monitor.ovThreshold_mV == 4150, "out of range image falls back to the other slot");
+    uint32_t seqBefore = ConfigStore_GetStats()->seq;
+    CHECK(ConfigStore_Commit(&wide) == HAL_ERROR && ConfigStore_GetStats()->rejected == 1 &&
+          ConfigStore_GetStats()->seq == seqBefore && ConfigStore_Get()->monitor.ovThreshold_mV == 4150,
+          "commit refuses thresholds the monitor cannot hold");
+
+    /* Run-time edit: the main loop takes the request and commits it */
+    ConfigStore_Data next = *ConfigStore_Get();
+    next.monitor.uvThreshold_mV = 2650;
+    ConfigStore_RequestCommit(&next);
+    next.monitor.uvThreshold_mV = 0;   /* the request holds its own copy */
+    const ConfigStore_Data *req = ConfigStore_TakeCommitRequest();
+    CHECK(req && req->monitor.uvThreshold_mV == 2650 && !ConfigStore_TakeCommitRequest() &&
+          ConfigStore_Commit(req) == HAL_OK && ConfigStore_Get()->monitor.uvThreshold_mV == 2650,
+          "commit request copied, taken once, committed");
+    ConfigStore_LogStats();
+
+    return HostCheck_result();
+}
@@ -0,0 +1,116 @@
+/*
+ * faultlog_dump.c
+ *
+ *  Prints the records of a raw dump of the fault log region (faultlog.h),
+ *  oldest first. Read the region off a board with e.g.
+ *
+ *    st-flash read faultlog.bin 0x0807E000 8192
+ *    STM32_Programmer_CLI -c port=SWD -u 0x0807E000 8192 faultlog.bin
+ *
+ *    faultlog_dump <image>          image defaults to stdin
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "faultlog.h"
+
+#define MAX_PAGES 64
+
+/* Same CRC as FaultLog_Crc16 */
+static uint16_t crc16(const uint8_t *data, uint32_t len){
+    uint16_t crc = 0xFFFFu;
+    while (len--){
+        crc ^= (uint16_t)(*data++ << 8);
+        for (int b = 0; b < 8; b++) crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+static const char *sourceName(uint8_t s){
+    switch (s){
+    case BM_SRC_GENERIC: return "generic";
+    case BM_SRC_BQ25798: return "BQ25798";
+    case BM_SRC_BQ76907: return "BQ76907";
+    default:             return "?";
+    }
+}
+
+static const char *codeName(int8_t c){
+    switch (c){
+    case BM_OK:                  return "OK";
+    case BM_ERR_I2C:             return "I2C";
+    case BM_ERR_ID_MISMATCH:     return "ID_MISMATCH";
+    case BM_ERR_TIMEOUT:         return "TIMEOUT";
+    case BM_ERR_RANGE:           return "RANGE";
+    case BM_ERR_STATE:           return "STATE";
+    case BM_ERR_CONFIG:          return "CONFIG";
+    case BM_ERR_COMM_CRC:        return "COMM_CRC";
+    case BM_ERR_PROTECTION_TRIP: return "PROTECTION_TRIP";
+    default:                     return "UNKNOWN";
+    }
+}
+
+static uint8_t erased(const uint8_t *p, uint32_t n){
+    while (n--) if (*p++ != 0xFFu) return 0;
+    return 1;
+}
+
+int main(int argc, char **argv){
+    FILE *f = argc > 1 ? fopen(argv[1], "rb") : stdin;
+    if (!f){
+        fprintf(stderr, "usage: %s [image]\n", argv[0]);
+        return 2;
+    }
+    static uint8_t img[MAX_PAGES * FAULTLOG_PAGE_SIZE];
+    size_t size = fread(img, 1, sizeof(img), f);
+    if (f != stdin) fclose(f);
+    uint32_t pages = (uint32_t)(size / FAULTLOG_PAGE_SIZE);
+    if (pages == 0 || size % FAULTLOG_PAGE_SIZE){
+        fprintf(stderr, "image is %zu bytes, expected a multiple of %u\n", size, (unsigned)FAULTLOG_PAGE_SIZE);
+        return 1;
+    }
+
+    /* Valid pages in header sequence order */
+    uint32_t order[MAX_PAGES], seq[MAX_PAGES], n = 0;
+    for (uint32_t p = 0; p < pages; p++){
+        uint32_t hdr[2];
+        memcpy(hdr, img + p * FAULTLOG_PAGE_SIZE, sizeof(hdr));
+        if (hdr[0] != FAULTLOG_MAGIC) continue;
+        uint32_t i = n++;
+        while (i > 0 && (int32_t)(seq[i - 1] - hdr[1]) > 0){
+            order[i] = order[i - 1];
+            seq[i] = seq[i - 1];
+            i--;
+        }
+        order[i] = p;
+        seq[i] = hdr[1];
+    }
+
+    unsigned long records = 0, corrupt = 0, lost = 0;
+    for (uint32_t k = 0; k < n; k++){
+        const uint8_t *page = img + order[k] * FAULTLOG_PAGE_SIZE;
+        for (uint32_t s = 0; s < FAULTLOG_REC_PER_PAGE; s++){
+            const uint8_t *raw = page + 8u + s * FAULTLOG_REC_SIZE;
+            if (erased(raw, FAULTLOG_REC_SIZE)) continue;
+            FaultLog_Record r;
+            memcpy(&r, raw, sizeof(r));
+            if (crc16(raw, FAULTLOG_REC_SIZE - 2u) != r.crc){
+                printf("<corrupt record: page %u slot %u>\n", (unsigned)order[k], (unsigned)s);
+                corrupt++;
+                continue;
+            }
+            if (r.lost){
+                printf("<%u record(s) lost>\n", (unsigned)r.lost);
+                lost += r.lost;
+            }
+            printf("[boot %3u] %10lu ms  %-7s %-15s detail=%u reg=0x%02X value=0x%04X\n",
+                (unsigned)r.boot, (unsigned long)r.tick, sourceName(r.source), codeName(r.code),
+                (unsigned)r.detail, (unsigned)r.reg, (unsigned)r.value);
+            records++;
+        }
+    }
+    fprintf(stderr, "[FLOG] %lu record(s) in %u page(s), %lu corrupt, %lu lost\n",
+        records, (unsigned)n, corrupt, lost);
+    return 0;
+}
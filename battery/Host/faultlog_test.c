@@ -0,0 +1,91 @@
+/*
+ * faultlog_test.c
+ *
+ *  Flash fault log (faultlog.h) on the host flash model: errors from the
+ *  error ring are queued in RAM and only programmed by FaultLog_Service,
+ *  the log survives a reset, a full queue is counted in the next record,
+ *  pages are recycled round robin and a torn record is skipped. The final
+ *  image is written to build/faultlog.bin for faultlog_dump.
+ *
+ *    faultlog_test
+ *
+ *  Exits non-zero if a check fails (`make run`).
+ */
+#include <stdio.h>
+#include <string.h>
+#include "host_hal.h"
+#include "bm_errors.h"
+#include "bq76907.h"
+#include "faultlog.h"
+
+#define HOST_CHECK_TAG "[FLOG]"
+#include "host_check.h"
+
+/* Fault log image: first valid record with the given tick (NULL if none) */
+static const uint8_t *findFaultRecord(uint32_t tick, FaultLog_Record *out){
+    const uint8_t *img = HostHal_flashImage();
+    for (uint32_t p = 0; p < FAULTLOG_PAGES; p++){
+        for (uint32_t s = 0; s < FAULTLOG_REC_PER_PAGE; s++){
+            const uint8_t *raw = img + p * FAULTLOG_PAGE_SIZE + 8u + s * FAULTLOG_REC_SIZE;
+            memcpy(out, raw, sizeof(*out));
+            if (out->tick == tick && FaultLog_Crc16(raw, FAULTLOG_REC_SIZE - 2u) == out->crc) return raw;
+        }
+    }
+    return NULL;
+}
+
+int main(void){
+    HostHal_reset();
+    FaultLog_Init();
+
+    /* Bus errors as the driver reports them: queued, flash untouched until Service */
+    HostHal_advanceMs(10);
+    for (int i = 0; i < 3; i++) BM_ErrorPush(NULL, BM_SRC_BQ76907, BM_ERR_I2C, HAL_TIMEOUT, BQ76907_REG_SYS_STAT, 0);
+    const FaultLog_Stats *fl = FaultLog_GetStats();
+    uint32_t queued = FaultLog_Pending();
+    CHECK(fl->boot == 1 && queued > 0 && HostHal_flashImage()[0] == 0xFFu, "fault log queued in RAM, flash untouched");
+    while (FaultLog_Service()) HostHal_advanceMs(1);
+    CHECK(fl->written == queued && fl->erases == 1 && FaultLog_Pending() == 0, "queued faults programmed at idle");
+    FaultLog_Init();   /* reset */
+    CHECK(fl->boot == 2 && fl->records == queued && fl->corrupt == 0, "fault log survives reset");
+
+    BM_ErrorEntry fe = { .tick = 0xA11u, .code = BM_ERR_TIMEOUT, .source = BM_SRC_BQ25798, .reg = 0x1B };
+    for (int i = 0; i < FAULTLOG_QUEUE_DEPTH + 4; i++) FaultLog_Enqueue(&fe);
+    while (FaultLog_Service()) HostHal_advanceMs(1);
+    fe.tick = 0xB0Bu;
+    FaultLog_Enqueue(&fe);
+    while (FaultLog_Service()) HostHal_advanceMs(1);
+    FaultLog_Record fr;
+    CHECK(fl->dropped == 4 && findFaultRecord(0xB0Bu, &fr) && fr.lost == 4 && fr.boot == 2,
+          "queue overflow counted in the next record");
+
+    for (uint32_t i = 0; i < FAULTLOG_PAGES * FAULTLOG_REC_PER_PAGE * 5u / 2u; i++){
+        fe.tick = 0x10000u + i;
+        FaultLog_Enqueue(&fe);
+        while (FaultLog_Service()) HostHal_advanceMs(1);
+    }
+    uint32_t eMin = 0xFFFFFFFFu, eMax = 0;
+    for (uint32_t p = 0; p < FAULTLOG_PAGES; p++){
+        uint32_t e = HostHal_flashEraseCount(p);
+        if (e < eMin) eMin = e;
+        if (e > eMax) eMax = e;
+    }
+    CHECK(eMin >= 2 && eMax - eMin <= 1 && fl->errors == 0, "pages recycled round robin (even wear)");
+
+    uint8_t *torn = (uint8_t *)findFaultRecord(0x10000u + FAULTLOG_PAGES * FAULTLOG_REC_PER_PAGE * 5u / 2u - 1u, &fr);
+    if (torn) torn[14] = 0x00;   /* reset during programming */
+    FaultLog_Init();
+    fe.tick = 0xC0DEu;
+    FaultLog_Enqueue(&fe);
+    while (FaultLog_Service()) HostHal_advanceMs(1);
+    CHECK(torn && fl->corrupt == 1 && fl->boot == 3 && fl->written == 1 && fl->errors == 0 &&
+          findFaultRecord(0xC0DEu, &fr), "torn record skipped, log continues after it");
+    FaultLog_LogStats();
+
+    FILE *ff = fopen("build/faultlog.bin", "wb");
+    if (ff){
+        fwrite(HostHal_flashImage(), 1, FAULTLOG_PAGES * FAULTLOG_PAGE_SIZE, ff);
+        fclose(ff);
+    }
+    return HostCheck_result();
+}
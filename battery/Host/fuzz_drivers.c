@@ -0,0 +1,527 @@
+/*
+ * fuzz_drivers.c
+ *
+ *  Fuzz harness for the driver decode paths and the control code on top of
+ *  them. Both I2C addresses are served by scripted devices that take every
+ *  transaction's outcome from the fuzz input, so the BQ25798 / BQ76907
+ *  drivers, the balancing evaluator and the charge-profile code see
+ *  arbitrary register contents and HAL error codes. An input is a sequence
+ *  of operations:
+ *
+ *    op byte (% FUZZ_OP_COUNT), the op's parameters, then for each bus
+ *    transaction it causes a status byte (bit 7 set: HAL status = bits 1:0,
+ *    else HAL_OK) followed, for a successful read, by the register bytes.
+ *    An exhausted input reads as HAL_TIMEOUT (device gone).
+ *
+ *  Invariants checked (FUZZ_CHECK):
+ *    - decoded bit fields fit their width and re-encode to the raw byte
+ *    - PART_INFO decode is lossless and confirmPart agrees with partInfoValid
+ *    - burst reads decode cells as scaleCellVoltage(raw)
+ *    - balancing never selects a cell at or below minCell_mV, never a bit
+ *      above cell 4, and returns the mask it wrote (0xFF only on a failure)
+ *    - the charge profile writes one ICHG set point matching the VBAT band,
+ *      and none if VBAT could not be read
+ *    - every VREG / ICHG / VINDPM / IINDPM value sent to the charger (init
+ *      script from any ChargeLimits, setters with any argument) is inside
+ *      the BQ25798_*_MIN / _MAX range
+ *
+ *  Built two ways:
+ *    - with clang and -fsanitize=fuzzer (-DFUZZ_LIBFUZZER): libFuzzer
+ *      drives LLVMFuzzerTestOneInput (`make fuzz-libfuzzer`)
+ *    - with gcc (`make fuzz`): the firmware objects are compiled with
+ *      -fsanitize-coverage=trace-pc and the small coverage-guided loop at
+ *      the bottom of this file mutates an in-memory corpus, keeping inputs
+ *      that reach new edges. ASan / UBSan in both.
+ *
+ *    fuzz_drivers [-n runs] [-s seed] [-o crash.bin] [input...]
+ *
+ *  With input files each is run once (reproducing a saved crash). A failed
+ *  invariant prints the check and saves the input to the -o file.
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_hal.h"
+#include "i2c_bus.h"
+#include "bq25798.h"
+#include "bq76907.h"
+
+#define FUZZ_MAX_INPUT  512u
+
+typedef enum {
+    FUZZ_OP_CHG_STATUS = 0,   /* readChargerStatus0..4 / readFaultStatus0..1 */
+    FUZZ_OP_CHG_READ,         /* BQ25798_readDecoded, any reg / len */
+    FUZZ_OP_PART_INFO,        /* BQ25798_confirmPart + decodePartInfo */
+    FUZZ_OP_MON_READ,         /* BQ76907_readSystemStatus / readCellVoltages / readDecoded */
+    FUZZ_OP_BALANCE,          /* BQ76907_evaluateAndBalance */
+    FUZZ_OP_PROFILE,          /* BQ25798_updateChargeProfile */
+    FUZZ_OP_INIT_SCRIPT,      /* BQ25798_initScript from fuzzed ChargeLimits */
+    FUZZ_OP_SETPOINT,         /* BQ25798_setChargeVoltage / Current / InputCurrentLimit */
+    FUZZ_OP_CLOCK,            /* advance the clock (bus back-off expiry) */
+    FUZZ_OP_COUNT
+} FuzzOp;
+
+static void fuzzFail(int line, const char *what);
+#define FUZZ_CHECK(cond) do { if (!(cond)) fuzzFail(__LINE__, #cond); } while (0)
+
+/* ================= Input ================= */
+static const uint8_t *inPtr;
+static size_t inLeft;
+
+static uint8_t take(void){
+    if (!inLeft) return 0;
+    inLeft--;
+    return *inPtr++;
+}
+static uint16_t take16(void){
+    uint16_t v = (uint16_t)(take() << 8);
+    return (uint16_t)(v | take());
+}
+static HAL_StatusTypeDef takeStatus(void){
+    if (!inLeft) return HAL_TIMEOUT;
+    uint8_t b = take();
+    return (b & 0x80u) ? (HAL_StatusTypeDef)(b & 3u) : HAL_OK;
+}
+
+/* ================= Scripted devices ================= */
+typedef struct {
+    uint16_t addr;
+    uint32_t writes;                  /* transactions handed to the device */
+    uint8_t  lastReadReg, lastReadLen;
+    uint8_t  lastRead[16];
+    uint32_t ichgWrites;              /* charger: ICHG set points seen */
+    uint16_t lastIchg;
+    uint32_t maskWrites;              /* monitor: CB_ACTIVE_CELLS writes */
+    uint8_t  lastMask;
+} FuzzDevice;
+
+static FuzzDevice charger = { BQ25798_I2C_ADDRESS };
+static FuzzDevice monitor = { BQ76907_I2C_ADDRESS };
+
+static HAL_StatusTypeDef fuzzRead(void *ctx, uint8_t reg, uint8_t *data, uint16_t len){
+    FuzzDevice *d = (FuzzDevice *)ctx;
+    HAL_StatusTypeDef st = takeStatus();
+    if (st != HAL_OK) return st;
+    for (uint16_t i = 0; i < len; i++) data[i] = take();
+    d->lastReadReg = reg;
+    d->lastReadLen = (uint8_t)(len < sizeof(d->lastRead) ? len : sizeof(d->lastRead));
+    memcpy(d->lastRead, data, d->lastReadLen);
+    return HAL_OK;
+}
+
+/* Set point registers: value (bus order) inside the datasheet range */
+static void checkChargerWrite(uint8_t reg, const uint8_t *data, uint16_t len){
+    uint16_t v = len >= 2 ? (uint16_t)(data[0] << 8 | data[1]) : data[0];
+    switch (reg){
+    case BQ25798_REG_CHARGE_VOLTAGE_LIMIT:
+        FUZZ_CHECK(len == 2 && v >= BQ25798_VREG_MIN_mV / 10u && v <= BQ25798_VREG_MAX_mV / 10u);
+        break;
+    case BQ25798_REG_CHARGE_CURRENT_LIMIT:
+        FUZZ_CHECK(len == 2 && v >= BQ25798_ICHG_MIN_mA / 10u && v <= BQ25798_ICHG_MAX_mA / 10u);
+        break;
+    case BQ25798_REG_INPUT_VOLTAGE_LIMIT:
+        FUZZ_CHECK(len == 1 && v >= BQ25798_VINDPM_MIN_mV / 100u && v <= BQ25798_VINDPM_MAX_mV / 100u);
+        break;
+    case BQ25798_REG_INPUT_CURRENT_LIMIT:
+        FUZZ_CHECK(len == 2 && v >= BQ25798_IINDPM_MIN_mA / 10u && v <= BQ25798_IINDPM_MAX_mA / 10u);
+        break;
+    default:
+        break;
+    }
+}
+
+static HAL_StatusTypeDef fuzzWrite(void *ctx, uint8_t reg, const uint8_t *data, uint16_t len){
+    FuzzDevice *d = (FuzzDevice *)ctx;
+    d->writes++;
+    if (d == &charger){
+        checkChargerWrite(reg, data, len);
+        if (reg == BQ25798_REG_CHARGE_CURRENT_LIMIT && len == 2){
+            d->ichgWrites++;
+            d->lastIchg = (uint16_t)(data[0] << 8 | data[1]);
+        }
+    } else if (reg == BQ76907_REG_CB_ACTIVE_CELLS && len == 1){
+        d->maskWrites++;
+        d->lastMask = data[0];
+    }
+    return takeStatus();
+}
+
+/* ================= Checks ================= */
+static uint8_t fieldMask(const BQ_RegDesc *reg){
+    uint8_t m = 0;
+    for (uint8_t f = 0; f < reg->fieldCount; f++){
+        m |= (uint8_t)(BQ_FIELD_BITS(reg->fields[f].msb, reg->fields[f].lsb) << reg->fields[f].lsb);
+    }
+    return m;
+}
+
+/* Every decoded field fits its width */
+static void checkFields(const void *dev, const BQ_RegDesc *tab, uint8_t count){
+    const uint8_t *base = (const uint8_t *)dev;
+    for (uint8_t r = 0; r < count; r++){
+        if (!tab[r].fields) continue;
+        for (uint8_t f = 0; f < tab[r].fieldCount; f++){
+            FUZZ_CHECK(base[tab[r].offset + f] <= BQ_FIELD_BITS(tab[r].fields[f].msb, tab[r].fields[f].lsb));
+        }
+    }
+}
+
+static const BQ_RegDesc *findDesc(const BQ_RegDesc *tab, uint8_t count, uint8_t addr){
+    for (uint8_t r = 0; r < count; r++) if (tab[r].addr == addr) return &tab[r];
+    return NULL;
+}
+
+/* ================= Operations ================= */
+static I2C_HandleTypeDef hi2c;
+static BQ25798 chg;
+static BQ76907 mon;
+
+static void opChargerStatus(void){
+    static const uint8_t regs[] = {
+        BQ25798_REG_CHARGER_STATUS_0, BQ25798_REG_CHARGER_STATUS_1, BQ25798_REG_CHARGER_STATUS_2,
+        BQ25798_REG_CHARGER_STATUS_3, BQ25798_REG_CHARGER_STATUS_4,
+        BQ25798_REG_FAULT_STATUS_0, BQ25798_REG_FAULT_STATUS_1
+    };
+    uint8_t reg = regs[take() % sizeof(regs)];
+    uint8_t raw = 0;
+    /* readChargerStatusN / readFaultStatusN expand to this */
+    if (BQ25798_readDecoded(&chg, reg, 1, &raw) != HAL_OK) return;
+    const BQ_RegDesc *d = findDesc(BQ25798_regDesc, BQ25798_regDescCount, reg);
+    FUZZ_CHECK(d && d->fields);
+    FUZZ_CHECK(BQ25798_encodeRegister(&chg, reg) == (raw & fieldMask(d)));
+    checkFields(&chg, BQ25798_regDesc, BQ25798_regDescCount);
+}
+
+static void opChargerRead(void){
+    uint8_t reg = take();
+    uint8_t len = (uint8_t)(take() % 10u);
+    uint32_t reads = HostHal_getI2CStats(BQ25798_I2C_ADDRESS).reads;
+    HAL_StatusTypeDef st = BQ25798_readDecoded(&chg, reg, len, NULL);
+    if (len == 0 || len > 8){
+        FUZZ_CHECK(st == HAL_ERROR);
+        FUZZ_CHECK(HostHal_getI2CStats(BQ25798_I2C_ADDRESS).reads == reads);
+        return;
+    }
+    checkFields(&chg, BQ25798_regDesc, BQ25798_regDescCount);
+}
+
+static void opPartInfo(void){
+    BQ25798_PartInfo info;
+    BQ25798_Result r = BQ25798_confirmPart(&chg, &info);
+    if (r == BQ25798_ERR_I2C) return;
+    uint8_t raw = charger.lastRead[0];
+    FUZZ_CHECK(info.raw == raw);
+    FUZZ_CHECK(info.part3bit <= 7u && info.part5bit <= 31u && info.rev <= 7u);
+    FUZZ_CHECK((uint8_t)(info.part5bit << BQ25798_PART_INFO_PART5_SHIFT | info.rev) == raw);
+    FUZZ_CHECK(info.part3bit == (info.part5bit & 7u));
+    FUZZ_CHECK((r == BQ25798_OK) == (BQ25798_partInfoValid(raw) != 0));
+    if (r == BQ25798_OK) FUZZ_CHECK(info.rev == BQ25798_DEV_REV_VAL || info.rev == BQ25798_EXPECTED_REVISION);
+}
+
+static void opMonitorRead(void){
+    uint8_t which = (uint8_t)(take() % 3u);
+    HAL_StatusTypeDef st;
+    if (which == 0) st = BQ76907_readSystemStatus(&mon);
+    else if (which == 1) st = BQ76907_readCellVoltages(&mon);
+    else st = BQ76907_readDecoded(&mon, take(), (uint8_t)(1u + take() % 8u));
+    if (st != HAL_OK) return;
+    checkFields(&mon, BQ76907_regDesc, BQ76907_regDescCount);
+    if (which == 1){
+        for (uint8_t i = 0; i < 4; i++){
+            uint16_t raw = (uint16_t)(monitor.lastRead[2 * i] << 8 | monitor.lastRead[2 * i + 1]);
+            FUZZ_CHECK(mon.cellVoltage_mV[i] == BQ76907_scaleCellVoltage(raw));
+        }
+    }
+}
+
+static void opBalance(void){
+    uint16_t start = take16(), stop = take16(), minCell = take16();
+    uint32_t writes = monitor.maskWrites;
+    uint8_t r = BQ76907_evaluateAndBalance(&mon, start, stop, minCell);
+    if (monitor.maskWrites != writes){
+        uint8_t mask = monitor.lastMask;
+        FUZZ_CHECK((mask & ~0x0Fu) == 0);
+        for (uint8_t i = 0; i < 4; i++){
+            if (mask & (1u << i)) FUZZ_CHECK(mon.cellVoltage_mV[i] > minCell);
+        }
+        FUZZ_CHECK(r == mask || r == 0xFF);
+    } else {
+        FUZZ_CHECK(r == 0xFF);     /* cell read failed, nothing written */
+    }
+}
+
+static void opProfile(void){
+    uint32_t writes = charger.ichgWrites;
+    HAL_StatusTypeDef st = BQ25798_updateChargeProfile(&chg);
+    if (charger.ichgWrites == writes){
+        /* no set point: VBAT read failed, or the write was backed off */
+        FUZZ_CHECK(st != HAL_OK);
+        return;
+    }
+    FUZZ_CHECK(charger.ichgWrites == writes + 1u);
+    uint16_t v = chg.voltageBattery;
+    uint16_t expect_mA = v < 3000u ? 100u : v < 3650u ? 5000u : 1000u;
+    FUZZ_CHECK(charger.lastIchg == BQ25798_encodeChargeCurrent_mA(expect_mA));
+}
+
+static void opInitScript(void){
+    BQ25798_ChargeLimits lim;
+    lim.chargeVoltage_mV = take16();
+    lim.chargeCurrent_mA = take16();
+    lim.inputVoltage_mV  = take16();
+    lim.inputCurrent_mA  = take16();
+    BQ_RegWrite script[BQ25798_INIT_SCRIPT_LEN];
+    uint8_t n = BQ25798_initScript(&lim, script);
+    FUZZ_CHECK(n <= BQ25798_INIT_SCRIPT_LEN);
+    for (uint8_t i = 0; i < n; i++){
+        FUZZ_CHECK(script[i].len == 1 || script[i].len == 2);
+        checkChargerWrite(script[i].reg, script[i].data, script[i].len);
+    }
+}
+
+static void opSetpoint(void){
+    uint8_t which = (uint8_t)(take() % 3u);
+    uint16_t v = take16();
+    if (which == 0) BQ25798_setChargeVoltage(&chg, v);
+    else if (which == 1) BQ25798_setChargeCurrent(&chg, v);
+    else BQ25798_setInputCurrentLimit(&chg, v);
+}
+
+/* Balancing hysteresis lives in a static: equal cells turn it off */
+static void resetBalancing(void){
+    static const uint8_t equalCells[] = { 0x00, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x00 };
+    inPtr = equalCells;
+    inLeft = sizeof(equalCells);
+    BQ76907_evaluateAndBalance(&mon, 1, 0, 0);
+}
+
+static void fuzzSetup(void){
+    static uint8_t done;
+    if (done) return;
+    done = 1;
+    HostHal_reset();
+    HostI2C_Device c = { BQ25798_I2C_ADDRESS, &charger, fuzzRead, fuzzWrite, NULL };
+    HostI2C_Device m = { BQ76907_I2C_ADDRESS, &monitor, fuzzRead, fuzzWrite, NULL };
+    HostHal_attachI2C(&c);
+    HostHal_attachI2C(&m);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size){
+    fuzzSetup();
+    I2CBus_Init(&hi2c);
+    memset(&chg, 0, sizeof(chg));
+    memset(&mon, 0, sizeof(mon));
+    chg.i2cHandle = &hi2c;
+    mon.i2cHandle = &hi2c;
+    resetBalancing();
+    memset(&charger.writes, 0, sizeof(charger) - offsetof(FuzzDevice, writes));
+    memset(&monitor.writes, 0, sizeof(monitor) - offsetof(FuzzDevice, writes));
+
+    inPtr = data;
+    inLeft = size > FUZZ_MAX_INPUT ? FUZZ_MAX_INPUT : size;
+    while (inLeft){
+        switch ((FuzzOp)(take() % FUZZ_OP_COUNT)){
+        case FUZZ_OP_CHG_STATUS:  opChargerStatus(); break;
+        case FUZZ_OP_CHG_READ:    opChargerRead(); break;
+        case FUZZ_OP_PART_INFO:   opPartInfo(); break;
+        case FUZZ_OP_MON_READ:    opMonitorRead(); break;
+        case FUZZ_OP_BALANCE:     opBalance(); break;
+        case FUZZ_OP_PROFILE:     opProfile(); break;
+        case FUZZ_OP_INIT_SCRIPT: opInitScript(); break;
+        case FUZZ_OP_SETPOINT:    opSetpoint(); break;
+        case FUZZ_OP_CLOCK:       HostHal_advanceMs(take()); break;
+        default: break;
+        }
+    }
+    return 0;
+}
+
+#ifdef FUZZ_LIBFUZZER
+int LLVMFuzzerInitialize(int *argc, char ***argv){
+    (void)argc; (void)argv;
+    freopen("/dev/null", "w", stdout);   /* driver BQ_LOG output */
+    return 0;
+}
+
+static void fuzzFail(int line, const char *what){
+    fprintf(stderr, "[FUZZ] FAIL fuzz_drivers.c:%d: %s\n", line, what);
+    abort();
+}
+#else
+/* ================= gcc driver: coverage-guided mutation loop ================= */
+#include <time.h>
+#include <unistd.h>
+#if defined(__SANITIZE_ADDRESS__)
+#include <sanitizer/common_interface_defs.h>
+#endif
+
+#define FUZZ_RUNS         200000u
+#define FUZZ_MAP_SIZE     65536u
+#define FUZZ_CORPUS_MAX   2048u
+#define FUZZ_MAX_MUTATIONS 4u
+
+/* Edge coverage of the firmware objects (-fsanitize-coverage=trace-pc);
+ * this file is built without it */
+static uint8_t   edgeSeen[FUZZ_MAP_SIZE];
+static uintptr_t prevPc;
+static uint32_t  edges, newEdges;
+
+void __sanitizer_cov_trace_pc(void){
+    uintptr_t pc = (uintptr_t)__builtin_return_address(0);
+    uint32_t e = ((uint32_t)(pc ^ prevPc) * 0x9E3779B1u) >> 16;
+    prevPc = pc >> 1;
+    if (!edgeSeen[e]){
+        edgeSeen[e] = 1;
+        edges++;
+        newEdges++;
+    }
+}
+
+typedef struct {
+    uint16_t len;
+    uint8_t  data[FUZZ_MAX_INPUT];
+} FuzzEntry;
+
+static FuzzEntry corpus[FUZZ_CORPUS_MAX];
+static uint32_t  corpusCount;
+static FuzzEntry current;
+static const char *crashPath = "build/fuzz-crash.bin";
+static uint64_t rng = 0x9E3779B97F4A7C15ull;
+
+static uint32_t rnd(uint32_t n){
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    return (uint32_t)(rng >> 32) % n;
+}
+
+static void saveCurrent(void){
+    FILE *f = fopen(crashPath, "wb");
+    if (!f) return;
+    fwrite(current.data, 1, current.len, f);
+    fclose(f);
+    fprintf(stderr, "[FUZZ] input (%u bytes) saved to %s\n", current.len, crashPath);
+}
+
+static void fuzzFail(int line, const char *what){
+    fprintf(stderr, "[FUZZ] FAIL fuzz_drivers.c:%d: %s\n", line, what);
+    saveCurrent();
+    exit(1);
+}
+
+static void runCurrent(void){
+    prevPc = 0;
+    newEdges = 0;
+    LLVMFuzzerTestOneInput(current.data, current.len);
+}
+
+static void addCurrent(void){
+    uint32_t slot = corpusCount < FUZZ_CORPUS_MAX ? corpusCount++ : rnd(FUZZ_CORPUS_MAX);
+    corpus[slot] = current;
+}
+
+/* One of: flip a bit, random / boundary byte, insert, erase, splice */
+static void mutate(void){
+    static const uint8_t special[] = { 0x00, 0x01, 0x7F, 0x80, 0x81, 0x82, 0x83, 0xFF, 0x0E, 0x48 };
+    uint16_t len = current.len;
+    switch (rnd(6)){
+    case 0:
+        if (len) current.data[rnd(len)] ^= (uint8_t)(1u << rnd(8));
+        break;
+    case 1:
+        if (len) current.data[rnd(len)] = (uint8_t)rnd(256);
+        break;
+    case 2:
+        if (len) current.data[rnd(len)] = special[rnd(sizeof(special))];
+        break;
+    case 3:
+        if (len < FUZZ_MAX_INPUT){
+            uint16_t at = (uint16_t)rnd(len + 1u);
+            uint16_t n = (uint16_t)(1u + rnd(FUZZ_MAX_INPUT - len < 8u ? FUZZ_MAX_INPUT - len : 8u));
+            memmove(&current.data[at + n], &current.data[at], len - at);
+            for (uint16_t i = 0; i < n; i++) current.data[at + i] = (uint8_t)rnd(256);
+            current.len = (uint16_t)(len + n);
+        }
+        break;
+    case 4:
+        if (len > 1){
+            uint16_t at = (uint16_t)rnd(len);
+            uint16_t n = (uint16_t)(1u + rnd(len - at < 8u ? len - at : 8u));
+            memmove(&current.data[at], &current.data[at + n], len - at - n);
+            current.len = (uint16_t)(len - n);
+        }
+        break;
+    default: {
+        const FuzzEntry *o = &corpus[rnd(corpusCount)];
+        if (!o->len) break;
+        uint16_t from = (uint16_t)rnd(o->len);
+        uint16_t at = (uint16_t)rnd(len + 1u);
+        uint16_t n = (uint16_t)(o->len - from);
+        if (at + n > FUZZ_MAX_INPUT) n = (uint16_t)(FUZZ_MAX_INPUT - at);
+        memcpy(&current.data[at], &o->data[from], n);
+        if (at + n > len) current.len = (uint16_t)(at + n);
+        break;
+    }
+    }
+}
+
+static int runFile(const char *path){
+    FILE *f = fopen(path, "rb");
+    if (!f){ perror(path); return 1; }
+    current.len = (uint16_t)fread(current.data, 1, FUZZ_MAX_INPUT, f);
+    fclose(f);
+    runCurrent();
+    fprintf(stderr, "[FUZZ] %s: %u bytes OK\n", path, current.len);
+    return 0;
+}
+
+int main(int argc, char **argv){
+    uint32_t runs = FUZZ_RUNS;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:s:o:")) != -1){
+        switch (opt){
+        case 'n': runs = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 's': rng ^= strtoull(optarg, NULL, 0) * 0xBF58476D1CE4E5B9ull; break;
+        case 'o': crashPath = optarg; break;
+        default:
+            fprintf(stderr, "usage: %s [-n runs] [-s seed] [-o crash.bin] [input...]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (!freopen("/dev/null", "w", stdout)) return 2;   /* driver BQ_LOG output */
+#if defined(__SANITIZE_ADDRESS__)
+    __sanitizer_set_death_callback(saveCurrent);
+#endif
+    if (optind < argc){
+        int rc = 0;
+        for (int i = optind; i < argc; i++) rc |= runFile(argv[i]);
+        return rc;
+    }
+
+    /* Seeds: every op alone, with an OK bus behind it */
+    for (uint8_t op = 0; op < FUZZ_OP_COUNT; op++){
+        current.len = 24;
+        memset(current.data, 0, current.len);
+        current.data[0] = op;
+        runCurrent();
+        addCurrent();
+    }
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (uint32_t i = 0; i < runs; i++){
+        current = corpus[rnd(corpusCount)];
+        for (uint32_t m = 1u + rnd(FUZZ_MAX_MUTATIONS); m; m--) mutate();
+        runCurrent();
+        if (newEdges) addCurrent();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double s = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
+    fprintf(stderr, "[FUZZ] runs=%lu edges=%lu corpus=%lu %.0f execs/s, 0 failure(s)\n",
+        (unsigned long)runs, (unsigned long)edges, (unsigned long)corpusCount,
+        s > 0 ? (double)runs / s : 0.0);
+    return 0;
+}
+#endif /* FUZZ_LIBFUZZER */
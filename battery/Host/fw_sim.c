@@ -0,0 +1,277 @@
+/*
+ * fw_sim.c
+ *
+ *  Runs the firmware itself (Core/Src/main.c, compiled with
+ *  -Dmain=Firmware_main) against the BQ76907 and BQ25798 emulators on the
+ *  virtual clock. The loop idles through LowPower_Idle, which on the host
+ *  skips straight to the next due task, so hours of operation take
+ *  seconds:
+ *
+ *    fw_sim [-m simple|ecm] [-c spread%] [-r r0_mohm] [-s soc%] [-d soc%] [-l log] [hours]
+ *
+ *  hours defaults to 6, at least 5 (the timeline below). -m ecm swaps the
+ *  linear pack for the equivalent-circuit one (pack_ecm.h) with the given
+ *  capacity spread and R0. -s sets the starting state of charge (40 %),
+ *  -d starts the last cell soc% above the others (either model). The
+ *  last line ("[SIM] result ...") carries the metrics pack_sweep collects:
+ *  final / worst cell voltage spread, peak temperature, bleed and charge
+ *  time, and the cell steps the pack model took.
+ *
+ *  The harness is the board: a 4S pack under a constant system load, a
+ *  charger input that comes and goes, a bus dropout of each device and a
+ *  charger thermal shutdown (timeline[]), plus a configuration edit
+ *  requested before the monitor dropout, so its return applies it. The
+ *  SysTick hook runs the watchdog supervision, routes the charge current
+ *  through the pack, raises the BMS EXTI on ALERT and leaves the firmware
+ *  (longjmp) when the time is up or the IWDG expired.
+ *
+ *  The firmware console (printf text and TRACE records, as on the UART)
+ *  goes to build/fw_sim.log (-l): `./trace_decode fw_sim build/fw_sim.log`.
+ *  A second before the end the I2C recorder is dumped there, for
+ *  `./i2c_replay build/fw_sim.log`.
+ *  Checks print here; exits non-zero if any fails (`make run`).
+ */
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "host_hal.h"
+#include "main.h"
+#include "bq76907_emu.h"
+#include "bq25798_emu.h"
+#include "config_store.h"
+#include "pack_ecm.h"
+#include "scheduler.h"
+#include "watchdog.h"
+#include "i2c_rec.h"
+
+#define SIM_MIN(m)          ((m) * 60000u)
+#define SIM_LOAD_mA         2000     /* system load on the pack */
+#define SIM_VBUS_mV         20000    /* charger input while present */
+#define SIM_CAPACITY_mAh    20000
+#define SIM_START_SOC       40       /* default, -s */
+#define SIM_OFFLINE_MAX_MS  30000    /* dropout to charger reaction, either way */
+#define SIM_MON_LOST_MAX_MS 1500     /* monitor dropout to charging off: the next poll's refresh fails */
+#define SIM_DUMP_LEAD_MS    1000     /* I2C recorder dump this long before the end */
+#define SIM_CFG_EDIT_MS     SIM_MIN(90)   /* CUV edit requested, applied when the monitor returns */
+#define SIM_CFG_EDIT_UV_mV  2600
+
+int Firmware_main(void);
+
+static unsigned failures;
+static FILE *report;
+
+#define CHECK(cond, msg) do { \
+        int ok_ = (cond); if (!ok_) failures++; \
+        fprintf(report, "[SIM] %-50s %s\n", msg, ok_ ? "OK" : "FAIL"); \
+    } while (0)
+
+typedef enum {
+    EV_INPUT_ON, EV_CHG_DROP, EV_CHG_BACK, EV_MON_DROP, EV_MON_BACK,
+    EV_TSHUT_ON, EV_TSHUT_OFF, EV_INPUT_OFF, EV_COUNT
+} SimEvent;
+
+static const uint32_t timeline[EV_COUNT] = {
+    [EV_INPUT_ON]  = SIM_MIN(30),
+    [EV_CHG_DROP]  = SIM_MIN(60),
+    [EV_CHG_BACK]  = SIM_MIN(60) + 30000u,
+    [EV_MON_DROP]  = SIM_MIN(120),
+    [EV_MON_BACK]  = SIM_MIN(120) + 60000u,
+    [EV_TSHUT_ON]  = SIM_MIN(180),
+    [EV_TSHUT_OFF] = SIM_MIN(180) + 10000u,
+    [EV_INPUT_OFF] = SIM_MIN(240),
+};
+
+static PackModel pack;
+static PackModel_SimpleState packState;
+static PackModel_EcmState ecmState;
+static BQ76907_Emu mon;
+static BQ25798_Emu chg;
+static jmp_buf simEnd;
+static uint32_t endMs, wdgExpiredAt;
+static uint8_t nextEvent, alert;
+
+/* Observations along the run */
+static uint32_t seenAt[EV_COUNT];          /* virtual time each event was applied */
+static uint32_t chgIdReads[EV_COUNT], ledChanges[EV_COUNT], adcReads[EV_COUNT];
+static uint32_t packAt[EV_COUNT];
+static uint32_t chgOffAt, chgOnAt;         /* CHG_EN cleared / set again around the monitor dropout */
+static int16_t maxTemp_x10;
+static uint16_t maxSpread_mV;
+
+static uint32_t packVoltage_mV(void){
+    uint32_t v = 0;
+    for (uint8_t i = 0; i < pack.cellCount; i++) v += PackModel_cellVoltage_mV(&pack, i);
+    return v;
+}
+
+static uint16_t cellSpread_mV(void){
+    uint16_t vmin = 0xFFFF, vmax = 0;
+    for (uint8_t i = 0; i < pack.cellCount; i++){
+        uint16_t v = PackModel_cellVoltage_mV(&pack, i);
+        if (v < vmin) vmin = v;
+        if (v > vmax) vmax = v;
+    }
+    return (uint16_t)(vmax - vmin);
+}
+
+static void apply(SimEvent ev, uint32_t now){
+    seenAt[ev] = now;
+    chgIdReads[ev] = chg.stats.idReads;
+    adcReads[ev] = chg.stats.adcReads;
+    ledChanges[ev] = GPIOA->changes[5];
+    packAt[ev] = packVoltage_mV();
+    switch (ev){
+    case EV_INPUT_ON:  chg.vbus_mV = SIM_VBUS_mV; break;
+    case EV_INPUT_OFF: chg.vbus_mV = 0; break;
+    case EV_CHG_DROP:  HostHal_injectI2CErrors(BQ25798_I2C_ADDRESS, 0xFFFF, HAL_ERROR); break;
+    case EV_CHG_BACK:  HostHal_injectI2CErrors(BQ25798_I2C_ADDRESS, 0, HAL_OK); break;
+    case EV_MON_DROP:  HostHal_injectI2CErrors(BQ76907_I2C_ADDRESS, 0xFFFF, HAL_ERROR); break;
+    case EV_MON_BACK:  HostHal_injectI2CErrors(BQ76907_I2C_ADDRESS, 0, HAL_OK); break;
+    case EV_TSHUT_ON:  chg.tshut = 1; break;
+    case EV_TSHUT_OFF: chg.tshut = 0; break;
+    default: break;
+    }
+}
+
+/* SysTick: 1 ms of board time */
+static void simTick(void){
+    uint32_t now = HostHal_nowMs();
+    Watchdog_TickISR();
+    if (HostHal_watchdogExpired()){
+        wdgExpiredAt = now;
+        longjmp(simEnd, 1);
+    }
+    while (nextEvent < EV_COUNT && now >= timeline[nextEvent]){
+        apply((SimEvent)nextEvent, now);
+        nextEvent++;
+    }
+    BQ76907_Emu_setPackCurrent(&mon, chg.ibat_mA - SIM_LOAD_mA);
+
+    uint8_t a = BQ76907_Emu_alertAsserted(&mon);   /* open drain, active low */
+    if (a && !alert) HostHal_extiFalling(BMS_INTERRUPT_Pin);
+    alert = a;
+
+    if (nextEvent > EV_MON_DROP && nextEvent <= EV_MON_BACK && !chgOffAt && !BQ25798_Emu_chargeEnabled(&chg))
+        chgOffAt = now;
+    if (nextEvent > EV_MON_BACK && !chgOnAt && BQ25798_Emu_chargeEnabled(&chg))
+        chgOnAt = now;
+    if (now % 1000u == 0){
+        int16_t t = PackModel_temperature_x10(&pack);
+        uint16_t d = cellSpread_mV();
+        if (t > maxTemp_x10) maxTemp_x10 = t;
+        if (d > maxSpread_mV) maxSpread_mV = d;
+    }
+    if (now == SIM_CFG_EDIT_MS){
+        ConfigStore_Data edit = *ConfigStore_Get();
+        edit.monitor.uvThreshold_mV = SIM_CFG_EDIT_UV_mV;
+        ConfigStore_RequestCommit(&edit);
+    }
+    if (now == endMs - SIM_DUMP_LEAD_MS) I2CRec_RequestDump();
+    if (now >= endMs) longjmp(simEnd, 1);
+}
+
+static void usage(const char *prog){
+    fprintf(stderr, "usage: %s [-m simple|ecm] [-c spread%%] [-r r0_mohm] [-s soc%%] [-d soc%%] [-l log] [hours >= 5]\n", prog);
+}
+
+int main(int argc, char **argv){
+    PackEcm_Params ecm = PACK_ECM_DEFAULT_PARAMS;
+    const char *log = "build/fw_sim.log";
+    int useEcm = 0, startSoc = SIM_START_SOC, imbalance = 0, opt;
+    while ((opt = getopt(argc, argv, "m:c:r:s:d:l:")) != -1){
+        switch (opt){
+        case 'm': useEcm = !strcmp(optarg, "ecm"); break;
+        case 'c': ecm.capacitySpread_pct = (float)atof(optarg); break;
+        case 'r': ecm.r0_mohm = (float)atof(optarg); break;
+        case 's': startSoc = atoi(optarg); break;
+        case 'd': imbalance = atoi(optarg); break;
+        case 'l': log = optarg; break;
+        default: usage(argv[0]); return 2;
+        }
+    }
+    uint32_t hours = optind < argc ? (uint32_t)atoi(argv[optind]) : 6u;
+    if (hours < 5 || startSoc < 0 || startSoc > 100){
+        usage(argv[0]);
+        return 2;
+    }
+    report = fdopen(dup(fileno(stdout)), "w");
+    if (!report || !freopen(log, "wb", stdout)){
+        perror(log);
+        return 1;
+    }
+
+    HostHal_reset();
+    HostHal_setI2CTiming(300, 90);                      /* 100 kHz */
+    if (useEcm) PackModel_initEcm(&pack, &ecmState, 4, &ecm, (uint8_t)startSoc);
+    else PackModel_initSimple(&pack, &packState, 4, SIM_CAPACITY_mAh, (uint8_t)startSoc);
+    if (imbalance > 0){
+        uint8_t soc = (uint8_t)(startSoc + imbalance > 100 ? 100 : startSoc + imbalance);
+        if (useEcm) PackModel_setEcmCellSoc(&pack, 3, soc);
+        else PackModel_setSimpleCellSoc(&pack, 3, soc);
+    }
+    BQ25798_Emu_init(&chg, &pack);
+    BQ76907_Emu_init(&mon, &pack);
+    BQ25798_Emu_attach(&chg);                           /* steps first: current for the pack */
+    BQ76907_Emu_attach(&mon);
+    HostHal_setTickHook(simTick);
+    endMs = hours * 3600000u;
+
+    clock_t c0 = clock();
+    if (setjmp(simEnd) == 0) Firmware_main();           /* never returns */
+    double wall = (double)(clock() - c0) / CLOCKS_PER_SEC;
+    fflush(stdout);
+
+    uint32_t now = HostHal_nowMs();
+    fprintf(report, "[SIM] %lu h virtual in %.2f s wall (x%.0f), log in %s\n",
+            (unsigned long)hours, wall, wall > 0 ? now / 1000.0 / wall : 0.0, log);
+    CHECK(!wdgExpiredAt && now >= endMs, "ran to the end without an IWDG reset");
+    CHECK(mon.stats.cfgUpdateEntries >= 1 && chg.regs[BQ25798_REG_CHARGER_CTRL_0] == 0x8C,
+          "boot configured monitor and charger");
+    CHECK(ConfigStore_GetStats()->commits == 1 && ConfigStore_Get()->monitor.uvThreshold_mV == SIM_CFG_EDIT_UV_mV,
+          "config edit committed from the main loop");
+    CHECK(BQ76907_Emu_covThreshold_mV(&mon) == ConfigStore_Get()->monitor.ovThreshold_mV &&
+          BQ76907_Emu_cuvThreshold_mV(&mon) == ConfigStore_Get()->monitor.uvThreshold_mV,
+          "monitor holds the configured COV / CUV");
+
+    /* Charger refreshes every 500 ms while online (ADC read per refresh) */
+    uint32_t expected = (seenAt[EV_CHG_DROP] - 1000u) / 500u;
+    CHECK(adcReads[EV_CHG_DROP] >= expected * 95u / 100u && adcReads[EV_CHG_DROP] <= expected + 2u,
+          "charger polled every 500 ms");
+    CHECK(HostHal_getI2CStats(BQ76907_I2C_ADDRESS).reads >= (now / 750u) * 95u / 100u,
+          "monitor polled every 750 ms");
+
+    CHECK(chgIdReads[EV_MON_DROP] > chgIdReads[EV_CHG_BACK] &&
+          adcReads[EV_MON_DROP] - adcReads[EV_CHG_BACK] >= (seenAt[EV_MON_DROP] - seenAt[EV_CHG_BACK]) / 500u * 9u / 10u,
+          "charger re-initialised after its bus dropout");
+    /* Charging stops on the first failed monitor refresh, not at DEVICE_OFFLINE_FAILS */
+    CHECK(chgOffAt && chgOffAt - seenAt[EV_MON_DROP] < SIM_MON_LOST_MAX_MS, "charging stopped as soon as the monitor failed");
+    CHECK(chgOnAt && chgOnAt - seenAt[EV_MON_BACK] < SIM_OFFLINE_MAX_MS, "charging resumed when the monitor returned");
+    fprintf(report, "[SIM] monitor dropout: charging off after %lums, back %lums after recovery\n",
+            (unsigned long)(chgOffAt - seenAt[EV_MON_DROP]), (unsigned long)(chgOnAt - seenAt[EV_MON_BACK]));
+
+    uint32_t blinks = ledChanges[EV_TSHUT_OFF] - ledChanges[EV_TSHUT_ON];
+    CHECK(blinks >= 40 && blinks <= 52, "thermal shutdown blinks the LED at 200 ms");
+    CHECK(packAt[EV_INPUT_OFF] > packAt[EV_INPUT_ON] && packVoltage_mV() < packAt[EV_INPUT_OFF],
+          "pack charges with input present, discharges without");
+    CHECK(chg.stats.chgEnableChanges >= 2, "firmware toggled CHG_EN");
+
+    const Watchdog_Stats *ws = Watchdog_GetStats();
+    uint32_t overruns = 0;
+    for (uint8_t i = 0; Scheduler_GetStats(i); i++) overruns += Scheduler_GetStats(i)->overruns;
+    fprintf(report, "[SIM] watchdog kicks=%lu checks=%lu, task overruns=%lu, charger %lus charging\n",
+            (unsigned long)ws->kicks, (unsigned long)ws->checks, (unsigned long)overruns,
+            (unsigned long)(chg.stats.charge_ms / 1000u));
+    uint32_t balance_ms = 0;
+    for (uint8_t i = 0; i < pack.cellCount; i++) balance_ms += mon.stats.balance_ms[i];
+    fprintf(report, "[SIM] result model=%s spread=%.1f r0=%.2f soc=%d+%d pack=%lumV delta=%u/%umV tmax=%.1fC "
+            "balance=%lus charge=%lus cellsteps=%llu\n",
+            useEcm ? "ecm" : "simple", useEcm ? ecm.capacitySpread_pct : 0.0, useEcm ? ecm.r0_mohm : 0.0, startSoc, imbalance,
+            (unsigned long)packVoltage_mV(), cellSpread_mV(), maxSpread_mV, maxTemp_x10 / 10.0,
+            (unsigned long)(balance_ms / 1000u), (unsigned long)(chg.stats.charge_ms / 1000u),
+            (unsigned long long)now * pack.cellCount);
+    fprintf(report, "[SIM] %u failure(s)\n", failures);
+    return failures ? 1 : 0;
+}
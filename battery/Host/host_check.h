@@ -0,0 +1,34 @@
+/*
+ * host_check.h
+ *
+ *  Pass / fail lines for the host tests. Define HOST_CHECK_TAG (the
+ *  module's log tag, e.g. "[FLOG]") and include this once, in the file
+ *  with main:
+ *
+ *    CHECK(cond, what)    prints "<tag> what ... OK" or "... FAIL" and
+ *                         counts the failures
+ *    HostCheck_result()   prints "<tag> N failure(s)"; main's exit status
+ */
+
+#ifndef HOST_CHECK_H_
+#define HOST_CHECK_H_
+
+#include <stdio.h>
+
+#ifndef HOST_CHECK_TAG
+#error "define HOST_CHECK_TAG before including host_check.h"
+#endif
+
+static unsigned failures;
+
+#define CHECK(cond, what) do { \
+        int ok_ = (cond); if (!ok_) failures++; \
+        printf(HOST_CHECK_TAG " %-48s %s\n", (what), ok_ ? "OK" : "FAIL"); \
+    } while (0)
+
+static inline int HostCheck_result(void){
+    printf(HOST_CHECK_TAG " %u failure(s)\n", failures);
+    return failures ? 1 : 0;
+}
+
+#endif /* HOST_CHECK_H_ */
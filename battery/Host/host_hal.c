@@ -0,0 +1,407 @@
+/*
+ * host_hal.c
+ *
+ *  Virtual clock + emulated I2C bus backing hal_stubs.h on the host.
+ */
+#include "host_hal.h"
+#include "stm32g0xx_hal.h"
+#include "i2c.h"
+#include "gpio.h"
+#include "lowpower.h"
+#include "latency.h"
+#include "faultlog.h"
+#include "config_store.h"
+#include "watchdog.h"
+#include "memstats.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+typedef struct {
+    HostI2C_Device    dev;
+    HostI2C_Stats     stats;
+    uint16_t          failCount;  /* pending injected failures */
+    HAL_StatusTypeDef failStatus;
+} HostI2C_Slot;
+
+static HostI2C_Slot slots[HOST_HAL_MAX_I2C_DEVICES];
+static uint8_t      slotCount;
+static HostI2C_Stats unclaimed;   /* traffic to addresses nobody answers */
+static uint32_t     nowMs;
+static uint32_t     subUs;        /* microseconds into the current tick */
+static uint8_t      flash[FAULTLOG_PAGES * FAULTLOG_PAGE_SIZE];
+static uint32_t     flashErases[FAULTLOG_PAGES];
+static uint32_t     flashBusyUntil;
+static uint8_t      cfgFlash[CONFIG_STORE_SLOTS * CONFIG_STORE_PAGE_SIZE];
+static uint32_t     cfgFailAfter;   /* programs left before injected failures, 0 = off */
+static uint32_t     iwdgTimeout, iwdgLastKick;   /* iwdgTimeout 0 = not started */
+static uint8_t      iwdgResetFlag;
+static uint32_t     ram[HOST_HAL_RAM_BYTES / 4u];
+static uintptr_t    stackPointer;
+static uint32_t     i2cTxn_us, i2cByte_us;   /* bus time model, 0 = instantaneous */
+static void       (*tickHook)(void);
+static uint8_t      inTickHook;
+
+static HostI2C_Slot *findSlot(uint16_t devAddress){
+    for (uint8_t i = 0; i < slotCount; i++){
+        if (slots[i].dev.devAddress == devAddress) return &slots[i];
+    }
+    return NULL;
+}
+
+void HostHal_reset(void){
+    memset(slots, 0, sizeof(slots));
+    memset(&unclaimed, 0, sizeof(unclaimed));
+    slotCount = 0;
+    nowMs = 0;
+    subUs = 0;
+    memset(flash, 0xFF, sizeof(flash));
+    memset(flashErases, 0, sizeof(flashErases));
+    flashBusyUntil = 0;
+    memset(cfgFlash, 0xFF, sizeof(cfgFlash));
+    cfgFailAfter = 0;
+    iwdgTimeout = iwdgLastKick = 0;
+    iwdgResetFlag = 0;
+    memset(ram, 0, sizeof(ram));
+    stackPointer = (uintptr_t)ram + sizeof(ram) - 256u;
+    i2cTxn_us = i2cByte_us = 0;
+    tickHook = NULL;
+    memset(HostHal_gpio, 0, sizeof(HostHal_gpio));
+}
+
+int HostHal_attachI2C(const HostI2C_Device *dev){
+    if (!dev || slotCount >= HOST_HAL_MAX_I2C_DEVICES) return -1;
+    HostI2C_Slot *s = &slots[slotCount++];
+    memset(s, 0, sizeof(*s));
+    s->dev = *dev;
+    return 0;
+}
+
+int HostHal_interposeI2C(const HostI2C_Device *dev, HostI2C_Device *prev){
+    HostI2C_Slot *s = dev ? findSlot(dev->devAddress) : NULL;
+    if (!s) return -1;
+    if (prev) *prev = s->dev;
+    s->dev = *dev;
+    return 0;
+}
+
+static void stepDevices(uint32_t ms){
+    nowMs += ms;
+    for (uint8_t i = 0; i < slotCount; i++){
+        if (slots[i].dev.step) slots[i].dev.step(slots[i].dev.ctx, nowMs, ms);
+    }
+}
+
+void HostHal_advanceMs(uint32_t ms){
+    if (ms == 0) return;
+    if (!tickHook){
+        stepDevices(ms);
+        return;
+    }
+    while (ms--){
+        stepDevices(1);
+        inTickHook = 1;
+        tickHook();
+        inTickHook = 0;
+    }
+}
+
+void HostHal_setTickHook(void (*hook)(void)){ tickHook = hook; }
+
+uint32_t HostHal_nowMs(void){ return nowMs; }
+
+void HostHal_advanceUs(uint32_t us){
+    subUs += us;
+    HostHal_advanceMs(subUs / 1000u);
+    subUs %= 1000u;
+}
+
+uint32_t Latency_NowUs(void){ return nowMs * 1000u + subUs; }
+
+uint64_t HostHal_cycles(void){
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+void HostHal_injectI2CErrors(uint16_t devAddress, uint16_t count, HAL_StatusTypeDef status){
+    HostI2C_Slot *s = findSlot(devAddress);
+    if (!s) return;
+    s->failCount  = count;
+    s->failStatus = status;
+}
+
+void HostHal_setI2CTiming(uint32_t txn_us, uint32_t byte_us){
+    i2cTxn_us  = txn_us;
+    i2cByte_us = byte_us;
+}
+
+HostI2C_Stats HostHal_getI2CStats(uint16_t devAddress){
+    HostI2C_Slot *s = findSlot(devAddress);
+    if (s) return s->stats;
+    HostI2C_Stats none = {0};
+    return none;
+}
+
+/* ================= HAL surface (hal_stubs.h) ================= */
+uint32_t HAL_GetTick(void){
+    static uint32_t lastMs, reads;
+    if (tickHook && !inTickHook){
+        if (nowMs != lastMs){
+            lastMs = nowMs;
+            reads = 0;
+        } else if (++reads >= HOST_HAL_SPIN_READS){
+            reads = 0;
+            HostHal_advanceMs(1);
+        }
+    }
+    return nowMs;
+}
+
+void HAL_Delay(uint32_t Delay){ HostHal_advanceMs(Delay); }
+
+/* Shared pre-check: returns the slot to use or NULL with *st set to the failure.
+ * Charges the bus time: framing only for a failure, plus the payload otherwise. */
+static HostI2C_Slot *beginTransfer(uint16_t devAddress, uint16_t size, HAL_StatusTypeDef *st){
+    HostI2C_Slot *s = findSlot(devAddress);
+    if (!s){
+        unclaimed.errors++;
+        HostHal_advanceUs(i2cTxn_us);
+        *st = HAL_ERROR; /* address NACK */
+        return NULL;
+    }
+    if (s->failCount){
+        s->failCount--;
+        s->stats.errors++;
+        HostHal_advanceUs(i2cTxn_us);
+        *st = s->failStatus;
+        return NULL;
+    }
+    HostHal_advanceUs(i2cTxn_us + size * i2cByte_us);
+    *st = HAL_OK;
+    return s;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                   uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout){
+    (void)hi2c; (void)MemAddSize; (void)Timeout;
+    HAL_StatusTypeDef st;
+    HostI2C_Slot *s = beginTransfer(DevAddress, Size, &st);
+    if (!s) return st;
+    s->stats.reads++;
+    s->stats.bytes += Size;
+    st = s->dev.read ? s->dev.read(s->dev.ctx, (uint8_t)MemAddress, pData, Size) : HAL_ERROR;
+    if (st != HAL_OK) s->stats.errors++;
+    return st;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                    uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout){
+    (void)hi2c; (void)MemAddSize; (void)Timeout;
+    HAL_StatusTypeDef st;
+    HostI2C_Slot *s = beginTransfer(DevAddress, Size, &st);
+    if (!s) return st;
+    s->stats.writes++;
+    s->stats.bytes += Size;
+    st = s->dev.write ? s->dev.write(s->dev.ctx, (uint8_t)MemAddress, pData, Size) : HAL_ERROR;
+    if (st != HAL_OK) s->stats.errors++;
+    return st;
+}
+
+/* ================= Fault log flash (faultlog.h) ================= */
+uint8_t *HostHal_flashImage(void){ return flash; }
+
+uint32_t HostHal_flashEraseCount(uint32_t page){
+    return page < FAULTLOG_PAGES ? flashErases[page] : 0;
+}
+
+const uint8_t *FaultLog_FlashRead(uint32_t offset){ return &flash[offset]; }
+
+/* Like the G0 FLASH: double-word aligned, only into an erased double word */
+HAL_StatusTypeDef FaultLog_FlashProgram(uint32_t offset, uint64_t data){
+    if ((offset & 7u) || offset + 8u > sizeof(flash) || FaultLog_FlashBusy()) return HAL_ERROR;
+    for (uint32_t i = 0; i < 8u; i++) if (flash[offset + i] != 0xFFu) return HAL_ERROR;
+    memcpy(&flash[offset], &data, 8);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef FaultLog_FlashEraseStart(uint32_t page){
+    if (page >= FAULTLOG_PAGES) return HAL_ERROR;
+    if (FaultLog_FlashBusy()) return HAL_BUSY;
+    memset(&flash[page * FAULTLOG_PAGE_SIZE], 0xFF, FAULTLOG_PAGE_SIZE);
+    flashErases[page]++;
+    flashBusyUntil = nowMs + HOST_HAL_FLASH_ERASE_MS;
+    return HAL_OK;
+}
+
+uint8_t FaultLog_FlashBusy(void){
+    return (int32_t)(nowMs - flashBusyUntil) < 0;
+}
+
+/* ================= Configuration store flash (config_store.h) ================= */
+uint8_t *HostHal_configImage(void){ return cfgFlash; }
+
+void HostHal_failConfigProgramAfter(uint32_t count){ cfgFailAfter = count; }
+
+const uint8_t *ConfigStore_FlashRead(uint32_t offset){ return &cfgFlash[offset]; }
+
+HAL_StatusTypeDef ConfigStore_FlashProgram(uint32_t offset, uint64_t data){
+    if ((offset & 7u) || offset + 8u > sizeof(cfgFlash)) return HAL_ERROR;
+    if (cfgFailAfter && --cfgFailAfter == 0) return HAL_ERROR;
+    for (uint32_t i = 0; i < 8u; i++) if (cfgFlash[offset + i] != 0xFFu) return HAL_ERROR;
+    memcpy(&cfgFlash[offset], &data, 8);
+    return HAL_OK;
+}
+
+/* Blocking like the target: the virtual clock moves on by the erase time */
+HAL_StatusTypeDef ConfigStore_FlashErase(uint32_t slot){
+    if (slot >= CONFIG_STORE_SLOTS) return HAL_ERROR;
+    memset(&cfgFlash[slot * CONFIG_STORE_PAGE_SIZE], 0xFF, CONFIG_STORE_PAGE_SIZE);
+    HostHal_advanceMs(HOST_HAL_FLASH_ERASE_MS);
+    return HAL_OK;
+}
+
+/* ================= Independent watchdog (watchdog.h) ================= */
+uint8_t HostHal_watchdogExpired(void){
+    return iwdgTimeout && nowMs - iwdgLastKick > iwdgTimeout;
+}
+
+void HostHal_watchdogReset(void){
+    iwdgTimeout = 0;
+    iwdgResetFlag = 1;
+}
+
+void Watchdog_HwStart(uint32_t timeout_ms){
+    iwdgTimeout = timeout_ms;
+    iwdgLastKick = nowMs;
+}
+
+void Watchdog_HwKick(void){ iwdgLastKick = nowMs; }
+
+uint8_t Watchdog_HwTookReset(void){
+    uint8_t r = iwdgResetFlag;
+    iwdgResetFlag = 0;
+    return r;
+}
+
+/* ================= RAM layout (memstats.h) ================= */
+/* A quarter each for .data and .bss, half for heap + stack (1 KB stack reserve) */
+uint8_t *HostHal_ramImage(void){ return (uint8_t *)ram; }
+
+void HostHal_setStackPointer(uintptr_t sp){ stackPointer = sp; }
+
+void MemStats_HwLayout(MemStats_Layout *out){
+    out->ramStart = (uintptr_t)ram;
+    out->dataEnd = (uintptr_t)ram + sizeof(ram) / 4u;
+    out->staticEnd = (uintptr_t)ram + sizeof(ram) / 2u;
+    out->stackTop = (uintptr_t)ram + sizeof(ram);
+    out->heapLimit = out->stackTop - 1024u;
+}
+
+uintptr_t MemStats_HwStackPointer(void){ return stackPointer; }
+
+/* ================= Board: GPIO, clocks, CubeMX init (stm32g0xx_hal.h shim) ================= */
+GPIO_TypeDef HostHal_gpio[4];
+I2C_HandleTypeDef hi2c1;
+
+static void setPins(GPIO_TypeDef *port, uint16_t pins, uint32_t odr){
+    uint32_t changed = (port->ODR ^ odr) & pins;
+    for (uint8_t b = 0; b < 16u; b++) if (changed & (1u << b)) port->changes[b]++;
+    port->ODR = (port->ODR & ~(uint32_t)pins) | (odr & pins);
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState){
+    setPins(GPIOx, GPIO_Pin, PinState == GPIO_PIN_SET ? 0xFFFFu : 0u);
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin){
+    setPins(GPIOx, GPIO_Pin, ~GPIOx->ODR);
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin){
+    return (GPIOx->ODR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+HAL_StatusTypeDef HAL_Init(void){ return HAL_OK; }
+HAL_StatusTypeDef HAL_PWREx_ControlVoltageScaling(uint32_t VoltageScaling){ (void)VoltageScaling; return HAL_OK; }
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *RCC_OscInitStruct){ (void)RCC_OscInitStruct; return HAL_OK; }
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef *RCC_ClkInitStruct, uint32_t FLatency){
+    (void)RCC_ClkInitStruct; (void)FLatency;
+    return HAL_OK;
+}
+
+void MX_GPIO_Init(void){}
+void MX_I2C1_Init(void){}
+
+/* ================= Tickless idle (lowpower.h) ================= */
+static volatile uint8_t wakeEvents;
+static LowPower_Stats lpStats;
+static uint32_t lpInitTick;
+
+void LowPower_Init(void){
+    memset(&lpStats, 0, sizeof(lpStats));
+    wakeEvents = 0;
+    lpInitTick = nowMs;
+}
+
+/* Sleep: until the next SysTick. Stop: until the deadline or a wake event. */
+uint32_t LowPower_Idle(uint32_t maxSleep_ms){
+    if (maxSleep_ms == 0) return 0;
+    if (maxSleep_ms < LOWPOWER_MIN_STOP_MS){
+        lpStats.sleepEntries++;
+        HostHal_advanceMs(1);
+        return 0;
+    }
+    if (maxSleep_ms > LOWPOWER_MAX_STOP_MS) maxSleep_ms = LOWPOWER_MAX_STOP_MS;
+    if (wakeEvents) return 0;
+    uint32_t slept = 0;
+    while (slept < maxSleep_ms && !wakeEvents){
+        HostHal_advanceMs(1);
+        slept++;
+    }
+    if (slept < maxSleep_ms) lpStats.earlyWakes++;
+    lpStats.stopEntries++;
+    lpStats.stop_ms += slept;
+    return slept;
+}
+
+void LowPower_LptimIRQHandler(void){}
+
+void HAL_GPIO_EXTI_Falling_Callback(uint16_t GPIO_Pin){
+    if (GPIO_Pin == BMS_INTERRUPT_Pin){
+        wakeEvents |= LOWPOWER_WAKE_BMS;
+        lpStats.wakes[0]++;
+    } else if (GPIO_Pin == MPPT_BQ_INTERRUPT_Pin){
+        wakeEvents |= LOWPOWER_WAKE_CHARGER;
+        lpStats.wakes[1]++;
+    } else if (GPIO_Pin == LIGHT_SWITCH_Pin){
+        wakeEvents |= LOWPOWER_WAKE_SWITCH;
+        lpStats.wakes[2]++;
+    }
+}
+
+void HostHal_extiFalling(uint16_t pin){ HAL_GPIO_EXTI_Falling_Callback(pin); }
+
+uint8_t LowPower_TakeWakeEvents(void){
+    uint8_t ev = wakeEvents;
+    wakeEvents = 0;
+    return ev;
+}
+
+const LowPower_Stats *LowPower_GetStats(void){ return &lpStats; }
+
+void LowPower_LogStats(void){
+    uint32_t up = nowMs - lpInitTick;
+    printf("[PWR] stop=%lu (%lums, %lu%% of %lums) sleep=%lu early=%lu wake bms=%lu chg=%lu sw=%lu\n",
+        (unsigned long)lpStats.stopEntries, (unsigned long)lpStats.stop_ms,
+        (unsigned long)(up ? (uint32_t)(((uint64_t)lpStats.stop_ms * 100u) / up) : 0), (unsigned long)up,
+        (unsigned long)lpStats.sleepEntries, (unsigned long)lpStats.earlyWakes,
+        (unsigned long)lpStats.wakes[0], (unsigned long)lpStats.wakes[1], (unsigned long)lpStats.wakes[2]);
+}
@@ -0,0 +1,137 @@
+/*
+ * host_hal.h
+ *
+ *  Host-side implementation of the HAL subset declared in hal_stubs.h.
+ *  I2C memory transfers are routed by device address to register-level
+ *  emulators (e.g. bq76907_emu.c); HAL_GetTick() returns a virtual clock
+ *  that only moves when the harness (or HAL_Delay) advances it.
+ *
+ *  Build with -DUSE_HAL_STUBS so the driver headers pick up hal_stubs.h.
+ */
+
+#ifndef HOST_HAL_H_
+#define HOST_HAL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "hal_stubs.h"
+#include <stdint.h>
+
+#ifndef HOST_HAL_FLASH_ERASE_MS
+#define HOST_HAL_FLASH_ERASE_MS  22   /* page erase time (datasheet typ.) */
+#endif
+#ifndef HOST_HAL_RAM_BYTES
+#define HOST_HAL_RAM_BYTES       8192   /* emulated RAM behind memstats.h */
+#endif
+#ifndef HOST_HAL_MAX_I2C_DEVICES
+#define HOST_HAL_MAX_I2C_DEVICES 4
+#endif
+
+/* One emulated I2C target. Address uses the HAL convention (7-bit << 1). */
+typedef struct {
+    uint16_t devAddress;
+    void    *ctx;
+    HAL_StatusTypeDef (*read) (void *ctx, uint8_t reg, uint8_t *data, uint16_t len);
+    HAL_StatusTypeDef (*write)(void *ctx, uint8_t reg, const uint8_t *data, uint16_t len);
+    void (*step)(void *ctx, uint32_t now_ms, uint32_t dt_ms); /* optional, called on clock advance */
+} HostI2C_Device;
+
+/* Per-address bus counters (reads/writes count transactions, bytes count payload only) */
+typedef struct {
+    uint32_t reads;
+    uint32_t writes;
+    uint32_t bytes;
+    uint32_t errors;   /* injected failures + NACKs from unattached addresses */
+} HostI2C_Stats;
+
+/* Detach all devices, clear statistics, reset the virtual clock to 0 and
+ * erase the flash */
+void HostHal_reset(void);
+
+/* Register an emulator. Returns 0 on success, -1 if the table is full. */
+int  HostHal_attachI2C(const HostI2C_Device *dev);
+/* Put dev in front of the device already attached at its address (stats,
+ * injected errors and the attach order are kept); *prev receives the
+ * replaced descriptor so the wrapper can forward to it. -1 if none. */
+int  HostHal_interposeI2C(const HostI2C_Device *dev, HostI2C_Device *prev);
+
+/* Advance the virtual clock; every attached device's step() sees the delta.
+ * With a tick hook installed the clock moves 1 ms at a time: devices step,
+ * then the hook runs, like SysTick (it may call HostHal_* but not advance
+ * the clock). A program that polls HAL_GetTick() without anything else
+ * moving the clock (a busy wait) sees it advance 1 ms every
+ * HOST_HAL_SPIN_READS reads, so it cannot spin forever on frozen time.
+ * HostHal_reset removes the hook. */
+#define HOST_HAL_SPIN_READS  64u
+void     HostHal_advanceMs(uint32_t ms);
+void     HostHal_setTickHook(void (*hook)(void));
+uint32_t HostHal_nowMs(void);
+/* Sub-millisecond steps for Latency_NowUs(); whole milliseconds carry into
+ * the tick through HostHal_advanceMs() */
+void     HostHal_advanceUs(uint32_t us);
+
+/* Host CPU time for benchmarks: the TSC on x86, nanoseconds elsewhere
+ * (HOST_HAL_CYCLE_UNIT). Only meaningful relative to other host figures. */
+#if defined(__x86_64__) || defined(__i386__)
+#define HOST_HAL_CYCLE_UNIT "cycles"
+#else
+#define HOST_HAL_CYCLE_UNIT "ns"
+#endif
+uint64_t HostHal_cycles(void);
+
+/* Make the next `count` transactions to devAddress fail with `status` */
+void HostHal_injectI2CErrors(uint16_t devAddress, uint16_t count, HAL_StatusTypeDef status);
+
+/* Bus time model: every transaction advances the virtual clock (through
+ * HostHal_advanceUs) by txn_us of framing plus byte_us per payload byte; a
+ * failed transaction costs the framing only. E.g. 300 / 90 for 100 kHz.
+ * HostHal_reset restores 0 / 0 (transfers take no time). */
+void HostHal_setI2CTiming(uint32_t txn_us, uint32_t byte_us);
+
+/* Counters for one device address (zeroed struct if never addressed) */
+HostI2C_Stats HostHal_getI2CStats(uint16_t devAddress);
+
+/* Fault log region (faultlog.h) as NOR flash: erased by HostHal_reset, a
+ * double word can only be programmed while erased, a page erase keeps the
+ * flash busy for HOST_HAL_FLASH_ERASE_MS of virtual time. The image is
+ * FAULTLOG_PAGES * FAULTLOG_PAGE_SIZE bytes, laid out as on the target. */
+uint8_t *HostHal_flashImage(void);
+uint32_t HostHal_flashEraseCount(uint32_t page);
+
+/* Configuration store slots (config_store.h), same NOR rules; an erase
+ * blocks and advances the clock by HOST_HAL_FLASH_ERASE_MS. The image is
+ * CONFIG_STORE_SLOTS * CONFIG_STORE_PAGE_SIZE bytes. After
+ * HostHal_failConfigProgramAfter(n) the n-th double-word program from then
+ * on fails and the image is left as written so far (a reset mid-commit). */
+uint8_t *HostHal_configImage(void);
+void     HostHal_failConfigProgramAfter(uint32_t count);
+
+/* IWDG (watchdog.h): expired once the virtual clock has run more than the
+ * timeout past the last refresh. HostHal_watchdogReset stops it and sets
+ * the reset flag Watchdog_HwTookReset reports; the harness then re-runs
+ * the init code (.noinit state in watchdog.c is kept). HostHal_reset
+ * clears both. */
+uint8_t HostHal_watchdogExpired(void);
+void    HostHal_watchdogReset(void);
+
+/* RAM for memstats.h: HOST_HAL_RAM_BYTES laid out as .data / .bss (first
+ * half), heap, stack (last 1 KB reserved). The stack pointer starts 256
+ * bytes below the top; the harness writes the image to play stack and heap
+ * use. Zeroed by HostHal_reset. */
+uint8_t *HostHal_ramImage(void);
+void     HostHal_setStackPointer(uintptr_t sp);
+
+/* Board for builds of main.c (stm32g0xx_hal.h shim): GPIO outputs, hi2c1,
+ * and lowpower.h without LPTIM / Stop. LowPower_Idle moves the clock on
+ * 1 ms at a time until the next task is due or a wake event arrives, so an
+ * idle firmware runs as fast as the emulators step. HostHal_extiFalling
+ * plays a falling edge on one of the main.h EXTI pins. */
+void HostHal_extiFalling(uint16_t pin);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_HAL_H_ */
@@ -0,0 +1,54 @@
+/*
+ * i2c_rec_test.c
+ *
+ *  I2C flight recorder (i2c_rec.h): record layout (header, payload only
+ *  when data moved), a sync record over a long gap, overwrite of the
+ *  oldest records with the snapshot's base tick following, and the dump
+ *  request handshake. Replay of a whole recording is i2c_replay's job.
+ *
+ *    i2c_rec_test
+ *
+ *  Exits non-zero if a check fails (`make run`).
+ */
+#include <stdio.h>
+#include "host_hal.h"
+#include "i2c_rec.h"
+#include "bq76907.h"
+#include "bq25798.h"
+
+#define HOST_CHECK_TAG "[I2CREC]"
+#include "host_check.h"
+
+int main(void){
+    HostHal_reset();
+
+    I2CRec_Init();
+    uint32_t recT0 = HostHal_nowMs();
+    const uint8_t recW[2] = { 0x12, 0x34 }, recR[3] = { 1, 2, 3 };
+    HostHal_advanceMs(3);
+    I2CRec_Note(BQ25798_I2C_ADDRESS, 0x0F, recW, 2, 1, HAL_OK);
+    I2CRec_Note(BQ76907_I2C_ADDRESS, 0x14, recR, 3, 0, HAL_OK);
+    I2CRec_Note(BQ76907_I2C_ADDRESS, 0x14, recR, 3, 0, HAL_ERROR);
+    HostHal_advanceMs(70000);
+    I2CRec_Note(BQ76907_I2C_ADDRESS, 0x00, recR, 1, 0, HAL_OK);
+    uint8_t recBuf[64];
+    uint32_t recBase = 0;
+    uint32_t recLen = I2CRec_Snapshot(recBuf, sizeof(recBuf), &recBase);
+    CHECK(recLen == 7u + 8u + 5u + I2C_REC_SYNC_BYTES + 6u && recBase == recT0 &&
+          recBuf[0] == 0x82 && recBuf[1] == 0x6B && recBuf[3] == 3 && recBuf[5] == 0x12 &&
+          recBuf[7] == 0x03 && recBuf[15] == (0x20 | 3) && recBuf[20] == I2C_REC_SYNC,
+          "recorder: header, payload only when data moved, sync");
+    for (uint32_t i = 0; i < I2C_REC_RING_BYTES / 8u; i++){
+        HostHal_advanceMs(10);
+        I2CRec_Note(BQ76907_I2C_ADDRESS, 0x14, recR, 3, 0, HAL_OK);
+    }
+    I2CRec_Snapshot(recBuf, sizeof(recBuf), &recBase);
+    CHECK(I2CRec_GetStats()->overwritten > 0 && I2CRec_Used() <= I2C_REC_RING_BYTES &&
+          recBuf[0] == 0x03 && recBase == HostHal_nowMs() - (I2CRec_Used() / 8u) * 10u,
+          "recorder: oldest records overwritten, base tick follows");
+    I2CRec_RequestDump();
+    CHECK(I2CRec_TakeDumpRequest() && !I2CRec_TakeDumpRequest(), "recorder dump request consumed");
+    I2CRec_LogStats();
+
+    return HostCheck_result();
+}
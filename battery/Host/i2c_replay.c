@@ -0,0 +1,378 @@
+/*
+ * i2c_replay.c
+ *
+ *  Replays an I2C flight recording (i2c_rec.h) through the firmware:
+ *  Core/Src/main.c and the drivers run on the virtual clock as in fw_sim,
+ *  but the BQ76907 / BQ25798 answer from the recording instead of the pack.
+ *
+ *    i2c_replay [-o start_ms] [-w slack_ms] [-l log] capture
+ *
+ *  capture is a console log holding an "[I2CREC] begin ... end" dump (the
+ *  last one is used), e.g. a UART capture from the field or
+ *  build/fw_sim.log. Replay time t is recording tick start + t; start
+ *  defaults to the recorder's start when the ring never wrapped (the boot
+ *  is in the recording) and to I2C_REPLAY_LEAD_MS before the first record
+ *  otherwise, which gives the firmware time to boot.
+ *
+ *  A read returns, per register, the value last recorded at or before the
+ *  mapped time (the first recorded value before that); registers the
+ *  recording never read come from the emulators' POR state, which also
+ *  take every write. A recorded failure is returned to the first
+ *  transaction to that device at or after its time. The firmware's own
+ *  transactions are then matched against the recorded ones (device,
+ *  direction, register, length, written data) within slack_ms; recorded
+ *  transactions the firmware did not repeat are "missing", new ones
+ *  "extra". Interrupts are not in the recording, so the replayed firmware
+ *  only polls.
+ *
+ *  Everything runs on the virtual clock, so a replay is deterministic and
+ *  takes milliseconds: exits non-zero on any divergence, which makes it a
+ *  `git bisect run` script against field data.
+ */
+#define _GNU_SOURCE   /* memmem */
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "host_hal.h"
+#include "main.h"
+#include "i2c_rec.h"
+#include "bq76907_emu.h"
+#include "bq25798_emu.h"
+#include "watchdog.h"
+
+#define I2C_REPLAY_LEAD_MS   2000u   /* firmware boot ahead of a wrapped recording */
+#define I2C_REPLAY_SLACK_MS  1000u   /* default match window, > the poll phase drift */
+#define I2C_REPLAY_DEVICES   2
+
+int Firmware_main(void);
+
+typedef struct {
+    uint32_t tick;
+    uint8_t  addr;          /* 7-bit */
+    uint8_t  reg, len, write;
+    uint8_t  status;
+    uint8_t  data[I2C_REC_MAX_LEN];
+    uint8_t  hasData;
+    uint8_t  used;          /* matched, or failure already returned */
+} Txn;
+
+typedef struct {
+    Txn     *v;
+    uint32_t n, cap;
+} TxnList;
+
+typedef struct {
+    HostI2C_Device inner;   /* emulator behind the recording */
+    uint8_t        addr;
+} ReplayDevice;
+
+static TxnList recorded, replayed;
+static ReplayDevice devices[I2C_REPLAY_DEVICES];
+static uint32_t recStart, recBase, recFirst, recLast, recOverwritten;
+static uint32_t fromRecording, fromEmulator, injected;
+static uint32_t endMs, wdgExpiredAt;
+static jmp_buf replayEnd;
+
+static Txn *push(TxnList *l){
+    if (l->n == l->cap){
+        l->cap = l->cap ? l->cap * 2u : 256u;
+        l->v = realloc(l->v, l->cap * sizeof(Txn));
+        if (!l->v){
+            perror("realloc");
+            exit(1);
+        }
+    }
+    memset(&l->v[l->n], 0, sizeof(Txn));
+    return &l->v[l->n++];
+}
+
+/* ================= Capture parsing ================= */
+static int hexNibble(char c){
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+/* Last complete dump in the capture into buf; the console also carries
+ * binary TRACE records, so lines are searched, not parsed from the start */
+static long loadDump(const char *path, uint8_t **out){
+    FILE *f = fopen(path, "rb");
+    if (!f){
+        perror(path);
+        return -1;
+    }
+    char *line = NULL;
+    size_t lineCap = 0;
+    ssize_t len;
+    uint8_t *buf = NULL;
+    size_t n = 0, cap = 0;
+    long result = -1;
+    int inDump = 0;
+    while ((len = getline(&line, &lineCap, f)) > 0){
+        char *p = memmem(line, (size_t)len, "[I2CREC] ", 9);
+        if (!p) continue;
+        p += 9;
+        unsigned long base, bytes, records, over;
+        if (sscanf(p, "begin tick=%lu bytes=%lu records=%lu overwritten=%lu",
+                   &base, &bytes, &records, &over) == 4){
+            inDump = 1;
+            n = 0;
+            recBase = (uint32_t)base;
+            recOverwritten = (uint32_t)over;
+            continue;
+        }
+        if (!inDump) continue;
+        if (!strncmp(p, "end", 3)){
+            inDump = 0;
+            free(*out);
+            *out = malloc(n ? n : 1u);
+            memcpy(*out, buf, n);
+            result = (long)n;
+            continue;
+        }
+        for (; hexNibble(p[0]) >= 0 && hexNibble(p[1]) >= 0; p += 2){
+            if (n == cap){
+                cap = cap ? cap * 2u : 4096u;
+                buf = realloc(buf, cap);
+            }
+            buf[n++] = (uint8_t)(hexNibble(p[0]) << 4 | hexNibble(p[1]));
+        }
+    }
+    free(line);
+    free(buf);
+    fclose(f);
+    return result;
+}
+
+static int decode(const uint8_t *b, uint32_t n){
+    uint32_t tick = recBase;
+    for (uint32_t i = 0; i < n; ){
+        if (b[i] == I2C_REC_SYNC){
+            if (i + I2C_REC_SYNC_BYTES > n) return -1;
+            tick = (uint32_t)b[i + 1] | (uint32_t)b[i + 2] << 8 | (uint32_t)b[i + 3] << 16 | (uint32_t)b[i + 4] << 24;
+            i += I2C_REC_SYNC_BYTES;
+            continue;
+        }
+        if (i + I2C_REC_HEADER > n) return -1;
+        Txn *t = push(&recorded);
+        t->write  = (b[i] >> 7) & 1u;
+        t->status = (b[i] >> 5) & 3u;
+        t->len    = b[i] & 0x1Fu;
+        t->addr   = b[i + 1];
+        t->reg    = b[i + 2];
+        tick += (uint32_t)b[i + 3] | (uint32_t)b[i + 4] << 8;
+        t->tick   = tick;
+        t->hasData = t->write || t->status == HAL_OK;
+        i += I2C_REC_HEADER;
+        if (t->hasData){
+            if (t->len == 0 || i + t->len > n) return -1;
+            memcpy(t->data, &b[i], t->len);
+            i += t->len;
+        }
+    }
+    return 0;
+}
+
+/* ================= Recorded devices ================= */
+static uint32_t mappedNow(void){ return recStart + HostHal_nowMs(); }
+
+/* Recorded failure due for this device, returned once */
+static HAL_StatusTypeDef dueFailure(uint8_t addr, uint32_t now){
+    for (uint32_t i = 0; i < recorded.n && recorded.v[i].tick <= now; i++){
+        Txn *t = &recorded.v[i];
+        if (t->addr == addr && t->status != HAL_OK && !t->used){
+            t->used = 1;
+            injected++;
+            return (HAL_StatusTypeDef)t->status;
+        }
+    }
+    return HAL_OK;
+}
+
+/* Value of addr:reg at now, 0 = never read in the recording */
+static int recordedByte(uint8_t addr, uint8_t reg, uint32_t now, uint8_t *value){
+    int found = 0;
+    for (uint32_t i = 0; i < recorded.n; i++){
+        const Txn *t = &recorded.v[i];
+        if (t->write || !t->hasData || t->addr != addr || reg < t->reg || reg >= t->reg + t->len) continue;
+        if (found && t->tick > now) break;
+        *value = t->data[reg - t->reg];
+        found = 1;
+    }
+    return found;
+}
+
+static void note(uint8_t addr, uint8_t reg, const uint8_t *data, uint16_t len, uint8_t write,
+                 HAL_StatusTypeDef st){
+    Txn *t = push(&replayed);
+    t->tick = mappedNow();
+    t->addr = addr;
+    t->reg = reg;
+    t->len = (uint8_t)len;
+    t->write = write;
+    t->status = (uint8_t)st;
+    t->hasData = write;
+    if (write) memcpy(t->data, data, len < I2C_REC_MAX_LEN ? len : I2C_REC_MAX_LEN);
+}
+
+static HAL_StatusTypeDef replayRead(void *ctx, uint8_t reg, uint8_t *data, uint16_t len){
+    ReplayDevice *d = ctx;
+    uint32_t now = mappedNow();
+    HAL_StatusTypeDef st = dueFailure(d->addr, now);
+    if (st == HAL_OK) st = d->inner.read(d->inner.ctx, reg, data, len);
+    if (st == HAL_OK){
+        for (uint16_t i = 0; i < len; i++){
+            if (recordedByte(d->addr, (uint8_t)(reg + i), now, &data[i])) fromRecording++;
+            else fromEmulator++;
+        }
+    }
+    note(d->addr, reg, data, len, 0, st);
+    return st;
+}
+
+static HAL_StatusTypeDef replayWrite(void *ctx, uint8_t reg, const uint8_t *data, uint16_t len){
+    ReplayDevice *d = ctx;
+    HAL_StatusTypeDef st = dueFailure(d->addr, mappedNow());
+    if (st == HAL_OK) st = d->inner.write(d->inner.ctx, reg, data, len);
+    note(d->addr, reg, data, len, 1, st);
+    return st;
+}
+
+static void replayStep(void *ctx, uint32_t now_ms, uint32_t dt_ms){
+    ReplayDevice *d = ctx;
+    if (d->inner.step) d->inner.step(d->inner.ctx, now_ms, dt_ms);
+}
+
+static void interpose(ReplayDevice *d, uint16_t devAddress){
+    HostI2C_Device dev = {
+        .devAddress = devAddress,
+        .ctx   = d,
+        .read  = replayRead,
+        .write = replayWrite,
+        .step  = replayStep,
+    };
+    d->addr = (uint8_t)(devAddress >> 1);
+    HostHal_interposeI2C(&dev, &d->inner);
+}
+
+/* SysTick: watchdog supervision and the end of the recording */
+static void replayTick(void){
+    Watchdog_TickISR();
+    if (HostHal_watchdogExpired()){
+        wdgExpiredAt = HostHal_nowMs();
+        longjmp(replayEnd, 1);
+    }
+    if (HostHal_nowMs() >= endMs) longjmp(replayEnd, 1);
+}
+
+/* ================= Comparison ================= */
+static int sameKey(const Txn *a, const Txn *b){
+    return a->addr == b->addr && a->write == b->write && a->reg == b->reg && a->len == b->len &&
+           (!a->write || !memcmp(a->data, b->data, a->len));
+}
+
+static void printTxn(const char *what, const Txn *t){
+    printf("[REPLAY] %-7s t=%lu 0x%02X %s reg 0x%02X len %u", what, (unsigned long)(t->tick - recStart),
+           t->addr, t->write ? "W" : "R", t->reg, t->len);
+    if (t->write){
+        printf(" data");
+        for (uint8_t i = 0; i < t->len; i++) printf(" %02X", t->data[i]);
+    }
+    printf("\n");
+}
+
+int main(int argc, char **argv){
+    const char *log = "build/i2c_replay.log";
+    uint32_t slack = I2C_REPLAY_SLACK_MS;
+    long startOpt = -1;
+    int opt;
+    while ((opt = getopt(argc, argv, "o:w:l:")) != -1){
+        switch (opt){
+        case 'o': startOpt = atol(optarg); break;
+        case 'w': slack = (uint32_t)atol(optarg); break;
+        case 'l': log = optarg; break;
+        default: optind = argc + 1; break;
+        }
+    }
+    if (optind != argc - 1){
+        fprintf(stderr, "usage: %s [-o start_ms] [-w slack_ms] [-l log] capture\n", argv[0]);
+        return 2;
+    }
+    uint8_t *dump = NULL;
+    long bytes = loadDump(argv[optind], &dump);
+    if (bytes < 0 || decode(dump, (uint32_t)bytes) != 0 || recorded.n == 0){
+        fprintf(stderr, "%s: no complete [I2CREC] dump\n", argv[optind]);
+        return 1;
+    }
+    free(dump);
+    recFirst = recorded.v[0].tick;
+    recLast = recorded.v[recorded.n - 1].tick;
+    if (startOpt >= 0) recStart = (uint32_t)startOpt;
+    else if (recOverwritten) recStart = recFirst > I2C_REPLAY_LEAD_MS ? recFirst - I2C_REPLAY_LEAD_MS : 0;
+    else recStart = recBase;
+    /* Compared window: all of it when the boot is in the recording */
+    uint32_t winLo = recOverwritten || startOpt >= 0 ? recFirst + slack : recStart;
+    uint32_t winHi = recLast > slack ? recLast - slack : 0;
+
+    fflush(stdout);
+    int console = dup(fileno(stdout));
+    if (console < 0 || !freopen(log, "wb", stdout)){
+        perror(log);
+        return 1;
+    }
+    static PackModel pack;
+    static PackModel_SimpleState packState;
+    static BQ76907_Emu mon;
+    static BQ25798_Emu chg;
+    HostHal_reset();
+    HostHal_setI2CTiming(300, 90);                      /* 100 kHz */
+    PackModel_initSimple(&pack, &packState, 4, 20000, 50);
+    BQ25798_Emu_init(&chg, &pack);
+    BQ76907_Emu_init(&mon, &pack);
+    BQ25798_Emu_attach(&chg);
+    BQ76907_Emu_attach(&mon);
+    interpose(&devices[0], BQ25798_I2C_ADDRESS);
+    interpose(&devices[1], BQ76907_I2C_ADDRESS);
+    HostHal_setTickHook(replayTick);
+    endMs = recLast + slack - recStart;
+    if (setjmp(replayEnd) == 0) Firmware_main();       /* never returns */
+    fflush(stdout);
+    dup2(console, fileno(stdout));
+    close(console);
+
+    uint32_t missing = 0, extra = 0, compared = 0;
+    for (uint32_t i = 0; i < recorded.n; i++) recorded.v[i].used = 0;
+    for (uint32_t i = 0; i < recorded.n; i++){
+        Txn *r = &recorded.v[i];
+        if (r->tick < winLo || r->tick > winHi) continue;
+        compared++;
+        Txn *best = NULL;
+        for (uint32_t j = 0; j < replayed.n; j++){
+            Txn *p = &replayed.v[j];
+            if (p->used || !sameKey(r, p)) continue;
+            uint32_t d = p->tick > r->tick ? p->tick - r->tick : r->tick - p->tick;
+            if (d > slack) continue;
+            if (!best || d < (best->tick > r->tick ? best->tick - r->tick : r->tick - best->tick)) best = p;
+        }
+        if (best) best->used = r->used = 1;
+        else if (missing++ < 10) printTxn("missing", r);
+    }
+    for (uint32_t j = 0; j < replayed.n; j++){
+        Txn *p = &replayed.v[j];
+        if (p->used || p->tick < winLo || p->tick > winHi) continue;
+        if (extra++ < 10) printTxn("extra", p);
+    }
+    printf("[REPLAY] %lu recorded transaction(s) over %lu ms (tick %lu..%lu), %lu replayed, log in %s\n",
+           (unsigned long)recorded.n, (unsigned long)(recLast - recFirst), (unsigned long)recFirst,
+           (unsigned long)recLast, (unsigned long)replayed.n, log);
+    printf("[REPLAY] read bytes %lu from the recording, %lu from the emulators; %lu failure(s) replayed\n",
+           (unsigned long)fromRecording, (unsigned long)fromEmulator, (unsigned long)injected);
+    if (wdgExpiredAt) printf("[REPLAY] IWDG reset at t=%lu ms\n", (unsigned long)wdgExpiredAt);
+    printf("[REPLAY] compared %lu, %lu missing, %lu extra: %s\n", (unsigned long)compared,
+           (unsigned long)missing, (unsigned long)extra,
+           missing || extra || wdgExpiredAt ? "DIVERGED" : "MATCH");
+    return missing || extra || wdgExpiredAt ? 1 : 0;
+}
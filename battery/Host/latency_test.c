@@ -0,0 +1,78 @@
+/*
+ * latency_test.c
+ *
+ *  Latency histograms (latency.h): samples land in log2 buckets,
+ *  percentiles come from the buckets, the microsecond clock carries into
+ *  the HAL tick, and the scheduler's per task and the bus scheduler's per
+ *  device histograms fill from real runs (a 40 ms task, reads from the
+ *  BQ76907 emulator).
+ *
+ *    latency_test
+ *
+ *  Exits non-zero if a check fails (`make run`).
+ */
+#include <stdio.h>
+#include "host_hal.h"
+#include "bq76907_emu.h"
+#include "i2c_bus.h"
+#include "scheduler.h"
+#include "latency.h"
+
+#define HOST_CHECK_TAG "[LAT]"
+#include "host_check.h"
+
+static void taskSlow(void){ HostHal_advanceMs(40); }
+static const Scheduler_Task slowTable[1] = {
+    { "slow", taskSlow, 1000, 0, 20, 1, 0 },
+};
+
+int main(void){
+    static I2C_HandleTypeDef hi2c1;
+    static BQ76907 mon;
+    PackModel pack; PackModel_SimpleState packState;
+    BQ76907_Emu emu;
+
+    HostHal_reset();
+    Latency_Init();
+
+    static Latency_Hist lh;
+    const uint32_t samples[] = { 0, 1, 2, 3, 700, 1023, 1024, 1u << 30 };
+    for (unsigned i = 0; i < sizeof(samples) / sizeof(samples[0]); i++) Latency_Record(&lh, samples[i]);
+    CHECK(lh.bucket[0] == 2 && lh.bucket[1] == 2 && lh.bucket[9] == 2 && lh.bucket[10] == 1 &&
+          lh.bucket[LATENCY_BUCKETS - 1] == 1 && lh.count == 8, "latency samples land in log2 buckets");
+    CHECK(Latency_Percentile(&lh, 50) == 3 && Latency_Percentile(&lh, 99) == (1u << 30),
+          "latency percentiles from buckets");
+
+    uint32_t us0 = Latency_NowUs(), ms0 = HostHal_nowMs();
+    HostHal_advanceUs(600);
+    HostHal_advanceUs(900);
+    CHECK(Latency_NowUs() - us0 == 1500u && HostHal_nowMs() - ms0 == 1u, "microsecond clock carries into the tick");
+
+    /* Task execution time: five runs of 40 ms */
+    uint32_t t0 = HostHal_nowMs();
+    Scheduler_Init(slowTable, 1, t0);
+    while (HostHal_nowMs() - t0 < 5000u){
+        Scheduler_RunReady(1);
+        HostHal_advanceMs(1);
+    }
+    const Latency_Hist *slowHist = &Scheduler_GetStats(0)->exec;
+    CHECK(slowHist->count == Scheduler_GetStats(0)->runs && slowHist->count > 0 && slowHist->bucket[15] == slowHist->count,
+          "task exec time histogram (40 ms in 2^15 us)");
+
+    /* Bus transactions, timed per device */
+    PackModel_initSimple(&pack, &packState, 4, 200, 60);
+    BQ76907_Emu_init(&emu, &pack);
+    BQ76907_Emu_attach(&emu);
+    I2CBus_Init(&hi2c1);
+    HostHal_setI2CTiming(300, 90);
+    BQ76907_init(&mon, &hi2c1);
+    BQ76907_readCellVoltages(&mon);
+    HostHal_setI2CTiming(0, 0);
+    const Latency_Hist *monHist = I2CBus_GetLatency(BQ76907_I2C_ADDRESS);
+    CHECK(monHist && monHist->count > 0 && I2CBus_GetLatency(0x7E) == NULL, "I2C transaction histogram per device");
+
+    Latency_Print("task", "slow", slowHist);
+    Latency_Print("i2c", "bq76907", monHist);
+
+    return HostCheck_result();
+}
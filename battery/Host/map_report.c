@@ -0,0 +1,173 @@
+/*
+ * map_report.c
+ *
+ *  Flash and RAM use per module from a GNU ld map file. Link with
+ *  -Wl,-Map=<file> (CubeIDE writes Debug/<project>.map already), then
+ *
+ *    map_report <file.map> [rows]     rows defaults to 20, 0 = all
+ *
+ *  Input sections are attributed to their object file (archive members to
+ *  the archive) and counted by output section: .isr_vector / .text /
+ *  .rodata / init-fini arrays are flash, .bss / .noinit / the heap and
+ *  stack reserve are RAM, .data counts in both (initial values in flash).
+ *  What an output section holds beyond its input sections (alignment fill,
+ *  reserves) goes to "(linker)". Region totals use the FLASH and RAM lines
+ *  of the map's memory configuration when it has them.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_MODULES 512
+#define NAME_LEN    64
+
+enum { SEC_NONE = 0, SEC_FLASH = 1, SEC_RAM = 2, SEC_BOTH = 3 };
+
+typedef struct {
+    char          name[NAME_LEN];
+    unsigned long flash, ram;
+} Module;
+
+static Module modules[MAX_MODULES];
+static int moduleCount;
+
+static Module *module(const char *path){
+    char name[NAME_LEN];
+    const char *base = path;
+    const char *paren = path[0] ? strchr(path + 1, '(') : NULL;   /* lib.a(member.o) */
+    const char *end = paren ? paren : path + strlen(path);
+    for (const char *p = path; p < end; p++) if (*p == '/' || *p == '\\') base = p + 1;
+    size_t n = (size_t)(end - base) < NAME_LEN - 1 ? (size_t)(end - base) : NAME_LEN - 1;
+    memcpy(name, base, n);
+    name[n] = '\0';
+    for (int i = 0; i < moduleCount; i++) if (!strcmp(modules[i].name, name)) return &modules[i];
+    if (moduleCount == MAX_MODULES) return &modules[MAX_MODULES - 1];   /* overflow lumped in */
+    Module *m = &modules[moduleCount++];
+    strcpy(m->name, name);
+    return m;
+}
+
+static int kindOf(const char *sec){
+    static const char *const flash[] = { ".isr_vector", ".text", ".rodata", ".ARM.extab", ".ARM",
+                                         ".preinit_array", ".init_array", ".fini_array", ".init", ".fini" };
+    static const char *const ram[] = { ".bss", ".noinit", "._user_heap_stack" };
+    for (size_t i = 0; i < sizeof(flash) / sizeof(flash[0]); i++) if (!strcmp(sec, flash[i])) return SEC_FLASH;
+    for (size_t i = 0; i < sizeof(ram) / sizeof(ram[0]); i++) if (!strcmp(sec, ram[i])) return SEC_RAM;
+    return strcmp(sec, ".data") ? SEC_NONE : SEC_BOTH;
+}
+
+static void add(Module *m, int kind, unsigned long size){
+    if (kind & SEC_FLASH) m->flash += size;
+    if (kind & SEC_RAM) m->ram += size;
+}
+
+static int isHex(const char *s){
+    return s && s[0] == '0' && s[1] == 'x';
+}
+
+static int byTotal(const void *a, const void *b){
+    const Module *x = a, *y = b;
+    unsigned long tx = x->flash + x->ram, ty = y->flash + y->ram;
+    return tx < ty ? 1 : tx > ty ? -1 : strcmp(x->name, y->name);
+}
+
+int main(int argc, char **argv){
+    if (argc < 2){
+        fprintf(stderr, "usage: %s <file.map> [rows]\n", argv[0]);
+        return 2;
+    }
+    FILE *f = fopen(argv[1], "r");
+    if (!f){
+        perror(argv[1]);
+        return 1;
+    }
+    int rows = argc > 2 ? atoi(argv[2]) : 20;
+
+    char line[1024], outName[NAME_LEN] = "";
+    int inMemCfg = 0, inMap = 0, kind = SEC_NONE, pendingOut = 0, pendingIn = 0;
+    unsigned long outSize = 0, outInputs = 0, flashLen = 0, ramLen = 0;
+    Module *linker = NULL;
+
+    while (fgets(line, sizeof(line), f)){
+        char a[NAME_LEN * 4] = "", b[64] = "", c[64] = "", d[512] = "";
+        int n = sscanf(line, "%255s %63s %63s %511s", a, b, c, d);
+        if (!strncmp(line, "Memory Configuration", 20)){ inMemCfg = 1; continue; }
+        if (!strncmp(line, "Linker script and memory map", 28)){ inMemCfg = 0; inMap = 1; continue; }
+        if (inMemCfg){
+            if (n >= 3 && isHex(c)){
+                if (!strcmp(a, "FLASH")) flashLen = strtoul(c, NULL, 16);
+                if (!strcmp(a, "RAM")) ramLen = strtoul(c, NULL, 16);
+            }
+            continue;
+        }
+        if (!inMap || n <= 0) continue;
+
+        /* Output section: name in column 0, address and size on this or the next line.
+         * Anything else in column 0 (/DISCARD/, LOAD, OUTPUT) ends the section. */
+        if (line[0] != ' ' || pendingOut){
+            if (!linker) linker = module("(linker)");
+            if (kind != SEC_NONE && outSize > outInputs) add(linker, kind, outSize - outInputs);
+            if (!pendingOut){
+                snprintf(outName, sizeof(outName), "%s", a);
+                kind = line[0] == '.' ? kindOf(outName) : SEC_NONE;
+                outSize = outInputs = 0;
+                if (n == 1){ pendingOut = 1; continue; }
+                memmove(b, c, sizeof(c));
+            }
+            pendingOut = 0;
+            outSize = isHex(b) ? strtoul(b, NULL, 16) : 0;
+            continue;
+        }
+        if (kind == SEC_NONE) continue;
+
+        /* Input section: " .name addr size file", long names wrap after the name */
+        if (pendingIn){
+            pendingIn = 0;
+            if (n >= 3 && isHex(a) && isHex(b)){
+                unsigned long size = strtoul(b, NULL, 16);
+                add(module(c), kind, size);
+                outInputs += size;
+            }
+            continue;
+        }
+        if (line[0] == ' ' && line[1] != ' ' && (a[0] == '.' || !strcmp(a, "COMMON"))){
+            if (n == 1){
+                pendingIn = 1;
+            } else if (n >= 4 && isHex(b) && isHex(c)){
+                unsigned long size = strtoul(c, NULL, 16);
+                add(module(d), kind, size);
+                outInputs += size;
+            }
+        }
+    }
+    if (linker && kind != SEC_NONE && outSize > outInputs) add(linker, kind, outSize - outInputs);
+    fclose(f);
+
+    unsigned long flash = 0, ram = 0;
+    for (int i = 0; i < moduleCount; i++){
+        flash += modules[i].flash;
+        ram += modules[i].ram;
+    }
+    qsort(modules, (size_t)moduleCount, sizeof(modules[0]), byTotal);
+    printf("[MAP] %-32s %9s %9s\n", "module", "flash", "ram");
+    unsigned long restF = 0, restR = 0;
+    int shown = 0;
+    for (int i = 0; i < moduleCount; i++){
+        if (!modules[i].flash && !modules[i].ram) continue;
+        if (rows && shown >= rows){
+            restF += modules[i].flash;
+            restR += modules[i].ram;
+            continue;
+        }
+        printf("[MAP] %-32s %9lu %9lu\n", modules[i].name, modules[i].flash, modules[i].ram);
+        shown++;
+    }
+    if (restF || restR) printf("[MAP] %-32s %9lu %9lu\n", "(others)", restF, restR);
+    printf("[MAP] %-32s %9lu %9lu\n", "total", flash, ram);
+    if (flashLen) printf("[MAP] FLASH %lu of %lu bytes (%lu%%), %lu free\n", flash, flashLen,
+                         flash * 100u / flashLen, flash < flashLen ? flashLen - flash : 0);
+    if (ramLen) printf("[MAP] RAM   %lu of %lu bytes (%lu%%), %lu free (heap and stack reserves counted as used)\n",
+                       ram, ramLen, ram * 100u / ramLen, ram < ramLen ? ramLen - ram : 0);
+    return 0;
+}
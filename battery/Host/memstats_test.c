@@ -0,0 +1,46 @@
+/*
+ * memstats_test.c
+ *
+ *  Stack / heap watermarks (memstats.h) on the host RAM image: the stack
+ *  is painted below the current stack pointer, the high-water mark follows
+ *  what a deeper call overwrote, _sbrk growth, peak and refusals are
+ *  accounted, and the heap peak is not mistaken for stack use.
+ *
+ *    memstats_test
+ *
+ *  Exits non-zero if a check fails (`make run`).
+ */
+#include <stdio.h>
+#include <string.h>
+#include "host_hal.h"
+#include "memstats.h"
+
+#define HOST_CHECK_TAG "[MEM]"
+#include "host_check.h"
+
+int main(void){
+    HostHal_reset();
+
+    /* Paint, play 1500 bytes of stack and a 300 byte heap */
+    uint8_t *ramImg = HostHal_ramImage();
+    HostHal_setStackPointer((uintptr_t)ramImg + HOST_HAL_RAM_BYTES - 256u);
+    MemStats_PaintStack();
+    CHECK(MemStats_GetStats()->painted == HOST_HAL_RAM_BYTES / 2u - 256u - MEMSTATS_PAINT_GUARD &&
+          MemStats_StackHighWater() == 256u + MEMSTATS_PAINT_GUARD, "fresh paint: nothing below the guard touched");
+    memset(ramImg + HOST_HAL_RAM_BYTES - 1500u, 0x5A, 1500u - 256u - MEMSTATS_PAINT_GUARD);
+    CHECK(MemStats_StackHighWater() == 1500u, "stack high-water mark");
+    MemStats_NoteSbrk(300, 1);
+    memset(ramImg + HOST_HAL_RAM_BYTES / 2u, 0, 300);
+    MemStats_NoteSbrk(0x10000, 0);
+    MemStats_NoteSbrk(120, 1);
+    const MemStats_Stats *ms = MemStats_GetStats();
+    CHECK(ms->heapSize == 120 && ms->heapPeak == 300 && ms->sbrkCalls == 3 && ms->sbrkFailures == 1,
+          "_sbrk accounting: size, peak, refusals");
+    CHECK(MemStats_StackHighWater() == 1500u &&
+          MemStats_StackFree() == HOST_HAL_RAM_BYTES / 2u - 300u - 1500u, "heap peak not counted as stack");
+    MemStats_RequestReport();
+    if (MemStats_TakeReportRequest()) MemStats_Report();
+    CHECK(!MemStats_TakeReportRequest(), "memory report request consumed");
+
+    return HostCheck_result();
+}
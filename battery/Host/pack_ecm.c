@@ -0,0 +1,127 @@
+/*
+ * pack_ecm.c
+ *
+ *  Equivalent-circuit pack model. See pack_ecm.h for the circuit.
+ */
+#include "pack_ecm.h"
+#include <math.h>
+#include <string.h>
+
+/* LFP open-circuit voltage, SOC 0..100 % in 5 % steps */
+static const float ocvTable[PACK_ECM_OCV_POINTS] = {
+    2500, 3000, 3180, 3220, 3250, 3265, 3280, 3290, 3300, 3305, 3310,
+    3315, 3320, 3325, 3330, 3335, 3340, 3350, 3380, 3450, 3600,
+};
+
+float PackEcm_ocv_mV(float soc){
+    if (soc <= 0.0f) return ocvTable[0];
+    if (soc >= 1.0f) return ocvTable[PACK_ECM_OCV_POINTS - 1] + (soc - 1.0f) * PACK_ECM_OVERCHARGE_mV;
+    float x = soc * (PACK_ECM_OCV_POINTS - 1);
+    int i = (int)x;
+    return ocvTable[i] + (ocvTable[i + 1] - ocvTable[i]) * (x - (float)i);
+}
+
+static float r0_mohm(const PackModel_EcmState *st, const PackEcm_Cell *c){
+    float f = 1.0f + st->p.r0TempCoeff * (25.0f - c->temp_C);
+    return c->r0_mohm * (f < 0.5f ? 0.5f : f);
+}
+
+float PackEcm_cellSoc(const PackModel *pm, uint8_t cell){
+    const PackModel_EcmState *st = (const PackModel_EcmState *)pm->impl;
+    if (cell >= pm->cellCount) return 0.0f;
+    return (float)(st->cell[cell].charge_mAs / st->cell[cell].capacity_mAs);
+}
+
+float PackEcm_cellTemp_C(const PackModel *pm, uint8_t cell){
+    const PackModel_EcmState *st = (const PackModel_EcmState *)pm->impl;
+    return cell < pm->cellCount ? st->cell[cell].temp_C : st->p.ambient_C;
+}
+
+static uint16_t ecm_cellVoltage(const PackModel *pm, uint8_t cell){
+    const PackModel_EcmState *st = (const PackModel_EcmState *)pm->impl;
+    if (cell >= pm->cellCount) return 0;
+    const PackEcm_Cell *c = &st->cell[cell];
+    float v = PackEcm_ocv_mV((float)(c->charge_mAs / c->capacity_mAs)) +
+              c->lastI_mA * r0_mohm(st, c) * 1e-3f + c->v1_mV + c->v2_mV;
+    if (v < 0.0f) return 0;
+    return v > 65535.0f ? 65535u : (uint16_t)(v + 0.5f);
+}
+
+static int16_t ecm_temperature(const PackModel *pm){
+    const PackModel_EcmState *st = (const PackModel_EcmState *)pm->impl;
+    float t = st->cell[0].temp_C;
+    for (uint8_t n = 1; n < pm->cellCount; n++) if (st->cell[n].temp_C > t) t = st->cell[n].temp_C;
+    return (int16_t)lrintf(t * 10.0f);
+}
+
+static void ecm_step(PackModel *pm, int32_t packCurrent_mA, const uint16_t *bleed_mA, uint32_t dt_ms){
+    PackModel_EcmState *st = (PackModel_EcmState *)pm->impl;
+    if (dt_ms == 0) return;
+    if (dt_ms != st->cachedDt_ms){
+        st->cachedDt_ms = dt_ms;
+        st->a1 = expf(-(float)dt_ms / (st->p.tau1_s * 1000.0f));
+        st->a2 = expf(-(float)dt_ms / (st->p.tau2_s * 1000.0f));
+    }
+    float dt_s = (float)dt_ms * 1e-3f;
+    float i = (float)packCurrent_mA;
+
+    for (uint8_t n = 0; n < pm->cellCount; n++){
+        PackEcm_Cell *c = &st->cell[n];
+        float bleed = bleed_mA ? (float)bleed_mA[n] : 0.0f;
+        c->charge_mAs += (double)((i - bleed - c->leak_mA) * dt_s);
+        if (c->charge_mAs < 0.0) c->charge_mAs = 0.0;
+        if (c->charge_mAs > c->capacity_mAs * PACK_ECM_MAX_SOC) c->charge_mAs = c->capacity_mAs * PACK_ECM_MAX_SOC;
+        /* mA x mOhm = uV */
+        c->v1_mV += (i * st->p.r1_mohm * 1e-3f - c->v1_mV) * (1.0f - st->a1);
+        c->v2_mV += (i * st->p.r2_mohm * 1e-3f - c->v2_mV) * (1.0f - st->a2);
+        c->lastI_mA = i;
+        /* mA^2 x mOhm = nW, mV^2 / mOhm = mW */
+        c->heat_W = i * i * r0_mohm(st, c) * 1e-9f +
+                    (c->v1_mV * c->v1_mV / st->p.r1_mohm + c->v2_mV * c->v2_mV / st->p.r2_mohm) * 1e-3f -
+                    (c->temp_C - st->p.ambient_C) / st->p.thermalR_K_W;
+    }
+    /* Conduction to the next cell, from the temperatures before this step */
+    for (uint8_t n = 0; n + 1u < pm->cellCount; n++){
+        float flow_W = (st->cell[n].temp_C - st->cell[n + 1].temp_C) / st->p.couplingR_K_W;
+        st->cell[n].heat_W -= flow_W;
+        st->cell[n + 1].heat_W += flow_W;
+    }
+    for (uint8_t n = 0; n < pm->cellCount; n++){
+        st->cell[n].temp_C += st->cell[n].heat_W * dt_s / st->p.heatCapacity_J_K;
+    }
+}
+
+static const PackModel_Ops ecmOps = {
+    .cellVoltage_mV  = ecm_cellVoltage,
+    .temperature_x10 = ecm_temperature,
+    .step            = ecm_step,
+};
+
+void PackModel_initEcm(PackModel *pm, PackModel_EcmState *st, uint8_t cellCount,
+                       const PackEcm_Params *params, uint8_t soc_pct){
+    static const PackEcm_Params defaults = PACK_ECM_DEFAULT_PARAMS;
+    memset(st, 0, sizeof(*st));
+    if (cellCount > PACK_MODEL_MAX_CELLS) cellCount = PACK_MODEL_MAX_CELLS;
+    st->p = params ? *params : defaults;
+    pm->ops = &ecmOps;
+    pm->cellCount = cellCount;
+    pm->impl = st;
+    for (uint8_t n = 0; n < cellCount; n++){
+        /* +spread/2 on cell 1 down to -spread/2 on the last cell */
+        float pos = cellCount > 1 ? (float)n / (float)(cellCount - 1) - 0.5f : 0.0f;
+        PackEcm_Cell *c = &st->cell[n];
+        c->capacity_mAs = st->p.capacity_mAh * 3600.0 * (1.0 - pos * st->p.capacitySpread_pct / 100.0);
+        c->leak_mA = st->p.capacity_mAh * st->p.selfDischarge_pct_month / 100.0f / (30.0f * 24.0f) *
+                     (1.0f + pos * st->p.leakSpread_pct / 100.0f);
+        c->r0_mohm = st->p.r0_mohm * (1.0f + pos * st->p.r0Spread_pct / 100.0f);
+        c->temp_C = st->p.ambient_C;
+        PackModel_setEcmCellSoc(pm, n, soc_pct);
+    }
+}
+
+void PackModel_setEcmCellSoc(PackModel *pm, uint8_t cell, uint8_t soc_pct){
+    PackModel_EcmState *st = (PackModel_EcmState *)pm->impl;
+    if (cell >= pm->cellCount) return;
+    if (soc_pct > 100) soc_pct = 100;
+    st->cell[cell].charge_mAs = st->cell[cell].capacity_mAs * soc_pct / 100.0;
+}
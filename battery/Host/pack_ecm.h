@@ -0,0 +1,97 @@
+/*
+ * pack_ecm.h
+ *
+ *  Equivalent-circuit pack model (PackModel_Ops implementation) for closed
+ *  loop runs where the simple linear pack is too kind to the firmware:
+ *
+ *    V_cell = OCV(SOC, LFP table) + I * R0(T) + V_rc1 + V_rc2
+ *
+ *  per cell (OCV climbing steeply past full), with its own capacity,
+ *  self-discharge and R0 (spread linearly over the string by
+ *  capacitySpread_pct / leakSpread_pct / r0Spread_pct, cell 1 largest,
+ *  least leaky and lowest R0), two RC pairs for the diffusion /
+ *  charge-transfer tails, and its own thermal mass: the cell's I^2 R heat
+ *  against a thermal resistance to ambient and to each neighbour in the
+ *  string, its R0 rising as it cools. The pack temperature (TS1) is the
+ *  hottest cell.
+ *
+ *  The balancing bleed is taken from the cell only (not through R0 / RC),
+ *  matching PackModel_Simple. RC decay factors are cached for the last
+ *  step length, so the usual 1 ms steps cost a few multiply-adds per cell.
+ */
+
+#ifndef PACK_ECM_H_
+#define PACK_ECM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "pack_model.h"
+
+#define PACK_ECM_OCV_POINTS  21      /* SOC 0..100 % in 5 % steps */
+/* Past 100 % the cell keeps absorbing charge up to PACK_ECM_MAX_SOC with a
+ * steep OCV rise, so a charger sees its voltage limit instead of a flat cell */
+#define PACK_ECM_OVERCHARGE_mV  20000.0f   /* per unit SOC above 1 (200 mV per %) */
+#define PACK_ECM_MAX_SOC        1.05
+
+typedef struct {
+    float capacity_mAh;
+    float r0_mohm;                    /* ohmic, at 25 degC */
+    float r1_mohm, tau1_s;            /* charge transfer */
+    float r2_mohm, tau2_s;            /* diffusion */
+    float r0TempCoeff;                /* R0 change per degC below 25 (0.01 = 1 %/K) */
+    float r0Spread_pct;               /* R0, cell 1 .. cell n, linear */
+    float selfDischarge_pct_month;
+    float capacitySpread_pct;         /* cell 1 .. cell n, linear */
+    float leakSpread_pct;             /* self-discharge, cell 1 .. cell n, linear */
+    float heatCapacity_J_K;           /* per cell */
+    float thermalR_K_W;               /* cell to ambient */
+    float couplingR_K_W;              /* cell to neighbouring cell */
+    float ambient_C;
+} PackEcm_Params;
+
+/* 20 Ah prismatic LFP cells */
+#define PACK_ECM_DEFAULT_PARAMS { \
+    .capacity_mAh = 20000.0f, .r0_mohm = 2.5f, \
+    .r1_mohm = 1.5f, .tau1_s = 20.0f, .r2_mohm = 2.0f, .tau2_s = 600.0f, \
+    .r0TempCoeff = 0.015f, .r0Spread_pct = 0.0f, .selfDischarge_pct_month = 3.0f, \
+    .capacitySpread_pct = 0.0f, .leakSpread_pct = 0.0f, \
+    .heatCapacity_J_K = 550.0f, .thermalR_K_W = 6.0f, .couplingR_K_W = 2.0f, .ambient_C = 25.0f }
+
+typedef struct {
+    double charge_mAs;                /* double: 1 ms steps against ~1e8 mAs */
+    double capacity_mAs;
+    float  leak_mA;
+    float  r0_mohm;                   /* at 25 degC, after the spread */
+    float  v1_mV, v2_mV;
+    float  lastI_mA;                  /* for the terminal voltage */
+    float  temp_C;
+    float  heat_W;                    /* net heat flow of the step being taken */
+} PackEcm_Cell;
+
+typedef struct {
+    PackEcm_Params p;
+    PackEcm_Cell   cell[PACK_MODEL_MAX_CELLS];
+    uint32_t       cachedDt_ms;       /* RC decay factors below are for this step */
+    float          a1, a2;
+} PackModel_EcmState;
+
+/* Initialise from params (NULL = PACK_ECM_DEFAULT_PARAMS); every cell starts
+ * at soc_pct, relaxed, at ambient temperature. */
+void PackModel_initEcm(PackModel *pm, PackModel_EcmState *st, uint8_t cellCount,
+                       const PackEcm_Params *params, uint8_t soc_pct);
+/* Force one cell's state of charge (0..100 %) */
+void PackModel_setEcmCellSoc(PackModel *pm, uint8_t cell, uint8_t soc_pct);
+/* Open-circuit voltage at soc (0..1) */
+float PackEcm_ocv_mV(float soc);
+/* State of charge of one cell (0..1) */
+float PackEcm_cellSoc(const PackModel *pm, uint8_t cell);
+/* Temperature of one cell (degC) */
+float PackEcm_cellTemp_C(const PackModel *pm, uint8_t cell);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PACK_ECM_H_ */
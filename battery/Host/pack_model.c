@@ -0,0 +1,60 @@
+/*
+ * pack_model.c
+ *
+ *  Linear-OCV reference pack used when no detailed model is plugged in.
+ */
+#include "pack_model.h"
+#include <string.h>
+
+static uint16_t simple_cellVoltage(const PackModel *pm, uint8_t cell){
+    const PackModel_SimpleState *st = (const PackModel_SimpleState *)pm->impl;
+    if (cell >= pm->cellCount || st->capacity_mAs[cell] == 0) return 0;
+    uint32_t span = (uint32_t)(st->full_mV - st->empty_mV);
+    return (uint16_t)(st->empty_mV + (uint32_t)(((uint64_t)st->charge_mAs[cell] * span) / st->capacity_mAs[cell]));
+}
+
+static int16_t simple_temperature(const PackModel *pm){
+    return ((const PackModel_SimpleState *)pm->impl)->temperature_x10;
+}
+
+static void simple_step(PackModel *pm, int32_t packCurrent_mA, const uint16_t *bleed_mA, uint32_t dt_ms){
+    PackModel_SimpleState *st = (PackModel_SimpleState *)pm->impl;
+    for (uint8_t i = 0; i < pm->cellCount; i++){
+        int64_t mAms = (int64_t)packCurrent_mA * dt_ms + st->rem_mAms[i];
+        if (bleed_mA) mAms -= (int64_t)bleed_mA[i] * dt_ms;
+        st->rem_mAms[i] = (int16_t)(mAms % 1000);
+        int64_t q = (int64_t)st->charge_mAs[i] + mAms / 1000;
+        if (q < 0) q = 0;
+        if (q > st->capacity_mAs[i]) q = st->capacity_mAs[i];
+        st->charge_mAs[i] = (uint32_t)q;
+    }
+}
+
+static const PackModel_Ops simpleOps = {
+    .cellVoltage_mV  = simple_cellVoltage,
+    .temperature_x10 = simple_temperature,
+    .step            = simple_step,
+};
+
+void PackModel_initSimple(PackModel *pm, PackModel_SimpleState *st, uint8_t cellCount,
+                          uint32_t capacity_mAh, uint8_t soc_pct){
+    memset(st, 0, sizeof(*st));
+    if (cellCount > PACK_MODEL_MAX_CELLS) cellCount = PACK_MODEL_MAX_CELLS;
+    st->empty_mV = 2400;
+    st->full_mV  = 4200;
+    st->temperature_x10 = 250;
+    pm->ops = &simpleOps;
+    pm->cellCount = cellCount;
+    pm->impl = st;
+    for (uint8_t i = 0; i < cellCount; i++){
+        st->capacity_mAs[i] = capacity_mAh * 3600u;
+        PackModel_setSimpleCellSoc(pm, i, soc_pct);
+    }
+}
+
+void PackModel_setSimpleCellSoc(PackModel *pm, uint8_t cell, uint8_t soc_pct){
+    PackModel_SimpleState *st = (PackModel_SimpleState *)pm->impl;
+    if (cell >= pm->cellCount) return;
+    if (soc_pct > 100) soc_pct = 100;
+    st->charge_mAs[cell] = (uint32_t)(((uint64_t)st->capacity_mAs[cell] * soc_pct) / 100u);
+}
@@ -0,0 +1,69 @@
+/*
+ * pack_model.h
+ *
+ *  Abstract series-pack model consumed by the device emulators.
+ *  The emulator asks the pack for cell voltages / temperature and tells it
+ *  how much charge to move (pack current, per-cell balancing bleed).
+ *
+ *  PackModel_Simple is a deliberately crude reference: linear OCV between
+ *  the empty and full voltages, no resistance, no temperature dynamics.
+ */
+
+#ifndef PACK_MODEL_H_
+#define PACK_MODEL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#define PACK_MODEL_MAX_CELLS 8
+
+typedef struct PackModel PackModel;
+
+typedef struct {
+    uint16_t (*cellVoltage_mV)(const PackModel *pm, uint8_t cell);
+    int16_t  (*temperature_x10)(const PackModel *pm);              /* 0.1 degC */
+    /* Advance the model by dt_ms with packCurrent_mA through the string
+     * (positive = charging) and bleed_mA[cell] drawn by balancing FETs. */
+    void     (*step)(PackModel *pm, int32_t packCurrent_mA, const uint16_t *bleed_mA, uint32_t dt_ms);
+} PackModel_Ops;
+
+struct PackModel {
+    const PackModel_Ops *ops;
+    uint8_t cellCount;
+    void   *impl;      /* implementation-owned state */
+};
+
+static inline uint16_t PackModel_cellVoltage_mV(const PackModel *pm, uint8_t cell){
+    return pm->ops->cellVoltage_mV(pm, cell);
+}
+static inline int16_t PackModel_temperature_x10(const PackModel *pm){
+    return pm->ops->temperature_x10(pm);
+}
+static inline void PackModel_step(PackModel *pm, int32_t packCurrent_mA, const uint16_t *bleed_mA, uint32_t dt_ms){
+    pm->ops->step(pm, packCurrent_mA, bleed_mA, dt_ms);
+}
+
+/* ================= Reference implementation ================= */
+typedef struct {
+    uint32_t capacity_mAs[PACK_MODEL_MAX_CELLS];
+    uint32_t charge_mAs[PACK_MODEL_MAX_CELLS];
+    int16_t  rem_mAms[PACK_MODEL_MAX_CELLS];     /* sub-mAs carry between steps */
+    uint16_t empty_mV;
+    uint16_t full_mV;
+    int16_t  temperature_x10;
+} PackModel_SimpleState;
+
+/* Initialise a simple pack: every cell gets capacity_mAh and starts at soc_pct. */
+void PackModel_initSimple(PackModel *pm, PackModel_SimpleState *st, uint8_t cellCount,
+                          uint32_t capacity_mAh, uint8_t soc_pct);
+/* Force one cell's state of charge (0..100 %), e.g. to create an imbalance. */
+void PackModel_setSimpleCellSoc(PackModel *pm, uint8_t cell, uint8_t soc_pct);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PACK_MODEL_H_ */
@@ -0,0 +1,120 @@
+/*
+ * pack_sweep.c
+ *
+ *  Parameter sweep over the equivalent-circuit pack: runs one fw_sim per
+ *  grid point (starting SOC x cell imbalance x R0, 5 % capacity spread),
+ *  up to `jobs` processes at a time, and tabulates their "[SIM] result"
+ *  lines. Each run is an independent process (the firmware and host HAL
+ *  are full of file-scope state), so the sweep scales with the cores:
+ *
+ *    pack_sweep [-j jobs] [-x ./fw_sim] [hours]
+ *
+ *  jobs defaults to the online CPUs; run from Host/ after `make`. Per-run
+ *  report and console go to build/sweep_<n>.txt / .log. Exits non-zero if
+ *  any run fails its checks.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+static const int startSoc[] = { 40, 70 };
+static const int imbalance[] = { 0, 10 };
+static const char *const r0[] = { "2.5", "5" };
+#define SWEEP_SPREAD  "5"
+
+#define N_SOC  (sizeof(startSoc) / sizeof(startSoc[0]))
+#define N_IMB  (sizeof(imbalance) / sizeof(imbalance[0]))
+#define N_R0   (sizeof(r0) / sizeof(r0[0]))
+#define POINTS (N_SOC * N_IMB * N_R0)
+
+typedef struct {
+    pid_t pid;
+    int   status;
+} Run;
+
+static pid_t launch(const char *exe, unsigned n, const char *hours){
+    char out[64], log[64], soc[8], imb[8];
+    unsigned s = n / (N_IMB * N_R0), d = (n / N_R0) % N_IMB, r = n % N_R0;
+    snprintf(out, sizeof out, "build/sweep_%u.txt", n);
+    snprintf(log, sizeof log, "build/sweep_%u.log", n);
+    snprintf(soc, sizeof soc, "%d", startSoc[s]);
+    snprintf(imb, sizeof imb, "%d", imbalance[d]);
+
+    pid_t pid = fork();
+    if (pid != 0) return pid;
+    int fd = open(out, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || dup2(fd, STDOUT_FILENO) < 0) _exit(127);
+    close(fd);
+    execl(exe, exe, "-m", "ecm", "-c", SWEEP_SPREAD, "-r", r0[r], "-s", soc, "-d", imb,
+          "-l", log, hours, (char *)NULL);
+    perror(exe);
+    _exit(127);
+}
+
+int main(int argc, char **argv){
+    const char *exe = "./fw_sim";
+    long jobs = sysconf(_SC_NPROCESSORS_ONLN);
+    int opt;
+    while ((opt = getopt(argc, argv, "j:x:")) != -1){
+        switch (opt){
+        case 'j': jobs = atol(optarg); break;
+        case 'x': exe = optarg; break;
+        default:
+            fprintf(stderr, "usage: %s [-j jobs] [-x fw_sim] [hours]\n", argv[0]);
+            return 2;
+        }
+    }
+    const char *hours = optind < argc ? argv[optind] : "6";
+    if (jobs < 1) jobs = 1;
+
+    Run runs[POINTS];
+    unsigned next = 0, running = 0;
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    while (next < POINTS || running){
+        if (next < POINTS && running < (unsigned)jobs){
+            runs[next].pid = launch(exe, next, hours);
+            if (runs[next].pid < 0){
+                perror("fork");
+                return 1;
+            }
+            next++;
+            running++;
+            continue;
+        }
+        int status;
+        pid_t pid = wait(&status);
+        if (pid < 0) break;
+        for (unsigned i = 0; i < next; i++) if (runs[i].pid == pid) runs[i].status = status;
+        running--;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double wall = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
+
+    unsigned failed = 0;
+    double cellSteps = 0.0;
+    for (unsigned i = 0; i < POINTS; i++){
+        char path[64], line[256], result[256] = "(no result)";
+        snprintf(path, sizeof path, "build/sweep_%u.txt", i);
+        FILE *f = fopen(path, "r");
+        while (f && fgets(line, sizeof line, f)){
+            if (!strncmp(line, "[SIM] result ", 13)){
+                line[strcspn(line, "\n")] = 0;
+                strcpy(result, line + 13);
+            }
+        }
+        if (f) fclose(f);
+        const char *cs = strstr(result, "cellsteps=");
+        if (cs) cellSteps += atof(cs + 10);
+        int ok = WIFEXITED(runs[i].status) && WEXITSTATUS(runs[i].status) == 0;
+        if (!ok) failed++;
+        printf("[SWEEP] %2u %-4s %s\n", i, ok ? "OK" : "FAIL", result);
+    }
+    printf("[SWEEP] %u run(s), %ld job(s), %.2f s wall, %.0f cell steps/s, %u failure(s)\n",
+           (unsigned)POINTS, jobs, wall, wall > 0 ? cellSteps / wall : 0.0, failed);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,52 @@
+/*
+ * regfield_kernels.h
+ *
+ *  The same register operations written twice: kc_* in C the way the
+ *  drivers do it by hand (regfield_kernels_c.c), kx_* through the C++
+ *  Field<> types (regfield_kernels_cpp.cpp). regfield_bench.c times both and
+ *  checks they agree; `make bench` also prints their code size.
+ */
+
+#ifndef REGFIELD_KERNELS_H_
+#define REGFIELD_KERNELS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "bq25798.h"
+
+/* Status block REG1B..REG21 -> decoded status structs */
+typedef struct {
+    BQ25798_ChargerStatus0 cs0;
+    BQ25798_ChargerStatus1 cs1;
+    BQ25798_ChargerStatus2 cs2;
+    BQ25798_ChargerStatus3 cs3;
+    BQ25798_ChargerStatus4 cs4;
+    BQ25798_FaultStatus0   fs0;
+    BQ25798_FaultStatus1   fs1;
+} RegfieldStatus;
+
+void     kc_decode_status(const uint8_t raw[7], RegfieldStatus *out);
+void     kx_decode_status(const uint8_t raw[7], RegfieldStatus *out);
+
+/* VREG / ICHG / VINDPM / IINDPM / IPRECHG setpoints -> wire bytes */
+void     kc_encode_setpoints(uint16_t vreg_mV, uint16_t ichg_mA, uint16_t vindpm_mV,
+                             uint16_t iin_mA, uint16_t ipre_mA, uint8_t out[8]);
+void     kx_encode_setpoints(uint16_t vreg_mV, uint16_t ichg_mA, uint16_t vindpm_mV,
+                             uint16_t iin_mA, uint16_t ipre_mA, uint8_t out[8]);
+
+/* Read-modify-write of CHG_EN in CHARGER_CTRL_0 */
+uint8_t  kc_set_chg_enable(uint8_t reg, uint8_t enable);
+uint8_t  kx_set_chg_enable(uint8_t reg, uint8_t enable);
+
+/* BQ76907 SYS_STAT -> "any fault" */
+uint8_t  kc_any_fault(uint8_t sysStat);
+uint8_t  kx_any_fault(uint8_t sysStat);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* REGFIELD_KERNELS_H_ */
@@ -0,0 +1,79 @@
+/*
+ * regfield_kernels_c.c
+ *
+ *  Hand-written C reference for the regfield benchmark: explicit shifts and
+ *  masks and the BQ25798_encode* helpers, as the drivers write them.
+ */
+#include "regfield_kernels.h"
+#include "bq76907.h"
+
+void kc_decode_status(const uint8_t raw[7], RegfieldStatus *out){
+    uint8_t v = raw[0];
+    out->cs0.iindpm_stat       = (v >> 7) & 0x01;
+    out->cs0.vindpm_stat       = (v >> 6) & 0x01;
+    out->cs0.wd_stat           = (v >> 5) & 0x01;
+    out->cs0.pg_stat           = (v >> 3) & 0x01;
+    out->cs0.ac2_present_stat  = (v >> 2) & 0x01;
+    out->cs0.ac1_present_stat  = (v >> 1) & 0x01;
+    out->cs0.vbus_present_stat = (v >> 0) & 0x01;
+    v = raw[1];
+    out->cs1.chg_stat          = (v >> 5) & 0x07;
+    out->cs1.vbus_stat         = (v >> 1) & 0x0F;
+    out->cs1.bc12_done_stat    = (v >> 0) & 0x01;
+    v = raw[2];
+    out->cs2.ico_stat          = (v >> 6) & 0x03;
+    out->cs2.treg_stat         = (v >> 2) & 0x01;
+    out->cs2.dpdm_stat         = (v >> 1) & 0x01;
+    out->cs2.vbat_present_stat = (v >> 0) & 0x01;
+    v = raw[3];
+    out->cs3.acrb2_stat        = (v >> 7) & 0x01;
+    out->cs3.acrb1_stat        = (v >> 6) & 0x01;
+    out->cs3.adc_done_stat     = (v >> 5) & 0x01;
+    out->cs3.vsys_stat         = (v >> 4) & 0x01;
+    out->cs3.chg_tmr_stat      = (v >> 3) & 0x01;
+    out->cs3.trichg_tmr_stat   = (v >> 2) & 0x01;
+    out->cs3.prechg_tmr_stat   = (v >> 1) & 0x01;
+    v = raw[4];
+    out->cs4.vbatotg_low_stat  = (v >> 4) & 0x01;
+    out->cs4.ts_cold_stat      = (v >> 3) & 0x01;
+    out->cs4.ts_cool_stat      = (v >> 2) & 0x01;
+    out->cs4.ts_warm_stat      = (v >> 1) & 0x01;
+    out->cs4.ts_hot_stat       = (v >> 0) & 0x01;
+    v = raw[5];
+    out->fs0.ibat_reg_stat     = (v >> 7) & 0x01;
+    out->fs0.vbus_ovp_stat     = (v >> 6) & 0x01;
+    out->fs0.vbat_ovp_stat     = (v >> 5) & 0x01;
+    out->fs0.ibus_ocp_stat     = (v >> 4) & 0x01;
+    out->fs0.ibat_ocp_stat     = (v >> 3) & 0x01;
+    out->fs0.conv_ocp_stat     = (v >> 2) & 0x01;
+    out->fs0.vac2_ovp_stat     = (v >> 1) & 0x01;
+    out->fs0.vac1_ovp_stat     = (v >> 0) & 0x01;
+    v = raw[6];
+    out->fs1.vsys_short_stat   = (v >> 7) & 0x01;
+    out->fs1.vsys_ovp_stat     = (v >> 6) & 0x01;
+    out->fs1.otg_ovp_stat      = (v >> 5) & 0x01;
+    out->fs1.otg_uvp_stat      = (v >> 4) & 0x01;
+    out->fs1.tshut_stat        = (v >> 2) & 0x01;
+}
+
+/* Field widths applied explicitly (VREG 11 bits, ICHG/IINDPM 9, IPRECHG 6) */
+void kc_encode_setpoints(uint16_t vreg_mV, uint16_t ichg_mA, uint16_t vindpm_mV,
+                         uint16_t iin_mA, uint16_t ipre_mA, uint8_t out[8]){
+    uint16_t vreg = BQ25798_encodeChargeVoltage_mV(vreg_mV) & 0x07FFu;
+    uint16_t ichg = BQ25798_encodeChargeCurrent_mA(ichg_mA) & 0x01FFu;
+    uint16_t iin  = BQ25798_encodeInputCurrent_mA(iin_mA)   & 0x01FFu;
+    out[0] = (uint8_t)(vreg >> 8); out[1] = (uint8_t)vreg;
+    out[2] = (uint8_t)(ichg >> 8); out[3] = (uint8_t)ichg;
+    out[4] = BQ25798_encodeInputVoltageLimit_mV(vindpm_mV);
+    out[5] = (uint8_t)(iin >> 8);  out[6] = (uint8_t)iin;
+    out[7] = (uint8_t)(BQ25798_encodePrechargeCurrent_mA(ipre_mA) & 0x3Fu);
+}
+
+uint8_t kc_set_chg_enable(uint8_t reg, uint8_t enable){
+    return (uint8_t)((reg & ~BQ25798_CHG_CTRL0_CHG_EN) | (enable ? BQ25798_CHG_CTRL0_CHG_EN : 0u));
+}
+
+uint8_t kc_any_fault(uint8_t sysStat){
+    return (sysStat & (BQ76907_SYS_STAT_OV_FLAG | BQ76907_SYS_STAT_UV_FLAG | BQ76907_SYS_STAT_SCD_FLAG |
+                       BQ76907_SYS_STAT_OCD_FLAG | BQ76907_SYS_STAT_OVERTEMP_FLAG)) ? 1u : 0u;
+}
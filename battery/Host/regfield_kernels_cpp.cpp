@@ -0,0 +1,47 @@
+/*
+ * regfield_kernels_cpp.cpp
+ *
+ *  The regfield benchmark kernels written against bq25798_regs.hpp /
+ *  bq76907_regs.hpp. Must produce the same results as regfield_kernels_c.c.
+ */
+#include "regfield_kernels.h"
+#include "bq25798_regs.hpp"
+#include "bq76907_regs.hpp"
+
+using namespace bq25798;
+
+/* Field list of one register -> "out.name = F::get(v);" */
+#define KX_GET(R, name, msb, lsb) dst.name = static_cast<uint8_t>(R::name::get(v));
+#define KX_DECODE(ID, access, member, Type) \
+    static inline void decode_##ID(uint8_t v, Type &dst) { BQ25798_##ID##_FIELDS(KX_GET, ID) }
+BQ25798_FIELD_REGS(KX_DECODE)
+
+extern "C" void kx_decode_status(const uint8_t raw[7], RegfieldStatus *out) {
+    decode_CHARGER_STATUS_0(raw[0], out->cs0);
+    decode_CHARGER_STATUS_1(raw[1], out->cs1);
+    decode_CHARGER_STATUS_2(raw[2], out->cs2);
+    decode_CHARGER_STATUS_3(raw[3], out->cs3);
+    decode_CHARGER_STATUS_4(raw[4], out->cs4);
+    decode_FAULT_STATUS_0(raw[5], out->fs0);
+    decode_FAULT_STATUS_1(raw[6], out->fs1);
+}
+
+extern "C" void kx_encode_setpoints(uint16_t vreg_mV, uint16_t ichg_mA, uint16_t vindpm_mV,
+                                    uint16_t iin_mA, uint16_t ipre_mA, uint8_t out[8]) {
+    ChargeVoltageLimit::toBytes(ChargeVoltage::encode(bq::Millivolts(vreg_mV)), &out[0]);
+    ChargeCurrentLimit::toBytes(ChargeCurrent::encode(bq::Milliamps(ichg_mA)), &out[2]);
+    InputVoltageLimit::toBytes(InputVoltage::encode(bq::Millivolts(vindpm_mV)), &out[4]);
+    InputCurrentLimit::toBytes(InputCurrent::encode(bq::Milliamps(iin_mA)), &out[5]);
+    PrechargeCtrl::toBytes(PrechargeCurrent::encode(bq::Milliamps(ipre_mA)), &out[7]);
+}
+
+extern "C" uint8_t kx_set_chg_enable(uint8_t reg, uint8_t enable) {
+    return ChargeEnable::set(reg, enable ? 1u : 0u);
+}
+
+extern "C" uint8_t kx_any_fault(uint8_t sysStat) {
+    using namespace bq76907::SYS_STAT;
+    constexpr uint32_t faults = ov_fault::mask | uv_fault::mask | scd_fault::mask |
+                                ocd_fault::mask | ot_fault::mask;
+    return (sysStat & faults) ? 1u : 0u;
+}
@@ -0,0 +1,32 @@
+/*
+ * scaling_test.c
+ *
+ *  BQ25798 / BQ76907 scaling helpers (bq25798_scale_test.c): the
+ *  exhaustive sweep of every raw code and physical value, which is too
+ *  slow for the target, and the boundary check main.c runs at boot. Both
+ *  are timed in host cycles for comparison between commits.
+ *
+ *    scaling_test
+ *
+ *  Exits non-zero if a check fails (`make run`).
+ */
+#include <stdio.h>
+#include "host_hal.h"
+#include "bq25798.h"
+
+#define HOST_CHECK_TAG "[SCALE]"
+#include "host_check.h"
+
+int main(void){
+    uint64_t t0 = HostHal_cycles();
+    CHECK(BQ25798_verifyScaling(1) == 0, "round trip, monotonic, error below 1 LSB");
+    uint64_t sweepCycles = HostHal_cycles() - t0;
+    t0 = HostHal_cycles();
+    CHECK(BQ25798_checkScalingRanges(1) == 0, "field ends and set point ranges (boot check)");
+    uint64_t rangeCycles = HostHal_cycles() - t0;
+    printf("[SCALE] sweep took %llu %s, boot range check %llu %s\n",
+           (unsigned long long)sweepCycles, HOST_HAL_CYCLE_UNIT,
+           (unsigned long long)rangeCycles, HOST_HAL_CYCLE_UNIT);
+
+    return HostCheck_result();
+}
@@ -0,0 +1,101 @@
+/*
+ * stm32g0xx_hal.h (host)
+ *
+ *  Stands in for the Cube HAL umbrella header in host builds, so the CubeMX
+ *  generated headers (main.h, i2c.h, gpio.h) and sources that include the
+ *  HAL directly (main.c, bq25798.c) compile unmodified. Found through the
+ *  Host Makefile's -I. ahead of the (absent) Drivers/ tree.
+ *
+ *  Adds to hal_stubs.h the GPIO, RCC / PWR and interrupt subset main.c
+ *  uses; implemented in host_hal.c. GPIO outputs are kept per port and
+ *  every pin change is counted, so a harness can watch the LEDs.
+ */
+#ifndef HOST_STM32G0XX_HAL_H
+#define HOST_STM32G0XX_HAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "hal_stubs.h"
+#include <stdint.h>
+
+/* ---- GPIO ---- */
+typedef struct {
+    uint32_t ODR;
+    uint32_t changes[16];   /* output changes per pin (host only) */
+} GPIO_TypeDef;
+
+extern GPIO_TypeDef HostHal_gpio[4];
+#define GPIOA (&HostHal_gpio[0])
+#define GPIOB (&HostHal_gpio[1])
+#define GPIOC (&HostHal_gpio[2])
+#define GPIOD (&HostHal_gpio[3])
+
+#define GPIO_PIN_0   0x0001u
+#define GPIO_PIN_1   0x0002u
+#define GPIO_PIN_2   0x0004u
+#define GPIO_PIN_3   0x0008u
+#define GPIO_PIN_4   0x0010u
+#define GPIO_PIN_5   0x0020u
+#define GPIO_PIN_6   0x0040u
+#define GPIO_PIN_7   0x0080u
+#define GPIO_PIN_8   0x0100u
+#define GPIO_PIN_9   0x0200u
+#define GPIO_PIN_10  0x0400u
+#define GPIO_PIN_11  0x0800u
+#define GPIO_PIN_12  0x1000u
+#define GPIO_PIN_13  0x2000u
+#define GPIO_PIN_14  0x4000u
+#define GPIO_PIN_15  0x8000u
+
+typedef enum { GPIO_PIN_RESET = 0, GPIO_PIN_SET } GPIO_PinState;
+
+void          HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+void          HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+
+/* ---- Core / RCC / PWR (SystemClock_Config) ---- */
+HAL_StatusTypeDef HAL_Init(void);
+
+static inline void __disable_irq(void){}
+static inline void __enable_irq(void){}
+
+typedef struct {
+    uint32_t OscillatorType;
+    uint32_t HSIState;
+    uint32_t HSIDiv;
+    uint32_t HSICalibrationValue;
+    struct { uint32_t PLLState; } PLL;
+} RCC_OscInitTypeDef;
+
+typedef struct {
+    uint32_t ClockType;
+    uint32_t SYSCLKSource;
+    uint32_t AHBCLKDivider;
+    uint32_t APB1CLKDivider;
+} RCC_ClkInitTypeDef;
+
+#define PWR_REGULATOR_VOLTAGE_SCALE1  0x00000200u
+#define RCC_OSCILLATORTYPE_HSI        0x00000002u
+#define RCC_HSI_ON                    0x00000100u
+#define RCC_HSI_DIV1                  0x00000000u
+#define RCC_HSICALIBRATION_DEFAULT    64u
+#define RCC_PLL_NONE                  0x00000000u
+#define RCC_CLOCKTYPE_SYSCLK          0x00000001u
+#define RCC_CLOCKTYPE_HCLK            0x00000002u
+#define RCC_CLOCKTYPE_PCLK1           0x00000004u
+#define RCC_SYSCLKSOURCE_HSI          0x00000000u
+#define RCC_SYSCLK_DIV1               0x00000000u
+#define RCC_HCLK_DIV1                 0x00000000u
+#define FLASH_LATENCY_0               0x00000000u
+
+HAL_StatusTypeDef HAL_PWREx_ControlVoltageScaling(uint32_t VoltageScaling);
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *RCC_OscInitStruct);
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef *RCC_ClkInitStruct, uint32_t FLatency);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_STM32G0XX_HAL_H */
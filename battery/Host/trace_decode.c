@@ -0,0 +1,154 @@
+/*
+ * trace_decode.c
+ *
+ *  Rebuilds TRACE() output (Core/Inc/trace.h) from a captured byte stream.
+ *  The format strings are read from the `trace_fmt` section of the ELF the
+ *  stream came from (firmware .elf or a host build). Bytes outside trace
+ *  records (plain printf text on the same channel) are copied through.
+ *
+ *    trace_decode <elf> [capture]      capture defaults to stdin
+ */
+#include <elf.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TRACE_MAGIC      0xA5u
+#define TRACE_ID_DROPPED 0xFFFFu
+
+static char    *fmtData;
+static uint32_t fmtSize;
+
+static uint8_t *readFile(const char *path, long *size){
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    *size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *buf = malloc((size_t)*size + 1);
+    if (buf && fread(buf, 1, (size_t)*size, f) != (size_t)*size){ free(buf); buf = NULL; }
+    fclose(f);
+    return buf;
+}
+
+/* Little-endian ELF32 (firmware) or ELF64 (host build) section header i */
+static void section(const uint8_t *elf, uint16_t i, uint32_t *name, uint64_t *off, uint64_t *len){
+    if (elf[EI_CLASS] == ELFCLASS64){
+        const Elf64_Ehdr *eh = (const Elf64_Ehdr *)elf;
+        const Elf64_Shdr *sh = (const Elf64_Shdr *)(elf + eh->e_shoff + (uint64_t)i * eh->e_shentsize);
+        *name = sh->sh_name; *off = sh->sh_offset; *len = sh->sh_size;
+    } else {
+        const Elf32_Ehdr *eh = (const Elf32_Ehdr *)elf;
+        const Elf32_Shdr *sh = (const Elf32_Shdr *)(elf + eh->e_shoff + (uint64_t)i * eh->e_shentsize);
+        *name = sh->sh_name; *off = sh->sh_offset; *len = sh->sh_size;
+    }
+}
+
+static int loadFormats(const uint8_t *elf, long size){
+    if (size < (long)sizeof(Elf64_Ehdr) || memcmp(elf, ELFMAG, SELFMAG) != 0) return -1;
+    uint16_t shnum, shstrndx;
+    uint64_t end;
+    if (elf[EI_CLASS] == ELFCLASS64){
+        const Elf64_Ehdr *eh = (const Elf64_Ehdr *)elf;
+        shnum = eh->e_shnum; shstrndx = eh->e_shstrndx;
+        end = eh->e_shoff + (uint64_t)shnum * eh->e_shentsize;
+    } else {
+        const Elf32_Ehdr *eh = (const Elf32_Ehdr *)elf;
+        shnum = eh->e_shnum; shstrndx = eh->e_shstrndx;
+        end = eh->e_shoff + (uint64_t)shnum * eh->e_shentsize;
+    }
+    if (end > (uint64_t)size || shstrndx >= shnum) return -1;
+
+    uint32_t name;
+    uint64_t namesOff, namesLen, off, len;
+    section(elf, shstrndx, &name, &namesOff, &namesLen);
+    for (uint16_t i = 0; i < shnum; i++){
+        section(elf, i, &name, &off, &len);
+        if (name >= namesLen || strcmp((const char *)elf + namesOff + name, "trace_fmt") != 0) continue;
+        if (off + len > (uint64_t)size) return -1;
+        fmtData = (char *)elf + off;
+        fmtSize = (uint32_t)len;
+        return 0;
+    }
+    return -1;
+}
+
+/* printf with every conversion taking one 32-bit argument */
+static void render(const char *fmt, const uint32_t *args, uint32_t nargs){
+    uint32_t a = 0;
+    while (*fmt){
+        if (*fmt != '%'){ putchar(*fmt++); continue; }
+        if (fmt[1] == '%'){ putchar('%'); fmt += 2; continue; }
+        char spec[32];
+        size_t n = 0;
+        spec[n++] = *fmt++;
+        while (*fmt && strchr("-+ #0123456789.", *fmt) && n < sizeof(spec) - 2) spec[n++] = *fmt++;
+        while (*fmt && strchr("hlzjtL", *fmt)) fmt++;       /* arguments are 32-bit */
+        char conv = *fmt ? *fmt++ : 'd';
+        uint32_t v = a < nargs ? args[a] : 0;
+        a++;
+        spec[n++] = conv;
+        spec[n] = '\0';
+        switch (conv){
+        case 'd': case 'i': printf(spec, (int)(int32_t)v); break;
+        case 'u': case 'x': case 'X': case 'o': case 'c': printf(spec, (unsigned)v); break;
+        default: printf("<%%%c?>", conv); break;
+        }
+    }
+}
+
+int main(int argc, char **argv){
+    if (argc < 2){
+        fprintf(stderr, "usage: %s <elf> [capture]\n", argv[0]);
+        return 2;
+    }
+    long elfSize = 0, capSize = 0;
+    uint8_t *elf = readFile(argv[1], &elfSize);
+    if (!elf || loadFormats(elf, elfSize) != 0){
+        fprintf(stderr, "%s: no trace_fmt section\n", argv[1]);
+        return 1;
+    }
+    uint8_t *cap;
+    if (argc > 2){
+        cap = readFile(argv[2], &capSize);
+    } else {
+        size_t cap_ = 0, n;
+        cap = NULL;
+        do {
+            cap = realloc(cap, cap_ + 4096);
+            n = fread(cap + cap_, 1, 4096, stdin);
+            cap_ += n;
+        } while (n == 4096);
+        capSize = (long)cap_;
+    }
+    if (!cap){
+        fprintf(stderr, "cannot read capture\n");
+        return 1;
+    }
+
+    unsigned long records = 0, bad = 0;
+    long i = 0;
+    while (i < capSize){
+        if (cap[i] != TRACE_MAGIC){ putchar(cap[i++]); continue; }
+        if (i + 8 > capSize){ bad++; break; }
+        uint32_t nargs = cap[i + 1];
+        uint32_t id = (uint32_t)cap[i + 2] | ((uint32_t)cap[i + 3] << 8);
+        uint32_t ts, args[8];
+        memcpy(&ts, cap + i + 4, 4);
+        if (nargs > 8 || i + 8 + 4 * (long)nargs > capSize ||
+            (id != TRACE_ID_DROPPED && id >= fmtSize)){
+            bad++; i++;                                   /* not a record: resync */
+            continue;
+        }
+        memcpy(args, cap + i + 8, 4 * nargs);
+        i += 8 + 4 * (long)nargs;
+        records++;
+        printf("[%10lu] ", (unsigned long)ts);
+        if (id == TRACE_ID_DROPPED) printf("[TRACE] %lu record(s) dropped", (unsigned long)(nargs ? args[0] : 0));
+        else render(fmtData + id, args, nargs);
+        putchar('\n');
+    }
+    fprintf(stderr, "[TRACE] %lu record(s) decoded, %lu bad\n", records, bad);
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * watchdog_test.c
+ *
+ *  IWDG task supervisor (watchdog.h) on the host IWDG model: healthy tasks
+ *  keep the watchdog refreshed, a hung task ends in a reset, and the
+ *  no-init reset record names the late task and the one that was running,
+ *  also for a task starved by a higher priority one. A tickless idle
+ *  (Stop: SysTick off, the tick catches up on wake-up) longer than the loop
+ *  deadline reads as a loop stall; capped by Watchdog_IdleLimit it does not.
+ *
+ *    watchdog_test
+ *
+ *  Exits non-zero if a check fails (`make run`).
+ */
+#include <stdio.h>
+#include "host_hal.h"
+#include "scheduler.h"
+#include "watchdog.h"
+#include "bm_errors.h"
+
+#define HOST_CHECK_TAG "[WDG]"
+#include "host_check.h"
+
+/* A 50 ms task, and a 1 s one that can be made to hang */
+enum { W_FAST, W_SLOW, W_COUNT };
+static uint8_t wdgHang;
+static void wdgTick(uint32_t ms){   /* virtual time with SysTick running */
+    while (ms-- && !HostHal_watchdogExpired()){
+        HostHal_advanceMs(1);
+        Watchdog_TickISR();
+    }
+}
+static void wdgFast(void){}
+static void wdgSlow(void){ if (wdgHang) wdgTick(5000); }
+static const Scheduler_Task wdgTable[W_COUNT] = {
+    [W_FAST] = { "fast", wdgFast, 50,   0,  0, 1, 0 },
+    [W_SLOW] = { "slow", wdgSlow, 1000, 10, 0, 2, 0 },
+};
+/* Main loop: one task per pass, 1 ms per pass; stops when the IWDG fires */
+static void wdgLoop(uint32_t ms){
+    while (ms-- && !HostHal_watchdogExpired()){
+        Scheduler_RunReady(1);
+        Watchdog_Service(HostHal_nowMs());
+        wdgTick(1);
+    }
+}
+static void wdgBoot(void){
+    Watchdog_Init();
+    Scheduler_Init(wdgTable, W_COUNT, HostHal_nowMs());
+    Watchdog_Supervise(W_FAST, 200);
+    Watchdog_Supervise(W_SLOW, 1500);
+}
+
+/* Idle runs: one 1 s task, so the loop would sleep up to 1 s at a time */
+static void idleTask(void){}
+static const Scheduler_Task idleTable[1] = {
+    { "idle", idleTask, 1000, 0, 0, 1, 0 },
+};
+/* main.c's loop with LowPower_Idle: no SysTick while stopped, then SysTick
+ * up to the next supervision pass */
+static void idleLoop(uint32_t ms, uint8_t capped){
+    uint32_t end = HostHal_nowMs() + ms;
+    while ((int32_t)(end - HostHal_nowMs()) > 0 && !HostHal_watchdogExpired()){
+        Scheduler_RunReady(1);
+        Watchdog_Service(HostHal_nowMs());
+        uint32_t sleep = Scheduler_TimeToNext(HostHal_nowMs());
+        HostHal_advanceMs(capped ? Watchdog_IdleLimit(sleep) : sleep);
+        wdgTick(WATCHDOG_CHECK_MS);   /* the next supervision pass after the wake-up */
+    }
+}
+static void idleBoot(void){
+    Watchdog_Init();
+    Scheduler_Init(idleTable, 1, HostHal_nowMs());
+    Watchdog_Supervise(0, 1500);
+}
+
+int main(void){
+    HostHal_reset();
+
+    wdgBoot();
+    CHECK(Watchdog_GetStats()->last.reason == WATCHDOG_OK, "power-up reports no watchdog reset");
+    wdgLoop(5000);
+    CHECK(!HostHal_watchdogExpired() && !Watchdog_GetStats()->tripped && Watchdog_GetStats()->kicks >= 19,
+          "healthy tasks keep the IWDG refreshed");
+    wdgHang = 1;
+    uint32_t w0 = HostHal_nowMs();
+    wdgLoop(5000);
+    wdgHang = 0;
+    CHECK(HostHal_watchdogExpired() && Watchdog_GetStats()->tripped &&
+          HostHal_nowMs() - w0 <= WATCHDOG_TIMEOUT_MS + WATCHDOG_KICK_MS + 1000u, "hung task ends in an IWDG reset");
+    HostHal_watchdogReset();
+    uint32_t errs = BM_ErrorCountByCode(BM_ERR_TIMEOUT);
+    wdgBoot();
+    const Watchdog_ResetRecord *wr = &Watchdog_GetStats()->last;
+    CHECK(wr->reason == WATCHDOG_TASK_LATE && wr->task == W_FAST && wr->running == W_SLOW && wr->resets == 1 &&
+          BM_ErrorCountByCode(BM_ERR_TIMEOUT) == errs + 1, "reset record names starving and running task");
+    Watchdog_LogStats();
+
+    wdgLoop(100);
+    Scheduler_SetPeriod(W_FAST, 1);        /* always ready at higher priority: W_SLOW never runs */
+    wdgLoop(6000);
+    HostHal_watchdogReset();
+    wdgBoot();
+    CHECK(wr->reason == WATCHDOG_TASK_LATE && wr->task == W_SLOW && wr->running == SCHED_NO_TASK && wr->resets == 2,
+          "starved task recorded across the reset");
+    Watchdog_LogStats();
+
+    idleBoot();
+    idleLoop(10000, 0);
+    HostHal_watchdogReset();
+    idleBoot();
+    CHECK(wr->reason == WATCHDOG_LOOP_STALL && wr->resets == 3, "uncapped 1 s idle trips the loop deadline");
+    uint32_t i0 = HostHal_nowMs();
+    idleLoop(10000, 1);
+    CHECK(!HostHal_watchdogExpired() && !Watchdog_GetStats()->tripped && HostHal_nowMs() - i0 >= 10000u &&
+          Watchdog_GetStats()->kicks >= 10000u / (2u * WATCHDOG_KICK_MS), "idle capped at WATCHDOG_MAX_IDLE_MS stays on time");
+    Watchdog_LogStats();
+
+    return HostCheck_result();
+}
@@ -0,0 +1,188 @@
+/*
+ * bench.c
+ * Dispatch-strategy benchmark for the statePractice state machine styles.
+ *
+ * Every variant implements the same machine (machine.h) in its own style
+ * and is driven with the same pseudo-random event stream. A variant is only
+ * timed once its final state, outputs, unhandled count and action checksum
+ * match the nested-switch reference, so the numbers compare equivalent code.
+ *
+ * Usage: dispatch_bench [-n events] [-r repeats] [-s seed]
+ * Code size and static RAM per variant: `make report` (runs size(1) on the
+ * objects); the instance column here is the per-machine context struct.
+ */
+#include "machine.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const DispatchVariant* const variants[] = {
+    &variant_baseline,
+    &variant_nested_switch,
+    &variant_state_table,
+    &variant_state_handler,
+    &variant_optimal,
+    &variant_shawal,
+    &variant_linear_table,
+};
+#define NUM_VARIANTS ((int)(sizeof(variants) / sizeof(variants[0])))
+#define REFERENCE 1     // nested switch
+
+// Relative frequency of each event in the stream: mostly source changes and
+// polling, with rare faults and a reset that gets the machine out of FAULT
+static const unsigned event_weight[EV_MAX] = {
+    [EV_NONE]              = 4,
+    [EV_60W_CONNECTED]     = 10,
+    [EV_100W_CONNECTED]    = 10,
+    [EV_MPPT_CONNECTED]    = 10,
+    [EV_BQ_CHARGING_DONE]  = 10,
+    [EV_BQ_CHARGING_ERROR] = 1,
+    [EV_BMS_FAULT]         = 1,
+    [EV_POWER_GOOD_VBAT]   = 8,
+    [EV_ADC_TEMP_HIGH]     = 2,
+    [EV_ADC_CURRENT_HIGH]  = 4,
+    [EV_TIMEOUT]           = 10,
+    [EV_FAULT]             = 1,
+    [EV_RESET]             = 6,
+};
+
+static uint32_t rng_state;
+
+static uint32_t xorshift32(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static void make_stream(uint8_t* events, size_t count, uint32_t seed) {
+    unsigned total = 0;
+    for (int e = 0; e < EV_MAX; e++) {
+        total += event_weight[e];
+    }
+    rng_state = seed ? seed : 1;
+    for (size_t i = 0; i < count; i++) {
+        unsigned pick = xorshift32() % total;
+        int e = 0;
+        while (pick >= event_weight[e]) {
+            pick -= event_weight[e++];
+        }
+        events[i] = (uint8_t)e;
+    }
+}
+
+typedef struct {
+    BenchState state;
+    uint32_t outputs;
+    uint32_t checksum;
+    uint32_t unhandled;
+} Outcome;
+
+static Outcome run_once(const DispatchVariant* v, const uint8_t* events, size_t count) {
+    Outcome o;
+    bench_reset_outputs();
+    v->init();
+    v->run(events, count);
+    o.state = v->state();
+    o.outputs = bench_outputs;
+    o.checksum = bench_checksum;
+    o.unhandled = bench_unhandled;
+    return o;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static int cmp_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char** argv) {
+    size_t count = 1u << 20;
+    int repeats = 11;
+    uint32_t seed = 2025;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            count = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            repeats = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "usage: %s [-n events] [-r repeats] [-s seed]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (count == 0 || repeats < 1) {
+        fprintf(stderr, "need at least one event and one repeat\n");
+        return 2;
+    }
+
+    uint8_t* events = malloc(count);
+    double* samples = malloc(sizeof(double) * (size_t)repeats);
+    if (events == NULL || samples == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 2;
+    }
+    make_stream(events, count, seed);
+
+    // Same behaviour first
+    Outcome ref = run_once(variants[REFERENCE], events, count);
+    int mismatches = 0;
+    for (int v = REFERENCE; v < NUM_VARIANTS; v++) {
+        Outcome o = run_once(variants[v], events, count);
+        if (memcmp(&o, &ref, sizeof(o)) != 0) {
+            printf("MISMATCH %s: state %d outputs 0x%02x checksum 0x%08x unhandled %u"
+                   " (reference: %d 0x%02x 0x%08x %u)\n",
+                   variants[v]->name, o.state, (unsigned)o.outputs, (unsigned)o.checksum,
+                   (unsigned)o.unhandled, ref.state, (unsigned)ref.outputs,
+                   (unsigned)ref.checksum, (unsigned)ref.unhandled);
+            mismatches++;
+        }
+    }
+
+    printf("Dispatch benchmark: %zu events (seed %u), best and median of %d runs\n",
+           count, (unsigned)seed, repeats);
+    printf("All variants agree: final state %d, checksum 0x%08x, %u unhandled events\n\n",
+           ref.state, (unsigned)ref.checksum, (unsigned)ref.unhandled);
+    printf("%-30s %-22s %8s %8s %8s %9s\n", "variant", "from", "best", "median", "net", "instance");
+    printf("%-30s %-22s %8s %8s %8s %9s\n", "", "", "ns/ev", "ns/ev", "ns/ev", "bytes");
+
+    double baseline = 0.0;
+    for (int v = 0; v < NUM_VARIANTS; v++) {
+        const DispatchVariant* var = variants[v];
+        run_once(var, events, count);      // warm caches and branch predictors
+        for (int r = 0; r < repeats; r++) {
+            bench_reset_outputs();
+            var->init();
+            double t0 = now_ns();
+            var->run(events, count);
+            samples[r] = (now_ns() - t0) / (double)count;
+        }
+        qsort(samples, (size_t)repeats, sizeof(double), cmp_double);
+        double best = samples[0];
+        double median = samples[repeats / 2];
+        if (v == 0) {
+            baseline = best;
+            printf("%-30s %-22s %8.2f %8.2f %8s %9s\n", var->name, var->origin, best, median, "-", "-");
+        } else {
+            printf("%-30s %-22s %8.2f %8.2f %8.2f %9zu\n", var->name, var->origin, best, median,
+                   best - baseline, var->instance_bytes);
+        }
+    }
+    printf("\nnet = best minus the loop-only baseline\n");
+
+    free(samples);
+    free(events);
+    if (mismatches) {
+        printf("%d variant(s) disagree with the reference\n", mismatches);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,53 @@
+// machine.c - Actions shared by every dispatch variant
+#include "machine.h"
+
+// Output bits (GPIO names from sample_state_machine.c)
+#define OUT_CHARGE_ENABLE  (1u << 0)
+#define OUT_USB_60W        (1u << 1)
+#define OUT_USB_100W       (1u << 2)
+#define OUT_BAT_OUTPUT     (1u << 3)
+#define OUT_BQ_QON         (1u << 4)
+
+volatile uint32_t bench_outputs;
+uint32_t bench_checksum;
+uint32_t bench_unhandled;
+
+static void trace(uint32_t id) {
+    bench_checksum = bench_checksum * 31u + id;
+}
+
+void bench_reset_outputs(void) {
+    bench_outputs = OUT_BQ_QON;
+    bench_checksum = 1;
+    bench_unhandled = 0;
+}
+
+void act_idle(void) {
+    bench_outputs &= ~(OUT_CHARGE_ENABLE | OUT_USB_60W | OUT_USB_100W);
+    trace(1);
+}
+
+void act_charge_60w(void) {
+    bench_outputs = (bench_outputs & ~OUT_USB_100W) | OUT_USB_60W | OUT_CHARGE_ENABLE;
+    trace(2);
+}
+
+void act_charge_100w(void) {
+    bench_outputs = (bench_outputs & ~OUT_USB_60W) | OUT_USB_100W | OUT_CHARGE_ENABLE;
+    trace(3);
+}
+
+void act_charge_mppt(void) {
+    bench_outputs = (bench_outputs & ~(OUT_USB_60W | OUT_USB_100W)) | OUT_CHARGE_ENABLE;
+    trace(4);
+}
+
+void act_discharge(void) {
+    bench_outputs |= OUT_BAT_OUTPUT;
+    trace(5);
+}
+
+void act_fault(void) {
+    bench_outputs &= ~(OUT_BAT_OUTPUT | OUT_BQ_QON | OUT_USB_60W | OUT_USB_100W | OUT_CHARGE_ENABLE);
+    trace(6);
+}
@@ -0,0 +1,84 @@
+// machine.h - The power-management machine every dispatch variant implements
+//
+// States, events and transitions are those of sample_state_machine.c (the
+// table-driven charger / fault machine), plus EVENT_RESET to leave FAULT so
+// a long event stream keeps exercising the machine. Every variant must give
+// the same sequence of actions for the same stream; bench.c checks that.
+//
+// Semantics, whatever the dispatch style:
+// - FAULT ignores everything except EVENT_RESET (-> IDLE)
+// - otherwise an explicit transition for (state, event) wins
+// - otherwise the charging states inherit BQ_CHARGING_ERROR and ADC_TEMP_HIGH
+//   (-> FAULT) from the CHARGING superstate
+// - otherwise the event is unhandled and bench_unhandled is incremented
+// - each transition runs the action of its target state (act_*)
+#ifndef DISPATCH_BENCH_MACHINE_H
+#define DISPATCH_BENCH_MACHINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// States
+typedef enum {
+    ST_IDLE,
+    ST_CHARGING_60W,
+    ST_CHARGING_100W,
+    ST_CHARGING_MPPT,
+    ST_DISCHARGING,
+    ST_FAULT,
+    ST_STANDBY,
+    ST_MAX
+} BenchState;
+
+// Events
+typedef enum {
+    EV_NONE,
+    EV_60W_CONNECTED,
+    EV_100W_CONNECTED,
+    EV_MPPT_CONNECTED,
+    EV_BQ_CHARGING_DONE,
+    EV_BQ_CHARGING_ERROR,
+    EV_BMS_FAULT,
+    EV_POWER_GOOD_VBAT,
+    EV_ADC_TEMP_HIGH,
+    EV_ADC_CURRENT_HIGH,
+    EV_TIMEOUT,
+    EV_FAULT,
+    EV_RESET,
+    EV_MAX
+} BenchEvent;
+
+// Transition actions (machine.c, a separate unit so no variant can inline
+// them): each drives the simulated outputs and folds its id into a checksum
+void act_idle(void);
+void act_charge_60w(void);
+void act_charge_100w(void);
+void act_charge_mppt(void);
+void act_discharge(void);
+void act_fault(void);
+
+extern volatile uint32_t bench_outputs;
+extern uint32_t bench_checksum;
+extern uint32_t bench_unhandled;
+void bench_reset_outputs(void);
+
+// One dispatch strategy. run() feeds the whole stream through the variant's
+// own dispatcher the way a main loop would call it.
+typedef struct {
+    const char* name;
+    const char* origin;          // where the style comes from
+    size_t instance_bytes;       // per-machine RAM (context struct)
+    void (*init)(void);          // enter IDLE (no action)
+    void (*run)(const uint8_t* events, size_t count);
+    BenchState (*state)(void);
+} DispatchVariant;
+
+extern const DispatchVariant variant_baseline;
+extern const DispatchVariant variant_nested_switch;
+extern const DispatchVariant variant_state_table;
+extern const DispatchVariant variant_state_handler;
+extern const DispatchVariant variant_optimal;
+extern const DispatchVariant variant_shawal;
+extern const DispatchVariant variant_linear_table;
+
+#endif // DISPATCH_BENCH_MACHINE_H
@@ -0,0 +1,26 @@
+// v0_baseline.c - The stream loop without a state machine, to subtract
+#include "machine.h"
+
+static volatile uint8_t last_event;
+
+static void baseline_init(void) {
+}
+
+static void baseline_run(const uint8_t* events, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        last_event = events[i];
+    }
+}
+
+static BenchState baseline_state(void) {
+    return ST_IDLE;
+}
+
+const DispatchVariant variant_baseline = {
+    .name = "baseline (loop only)",
+    .origin = "-",
+    .instance_bytes = 0,
+    .init = baseline_init,
+    .run = baseline_run,
+    .state = baseline_state,
+};
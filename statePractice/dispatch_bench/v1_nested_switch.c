@@ -0,0 +1,210 @@
+// v1_nested_switch.c - switch on the state, then on the signal
+// (statePractice/1nestedswitch)
+#include "machine.h"
+
+typedef struct {
+    BenchState state;
+    BenchEvent signal;
+} Machine;
+
+static Machine machine;
+
+// Inherited from the CHARGING superstate
+static void handle_charging_common(Machine *m) {
+    switch (m->signal) {
+        case EV_BQ_CHARGING_ERROR:
+        case EV_ADC_TEMP_HIGH:
+        case EV_BMS_FAULT:
+            m->state = ST_FAULT;
+            act_fault();
+            break;
+        default:
+            bench_unhandled++;
+            break;
+    }
+}
+
+static void handle_state_idle(Machine *m) {
+    switch (m->signal) {
+        case EV_60W_CONNECTED:
+            m->state = ST_CHARGING_60W;
+            act_charge_60w();
+            break;
+        case EV_100W_CONNECTED:
+            m->state = ST_CHARGING_100W;
+            act_charge_100w();
+            break;
+        case EV_MPPT_CONNECTED:
+            m->state = ST_CHARGING_MPPT;
+            act_charge_mppt();
+            break;
+        case EV_POWER_GOOD_VBAT:
+            m->state = ST_DISCHARGING;
+            act_discharge();
+            break;
+        case EV_BMS_FAULT:
+            m->state = ST_FAULT;
+            act_fault();
+            break;
+        default:
+            bench_unhandled++;
+            break;
+    }
+}
+
+static void handle_state_charging_60w(Machine *m) {
+    switch (m->signal) {
+        case EV_BQ_CHARGING_DONE:
+            m->state = ST_IDLE;
+            act_idle();
+            break;
+        case EV_100W_CONNECTED:
+            m->state = ST_CHARGING_100W;
+            act_charge_100w();
+            break;
+        case EV_MPPT_CONNECTED:
+            m->state = ST_CHARGING_MPPT;
+            act_charge_mppt();
+            break;
+        default:
+            handle_charging_common(m);
+            break;
+    }
+}
+
+static void handle_state_charging_100w(Machine *m) {
+    switch (m->signal) {
+        case EV_BQ_CHARGING_DONE:
+            m->state = ST_IDLE;
+            act_idle();
+            break;
+        case EV_60W_CONNECTED:
+            m->state = ST_CHARGING_60W;
+            act_charge_60w();
+            break;
+        case EV_MPPT_CONNECTED:
+            m->state = ST_CHARGING_MPPT;
+            act_charge_mppt();
+            break;
+        default:
+            handle_charging_common(m);
+            break;
+    }
+}
+
+static void handle_state_charging_mppt(Machine *m) {
+    switch (m->signal) {
+        case EV_BQ_CHARGING_DONE:
+            m->state = ST_IDLE;
+            act_idle();
+            break;
+        case EV_60W_CONNECTED:
+            m->state = ST_CHARGING_60W;
+            act_charge_60w();
+            break;
+        case EV_100W_CONNECTED:
+            m->state = ST_CHARGING_100W;
+            act_charge_100w();
+            break;
+        default:
+            handle_charging_common(m);
+            break;
+    }
+}
+
+static void handle_state_discharging(Machine *m) {
+    switch (m->signal) {
+        case EV_60W_CONNECTED:
+            m->state = ST_CHARGING_60W;
+            act_charge_60w();
+            break;
+        case EV_100W_CONNECTED:
+            m->state = ST_CHARGING_100W;
+            act_charge_100w();
+            break;
+        case EV_MPPT_CONNECTED:
+            m->state = ST_CHARGING_MPPT;
+            act_charge_mppt();
+            break;
+        case EV_BMS_FAULT:
+            m->state = ST_FAULT;
+            act_fault();
+            break;
+        default:
+            bench_unhandled++;
+            break;
+    }
+}
+
+static void handle_state_standby(Machine *m) {
+    switch (m->signal) {
+        case EV_POWER_GOOD_VBAT:
+            m->state = ST_DISCHARGING;
+            act_discharge();
+            break;
+        case EV_60W_CONNECTED:
+            m->state = ST_CHARGING_60W;
+            act_charge_60w();
+            break;
+        case EV_100W_CONNECTED:
+            m->state = ST_CHARGING_100W;
+            act_charge_100w();
+            break;
+        case EV_MPPT_CONNECTED:
+            m->state = ST_CHARGING_MPPT;
+            act_charge_mppt();
+            break;
+        case EV_BMS_FAULT:
+            m->state = ST_FAULT;
+            act_fault();
+            break;
+        default:
+            bench_unhandled++;
+            break;
+    }
+}
+
+static void handle_state_fault(Machine *m) {
+    if (m->signal == EV_RESET) {
+        m->state = ST_IDLE;
+        act_idle();
+    }
+}
+
+static void dispatch(Machine *m) {
+    switch (m->state) {
+        case ST_IDLE:          handle_state_idle(m); break;
+        case ST_CHARGING_60W:  handle_state_charging_60w(m); break;
+        case ST_CHARGING_100W: handle_state_charging_100w(m); break;
+        case ST_CHARGING_MPPT: handle_state_charging_mppt(m); break;
+        case ST_DISCHARGING:   handle_state_discharging(m); break;
+        case ST_FAULT:         handle_state_fault(m); break;
+        case ST_STANDBY:       handle_state_standby(m); break;
+        default: break;
+    }
+}
+
+static void nested_init(void) {
+    machine.state = ST_IDLE;
+    machine.signal = EV_NONE;
+}
+
+static void nested_run(const uint8_t* events, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        machine.signal = (BenchEvent)events[i];
+        dispatch(&machine);
+    }
+}
+
+static BenchState nested_state(void) {
+    return machine.state;
+}
+
+const DispatchVariant variant_nested_switch = {
+    .name = "nested switch",
+    .origin = "1nestedswitch",
+    .instance_bytes = sizeof(Machine),
+    .init = nested_init,
+    .run = nested_run,
+    .state = nested_state,
+};
@@ -0,0 +1,92 @@
+// v2_state_table.c - [state][signal] table of handler pointers
+// (statePractice/2stateTable)
+#include "machine.h"
+
+typedef struct {
+    BenchState state;
+    BenchEvent event;
+} Machine;
+
+typedef void (*StateHandler)(Machine *machine);
+
+static Machine machine;
+
+static void machine_ignore(Machine *m) {
+    (void)m;
+    bench_unhandled++;
+}
+static void machine_stay(Machine *m) {      // FAULT: dropped silently
+    (void)m;
+}
+static void machine_to_idle(Machine *m) {
+    m->state = ST_IDLE;
+    act_idle();
+}
+static void machine_to_60w(Machine *m) {
+    m->state = ST_CHARGING_60W;
+    act_charge_60w();
+}
+static void machine_to_100w(Machine *m) {
+    m->state = ST_CHARGING_100W;
+    act_charge_100w();
+}
+static void machine_to_mppt(Machine *m) {
+    m->state = ST_CHARGING_MPPT;
+    act_charge_mppt();
+}
+static void machine_to_discharging(Machine *m) {
+    m->state = ST_DISCHARGING;
+    act_discharge();
+}
+static void machine_to_fault(Machine *m) {
+    m->state = ST_FAULT;
+    act_fault();
+}
+
+#define IGN machine_ignore
+#define STY machine_stay
+// state table
+static StateHandler const state_table[ST_MAX][EV_MAX] = {
+/*                 NONE 60W              100W              MPPT              DONE             ERROR             BMS_FAULT         PGOOD                   TEMP              CURRENT TIMEOUT FAULT RESET */
+/* IDLE     */ { IGN, machine_to_60w, machine_to_100w, machine_to_mppt, IGN,             IGN,              machine_to_fault, machine_to_discharging, IGN,              IGN, IGN, IGN, IGN },
+/* CHG_60W  */ { IGN, IGN,            machine_to_100w, machine_to_mppt, machine_to_idle, machine_to_fault, machine_to_fault, IGN,                    machine_to_fault, IGN, IGN, IGN, IGN },
+/* CHG_100W */ { IGN, machine_to_60w, IGN,             machine_to_mppt, machine_to_idle, machine_to_fault, machine_to_fault, IGN,                    machine_to_fault, IGN, IGN, IGN, IGN },
+/* CHG_MPPT */ { IGN, machine_to_60w, machine_to_100w, IGN,             machine_to_idle, machine_to_fault, machine_to_fault, IGN,                    machine_to_fault, IGN, IGN, IGN, IGN },
+/* DISCHG   */ { IGN, machine_to_60w, machine_to_100w, machine_to_mppt, IGN,             IGN,              machine_to_fault, IGN,                    IGN,              IGN, IGN, IGN, IGN },
+/* FAULT    */ { STY, STY,            STY,             STY,             STY,             STY,              STY,              STY,                    STY,              STY, STY, STY, machine_to_idle },
+/* STANDBY  */ { IGN, machine_to_60w, machine_to_100w, machine_to_mppt, IGN,             IGN,              machine_to_fault, machine_to_discharging, IGN,              IGN, IGN, IGN, IGN },
+};
+#undef IGN
+#undef STY
+
+static void dispatch(Machine *m) {
+    if (m->state >= ST_MAX || m->event >= EV_MAX) {
+        return;
+    }
+    (*state_table[m->state][m->event])(m);
+}
+
+static void table_init(void) {
+    machine.state = ST_IDLE;
+    machine.event = EV_NONE;
+}
+
+static void table_run(const uint8_t* events, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        machine.event = (BenchEvent)events[i];
+        dispatch(&machine);
+    }
+}
+
+static BenchState table_state(void) {
+    return machine.state;
+}
+
+const DispatchVariant variant_state_table = {
+    .name = "state table [state][event]",
+    .origin = "2stateTable",
+    .instance_bytes = sizeof(Machine),
+    .init = table_init,
+    .run = table_run,
+    .state = table_state,
+};
@@ -0,0 +1,175 @@
+// v3_state_handler.c - state structs of entry / transition pointers, reached
+// through methods bound into the machine object (statePractice/3stateHandler)
+#include "machine.h"
+
+typedef void (*StateFunc)(void);
+typedef struct {
+    StateFunc Entry;
+    StateFunc Main;
+    StateFunc Exit;
+    StateFunc Transition;
+} State;
+
+typedef enum { ENTRY, MAIN, EXIT, TRANSITION } StateAction;
+
+typedef struct StateMachine StateMachine;
+struct StateMachine {
+    const State* current_state;
+    BenchEvent event;               // signal the Transition function reads
+    /* methods */
+    void (*dispatch)(StateMachine* sm, StateAction action);
+    void (*set_state)(StateMachine* sm, const State* new_state);
+};
+
+static StateMachine sm;
+
+static void state_machine_dispatch_impl(StateMachine* m, StateAction action) {
+    if (!m->current_state) return;
+    switch (action) {
+        case ENTRY:
+            if (m->current_state->Entry) m->current_state->Entry();
+            break;
+        case MAIN:
+            if (m->current_state->Main) m->current_state->Main();
+            break;
+        case EXIT:
+            if (m->current_state->Exit) m->current_state->Exit();
+            break;
+        case TRANSITION:
+            if (m->current_state->Transition) m->current_state->Transition();
+            break;
+        default:
+            break;
+    }
+}
+
+static void state_machine_set_state_impl(StateMachine* m, const State* new_state) {
+    m->current_state = new_state;
+}
+
+static void idle_trans(void);
+static void chg60_trans(void);
+static void chg100_trans(void);
+static void mppt_trans(void);
+static void dischg_trans(void);
+static void fault_trans(void);
+static void standby_trans(void);
+
+static const State IDLE_S        = { act_idle,        0, 0, idle_trans };
+static const State CHARGING_60W  = { act_charge_60w,  0, 0, chg60_trans };
+static const State CHARGING_100W = { act_charge_100w, 0, 0, chg100_trans };
+static const State CHARGING_MPPT = { act_charge_mppt, 0, 0, mppt_trans };
+static const State DISCHARGING   = { act_discharge,   0, 0, dischg_trans };
+static const State FAULT_S       = { act_fault,       0, 0, fault_trans };
+static const State STANDBY       = { 0,               0, 0, standby_trans };
+
+static void go(const State* s) {
+    sm.dispatch(&sm, EXIT);
+    sm.set_state(&sm, s);
+    sm.dispatch(&sm, ENTRY);
+}
+
+// CHARGING superstate
+static void charging_trans(void) {
+    switch (sm.event) {
+        case EV_BQ_CHARGING_ERROR:
+        case EV_ADC_TEMP_HIGH:
+        case EV_BMS_FAULT: go(&FAULT_S); break;
+        default: bench_unhandled++; break;
+    }
+}
+
+static void idle_trans(void) {
+    switch (sm.event) {
+        case EV_60W_CONNECTED:   go(&CHARGING_60W); break;
+        case EV_100W_CONNECTED:  go(&CHARGING_100W); break;
+        case EV_MPPT_CONNECTED:  go(&CHARGING_MPPT); break;
+        case EV_POWER_GOOD_VBAT: go(&DISCHARGING); break;
+        case EV_BMS_FAULT:       go(&FAULT_S); break;
+        default: bench_unhandled++; break;
+    }
+}
+
+static void chg60_trans(void) {
+    switch (sm.event) {
+        case EV_BQ_CHARGING_DONE: go(&IDLE_S); break;
+        case EV_100W_CONNECTED:   go(&CHARGING_100W); break;
+        case EV_MPPT_CONNECTED:   go(&CHARGING_MPPT); break;
+        default: charging_trans(); break;
+    }
+}
+
+static void chg100_trans(void) {
+    switch (sm.event) {
+        case EV_BQ_CHARGING_DONE: go(&IDLE_S); break;
+        case EV_60W_CONNECTED:    go(&CHARGING_60W); break;
+        case EV_MPPT_CONNECTED:   go(&CHARGING_MPPT); break;
+        default: charging_trans(); break;
+    }
+}
+
+static void mppt_trans(void) {
+    switch (sm.event) {
+        case EV_BQ_CHARGING_DONE: go(&IDLE_S); break;
+        case EV_60W_CONNECTED:    go(&CHARGING_60W); break;
+        case EV_100W_CONNECTED:   go(&CHARGING_100W); break;
+        default: charging_trans(); break;
+    }
+}
+
+static void dischg_trans(void) {
+    switch (sm.event) {
+        case EV_60W_CONNECTED:  go(&CHARGING_60W); break;
+        case EV_100W_CONNECTED: go(&CHARGING_100W); break;
+        case EV_MPPT_CONNECTED: go(&CHARGING_MPPT); break;
+        case EV_BMS_FAULT:      go(&FAULT_S); break;
+        default: bench_unhandled++; break;
+    }
+}
+
+static void fault_trans(void) {
+    if (sm.event == EV_RESET) go(&IDLE_S);
+}
+
+static void standby_trans(void) {
+    switch (sm.event) {
+        case EV_POWER_GOOD_VBAT: go(&DISCHARGING); break;
+        case EV_60W_CONNECTED:   go(&CHARGING_60W); break;
+        case EV_100W_CONNECTED:  go(&CHARGING_100W); break;
+        case EV_MPPT_CONNECTED:  go(&CHARGING_MPPT); break;
+        case EV_BMS_FAULT:       go(&FAULT_S); break;
+        default: bench_unhandled++; break;
+    }
+}
+
+static void handler_init(void) {
+    sm.dispatch = state_machine_dispatch_impl;
+    sm.set_state = state_machine_set_state_impl;
+    sm.current_state = &IDLE_S;
+}
+
+static void handler_run(const uint8_t* events, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        sm.event = (BenchEvent)events[i];
+        sm.dispatch(&sm, TRANSITION);
+    }
+}
+
+static BenchState handler_state(void) {
+    static const State* const order[ST_MAX] = {
+        &IDLE_S, &CHARGING_60W, &CHARGING_100W, &CHARGING_MPPT, &DISCHARGING, &FAULT_S, &STANDBY,
+    };
+    for (int i = 0; i < ST_MAX; i++) {
+        if (order[i] == sm.current_state) return (BenchState)i;
+    }
+    return ST_MAX;
+}
+
+const DispatchVariant variant_state_handler = {
+    .name = "state handler (bound methods)",
+    .origin = "3stateHandler",
+    .instance_bytes = sizeof(StateMachine),
+    .init = handler_init,
+    .run = handler_run,
+    .state = handler_state,
+};
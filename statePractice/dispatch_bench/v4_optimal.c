@@ -0,0 +1,181 @@
+// v4_optimal.c - state structs of function pointers, a state id switch and
+// one direct dispatch function per action (statePractice/3optimal)
+#include "machine.h"
+
+typedef void (*StateFunc)(void);
+typedef struct {
+    StateFunc Entry;
+    StateFunc Main;
+    StateFunc Exit;
+    StateFunc Transition;
+} State;
+
+typedef struct {
+    State IDLE;
+    State CHARGING_60W;
+    State CHARGING_100W;
+    State CHARGING_MPPT;
+    State DISCHARGING;
+    State FAULT;
+    State STANDBY;
+} States;
+
+typedef struct {
+    States* states;
+    State* current_state;
+    int current_state_id;
+    BenchEvent event;
+} StateMachine;
+
+static StateMachine sm;
+
+static void idle_trans(void);
+static void chg60_trans(void);
+static void chg100_trans(void);
+static void mppt_trans(void);
+static void dischg_trans(void);
+static void fault_trans(void);
+static void standby_trans(void);
+
+static States all_states = {
+    .IDLE          = { act_idle,        0, 0, idle_trans },
+    .CHARGING_60W  = { act_charge_60w,  0, 0, chg60_trans },
+    .CHARGING_100W = { act_charge_100w, 0, 0, chg100_trans },
+    .CHARGING_MPPT = { act_charge_mppt, 0, 0, mppt_trans },
+    .DISCHARGING   = { act_discharge,   0, 0, dischg_trans },
+    .FAULT         = { act_fault,       0, 0, fault_trans },
+    .STANDBY       = { 0,               0, 0, standby_trans },
+};
+
+static void state_machine_set_state(StateMachine* m, int state_id) {
+    m->current_state_id = state_id;
+    switch (state_id) {
+        case ST_IDLE:          m->current_state = &all_states.IDLE; break;
+        case ST_CHARGING_60W:  m->current_state = &all_states.CHARGING_60W; break;
+        case ST_CHARGING_100W: m->current_state = &all_states.CHARGING_100W; break;
+        case ST_CHARGING_MPPT: m->current_state = &all_states.CHARGING_MPPT; break;
+        case ST_DISCHARGING:   m->current_state = &all_states.DISCHARGING; break;
+        case ST_FAULT:         m->current_state = &all_states.FAULT; break;
+        case ST_STANDBY:       m->current_state = &all_states.STANDBY; break;
+    }
+}
+
+static void state_machine_dispatch_entry(StateMachine* m) {
+    if (m->current_state && m->current_state->Entry)
+        m->current_state->Entry();
+}
+
+static void state_machine_dispatch_exit(StateMachine* m) {
+    if (m->current_state && m->current_state->Exit)
+        m->current_state->Exit();
+}
+
+static void state_machine_dispatch_transition(StateMachine* m) {
+    if (m->current_state && m->current_state->Transition)
+        m->current_state->Transition();
+}
+
+static void go(int state_id) {
+    state_machine_dispatch_exit(&sm);
+    state_machine_set_state(&sm, state_id);
+    state_machine_dispatch_entry(&sm);
+}
+
+// CHARGING superstate
+static void charging_trans(void) {
+    switch (sm.event) {
+        case EV_BQ_CHARGING_ERROR:
+        case EV_ADC_TEMP_HIGH:
+        case EV_BMS_FAULT: go(ST_FAULT); break;
+        default: bench_unhandled++; break;
+    }
+}
+
+static void idle_trans(void) {
+    switch (sm.event) {
+        case EV_60W_CONNECTED:   go(ST_CHARGING_60W); break;
+        case EV_100W_CONNECTED:  go(ST_CHARGING_100W); break;
+        case EV_MPPT_CONNECTED:  go(ST_CHARGING_MPPT); break;
+        case EV_POWER_GOOD_VBAT: go(ST_DISCHARGING); break;
+        case EV_BMS_FAULT:       go(ST_FAULT); break;
+        default: bench_unhandled++; break;
+    }
+}
+
+static void chg60_trans(void) {
+    switch (sm.event) {
+        case EV_BQ_CHARGING_DONE: go(ST_IDLE); break;
+        case EV_100W_CONNECTED:   go(ST_CHARGING_100W); break;
+        case EV_MPPT_CONNECTED:   go(ST_CHARGING_MPPT); break;
+        default: charging_trans(); break;
+    }
+}
+
+static void chg100_trans(void) {
+    switch (sm.event) {
+        case EV_BQ_CHARGING_DONE: go(ST_IDLE); break;
+        case EV_60W_CONNECTED:    go(ST_CHARGING_60W); break;
+        case EV_MPPT_CONNECTED:   go(ST_CHARGING_MPPT); break;
+        default: charging_trans(); break;
+    }
+}
+
+static void mppt_trans(void) {
+    switch (sm.event) {
+        case EV_BQ_CHARGING_DONE: go(ST_IDLE); break;
+        case EV_60W_CONNECTED:    go(ST_CHARGING_60W); break;
+        case EV_100W_CONNECTED:   go(ST_CHARGING_100W); break;
+        default: charging_trans(); break;
+    }
+}
+
+static void dischg_trans(void) {
+    switch (sm.event) {
+        case EV_60W_CONNECTED:  go(ST_CHARGING_60W); break;
+        case EV_100W_CONNECTED: go(ST_CHARGING_100W); break;
+        case EV_MPPT_CONNECTED: go(ST_CHARGING_MPPT); break;
+        case EV_BMS_FAULT:      go(ST_FAULT); break;
+        default: bench_unhandled++; break;
+    }
+}
+
+static void fault_trans(void) {
+    if (sm.event == EV_RESET) go(ST_IDLE);
+}
+
+static void standby_trans(void) {
+    switch (sm.event) {
+        case EV_POWER_GOOD_VBAT: go(ST_DISCHARGING); break;
+        case EV_60W_CONNECTED:   go(ST_CHARGING_60W); break;
+        case EV_100W_CONNECTED:  go(ST_CHARGING_100W); break;
+        case EV_MPPT_CONNECTED:  go(ST_CHARGING_MPPT); break;
+        case EV_BMS_FAULT:       go(ST_FAULT); break;
+        default: bench_unhandled++; break;
+    }
+}
+
+static void optimal_init(void) {
+    sm.states = &all_states;
+    sm.current_state_id = ST_IDLE;
+    sm.current_state = &all_states.IDLE;
+}
+
+static void optimal_run(const uint8_t* events, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        sm.event = (BenchEvent)events[i];
+        state_machine_dispatch_transition(&sm);
+    }
+}
+
+static BenchState optimal_state(void) {
+    return (BenchState)sm.current_state_id;
+}
+
+const DispatchVariant variant_optimal = {
+    .name = "direct dispatch + state id",
+    .origin = "3optimal",
+    .instance_bytes = sizeof(StateMachine),
+    .init = optimal_init,
+    .run = optimal_run,
+    .state = optimal_state,
+};
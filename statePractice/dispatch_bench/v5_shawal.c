@@ -0,0 +1,149 @@
+// v5_shawal.c - the reusable library: const StateActions per state,
+// transition_signal(event) and ChangeState() with exit / entry actions
+// (statePractice/shawal_machine, lib/state_machine linked unmodified)
+#include "machine.h"
+#include "state_machine.h"
+
+// Library instance and its transition entry point
+extern StateMachine g_stateMachine;
+
+static void idle_transition(Event event);
+static void chg60_transition(Event event);
+static void chg100_transition(Event event);
+static void mppt_transition(Event event);
+static void dischg_transition(Event event);
+static void fault_transition(Event event);
+static void standby_transition(Event event);
+
+static const StateActions BENCH_IDLE_STATE = {
+    .entry_action = act_idle, .transition_signal = idle_transition
+};
+static const StateActions BENCH_CHARGING_60W_STATE = {
+    .entry_action = act_charge_60w, .transition_signal = chg60_transition
+};
+static const StateActions BENCH_CHARGING_100W_STATE = {
+    .entry_action = act_charge_100w, .transition_signal = chg100_transition
+};
+static const StateActions BENCH_CHARGING_MPPT_STATE = {
+    .entry_action = act_charge_mppt, .transition_signal = mppt_transition
+};
+static const StateActions BENCH_DISCHARGING_STATE = {
+    .entry_action = act_discharge, .transition_signal = dischg_transition
+};
+static const StateActions BENCH_FAULT_STATE = {
+    .entry_action = act_fault, .transition_signal = fault_transition
+};
+static const StateActions BENCH_STANDBY_STATE = {
+    .transition_signal = standby_transition
+};
+
+// CHARGING superstate
+static void charging_transition(Event event) {
+    switch ((int)event) {
+        case EV_BQ_CHARGING_ERROR:
+        case EV_ADC_TEMP_HIGH:
+        case EV_BMS_FAULT:
+            ChangeState(&BENCH_FAULT_STATE);
+            break;
+        default:
+            bench_unhandled++;
+            break;
+    }
+}
+
+static void idle_transition(Event event) {
+    switch ((int)event) {
+        case EV_60W_CONNECTED:   ChangeState(&BENCH_CHARGING_60W_STATE); break;
+        case EV_100W_CONNECTED:  ChangeState(&BENCH_CHARGING_100W_STATE); break;
+        case EV_MPPT_CONNECTED:  ChangeState(&BENCH_CHARGING_MPPT_STATE); break;
+        case EV_POWER_GOOD_VBAT: ChangeState(&BENCH_DISCHARGING_STATE); break;
+        case EV_BMS_FAULT:       ChangeState(&BENCH_FAULT_STATE); break;
+        default: bench_unhandled++; break;
+    }
+}
+
+static void chg60_transition(Event event) {
+    switch ((int)event) {
+        case EV_BQ_CHARGING_DONE: ChangeState(&BENCH_IDLE_STATE); break;
+        case EV_100W_CONNECTED:   ChangeState(&BENCH_CHARGING_100W_STATE); break;
+        case EV_MPPT_CONNECTED:   ChangeState(&BENCH_CHARGING_MPPT_STATE); break;
+        default: charging_transition(event); break;
+    }
+}
+
+static void chg100_transition(Event event) {
+    switch ((int)event) {
+        case EV_BQ_CHARGING_DONE: ChangeState(&BENCH_IDLE_STATE); break;
+        case EV_60W_CONNECTED:    ChangeState(&BENCH_CHARGING_60W_STATE); break;
+        case EV_MPPT_CONNECTED:   ChangeState(&BENCH_CHARGING_MPPT_STATE); break;
+        default: charging_transition(event); break;
+    }
+}
+
+static void mppt_transition(Event event) {
+    switch ((int)event) {
+        case EV_BQ_CHARGING_DONE: ChangeState(&BENCH_IDLE_STATE); break;
+        case EV_60W_CONNECTED:    ChangeState(&BENCH_CHARGING_60W_STATE); break;
+        case EV_100W_CONNECTED:   ChangeState(&BENCH_CHARGING_100W_STATE); break;
+        default: charging_transition(event); break;
+    }
+}
+
+static void dischg_transition(Event event) {
+    switch ((int)event) {
+        case EV_60W_CONNECTED:  ChangeState(&BENCH_CHARGING_60W_STATE); break;
+        case EV_100W_CONNECTED: ChangeState(&BENCH_CHARGING_100W_STATE); break;
+        case EV_MPPT_CONNECTED: ChangeState(&BENCH_CHARGING_MPPT_STATE); break;
+        case EV_BMS_FAULT:      ChangeState(&BENCH_FAULT_STATE); break;
+        default: bench_unhandled++; break;
+    }
+}
+
+static void fault_transition(Event event) {
+    if ((int)event == EV_RESET) ChangeState(&BENCH_IDLE_STATE);
+}
+
+static void standby_transition(Event event) {
+    switch ((int)event) {
+        case EV_POWER_GOOD_VBAT: ChangeState(&BENCH_DISCHARGING_STATE); break;
+        case EV_60W_CONNECTED:   ChangeState(&BENCH_CHARGING_60W_STATE); break;
+        case EV_100W_CONNECTED:  ChangeState(&BENCH_CHARGING_100W_STATE); break;
+        case EV_MPPT_CONNECTED:  ChangeState(&BENCH_CHARGING_MPPT_STATE); break;
+        case EV_BMS_FAULT:       ChangeState(&BENCH_FAULT_STATE); break;
+        default: bench_unhandled++; break;
+    }
+}
+
+static void shawal_init(void) {
+    g_stateMachine.current_state = &BENCH_IDLE_STATE;
+}
+
+// As ProcessBmsEvent() in examples/battery_management_system/main.c
+static void shawal_run(const uint8_t* events, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (g_stateMachine.current_state != NULL && g_stateMachine.current_state->transition_signal != NULL) {
+            g_stateMachine.current_state->transition_signal((Event)events[i]);
+        }
+    }
+}
+
+static BenchState shawal_state(void) {
+    static const StateActions* const order[ST_MAX] = {
+        &BENCH_IDLE_STATE, &BENCH_CHARGING_60W_STATE, &BENCH_CHARGING_100W_STATE,
+        &BENCH_CHARGING_MPPT_STATE, &BENCH_DISCHARGING_STATE, &BENCH_FAULT_STATE,
+        &BENCH_STANDBY_STATE,
+    };
+    for (int i = 0; i < ST_MAX; i++) {
+        if (order[i] == g_stateMachine.current_state) return (BenchState)i;
+    }
+    return ST_MAX;
+}
+
+const DispatchVariant variant_shawal = {
+    .name = "shawal_machine library",
+    .origin = "shawal_machine/lib",
+    .instance_bytes = sizeof(StateMachine),
+    .init = shawal_init,
+    .run = shawal_run,
+    .state = shawal_state,
+};
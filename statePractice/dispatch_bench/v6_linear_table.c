@@ -0,0 +1,129 @@
+// v6_linear_table.c - list of {state, event, action, next} rows searched
+// linearly, then the CHARGING superstate rows (sample_state_machine.c)
+#include "machine.h"
+#include <stdbool.h>
+
+// Pseudo-state holding the rows every charging state inherits
+#define ST_HIERARCHICAL_CHARGING ((BenchState)ST_MAX)
+
+typedef struct {
+    BenchState current_state;
+    BenchEvent event;
+    void (*action)(void);
+    BenchState next_state;
+} StateTransition_t;
+
+// Row order as in sample_state_machine.c; the last row replaces its
+// {FAULT, NONE, no_action, FAULT} self-transition
+static const StateTransition_t state_transitions[] = {
+    // Global/Hierarchical Transitions
+    {ST_HIERARCHICAL_CHARGING, EV_BQ_CHARGING_ERROR, act_fault, ST_FAULT},
+    {ST_HIERARCHICAL_CHARGING, EV_ADC_TEMP_HIGH, act_fault, ST_FAULT},
+    {ST_IDLE, EV_BMS_FAULT, act_fault, ST_FAULT},
+    {ST_CHARGING_60W, EV_BMS_FAULT, act_fault, ST_FAULT},
+    {ST_CHARGING_100W, EV_BMS_FAULT, act_fault, ST_FAULT},
+    {ST_CHARGING_MPPT, EV_BMS_FAULT, act_fault, ST_FAULT},
+    {ST_DISCHARGING, EV_BMS_FAULT, act_fault, ST_FAULT},
+    {ST_STANDBY, EV_BMS_FAULT, act_fault, ST_FAULT},
+
+    // Transitions from IDLE
+    {ST_IDLE, EV_60W_CONNECTED, act_charge_60w, ST_CHARGING_60W},
+    {ST_IDLE, EV_100W_CONNECTED, act_charge_100w, ST_CHARGING_100W},
+    {ST_IDLE, EV_MPPT_CONNECTED, act_charge_mppt, ST_CHARGING_MPPT},
+    {ST_IDLE, EV_POWER_GOOD_VBAT, act_discharge, ST_DISCHARGING},
+
+    // Transitions from CHARGING_60W
+    {ST_CHARGING_60W, EV_BQ_CHARGING_DONE, act_idle, ST_IDLE},
+    {ST_CHARGING_60W, EV_100W_CONNECTED, act_charge_100w, ST_CHARGING_100W},
+    {ST_CHARGING_60W, EV_MPPT_CONNECTED, act_charge_mppt, ST_CHARGING_MPPT},
+
+    // Transitions from CHARGING_100W
+    {ST_CHARGING_100W, EV_BQ_CHARGING_DONE, act_idle, ST_IDLE},
+    {ST_CHARGING_100W, EV_60W_CONNECTED, act_charge_60w, ST_CHARGING_60W},
+    {ST_CHARGING_100W, EV_MPPT_CONNECTED, act_charge_mppt, ST_CHARGING_MPPT},
+
+    // Transitions from CHARGING_MPPT
+    {ST_CHARGING_MPPT, EV_BQ_CHARGING_DONE, act_idle, ST_IDLE},
+    {ST_CHARGING_MPPT, EV_60W_CONNECTED, act_charge_60w, ST_CHARGING_60W},
+    {ST_CHARGING_MPPT, EV_100W_CONNECTED, act_charge_100w, ST_CHARGING_100W},
+
+    // Transitions from DISCHARGING
+    {ST_DISCHARGING, EV_60W_CONNECTED, act_charge_60w, ST_CHARGING_60W},
+    {ST_DISCHARGING, EV_100W_CONNECTED, act_charge_100w, ST_CHARGING_100W},
+    {ST_DISCHARGING, EV_MPPT_CONNECTED, act_charge_mppt, ST_CHARGING_MPPT},
+
+    // Transitions from STANDBY
+    {ST_STANDBY, EV_POWER_GOOD_VBAT, act_discharge, ST_DISCHARGING},
+    {ST_STANDBY, EV_60W_CONNECTED, act_charge_60w, ST_CHARGING_60W},
+    {ST_STANDBY, EV_100W_CONNECTED, act_charge_100w, ST_CHARGING_100W},
+    {ST_STANDBY, EV_MPPT_CONNECTED, act_charge_mppt, ST_CHARGING_MPPT},
+
+    // Reset out of FAULT
+    {ST_FAULT, EV_RESET, act_idle, ST_IDLE},
+};
+
+static const int NUM_TRANSITIONS =
+    sizeof(state_transitions) / sizeof(StateTransition_t);
+
+static BenchState current_state = ST_IDLE;
+
+static bool is_charging_state(BenchState state) {
+    return state == ST_CHARGING_60W || state == ST_CHARGING_100W ||
+           state == ST_CHARGING_MPPT;
+}
+
+static void dispatch_event(BenchEvent event) {
+    // FAULT only answers to the reset row
+    if (current_state == ST_FAULT && event != EV_RESET) {
+        return;
+    }
+
+    for (int i = 0; i < NUM_TRANSITIONS; ++i) {
+        if (state_transitions[i].current_state == current_state &&
+            state_transitions[i].event == event) {
+            if (state_transitions[i].action != NULL) {
+                state_transitions[i].action();
+            }
+            current_state = state_transitions[i].next_state;
+            return;
+        }
+    }
+
+    if (is_charging_state(current_state)) {
+        for (int i = 0; i < NUM_TRANSITIONS; ++i) {
+            if (state_transitions[i].current_state == ST_HIERARCHICAL_CHARGING &&
+                state_transitions[i].event == event) {
+                if (state_transitions[i].action != NULL) {
+                    state_transitions[i].action();
+                }
+                current_state = state_transitions[i].next_state;
+                return;
+            }
+        }
+    }
+
+    bench_unhandled++;
+}
+
+static void linear_init(void) {
+    current_state = ST_IDLE;
+}
+
+static void linear_run(const uint8_t* events, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        dispatch_event((BenchEvent)events[i]);
+    }
+}
+
+static BenchState linear_state(void) {
+    return current_state;
+}
+
+const DispatchVariant variant_linear_table = {
+    .name = "linear-scan transition table",
+    .origin = "sample_state_machine.c",
+    .instance_bytes = sizeof(current_state),
+    .init = linear_init,
+    .run = linear_run,
+    .state = linear_state,
+};
@@ -0,0 +1,622 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "../../lib/state_machine/state_machine.h"
+#include "bms_states.h"
+#include "bms_events.h"
+#include "hw_abstraction.h"
+
+/*
+ * Bounded Model Checker for the Battery Management System
+ *
+ * Links the unmodified state and event code of the example and drives it
+ * with every input sequence up to a bounded depth, starting from the same
+ * initial state as main(). Each input goes the way the firmware delivers it:
+ * PostBmsEvent(), GetBmsEvent(), then the current state's transition_signal.
+ * After every step the safety properties below are checked against the
+ * simulated GPIO outputs.
+ *
+ * The report lists:
+ * - the (state, input) transition table, built by calling every state's
+ *   transition function directly with every input
+ * - states not reachable from IDLE within the depth
+ * - inputs GetBmsEvent() drops, and table entries that therefore never fire
+ * - unhandled (state, input) pairs that a reachable run can hit
+ * - every safety property with its violation count and the shortest
+ *   counterexample
+ *
+ * Sequences are split by their first two inputs across forked workers
+ * (-j, default: one per core); each worker sends its totals back through a
+ * pipe and the merged report does not depend on the worker count.
+ *
+ * Main actions are not run: the events they post (ADC thresholds, NTC, 12V
+ * fault pin) are part of the input alphabet instead, so every interleaving
+ * the environment could produce is covered.
+ *
+ * Usage: bms_model_check [-d depth] [-j workers]
+ * Exit status is 1 when a safety property is violated.
+ */
+
+#define MC_DEFAULT_DEPTH 5
+#define MC_MAX_DEPTH     8
+#define MC_MAX_WORKERS   64
+#define MC_SPLIT_DEPTH   2      // inputs per work unit prefix
+
+// --- Model ---
+
+// External state machine instance from library
+extern StateMachine g_stateMachine;
+
+static const StateActions* const states[] = {
+    &BMS_IDLE_STATE,
+    &BMS_CHARGING_STATE,
+    &BMS_DISCHARGING_STATE,
+    &BMS_LED_CONTROL_STATE,
+    &BMS_FAULT_STATE,
+    &BMS_DEEP_SLEEP_STATE,
+};
+static const char* const state_names[] = {
+    "IDLE", "CHARGING", "DISCHARGING", "LED_CONTROL", "FAULT", "DEEP_SLEEP",
+};
+#define STATE_LETTERS "ICDLFS"
+#define NUM_STATES ((int)(sizeof(states) / sizeof(states[0])))
+#define STATE_IDLE     0
+#define STATE_CHARGING 1
+#define STATE_LED      3
+#define STATE_FAULT    4
+#define STATE_SLEEP    5
+
+// One environment input: an event, plus the supply ADC levels the entry
+// actions see when it arrives (-1 = unchanged)
+typedef struct {
+    const char* name;
+    int event;
+    int usb_c;
+    int solar;
+} Input;
+
+static const Input inputs[] = {
+    {"EVENT_BUTTON_PRESS",         EVENT_BUTTON_PRESS,        -1, -1},
+    {"EVENT_TIMEOUT",              EVENT_TIMEOUT,             -1, -1},
+    {"EVENT_DOOR_OPEN",            EVENT_DOOR_OPEN,           -1, -1},
+    {"EVENT_QUEUE_FULL",           EVENT_QUEUE_FULL,          -1, -1},
+    {"POWER_SOURCE_CONNECTED/60W", POWER_SOURCE_CONNECTED,   150,  0},
+    {"POWER_SOURCE_CONNECTED/100W", POWER_SOURCE_CONNECTED,  250,  0},
+    {"SOLAR_POWER_CONNECTED",      SOLAR_POWER_CONNECTED,      0, 75},
+    {"POWER_SOURCE_DISCONNECTED",  POWER_SOURCE_DISCONNECTED,  0,  0},
+    {"CHARGE_COMPLETE",            CHARGE_COMPLETE,           -1, -1},
+    {"LIGHT_SWITCH_TOGGLED",       LIGHT_SWITCH_TOGGLED,      -1, -1},
+    {"BATTERY_TEMP_FAULT",         BATTERY_TEMP_FAULT,        -1, -1},
+    {"BMS_INTERRUPT",              BMS_INTERRUPT,             -1, -1},
+    {"USB_FAULT",                  USB_FAULT,                 -1, -1},
+    {"SYSTEM_FAULT",               SYSTEM_FAULT,              -1, -1},
+    {"FAULT_RS485_12V",            FAULT_RS485_12V,           -1, -1},
+    {"BMS_COMM_FAULT",             BMS_COMM_FAULT,            -1, -1},
+    {"CHARGER_COMM_FAULT",         CHARGER_COMM_FAULT,        -1, -1},
+    {"BATTERY_CELL_UVLO",          BATTERY_CELL_UVLO,         -1, -1},
+    {"BATTERY_CELL_OVLO",          BATTERY_CELL_OVLO,         -1, -1},
+    {"HIGH_CURRENT_DETECTED",      HIGH_CURRENT_DETECTED,     -1, -1},
+    {"GO_TO_SLEEP",                GO_TO_SLEEP,               -1, -1},
+    {"WAKE_UP",                    WAKE_UP,                   -1, -1},
+};
+#define NUM_INPUTS ((int)(sizeof(inputs) / sizeof(inputs[0])))
+
+// Everything a step can change: the current state, the outputs, the supply
+#define MAX_PINS 16
+typedef struct {
+    StateHandler state;
+    int pins[MAX_PINS];
+    int usb_c;
+    int solar;
+} Snapshot;
+
+static void take_snapshot(Snapshot* s) {
+    s->state = g_stateMachine.current_state;
+    for (int i = 0; i < hw_pin_count; i++) {
+        s->pins[i] = *hw_pins[i].value;
+    }
+    s->usb_c = adc_usb_c_voltage;
+    s->solar = adc_solar_voltage;
+}
+
+static void restore_snapshot(const Snapshot* s) {
+    g_stateMachine.current_state = s->state;
+    for (int i = 0; i < hw_pin_count; i++) {
+        *hw_pins[i].value = s->pins[i];
+    }
+    adc_usb_c_voltage = s->usb_c;
+    adc_solar_voltage = s->solar;
+}
+
+static int state_index(StateHandler state) {
+    for (int i = 0; i < NUM_STATES; i++) {
+        if (states[i] == state) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Power-on values of the outputs (hw_abstraction.c), then main()'s start-up
+static Snapshot power_on;
+
+static void enter_initial_state(void) {
+    restore_snapshot(&power_on);
+    g_stateMachine.current_state = &BMS_IDLE_STATE;
+    g_stateMachine.current_state->entry_action();
+}
+
+// Unhandled events reported by the state under test
+static int unhandled_flag;
+
+static void on_unhandled(Event event, const char* state_name) {
+    (void)event;
+    (void)state_name;
+    unhandled_flag = 1;
+}
+
+// --- Safety properties ---
+
+// prev: state index before the step (-1 for the initial state)
+typedef struct {
+    const char* name;
+    int (*holds)(int prev, int cur);
+} Property;
+
+static int prop_fault_outputs_off(int prev, int cur) {
+    (void)prev;
+    return cur != STATE_FAULT ||
+           (pin_MPPT_BQ_CHARGE_ENABLE == HIGH && pin_ENABLE_BAT_OUTPUT == LOW &&
+            pin_ENABLE_LED_BUCK == LOW && pin_ENABLE_BUCK_BOOST_100W == LOW &&
+            pin_ENABLE_USB_100W == LOW && pin_ENABLE_USB_60W == LOW &&
+            pin_ENABLE_12V_RS485 == LOW && pin_ENABLE_DIAG_12V_RS485 == LOW);
+}
+
+static int prop_fault_is_latched(int prev, int cur) {
+    return prev != STATE_FAULT || cur == STATE_FAULT;
+}
+
+static int prop_charger_only_when_charging(int prev, int cur) {
+    (void)prev;
+    return pin_MPPT_BQ_CHARGE_ENABLE == HIGH || cur == STATE_CHARGING;   // Active low
+}
+
+static int prop_usb_paths_exclusive(int prev, int cur) {
+    (void)prev;
+    (void)cur;
+    return !(pin_ENABLE_USB_60W == HIGH && pin_ENABLE_USB_100W == HIGH);
+}
+
+static int prop_usb_only_when_charging(int prev, int cur) {
+    (void)prev;
+    return cur == STATE_CHARGING ||
+           (pin_ENABLE_USB_60W == LOW && pin_ENABLE_USB_100W == LOW &&
+            pin_ENABLE_BUCK_BOOST_100W == LOW);
+}
+
+static int prop_led_only_in_led_control(int prev, int cur) {
+    (void)prev;
+    return pin_ENABLE_LED_BUCK == LOW || cur == STATE_LED;
+}
+
+static int prop_sleep_outputs_off(int prev, int cur) {
+    (void)prev;
+    return cur != STATE_SLEEP ||
+           (pin_ENABLE_BAT_OUTPUT == LOW && pin_MPPT_BQ_CHARGE_ENABLE == HIGH &&
+            pin_ENABLE_LED_BUCK == LOW);
+}
+
+static const Property properties[] = {
+    {"FAULT: charger, battery, LED, USB and 12V outputs off", prop_fault_outputs_off},
+    {"FAULT is only left by a reset",                        prop_fault_is_latched},
+    {"charger enabled only in CHARGING",                     prop_charger_only_when_charging},
+    {"USB 60W and 100W paths never both on",                 prop_usb_paths_exclusive},
+    {"USB paths and 100W buck-boost only in CHARGING",       prop_usb_only_when_charging},
+    {"LED buck only in LED_CONTROL",                         prop_led_only_in_led_control},
+    {"DEEP_SLEEP: battery output, charger and LED off",      prop_sleep_outputs_off},
+};
+#define NUM_PROPERTIES ((int)(sizeof(properties) / sizeof(properties[0])))
+
+// --- Exploration ---
+
+// Totals of one worker; plain data so it can go through a pipe
+typedef struct {
+    unsigned long long steps;
+    unsigned long long sequences;       // leaves at the full depth
+    unsigned reached;                   // bit per state
+    unsigned char taken[NUM_STATES][NUM_INPUTS];     // transition fired in a run
+    unsigned char unhandled[NUM_STATES][NUM_INPUTS]; // hit in a run
+    unsigned long long dropped[NUM_INPUTS];
+    unsigned long long violations[NUM_PROPERTIES];
+    int cex_len[NUM_PROPERTIES];        // 0 = none
+    int cex[NUM_PROPERTIES][MC_MAX_DEPTH];
+} Result;
+
+static int depth_limit = MC_DEFAULT_DEPTH;
+static int path[MC_MAX_DEPTH];
+
+// Shorter first, then lexicographic: the same counterexample for any -j
+static int cex_better(const int* a, int alen, const int* b, int blen) {
+    if (blen == 0 || alen != blen) {
+        return blen == 0 || alen < blen;
+    }
+    return memcmp(a, b, sizeof(int) * (size_t)alen) < 0;
+}
+
+// Deliver one input through the event queue; record and check, unless the
+// node belongs to another work unit (count == 0)
+static void step(int input, int depth, int count, Result* r) {
+    const Input* in = &inputs[input];
+    int prev = state_index(g_stateMachine.current_state);
+
+    if (in->usb_c >= 0) adc_usb_c_voltage = in->usb_c;
+    if (in->solar >= 0) adc_solar_voltage = in->solar;
+
+    PostBmsEvent((BmsEvent)in->event);
+    Event event = GetBmsEvent();
+    unhandled_flag = 0;
+    if (event != EVENT_MAX) {
+        g_stateMachine.current_state->transition_signal(event);
+    }
+    path[depth] = input;
+    if (!count) {
+        return;
+    }
+
+    int cur = state_index(g_stateMachine.current_state);
+    r->steps++;
+    r->reached |= 1u << cur;
+    if (event == EVENT_MAX) {
+        r->dropped[input]++;
+    } else if (unhandled_flag) {
+        r->unhandled[prev][input] = 1;
+    } else if (cur != prev) {
+        r->taken[prev][input] = 1;
+    }
+    for (int p = 0; p < NUM_PROPERTIES; p++) {
+        if (!properties[p].holds(prev, cur)) {
+            r->violations[p]++;
+            if (cex_better(path, depth + 1, r->cex[p], r->cex_len[p])) {
+                memcpy(r->cex[p], path, sizeof(int) * (size_t)(depth + 1));
+                r->cex_len[p] = depth + 1;
+            }
+        }
+    }
+}
+
+static void explore(int depth, Result* r) {
+    if (depth == depth_limit) {
+        r->sequences++;
+        return;
+    }
+    Snapshot here;
+    take_snapshot(&here);
+    for (int i = 0; i < NUM_INPUTS; i++) {
+        step(i, depth, 1, r);
+        explore(depth + 1, r);
+        restore_snapshot(&here);
+    }
+}
+
+// Work unit u: one prefix of `split` inputs (u in base NUM_INPUTS). A prefix
+// node is counted by the unit whose remaining prefix inputs are all 0, so
+// every node is counted exactly once.
+static void run_unit(long u, int split, Result* r) {
+    int prefix[MC_SPLIT_DEPTH];
+    for (int d = split - 1; d >= 0; d--) {
+        prefix[d] = (int)(u % NUM_INPUTS);
+        u /= NUM_INPUTS;
+    }
+    enter_initial_state();
+    for (int d = 0; d < split; d++) {
+        int owner = 1;
+        for (int k = d + 1; k < split; k++) {
+            owner = owner && prefix[k] == 0;
+        }
+        step(prefix[d], d, owner, r);
+    }
+    explore(split, r);
+}
+
+static void run_worker(int worker, int workers, int split, long units, Result* r) {
+    memset(r, 0, sizeof(*r));
+    if (worker == 0) {
+        // The initial state is a node of every run; check it once
+        enter_initial_state();
+        r->reached |= 1u << STATE_IDLE;
+        for (int p = 0; p < NUM_PROPERTIES; p++) {
+            if (!properties[p].holds(-1, STATE_IDLE)) {
+                r->violations[p]++;
+                r->cex_len[p] = 0;
+            }
+        }
+    }
+    for (long u = worker; u < units; u += workers) {
+        run_unit(u, split, r);
+    }
+}
+
+static void merge(Result* into, const Result* r) {
+    into->steps += r->steps;
+    into->sequences += r->sequences;
+    into->reached |= r->reached;
+    for (int s = 0; s < NUM_STATES; s++) {
+        for (int i = 0; i < NUM_INPUTS; i++) {
+            into->taken[s][i] |= r->taken[s][i];
+            into->unhandled[s][i] |= r->unhandled[s][i];
+        }
+    }
+    for (int i = 0; i < NUM_INPUTS; i++) {
+        into->dropped[i] += r->dropped[i];
+    }
+    for (int p = 0; p < NUM_PROPERTIES; p++) {
+        into->violations[p] += r->violations[p];
+        if (r->cex_len[p] > 0 &&
+            cex_better(r->cex[p], r->cex_len[p], into->cex[p], into->cex_len[p])) {
+            memcpy(into->cex[p], r->cex[p], sizeof(r->cex[p]));
+            into->cex_len[p] = r->cex_len[p];
+        }
+    }
+}
+
+// Fork the workers and collect their results; -1 if one of them failed
+static int run_parallel(int workers, int split, long units, Result* total) {
+    pid_t pids[MC_MAX_WORKERS];
+    int fds[MC_MAX_WORKERS];
+    int failed = 0;
+
+    fflush(NULL);
+    for (int w = 0; w < workers; w++) {
+        int fd[2];
+        if (pipe(fd) != 0) {
+            return -1;
+        }
+        pids[w] = fork();
+        if (pids[w] < 0) {
+            return -1;
+        }
+        if (pids[w] == 0) {
+            static Result r;
+            close(fd[0]);
+            run_worker(w, workers, split, units, &r);
+            const char* p = (const char*)&r;
+            size_t left = sizeof(r);
+            while (left > 0) {
+                ssize_t n = write(fd[1], p, left);
+                if (n <= 0) {
+                    _exit(1);
+                }
+                p += n;
+                left -= (size_t)n;
+            }
+            _exit(0);
+        }
+        close(fd[1]);
+        fds[w] = fd[0];
+    }
+    for (int w = 0; w < workers; w++) {
+        static Result r;
+        char* p = (char*)&r;
+        size_t left = sizeof(r);
+        while (left > 0) {
+            ssize_t n = read(fds[w], p, left);
+            if (n <= 0) {
+                break;
+            }
+            p += n;
+            left -= (size_t)n;
+        }
+        close(fds[w]);
+        int status;
+        if (waitpid(pids[w], &status, 0) < 0 || !WIFEXITED(status) ||
+            WEXITSTATUS(status) != 0 || left != 0) {
+            failed = 1;
+            continue;
+        }
+        merge(total, &r);
+    }
+    return failed ? -1 : 0;
+}
+
+// --- Direct (state, input) table ---
+
+// Target state per (state, input) with the handler called directly;
+// -1 = reported unhandled, -2 = ignored without a report
+static int table[NUM_STATES][NUM_INPUTS];
+
+static void build_table(void) {
+    for (int s = 0; s < NUM_STATES; s++) {
+        restore_snapshot(&power_on);
+        g_stateMachine.current_state = NULL;
+        ChangeState(states[s]);
+        Snapshot entered;
+        take_snapshot(&entered);
+        for (int i = 0; i < NUM_INPUTS; i++) {
+            if (inputs[i].usb_c >= 0) adc_usb_c_voltage = inputs[i].usb_c;
+            if (inputs[i].solar >= 0) adc_solar_voltage = inputs[i].solar;
+            unhandled_flag = 0;
+            states[s]->transition_signal((Event)inputs[i].event);
+            int target = state_index(g_stateMachine.current_state);
+            if (unhandled_flag) {
+                table[s][i] = -1;
+            } else if (target == s) {
+                table[s][i] = -2;
+            } else {
+                table[s][i] = target;
+            }
+            restore_snapshot(&entered);
+        }
+    }
+}
+
+// --- Report ---
+
+static FILE* out;
+
+static void print_sequence(const int* seq, int len) {
+    fprintf(out, "IDLE");
+    for (int i = 0; i < len; i++) {
+        fprintf(out, " -> %s", inputs[seq[i]].name);
+    }
+    fprintf(out, "\n");
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void usage(const char* argv0) {
+    fprintf(stderr, "usage: %s [-d depth (1-%d, default %d)] [-j workers (default: cores)]\n",
+            argv0, MC_MAX_DEPTH, MC_DEFAULT_DEPTH);
+}
+
+int main(int argc, char** argv) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int workers = cores > 0 ? (int)cores : 1;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "d:j:h")) != -1) {
+        switch (opt) {
+            case 'd':
+                depth_limit = atoi(optarg);
+                break;
+            case 'j':
+                workers = atoi(optarg);
+                break;
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+    if (depth_limit < 1 || depth_limit > MC_MAX_DEPTH || workers < 1) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (workers > MC_MAX_WORKERS) {
+        workers = MC_MAX_WORKERS;
+    }
+    if (hw_pin_count > MAX_PINS) {
+        fprintf(stderr, "hw_pins has %d entries, MAX_PINS is %d\n", hw_pin_count, MAX_PINS);
+        return 2;
+    }
+
+    // The states log every action to stdout; the report keeps the real one
+    fflush(stdout);
+    out = fdopen(dup(STDOUT_FILENO), "w");
+    if (out == NULL || freopen("/dev/null", "w", stdout) == NULL) {
+        perror("stdout");
+        return 2;
+    }
+    hw_log_enabled = 0;
+    g_unhandledEventHook = on_unhandled;
+    take_snapshot(&power_on);
+
+    build_table();
+
+    int split = depth_limit < MC_SPLIT_DEPTH ? depth_limit : MC_SPLIT_DEPTH;
+    long units = 1;
+    for (int d = 0; d < split; d++) {
+        units *= NUM_INPUTS;
+    }
+    if (workers > units) {
+        workers = (int)units;
+    }
+
+    static Result total;
+    double t0 = now_seconds();
+    if (run_parallel(workers, split, units, &total) != 0) {
+        fprintf(out, "A worker failed\n");
+        return 2;
+    }
+    double elapsed = now_seconds() - t0;
+
+    fprintf(out, "=== BMS Model Check ===\n");
+    fprintf(out, "%d states, %d inputs, depth %d, %d worker(s) on %ld core(s)\n",
+            NUM_STATES, NUM_INPUTS, depth_limit, workers, cores);
+    fprintf(out, "%llu sequences, %llu steps in %.3f s (%.2f M steps/s)\n\n",
+            total.sequences, total.steps, elapsed,
+            elapsed > 0 ? (double)total.steps / elapsed / 1e6 : 0.0);
+
+    fprintf(out, "Transition table (handler called directly):\n");
+    fprintf(out, "  I=IDLE C=CHARGING D=DISCHARGING L=LED_CONTROL F=FAULT S=DEEP_SLEEP\n");
+    fprintf(out, "  '-' unhandled, '.' ignored, '*' not taken in any reachable run\n");
+    fprintf(out, "  %-30s", "");
+    for (int s = 0; s < NUM_STATES; s++) {
+        fprintf(out, " %c ", STATE_LETTERS[s]);
+    }
+    fprintf(out, "\n");
+    int dead = 0;
+    for (int i = 0; i < NUM_INPUTS; i++) {
+        fprintf(out, "  %-30s", inputs[i].name);
+        for (int s = 0; s < NUM_STATES; s++) {
+            int t = table[s][i];
+            char c = t == -1 ? '-' : t == -2 ? '.' : STATE_LETTERS[t];
+            int live = t < 0 || total.taken[s][i] || !(total.reached & (1u << s));
+            if (!live) {
+                dead++;
+            }
+            fprintf(out, " %c%c", c, live ? ' ' : '*');
+        }
+        fprintf(out, "\n");
+    }
+
+    fprintf(out, "\nUnreachable states (depth %d):", depth_limit);
+    int unreachable = 0;
+    for (int s = 0; s < NUM_STATES; s++) {
+        if (!(total.reached & (1u << s))) {
+            fprintf(out, " %s", state_names[s]);
+            unreachable++;
+        }
+    }
+    fprintf(out, "%s\n", unreachable ? "" : " none");
+
+    fprintf(out, "Inputs dropped by GetBmsEvent():");
+    int dropped = 0;
+    for (int i = 0; i < NUM_INPUTS; i++) {
+        if (total.dropped[i] > 0) {
+            fprintf(out, "%s%s", dropped++ % 4 ? ", " : "\n  ", inputs[i].name);
+        }
+    }
+    fprintf(out, "%s\n", dropped ? "" : " none");
+    fprintf(out, "Transitions never taken because of dropped inputs: %d\n", dead);
+
+    fprintf(out, "Reachable unhandled (state, input) pairs:\n");
+    for (int s = 0; s < NUM_STATES; s++) {
+        int n = 0;
+        for (int i = 0; i < NUM_INPUTS; i++) {
+            n += total.unhandled[s][i];
+        }
+        if (n == 0) {
+            continue;
+        }
+        fprintf(out, "  %s (%d):", state_names[s], n);
+        int k = 0;
+        for (int i = 0; i < NUM_INPUTS; i++) {
+            if (total.unhandled[s][i]) {
+                fprintf(out, "%s%s", k++ % 4 ? ", " : "\n    ", inputs[i].name);
+            }
+        }
+        fprintf(out, "\n");
+    }
+
+    fprintf(out, "\nSafety properties:\n");
+    int failed = 0;
+    for (int p = 0; p < NUM_PROPERTIES; p++) {
+        fprintf(out, "  [%s] %s", total.violations[p] ? "FAIL" : "PASS", properties[p].name);
+        if (total.violations[p]) {
+            fprintf(out, ": %llu violating steps, e.g.\n    ", total.violations[p]);
+            print_sequence(total.cex[p], total.cex_len[p]);
+            failed = 1;
+        } else {
+            fprintf(out, "\n");
+        }
+    }
+    fprintf(out, "\n%s\n", failed ? "SAFETY VIOLATIONS FOUND" : "All safety properties hold");
+    fflush(out);
+    return failed ? 1 : 0;
+}
@@ -10,8 +10,14 @@
  * - External function declarations for states in other files
  */
 
+void (*g_unhandledEventHook)(Event event, const char* state_name) = NULL;
+
 // Helper function to handle unhandled events
 void HandleUnhandledEvent(Event event, const char* state_name) {
+    if (g_unhandledEventHook) {
+        g_unhandledEventHook(event, state_name);
+        return;
+    }
     printf("Unhandled event %d in state: %s\n", event, state_name);
     // In a real system, this would log to non-volatile memory
 }
@@ -15,4 +15,7 @@ extern const StateActions BMS_DEEP_SLEEP_STATE;
 // Helper function to handle unhandled events
 void HandleUnhandledEvent(Event event, const char* state_name);
 
+// Optional observer of unhandled events (e.g. the model checker); NULL = none
+extern void (*g_unhandledEventHook)(Event event, const char* state_name);
+
 #endif // BMS_STATES_H
\ No newline at end of file
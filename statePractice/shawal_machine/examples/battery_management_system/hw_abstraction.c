@@ -23,15 +23,51 @@ int adc_solar_voltage = 0;
 int adc_battery_ntc = 0;
 int adc_sys_current = 0;
 
+// Output pins by name (the part of the set_gpio() name before " (Pxx)")
+const HwPin hw_pins[] = {
+    {"ENABLE_LED_BUCK",        &pin_ENABLE_LED_BUCK},
+    {"ENABLE_BAT_OUTPUT",      &pin_ENABLE_BAT_OUTPUT},
+    {"ENABLE_CURRENT_SENSE",   &pin_ENABLE_CURRENT_SENSE},
+    {"MPPT_BQ_QON",            &pin_MPPT_BQ_QON},
+    {"MPPT_BQ_CHARGE_ENABLE",  &pin_MPPT_BQ_CHARGE_ENABLE},
+    {"LED_DISABLE",            &pin_LED_DISABLE},
+    {"ENABLE_BUCK_BOOST_100W", &pin_ENABLE_BUCK_BOOST_100W},
+    {"ENABLE_USB_100W",        &pin_ENABLE_USB_100W},
+    {"ENABLE_USB_60W",         &pin_ENABLE_USB_60W},
+    {"ENABLE_12V_RS485",       &pin_ENABLE_12V_RS485},
+    {"ENABLE_DIAG_12V_RS485",  &pin_ENABLE_DIAG_12V_RS485},
+    {"RS485_RECEIVER_ENABLE",  &pin_RS485_RECEIVER_ENABLE},
+    {"CAN_ENABLE",             &pin_CAN_ENABLE},
+};
+const int hw_pin_count = sizeof(hw_pins) / sizeof(hw_pins[0]);
+
+// Console output of the simulation (set_gpio, i2c_*); tools clear it
+int hw_log_enabled = 1;
+
+int (*hw_adc_source)(const char* channel_name) = NULL;
+int (*hw_gpio_input_source)(const char* pin_name) = NULL;
+
 // Simulates setting a digital output pin state
 void set_gpio(const char* pin_name, int state) {
-    printf("GPIO: Setting %s to %s\n", pin_name, state == HIGH ? "HIGH" : "LOW");
+    size_t len = strcspn(pin_name, " ");
+    for (int i = 0; i < hw_pin_count; i++) {
+        if (strlen(hw_pins[i].name) == len && strncmp(hw_pins[i].name, pin_name, len) == 0) {
+            *hw_pins[i].value = state;
+            break;
+        }
+    }
+    if (hw_log_enabled) {
+        printf("GPIO: Setting %s to %s\n", pin_name, state == HIGH ? "HIGH" : "LOW");
+    }
     // In real hardware, this would write to the actual GPIO register
     // Example: HAL_GPIO_WritePin(GPIOB, GPIO_PIN_13, state);
 }
 
 // Simulates reading a digital input pin state
 int read_gpio(const char* pin_name) {
+    if (hw_gpio_input_source) {
+        return hw_gpio_input_source(pin_name);
+    }
     // In real hardware, this would read from the actual GPIO register
     // Example: return HAL_GPIO_ReadPin(GPIOD, GPIO_PIN_10);
     return LOW; // Returning a dummy value for the simulation
@@ -39,6 +75,9 @@ int read_gpio(const char* pin_name) {
 
 // Simulates reading an ADC channel
 int read_adc(const char* channel_name) {
+    if (hw_adc_source) {
+        return hw_adc_source(channel_name);
+    }
     // In real hardware, this would trigger ADC conversion and read the result
     // Example: HAL_ADC_Start(&hadc1); HAL_ADC_PollForConversion(&hadc1, 100); return HAL_ADC_GetValue(&hadc1);
     
@@ -65,13 +104,13 @@ int read_adc(const char* channel_name) {
 
 // Simulates writing to an I2C device
 void i2c_write(const char* device_name, int data) {
-    printf("I2C: Writing %d to %s\n", data, device_name);
+    if (hw_log_enabled) printf("I2C: Writing %d to %s\n", data, device_name);
     // In real hardware: HAL_I2C_Mem_Write(&hi2c1, device_addr, reg_addr, I2C_MEMADD_SIZE_8BIT, &data, 1, 100);
 }
 
 // Simulates reading from an I2C device
 int i2c_read(const char* device_name) {
-    printf("I2C: Reading from %s\n", device_name);
+    if (hw_log_enabled) printf("I2C: Reading from %s\n", device_name);
     // In real hardware: HAL_I2C_Mem_Read(&hi2c1, device_addr, reg_addr, I2C_MEMADD_SIZE_8BIT, &data, 1, 100);
     return 0; // Returning a dummy value for normal operation
 }
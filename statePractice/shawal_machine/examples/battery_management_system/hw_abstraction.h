@@ -24,6 +24,21 @@ extern int pin_ENABLE_DIAG_12V_RS485;
 extern int pin_RS485_RECEIVER_ENABLE;
 extern int pin_CAN_ENABLE;
 
+// Output pins by name, in the order above; set_gpio() updates them
+typedef struct {
+    const char* name;
+    int* value;
+} HwPin;
+extern const HwPin hw_pins[];
+extern const int hw_pin_count;
+
+// Simulation console output (1 = print every GPIO / I2C access)
+extern int hw_log_enabled;
+
+// Optional input sources (e.g. a scenario); NULL = built-in simulation
+extern int (*hw_adc_source)(const char* channel_name);
+extern int (*hw_gpio_input_source)(const char* pin_name);
+
 // Simulated ADC readings (0-4095)
 extern int adc_usb_c_voltage;
 extern int adc_solar_voltage;
@@ -1,10 +1,13 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdbool.h>
+#include <unistd.h>
 #include "../../lib/state_machine/state_machine.h"
 #include "../../lib/state_machine/logger.h"
 #include "bms_states.h"
 #include "bms_events.h"
 #include "hw_abstraction.h"
+#include "scenario.h"
 
 /*
  * Battery Management System using State Machine Library
@@ -18,8 +21,13 @@
  * - Comprehensive fault handling
  *
  * The state machine ensures safe operation and immediate response to fault conditions.
+ *
+ * The host build runs scenario files (see scenario.h) against a virtual clock:
+ *   battery_management_system [-v] [-j jobs] [scenario...]
  */
 
+#define DEFAULT_SCENARIO "scenarios/demo.scn"
+
 // External state machine instance from library
 extern StateMachine g_stateMachine;
 
@@ -50,56 +58,10 @@ void SystemMainLoop(void) {
     }
 }
 
-// Simulation function to demonstrate system behavior
-void RunSimulation(void) {
-    static int simulation_step = 0;
-    simulation_step++;
-    
-    switch (simulation_step) {
-        case 5:
-            printf("\n--- Simulation: USB-C power source connected ---\n");
-            PostBmsEvent(POWER_SOURCE_CONNECTED);
-            break;
-        case 15:
-            printf("\n--- Simulation: Charging complete ---\n");
-            PostBmsEvent(CHARGE_COMPLETE);
-            break;
-        case 25:
-            printf("\n--- Simulation: Light switch toggled ON ---\n");
-            PostBmsEvent(LIGHT_SWITCH_TOGGLED);
-            break;
-        case 35:
-            printf("\n--- Simulation: Solar power connected ---\n");
-            PostBmsEvent(SOLAR_POWER_CONNECTED);
-            break;
-        case 45:
-            printf("\n--- Simulation: Light switch toggled OFF ---\n");
-            PostBmsEvent(LIGHT_SWITCH_TOGGLED);
-            break;
-        case 55:
-            printf("\n--- Simulation: Battery temperature fault ---\n");
-            PostBmsEvent(BATTERY_TEMP_FAULT);
-            break;
-        case 65:
-            printf("\n--- Simulation: System reset (back to IDLE) ---\n");
-            ChangeState(&BMS_IDLE_STATE);
-            break;
-        case 75:
-            printf("\n--- Simulation: Going to deep sleep ---\n");
-            PostBmsEvent(GO_TO_SLEEP);
-            break;
-        case 85:
-            printf("\n--- Simulation: Wake up from sleep ---\n");
-            PostBmsEvent(WAKE_UP);
-            break;
-        case 95:
-            printf("\n--- Simulation complete ---\n");
-            simulation_step = 0; // Reset for continuous demo
-            break;
-    }
-}
-
-int main(void) {
+// Run one scenario on the virtual clock: the main loop above, with the
+// scenario's inputs applied before each iteration and one tick of virtual
+// time per iteration instead of a delay
+int RunScenario(Scenario* sc) {
     printf("=== Battery Management System Initialization ===\n");
     
     // Initialize hardware abstraction layer
@@ -107,6 +69,7 @@ int main(void) {
     
     // Initialize the state machine to IDLE state
     g_stateMachine.current_state = &BMS_IDLE_STATE;
+    Scenario_Start(sc);
     
     non_blocking_log("System initialized. Starting in BMS_IDLE_STATE...\n");
     
@@ -115,11 +78,11 @@ int main(void) {
         g_stateMachine.current_state->entry_action();
     }
     
-    printf("\n=== Starting Battery Management System ===\n");
+    printf("\n=== Starting Battery Management System (%s) ===\n", sc->path);
     
-    // Main system loop with simulation
-    int loop_counter = 0;
-    while(1) {
+    for (sc->now_ms = 0; sc->now_ms <= sc->end_ms; sc->now_ms += sc->tick_ms) {
+        Scenario_ApplyInputs(sc);
+        
         // Execute current state's main action
         if (g_stateMachine.current_state && g_stateMachine.current_state->main_action) {
             g_stateMachine.current_state->main_action();
@@ -131,22 +94,49 @@ int main(void) {
             ProcessBmsEvent(event);
         }
         
-        // Run simulation events
-        if (loop_counter % 10 == 0) {  // Slow down simulation
-            RunSimulation();
-        }
-        
-        // Simulate processing delay
-        for (volatile long i = 0; i < 100000; i++);
-        
-        loop_counter++;
-        
-        // Exit after demonstration
-        if (loop_counter > 1000) {
-            break;
-        }
+        Scenario_Check(sc);
     }
     
     printf("\n=== Battery Management System Demo Complete ===\n");
-    return 0;
-}
\ No newline at end of file
+    return Scenario_Finish(sc);
+}
+
+static void Usage(const char* argv0) {
+    fprintf(stderr, "usage: %s [-v] [-j jobs] [scenario...]\n"
+                    "  default scenario: %s; -v shows the simulation output\n",
+            argv0, DEFAULT_SCENARIO);
+}
+
+int main(int argc, char** argv) {
+    static char* default_scenarios[] = { DEFAULT_SCENARIO };
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int jobs = cores > 0 ? (int)cores : 1;
+    int verbose = 0;
+    int opt;
+    
+    while ((opt = getopt(argc, argv, "vj:h")) != -1) {
+        switch (opt) {
+            case 'v':
+                verbose = 1;
+                break;
+            case 'j':
+                jobs = atoi(optarg);
+                break;
+            default:
+                Usage(argv[0]);
+                return 2;
+        }
+    }
+    if (jobs < 1) {
+        Usage(argv[0]);
+        return 2;
+    }
+    
+    char** scenarios = argv + optind;
+    int count = argc - optind;
+    if (count == 0) {
+        scenarios = default_scenarios;
+        count = 1;
+    }
+    return Scenario_RunFiles(scenarios, count, jobs, verbose, RunScenario) == 0 ? 0 : 1;
+}
@@ -0,0 +1,525 @@
+#include "scenario.h"
+#include "bms_states.h"
+#include "bms_events.h"
+#include "hw_abstraction.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+/*
+ * Scenario Runner
+ *
+ * Parses scenario files (format in scenario.h), feeds their inputs to the
+ * simulation through the hw_abstraction input sources and checks the state
+ * and GPIO trace. Every scenario runs in a forked process, so the static
+ * state of the firmware (event queue, pins) starts fresh each time and many
+ * scenarios can run side by side.
+ */
+
+// External state machine instance from library
+extern StateMachine g_stateMachine;
+
+// --- Name tables ---
+
+typedef struct {
+    const char* name;
+    int value;
+} NamedValue;
+
+static const NamedValue event_names[] = {
+    {"POWER_SOURCE_CONNECTED",    POWER_SOURCE_CONNECTED},
+    {"SOLAR_POWER_CONNECTED",     SOLAR_POWER_CONNECTED},
+    {"POWER_SOURCE_DISCONNECTED", POWER_SOURCE_DISCONNECTED},
+    {"CHARGE_COMPLETE",           CHARGE_COMPLETE},
+    {"LIGHT_SWITCH_TOGGLED",      LIGHT_SWITCH_TOGGLED},
+    {"BATTERY_TEMP_FAULT",        BATTERY_TEMP_FAULT},
+    {"BMS_INTERRUPT",             BMS_INTERRUPT},
+    {"USB_FAULT",                 USB_FAULT},
+    {"SYSTEM_FAULT",              SYSTEM_FAULT},
+    {"FAULT_RS485_12V",           FAULT_RS485_12V},
+    {"BMS_COMM_FAULT",            BMS_COMM_FAULT},
+    {"CHARGER_COMM_FAULT",        CHARGER_COMM_FAULT},
+    {"BATTERY_CELL_UVLO",         BATTERY_CELL_UVLO},
+    {"BATTERY_CELL_OVLO",         BATTERY_CELL_OVLO},
+    {"HIGH_CURRENT_DETECTED",     HIGH_CURRENT_DETECTED},
+    {"GO_TO_SLEEP",               GO_TO_SLEEP},
+    {"WAKE_UP",                   WAKE_UP},
+};
+#define NUM_EVENT_NAMES ((int)(sizeof(event_names) / sizeof(event_names[0])))
+
+static const struct {
+    const char* name;
+    StateHandler state;
+} state_names[] = {
+    {"IDLE",        &BMS_IDLE_STATE},
+    {"CHARGING",    &BMS_CHARGING_STATE},
+    {"DISCHARGING", &BMS_DISCHARGING_STATE},
+    {"LED_CONTROL", &BMS_LED_CONTROL_STATE},
+    {"FAULT",       &BMS_FAULT_STATE},
+    {"DEEP_SLEEP",  &BMS_DEEP_SLEEP_STATE},
+};
+#define NUM_STATE_NAMES ((int)(sizeof(state_names) / sizeof(state_names[0])))
+
+// ADC channels and digital inputs the states read (see read_adc / read_gpio)
+static const char* const adc_channels[SCENARIO_MAX_CHANNELS] = {
+    "ADC_Con_1", "ADC_Solar_In", "NTC_2_PACK", "I_SYS_OUT",
+};
+static const char* const gpio_inputs[] = {
+    "FAULT_12V_RS485",
+};
+#define NUM_GPIO_INPUTS ((int)(sizeof(gpio_inputs) / sizeof(gpio_inputs[0])))
+
+static int find_name(const char* const* names, int count, const char* name) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(names[i], name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int find_event(const char* name) {
+    for (int i = 0; i < NUM_EVENT_NAMES; i++) {
+        if (strcmp(event_names[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static StateHandler find_state(const char* name) {
+    for (int i = 0; i < NUM_STATE_NAMES; i++) {
+        if (strcmp(state_names[i].name, name) == 0) {
+            return state_names[i].state;
+        }
+    }
+    return NULL;
+}
+
+static int state_bit(StateHandler state) {
+    for (int i = 0; i < NUM_STATE_NAMES; i++) {
+        if (state_names[i].state == state) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static const char* state_name(StateHandler state) {
+    int i = state_bit(state);
+    return i >= 0 ? state_names[i].name : "?";
+}
+
+static int find_output(const char* name) {
+    for (int i = 0; i < hw_pin_count; i++) {
+        if (strcmp(hw_pins[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int parse_level(const char* s) {
+    if (s && strcmp(s, "HIGH") == 0) return HIGH;
+    if (s && strcmp(s, "LOW") == 0) return LOW;
+    return -1;
+}
+
+static int parse_number(const char* s, unsigned long* out) {
+    char* end;
+    if (s == NULL || *s == '\0') {
+        return -1;
+    }
+    *out = strtoul(s, &end, 10);
+    return *end == '\0' ? 0 : -1;
+}
+
+// --- Loading ---
+
+static int parse_step(ScenarioStep* st, char** tok, int n) {
+    const char* what = tok[0];
+    unsigned long v;
+
+    if (strcmp(what, "event") == 0 && n == 2) {
+        st->kind = STEP_EVENT;
+        st->index = find_event(tok[1]);
+        return st->index >= 0 ? 0 : -1;
+    }
+    if (strcmp(what, "adc") == 0 && (n == 3 || n == 5)) {
+        st->kind = STEP_ADC;
+        st->index = find_name(adc_channels, SCENARIO_MAX_CHANNELS, tok[1]);
+        if (n == 3) {
+            if (parse_number(tok[2], &v) != 0) return -1;
+            st->ramp_ms = 0;
+        } else {
+            if (strcmp(tok[2], "ramp") != 0 || parse_number(tok[3], &v) != 0 ||
+                parse_number(tok[4], &st->ramp_ms) != 0) return -1;
+        }
+        st->value = (int)v;
+        return st->index >= 0 && v <= 4095 ? 0 : -1;
+    }
+    if (strcmp(what, "gpio") == 0 && n == 3) {
+        st->kind = STEP_GPIO;
+        st->index = find_name(gpio_inputs, NUM_GPIO_INPUTS, tok[1]);
+        st->value = parse_level(tok[2]);
+        return st->index >= 0 && st->value >= 0 ? 0 : -1;
+    }
+    if (strcmp(what, "reset") == 0 && n == 1) {
+        st->kind = STEP_RESET;
+        return 0;
+    }
+    if (strcmp(what, "expect") == 0 && n == 3 && strcmp(tok[1], "state") == 0) {
+        st->kind = STEP_EXPECT_STATE;
+        st->state = find_state(tok[2]);
+        return st->state ? 0 : -1;
+    }
+    if (strcmp(what, "expect") == 0 && n == 4 && strcmp(tok[1], "pin") == 0) {
+        st->kind = STEP_EXPECT_PIN;
+        st->index = find_output(tok[2]);
+        st->value = parse_level(tok[3]);
+        return st->index >= 0 && st->value >= 0 ? 0 : -1;
+    }
+    return -1;
+}
+
+static int parse_line(Scenario* sc, char* line, int line_no) {
+    char* tok[SCENARIO_MAX_TRACE + 1];
+    int n = 0;
+    char* hash = strchr(line, '#');
+    if (hash) {
+        *hash = '\0';
+    }
+    for (char* t = strtok(line, " \t\r\n"); t && n < SCENARIO_MAX_TRACE + 1; t = strtok(NULL, " \t\r\n")) {
+        tok[n++] = t;
+    }
+    if (n == 0) {
+        return 0;
+    }
+
+    if (strcmp(tok[0], "tick") == 0 && n == 2) {
+        return parse_number(tok[1], &sc->tick_ms) == 0 && sc->tick_ms > 0 ? 0 : -1;
+    }
+    if (strcmp(tok[0], "end") == 0 && n == 2) {
+        return parse_number(tok[1], &sc->end_ms);
+    }
+    if (strcmp(tok[0], "never") == 0 && n == 2) {
+        int bit = state_bit(find_state(tok[1]));
+        if (bit < 0) return -1;
+        sc->never_mask |= 1u << bit;
+        return 0;
+    }
+    if (strcmp(tok[0], "trace") == 0 && n >= 2 && n <= SCENARIO_MAX_TRACE) {
+        sc->expected_trace_len = n - 1;
+        for (int i = 1; i < n; i++) {
+            sc->expected_trace[i - 1] = find_state(tok[i]);
+            if (sc->expected_trace[i - 1] == NULL) return -1;
+        }
+        return 0;
+    }
+    if (strcmp(tok[0], "at") == 0 && n >= 3) {
+        if (sc->step_count == SCENARIO_MAX_STEPS) {
+            return -1;
+        }
+        ScenarioStep* st = &sc->steps[sc->step_count];
+        memset(st, 0, sizeof(*st));
+        st->line = line_no;
+        if (parse_number(tok[1], &st->at_ms) != 0 || parse_step(st, tok + 2, n - 2) != 0) {
+            return -1;
+        }
+        sc->step_count++;
+        return 0;
+    }
+    return -1;
+}
+
+int Scenario_Load(const char* path, Scenario* sc) {
+    char line[512];
+    int line_no = 0;
+    FILE* f = fopen(path, "r");
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    memset(sc, 0, sizeof(*sc));
+    sc->path = path;
+    sc->tick_ms = 10;
+    sc->expected_trace_len = -1;
+    while (fgets(line, sizeof(line), f)) {
+        line_no++;
+        if (parse_line(sc, line, line_no) != 0) {
+            fprintf(stderr, "%s:%d: invalid line\n", path, line_no);
+            fclose(f);
+            return -1;
+        }
+    }
+    fclose(f);
+
+    // Stable sort by time: steps at the same time keep their file order
+    for (int i = 1; i < sc->step_count; i++) {
+        ScenarioStep st = sc->steps[i];
+        int j = i;
+        while (j > 0 && sc->steps[j - 1].at_ms > st.at_ms) {
+            sc->steps[j] = sc->steps[j - 1];
+            j--;
+        }
+        sc->steps[j] = st;
+    }
+    if (sc->end_ms == 0 && sc->step_count > 0) {
+        sc->end_ms = sc->steps[sc->step_count - 1].at_ms;
+    }
+    return 0;
+}
+
+// --- Running ---
+
+// The scenario the input sources read (one per process)
+static Scenario* active;
+
+static int wave_value(const ScenarioWave* w, unsigned long now) {
+    if (now <= w->start_ms) {
+        return w->v0;
+    }
+    if (now >= w->start_ms + w->ramp_ms) {
+        return w->v1;
+    }
+    long span = (long)(now - w->start_ms);
+    return w->v0 + (int)((long)(w->v1 - w->v0) * span / (long)w->ramp_ms);
+}
+
+static int scenario_adc(const char* channel_name) {
+    int i = find_name(adc_channels, SCENARIO_MAX_CHANNELS, channel_name);
+    return i >= 0 ? wave_value(&active->adc[i], active->now_ms) : 0;
+}
+
+static int scenario_gpio_input(const char* pin_name) {
+    int i = find_name(gpio_inputs, NUM_GPIO_INPUTS, pin_name);
+    return i >= 0 ? active->gpio_in[i] : LOW;
+}
+
+static void fail(Scenario* sc, int line, const char* fmt, const char* a, const char* b) {
+    if (sc->failures++ == 0) {
+        int n = line > 0
+            ? snprintf(sc->failure, sizeof(sc->failure), "%s:%d: at %lu ms: ", sc->path, line, sc->now_ms)
+            : snprintf(sc->failure, sizeof(sc->failure), "%s: at %lu ms: ", sc->path, sc->now_ms);
+        if (n > 0 && n < (int)sizeof(sc->failure)) {
+            snprintf(sc->failure + n, sizeof(sc->failure) - (size_t)n, fmt, a, b);
+        }
+    }
+    printf("*** SCENARIO FAILURE at %lu ms ***\n", sc->now_ms);
+}
+
+static void record_state(Scenario* sc) {
+    StateHandler cur = g_stateMachine.current_state;
+    if (sc->trace_len > 0 && sc->trace[sc->trace_len - 1] == cur) {
+        return;
+    }
+    if (sc->trace_len == SCENARIO_MAX_TRACE) {
+        sc->trace_overflow = 1;
+        return;
+    }
+    sc->trace[sc->trace_len++] = cur;
+    int bit = state_bit(cur);
+    if (bit >= 0 && (sc->never_mask & (1u << bit))) {
+        fail(sc, 0, "entered %s%s", state_name(cur), " (never)");
+    }
+}
+
+void Scenario_Start(Scenario* sc) {
+    active = sc;
+    sc->now_ms = 0;
+    sc->next_input = 0;
+    sc->next_check = 0;
+    sc->trace_len = 0;
+    hw_adc_source = scenario_adc;
+    hw_gpio_input_source = scenario_gpio_input;
+    record_state(sc);
+}
+
+void Scenario_ApplyInputs(Scenario* sc) {
+    for (; sc->next_input < sc->step_count; sc->next_input++) {
+        ScenarioStep* st = &sc->steps[sc->next_input];
+        if (st->at_ms > sc->now_ms) {
+            break;
+        }
+        switch (st->kind) {
+            case STEP_EVENT:
+                printf("\n--- %lu ms: %s ---\n", sc->now_ms, event_names[st->index].name);
+                PostBmsEvent((BmsEvent)event_names[st->index].value);
+                break;
+            case STEP_ADC: {
+                ScenarioWave* w = &sc->adc[st->index];
+                w->v0 = wave_value(w, sc->now_ms);
+                w->v1 = st->value;
+                w->start_ms = sc->now_ms;
+                w->ramp_ms = st->ramp_ms;
+                if (st->ramp_ms) {
+                    printf("\n--- %lu ms: %s ramp to %d over %lu ms ---\n", sc->now_ms,
+                           adc_channels[st->index], st->value, st->ramp_ms);
+                } else {
+                    printf("\n--- %lu ms: %s = %d ---\n", sc->now_ms, adc_channels[st->index], st->value);
+                }
+                break;
+            }
+            case STEP_GPIO:
+                sc->gpio_in[st->index] = st->value;
+                printf("\n--- %lu ms: %s %s ---\n", sc->now_ms, gpio_inputs[st->index],
+                       st->value == HIGH ? "HIGH" : "LOW");
+                break;
+            case STEP_RESET:
+                printf("\n--- %lu ms: System reset (back to IDLE) ---\n", sc->now_ms);
+                ChangeState(&BMS_IDLE_STATE);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void Scenario_Check(Scenario* sc) {
+    record_state(sc);
+    for (; sc->next_check < sc->step_count; sc->next_check++) {
+        ScenarioStep* st = &sc->steps[sc->next_check];
+        if (st->at_ms > sc->now_ms) {
+            break;
+        }
+        if (st->kind == STEP_EXPECT_STATE && g_stateMachine.current_state != st->state) {
+            fail(sc, st->line, "expected state %s, got %s",
+                 state_name(st->state), state_name(g_stateMachine.current_state));
+        } else if (st->kind == STEP_EXPECT_PIN && *hw_pins[st->index].value != st->value) {
+            fail(sc, st->line, "expected %s %s", hw_pins[st->index].name,
+                 st->value == HIGH ? "HIGH" : "LOW");
+        }
+    }
+}
+
+int Scenario_Finish(Scenario* sc) {
+    if (sc->next_check < sc->step_count) {
+        fail(sc, sc->steps[sc->next_check].line, "%s%s", "not reached before end", "");
+    }
+    if (sc->expected_trace_len >= 0) {
+        int same = !sc->trace_overflow && sc->trace_len == sc->expected_trace_len;
+        for (int i = 0; same && i < sc->trace_len; i++) {
+            same = sc->trace[i] == sc->expected_trace[i];
+        }
+        if (!same) {
+            char got[192] = "";
+            for (int i = 0; i < sc->trace_len; i++) {
+                size_t used = strlen(got);
+                snprintf(got + used, sizeof(got) - used, "%s%s", i ? " " : "", state_name(sc->trace[i]));
+            }
+            fail(sc, 0, "trace was: %s%s", got, sc->trace_overflow ? " ..." : "");
+        }
+    }
+    hw_adc_source = NULL;
+    hw_gpio_input_source = NULL;
+    active = NULL;
+    return sc->failures;
+}
+
+// --- Parallel runs ---
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Child: run one scenario and write its result line to fd
+static void run_child(const char* path, int verbose, int fd, int (*run)(Scenario* sc)) {
+    static Scenario sc;
+    char msg[512];
+    int failures;
+
+    if (!verbose && freopen("/dev/null", "w", stdout) == NULL) {
+        _exit(2);
+    }
+    if (Scenario_Load(path, &sc) != 0) {
+        snprintf(msg, sizeof(msg), "ERROR %s: cannot load\n", path);
+        failures = -1;
+    } else {
+        double t0 = now_seconds();
+        failures = run(&sc);
+        double wall_ms = (now_seconds() - t0) * 1e3;
+        if (failures == 0) {
+            snprintf(msg, sizeof(msg), "PASS  %s: %lu ms in %.2f ms (%.0fx real time)\n",
+                     path, sc.end_ms, wall_ms, wall_ms > 0 ? (double)sc.end_ms / wall_ms : 0.0);
+        } else {
+            snprintf(msg, sizeof(msg), "FAIL  %s: %d failure(s)\n      %s\n",
+                     path, failures, sc.failure);
+        }
+    }
+    fflush(stdout);
+    if (write(fd, msg, strlen(msg)) < 0) {
+        _exit(2);
+    }
+    _exit(failures == 0 ? 0 : 1);
+}
+
+int Scenario_RunFiles(char** paths, int count, int jobs, int verbose,
+                      int (*run)(Scenario* sc)) {
+    typedef struct {
+        pid_t pid;
+        int fd;
+        char result[512];
+        int ok;
+    } Run;
+    Run* runs = calloc((size_t)count, sizeof(Run));
+    int next = 0, running = 0, failed = 0;
+
+    if (runs == NULL) {
+        return count;
+    }
+    while (next < count || running > 0) {
+        while (running < jobs && next < count) {
+            int fd[2];
+            Run* r = &runs[next];
+            fflush(NULL);
+            if (pipe(fd) != 0 || (r->pid = fork()) < 0) {
+                snprintf(r->result, sizeof(r->result), "ERROR %s: cannot start\n", paths[next]);
+                next++;
+                continue;
+            }
+            if (r->pid == 0) {
+                close(fd[0]);
+                run_child(paths[next], verbose, fd[1], run);
+            }
+            close(fd[1]);
+            r->fd = fd[0];
+            next++;
+            running++;
+        }
+        if (running == 0) {
+            break;
+        }
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            break;
+        }
+        for (int i = 0; i < next; i++) {
+            Run* r = &runs[i];
+            if (r->pid != pid) {
+                continue;
+            }
+            ssize_t n = read(r->fd, r->result, sizeof(r->result) - 1);
+            r->result[n > 0 ? n : 0] = '\0';
+            close(r->fd);
+            r->ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+            if (n <= 0) {
+                snprintf(r->result, sizeof(r->result), "ERROR %s: crashed\n", paths[i]);
+            }
+            running--;
+            break;
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        fputs(runs[i].result, stdout);
+        failed += !runs[i].ok;
+    }
+    printf("%d of %d scenario(s) passed\n", count - failed, count);
+    free(runs);
+    return failed;
+}
@@ -0,0 +1,110 @@
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include "../../lib/state_machine/state_machine.h"
+
+/*
+ * Scenario files for the BMS simulation
+ *
+ * A scenario is a text file of timestamped inputs and expectations, run
+ * against a virtual clock (one main loop iteration per tick):
+ *
+ *   # comment
+ *   tick 10                              main loop period in ms (default 10)
+ *   end 10000                            stop after this many ms
+ *   at 400  event POWER_SOURCE_CONNECTED post a BMS event
+ *   at 0    adc NTC_2_PACK 2048          ADC channel: constant from then on
+ *   at 2000 adc NTC_2_PACK ramp 3500 500 ... or a ramp to 3500 over 500 ms
+ *   at 300  gpio FAULT_12V_RS485 HIGH    digital input level (default LOW)
+ *   at 6400 reset                        force BMS_IDLE_STATE (manual reset)
+ *   at 500  expect state CHARGING        state at that time
+ *   at 500  expect pin MPPT_BQ_CHARGE_ENABLE LOW
+ *   never FAULT                          state never entered
+ *   trace IDLE CHARGING FAULT IDLE       exact sequence of states visited
+ *
+ * Each tick: inputs due at the current time are applied, the state's main
+ * action runs, one queued event is processed, then the state is traced and
+ * the expectations due are checked.
+ */
+
+#define SCENARIO_MAX_STEPS    128
+#define SCENARIO_MAX_TRACE    64
+#define SCENARIO_MAX_CHANNELS 4
+#define SCENARIO_MAX_INPUTS   4
+
+typedef enum {
+    STEP_EVENT,
+    STEP_ADC,
+    STEP_GPIO,
+    STEP_RESET,
+    STEP_EXPECT_STATE,
+    STEP_EXPECT_PIN,
+} ScenarioStepKind;
+
+typedef struct {
+    unsigned long at_ms;
+    ScenarioStepKind kind;
+    int line;
+    int index;              // event, ADC channel, input or output pin
+    int value;              // level, or ADC target
+    unsigned long ramp_ms;  // 0 = step
+    StateHandler state;
+} ScenarioStep;
+
+// One ADC channel: v0 until start, then a linear ramp to v1
+typedef struct {
+    unsigned long start_ms;
+    unsigned long ramp_ms;
+    int v0;
+    int v1;
+} ScenarioWave;
+
+typedef struct {
+    const char* path;
+    unsigned long tick_ms;
+    unsigned long end_ms;
+    unsigned long now_ms;       // virtual clock
+
+    ScenarioStep steps[SCENARIO_MAX_STEPS];
+    int step_count;
+    int next_input;             // steps are sorted by time; inputs and
+    int next_check;             // checks are consumed separately
+
+    ScenarioWave adc[SCENARIO_MAX_CHANNELS];
+    int gpio_in[SCENARIO_MAX_INPUTS];
+
+    unsigned never_mask;        // bit per state
+    StateHandler expected_trace[SCENARIO_MAX_TRACE];
+    int expected_trace_len;     // -1 = no trace assertion
+
+    StateHandler trace[SCENARIO_MAX_TRACE];
+    int trace_len;
+    int trace_overflow;
+
+    int failures;
+    char failure[256];          // first failure
+} Scenario;
+
+// Parse a scenario file; prints "path:line: error" to stderr, returns 0 on success
+int Scenario_Load(const char* path, Scenario* sc);
+
+// Install the ADC / GPIO input sources, start the clock at 0 and trace the
+// initial state. Call before the initial state's entry action.
+void Scenario_Start(Scenario* sc);
+
+// Apply the inputs due at sc->now_ms
+void Scenario_ApplyInputs(Scenario* sc);
+
+// Trace the state, check the expectations due at sc->now_ms
+void Scenario_Check(Scenario* sc);
+
+// Final checks (trace, unconsumed expectations); returns the failure count
+int Scenario_Finish(Scenario* sc);
+
+// Run every file in its own process, up to `jobs` at a time, and print one
+// result line per scenario in argument order. With verbose the simulation
+// output is shown, otherwise discarded. Returns the number of failed runs.
+int Scenario_RunFiles(char** paths, int count, int jobs, int verbose,
+                      int (*run)(Scenario* sc));
+
+#endif // SCENARIO_H